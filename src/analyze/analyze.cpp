@@ -21,7 +21,8 @@ std::shared_ptr<Query> Analyze::do_analyze(std::shared_ptr<ast::TreeNode> parse)
 
         // 处理target list，再target list中添加上表名，例如 a.id
         for (auto &sv_sel_col : x->cols) {
-            TabCol sel_col = {.tab_name = sv_sel_col->tab_name, .col_name = sv_sel_col->col_name};
+            TabCol sel_col = {.tab_name = sv_sel_col->tab_name, .col_name = sv_sel_col->col_name,
+                              .agg_type = convert_sv_agg_type(sv_sel_col->agg_type)};
             query->cols.push_back(sel_col);
         }
         // auto all_cols = get_all_cols(query->tables);
@@ -36,12 +37,35 @@ std::shared_ptr<Query> Analyze::do_analyze(std::shared_ptr<ast::TreeNode> parse)
         } else {
             // infer table name from column name
             for (auto &sel_col : query->cols) {
-                sel_col = check_column(all_cols, sel_col);  // 列元数据校验
+                if (sel_col.col_name != "*") {  // COUNT(*)不对应具体的字段
+                    sel_col = check_column(all_cols, sel_col);  // 列元数据校验
+                }
             }
         }
         //处理where条件
         get_clause(x->conds, query->conds);
         check_clause(query->tables, query->conds);
+        // 处理order by的字段
+        for (auto &order : x->orders) {
+            TabCol order_col = {.tab_name = order->cols->tab_name, .col_name = order->cols->col_name,
+                                .agg_type = convert_sv_agg_type(order->cols->agg_type)};
+            query->order_cols.push_back(order_col.col_name == "*" ? order_col : check_column(all_cols, order_col));
+            query->order_descs.push_back(order->orderby_dir == ast::OrderBy_DESC);
+        }
+        // 处理group by的字段和聚合函数
+        for (auto &group : x->groups) {
+            TabCol group_col = {.tab_name = group->tab_name, .col_name = group->col_name};
+            query->group_cols.push_back(check_column(all_cols, group_col));
+        }
+        check_aggregate(all_cols, query);
+        // 处理limit和offset
+        if (x->limit) {
+            if (x->limit->limit < 0 || x->limit->offset < 0) {
+                throw InvalidLimitError(x->limit->limit, x->limit->offset);
+            }
+            query->limit = x->limit->limit;
+            query->offset = x->limit->offset;
+        }
     } else if (auto x = std::dynamic_pointer_cast<ast::UpdateStmt>(parse)) {
         // 处理 update 的set 值
         for (auto &sv_set_clause : x->set_clauses) {
@@ -103,6 +127,40 @@ TabCol Analyze::check_column(const std::vector<ColMeta> &all_cols, TabCol target
     return target;
 }
 
+/**
+ * @brief 有聚合函数或group by时，select列表和order by中的普通字段都必须是分组字段，SUM和AVG只能作用在数值字段上
+ */
+void Analyze::check_aggregate(const std::vector<ColMeta> &all_cols, const std::shared_ptr<Query> &query) {
+    query->has_agg = !query->group_cols.empty();
+    for (auto *cols : {&query->cols, &query->order_cols}) {
+        for (auto &col : *cols) {
+            query->has_agg |= col.agg_type != AGG_NONE;
+        }
+    }
+    if (!query->has_agg) {
+        return;
+    }
+    for (auto *cols : {&query->cols, &query->order_cols}) {
+        for (auto &col : *cols) {
+            if (col.agg_type == AGG_NONE) {
+                auto is_group_col = [&](const TabCol &group_col) {
+                    return group_col.tab_name == col.tab_name && group_col.col_name == col.col_name;
+                };
+                if (std::none_of(query->group_cols.begin(), query->group_cols.end(), is_group_col)) {
+                    throw InvalidAggregateError(col.tab_name + '.' + col.col_name + " is not in group by");
+                }
+            } else if (col.agg_type == AGG_SUM || col.agg_type == AGG_AVG) {
+                auto meta = std::find_if(all_cols.begin(), all_cols.end(), [&](const ColMeta &meta) {
+                    return meta.tab_name == col.tab_name && meta.name == col.col_name;
+                });
+                if (meta->type == TYPE_STRING) {
+                    throw InvalidAggregateError(col.caption() + " on " + coltype2str(meta->type));
+                }
+            }
+        }
+    }
+}
+
 void Analyze::get_all_cols(const std::vector<std::string> &tab_names, std::vector<ColMeta> &all_cols) {
     for (auto &sel_tab_name : tab_names) {
         // 这里db_不能写成get_db(), 注意要传指针
@@ -172,6 +230,14 @@ Value Analyze::convert_sv_value(const std::shared_ptr<ast::Value> &sv_val) {
     return val;
 }
 
+AggType Analyze::convert_sv_agg_type(ast::SvAggType agg_type) {
+    std::map<ast::SvAggType, AggType> m = {
+        {ast::SV_AGG_NONE, AGG_NONE}, {ast::SV_AGG_COUNT, AGG_COUNT}, {ast::SV_AGG_SUM, AGG_SUM},
+        {ast::SV_AGG_MIN, AGG_MIN},   {ast::SV_AGG_MAX, AGG_MAX},     {ast::SV_AGG_AVG, AGG_AVG},
+    };
+    return m.at(agg_type);
+}
+
 CompOp Analyze::convert_sv_comp_op(ast::SvCompOp op) {
     std::map<ast::SvCompOp, CompOp> m = {
         {ast::SV_OP_EQ, OP_EQ}, {ast::SV_OP_NE, OP_NE}, {ast::SV_OP_LT, OP_LT},
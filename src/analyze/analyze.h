@@ -10,6 +10,7 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <memory>
@@ -34,6 +35,15 @@ class Query{
     std::vector<SetClause> set_clauses;
     //insert 的values值
     std::vector<Value> values;
+    // order by 的字段，以及每个字段是否降序
+    std::vector<TabCol> order_cols;
+    std::vector<bool> order_descs;
+    // group by 的分组字段，以及查询是否有聚合函数或group by
+    std::vector<TabCol> group_cols;
+    bool has_agg = false;
+    // limit 返回的最多行数（-1表示没有限制）和跳过的行数
+    int limit = -1;
+    int offset = 0;
 
     Query(){}
 
@@ -51,10 +61,12 @@ public:
 
 private:
     TabCol check_column(const std::vector<ColMeta> &all_cols, TabCol target);
+    void check_aggregate(const std::vector<ColMeta> &all_cols, const std::shared_ptr<Query> &query);
     void get_all_cols(const std::vector<std::string> &tab_names, std::vector<ColMeta> &all_cols);
     void get_clause(const std::vector<std::shared_ptr<ast::BinaryExpr>> &sv_conds, std::vector<Condition> &conds);
     void check_clause(const std::vector<std::string> &tab_names, std::vector<Condition> &conds);
     Value convert_sv_value(const std::shared_ptr<ast::Value> &sv_val);
     CompOp convert_sv_comp_op(ast::SvCompOp op);
+    AggType convert_sv_agg_type(ast::SvAggType agg_type);
 };
 
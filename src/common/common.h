@@ -19,13 +19,27 @@ See the Mulan PSL v2 for more details. */
 #include "record/rm_defs.h"
 
 
+enum AggType { AGG_NONE, AGG_COUNT, AGG_SUM, AGG_MIN, AGG_MAX, AGG_AVG };
+
 struct TabCol {
     std::string tab_name;
     std::string col_name;
+    AggType agg_type = AGG_NONE;  // 作用在字段上的聚合函数，COUNT(*)的tab_name为空、col_name为"*"
 
     friend bool operator<(const TabCol &x, const TabCol &y) {
         return std::make_pair(x.tab_name, x.col_name) < std::make_pair(y.tab_name, y.col_name);
     }
+
+    /**
+     * @brief 字段在结果中的名称，聚合字段为SUM(score)、COUNT(*)这样的形式
+     */
+    std::string caption() const {
+        static const char *agg_names[] = {"", "COUNT", "SUM", "MIN", "MAX", "AVG"};
+        if (agg_type == AGG_NONE) {
+            return col_name;
+        }
+        return std::string(agg_names[agg_type]) + "(" + col_name + ")";
+    }
 };
 
 struct Value {
@@ -132,6 +132,18 @@ class IndexExistsError : public RMDBError {
     }
 };
 
+class UniqueConstraintError : public RMDBError {
+   public:
+    UniqueConstraintError(const std::string &tab_name, const std::vector<std::string> &col_names) {
+        _msg += "Duplicate key violates unique index: " + tab_name + ".(";
+        for(size_t i = 0; i < col_names.size(); ++i) {
+            if(i > 0) _msg += ", ";
+            _msg += col_names[i];
+        }
+        _msg += ")";
+    }
+};
+
 // QL errors
 class InvalidValueCountError : public RMDBError {
    public:
@@ -149,6 +161,17 @@ class IncompatibleTypeError : public RMDBError {
         : RMDBError("Incompatible type error: lhs " + lhs + ", rhs " + rhs) {}
 };
 
+class InvalidLimitError : public RMDBError {
+   public:
+    InvalidLimitError(int limit, int offset)
+        : RMDBError("Invalid limit " + std::to_string(limit) + " offset " + std::to_string(offset)) {}
+};
+
+class InvalidAggregateError : public RMDBError {
+   public:
+    InvalidAggregateError(const std::string &msg) : RMDBError("Invalid aggregate: " + msg) {}
+};
+
 class AmbiguousColumnError : public RMDBError {
    public:
     AmbiguousColumnError(const std::string &col_name) : RMDBError("Ambiguous column: " + col_name) {}
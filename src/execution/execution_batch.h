@@ -0,0 +1,89 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "execution_defs.h"
+
+/**
+ * 算子之间一次传递的一批定长元组，元组按行连续存放；
+ * 选择向量sel_按顺序记录批中有效元组的行号，过滤时只压缩选择向量，不移动元组
+ */
+class TupleBatch {
+   private:
+    size_t tuple_len_ = 0;
+    size_t capacity_ = 0;       // 最多存放的元组数量
+    size_t num_rows_ = 0;       // 已经存放的元组数量，包括被过滤掉的
+    std::vector<char> data_;
+    std::vector<uint32_t> sel_;
+
+   public:
+    /**
+     * @brief 清空这一批，并按元组长度准备好存放capacity个元组的空间
+     */
+    void reset(size_t tuple_len, size_t capacity = EXECUTION_BATCH_SIZE) {
+        tuple_len_ = tuple_len;
+        capacity_ = capacity;
+        if (data_.size() < tuple_len * capacity) {
+            data_.resize(tuple_len * capacity);
+        }
+        clear();
+    }
+
+    void clear() {
+        num_rows_ = 0;
+        sel_.clear();
+    }
+
+    size_t tuple_len() const { return tuple_len_; }
+
+    size_t num_rows() const { return num_rows_; }
+
+    bool full() const { return num_rows_ == capacity_; }
+
+    size_t remaining() const { return capacity_ - num_rows_; }
+
+    /** 有效元组的数量 */
+    size_t size() const { return sel_.size(); }
+
+    bool empty() const { return sel_.empty(); }
+
+    char *row(size_t row_no) { return data_.data() + row_no * tuple_len_; }
+
+    const char *row(size_t row_no) const { return data_.data() + row_no * tuple_len_; }
+
+    /** 第i个有效元组 */
+    const char *get(size_t i) const { return row(sel_[i]); }
+
+    std::vector<uint32_t> &sel() { return sel_; }
+
+    /**
+     * @brief 在末尾追加一个有效元组，返回它的存放位置由调用者填写
+     */
+    char *append() {
+        sel_.push_back(static_cast<uint32_t>(num_rows_));
+        return row(num_rows_++);
+    }
+
+    void append(const char *tuple) { memcpy(append(), tuple, tuple_len_); }
+
+    /**
+     * @brief 调用者已经直接在row(num_rows())开始的位置写入了n个元组，把它们都加入这一批
+     */
+    void extend(size_t n) {
+        for (size_t i = 0; i < n; i++) {
+            sel_.push_back(static_cast<uint32_t>(num_rows_++));
+        }
+    }
+};
@@ -0,0 +1,160 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "common/common.h"
+#include "execution_batch.h"
+#include "system/sm_meta.h"
+
+/**
+ * 构造算子时按字段名找好条件两侧在元组中的位置，并按字段类型和比较运算符选好一个特化的判断函数，
+ * 算子的全部条件就是一段依次执行的判断程序；判断每个元组时每个条件只有一次函数指针调用，
+ * 不再逐个条件按字符串查找字段，也不再对类型和运算符分支
+ */
+class ResolvedCond {
+   private:
+    using EvalFn = bool (*)(const char *lhs, const char *rhs, int len);
+
+    EvalFn eval_fn_;
+    int lhs_offset_;
+    int rhs_offset_;            // 右侧是值时不使用
+    const char *rhs_val_;       // 右侧是值时指向Condition中的值，Condition需要比ResolvedCond存在得久
+    int len_;                   // 左侧字段的长度，比较字符串时使用
+    ColType type_;
+    CompOp op_;
+
+   public:
+    ResolvedCond(const std::vector<ColMeta> &cols, const Condition &cond) : op_(cond.op) {
+        auto lhs_col = find_col(cols, cond.lhs_col);
+        lhs_offset_ = lhs_col->offset;
+        if (cond.is_rhs_val) {
+            rhs_offset_ = -1;
+            rhs_val_ = cond.rhs_val.raw->data;
+        } else {
+            rhs_offset_ = find_col(cols, cond.rhs_col)->offset;
+            rhs_val_ = nullptr;
+        }
+        len_ = lhs_col->len;
+        type_ = lhs_col->type;
+        eval_fn_ = select_eval_fn(type_, op_);
+    }
+
+    bool eval(const char *tuple) const {
+        return eval_fn_(tuple + lhs_offset_, rhs_val_ != nullptr ? rhs_val_ : tuple + rhs_offset_, len_);
+    }
+
+    int lhs_offset() const { return lhs_offset_; }
+
+    /** 右侧的值，右侧是字段时为nullptr */
+    const char *rhs_val() const { return rhs_val_; }
+
+    ColType type() const { return type_; }
+
+    CompOp op() const { return op_; }
+
+    static std::vector<ResolvedCond> resolve(const std::vector<ColMeta> &cols, const std::vector<Condition> &conds) {
+        std::vector<ResolvedCond> resolved;
+        for (auto &cond : conds) {
+            resolved.emplace_back(cols, cond);
+        }
+        return resolved;
+    }
+
+    static bool eval_all(const std::vector<ResolvedCond> &conds, const char *tuple) {
+        for (auto &cond : conds) {
+            if (!cond.eval(tuple)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief 对batch中的有效元组执行全部条件，不满足的从选择向量中去掉
+     */
+    static void filter(const std::vector<ResolvedCond> &conds, TupleBatch *batch) {
+        if (conds.empty()) {
+            return;
+        }
+        auto &sel = batch->sel();
+        size_t num_sel = 0;
+        for (uint32_t row_no : sel) {
+            if (eval_all(conds, batch->row(row_no))) {
+                sel[num_sel++] = row_no;
+            }
+        }
+        sel.resize(num_sel);
+    }
+
+    static std::vector<ColMeta>::const_iterator find_col(const std::vector<ColMeta> &cols, const TabCol &target) {
+        auto pos = std::find_if(cols.begin(), cols.end(), [&](const ColMeta &col) {
+            return col.tab_name == target.tab_name && col.name == target.col_name;
+        });
+        if (pos == cols.end()) {
+            throw ColumnNotFoundError(target.tab_name + '.' + target.col_name);
+        }
+        return pos;
+    }
+
+   private:
+    /** 由三路比较的结果得出条件是否成立，op是模板参数，编译时就确定了分支 */
+    template <CompOp op>
+    static bool test(int result) {
+        switch (op) {
+            case OP_EQ: return result == 0;
+            case OP_NE: return result != 0;
+            case OP_LT: return result < 0;
+            case OP_GT: return result > 0;
+            case OP_LE: return result <= 0;
+            case OP_GE: return result >= 0;
+        }
+        return false;
+    }
+
+    template <typename T, CompOp op>
+    static bool eval_scalar(const char *lhs, const char *rhs, int) {
+        T lv, rv;
+        memcpy(&lv, lhs, sizeof(T));
+        memcpy(&rv, rhs, sizeof(T));
+        return test<op>((lv < rv) ? -1 : ((lv > rv) ? 1 : 0));
+    }
+
+    template <CompOp op>
+    static bool eval_string(const char *lhs, const char *rhs, int len) {
+        return test<op>(memcmp(lhs, rhs, len));
+    }
+
+    template <CompOp op>
+    static EvalFn select_eval_fn(ColType type) {
+        switch (type) {
+            case TYPE_INT: return &eval_scalar<int, op>;
+            case TYPE_FLOAT: return &eval_scalar<float, op>;
+            case TYPE_STRING: return &eval_string<op>;
+        }
+        throw InternalError("Unexpected data type");
+    }
+
+    static EvalFn select_eval_fn(ColType type, CompOp op) {
+        switch (op) {
+            case OP_EQ: return select_eval_fn<OP_EQ>(type);
+            case OP_NE: return select_eval_fn<OP_NE>(type);
+            case OP_LT: return select_eval_fn<OP_LT>(type);
+            case OP_GT: return select_eval_fn<OP_GT>(type);
+            case OP_LE: return select_eval_fn<OP_LE>(type);
+            case OP_GE: return select_eval_fn<OP_GE>(type);
+        }
+        throw InternalError("Unexpected op type");
+    }
+};
@@ -12,3 +12,14 @@ See the Mulan PSL v2 for more details. */
 
 #include "defs.h"
 #include "errors.h"
+
+constexpr size_t NLJ_BLOCK_MEM_BUDGET = 16 << 20;   // 块嵌套循环连接一块外层元组可使用的内存大小(字节)
+constexpr size_t HASH_JOIN_MEM_BUDGET = 64 << 20;   // 哈希连接建表可使用的内存大小(字节)，超过时分区写出到临时文件
+constexpr int HASH_JOIN_PARTITION_BITS = 4;         // 每次分区使用的哈希值位数，分成2^4个分区
+constexpr int HASH_JOIN_MAX_DEPTH = 4;              // 最多分区的次数，之后仍然放不下说明相同key的元组太多，直接建表
+constexpr size_t SORT_MEM_BUDGET = 64 << 20;        // 排序可使用的内存大小(字节)，超过时把排好序的一段写到临时文件
+constexpr size_t SORT_MERGE_FANIN = 64;             // 一次最多归并的有序段数量，更多时先归并成更长的段
+constexpr size_t EXECUTION_BATCH_SIZE = 1024;       // 算子之间按批传递元组时每批最多的元组数量
+constexpr size_t AGG_MEM_BUDGET = 64 << 20;         // 哈希聚合的哈希表可使用的内存大小(字节)，超过时新分组的元组分区写出
+constexpr int AGG_PARTITION_BITS = 4;               // 每次分区使用的哈希值位数，分成2^4个分区
+constexpr int AGG_MAX_DEPTH = 4;                    // 最多分区的次数，之后不再分区，哈希表直接扩大
@@ -0,0 +1,210 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <climits>
+#include <limits>
+
+#include "common/common.h"
+#include "index/ix.h"
+#include "system/sm_meta.h"
+
+/**
+ * 由谓词条件推出一个索引上的key范围
+ * 按索引字段的顺序处理与常量比较的=,<,<=,>,>=条件：每个字段的条件合并为一个上下界，
+ * 上下界相等（等值）时继续处理下一个字段，否则该字段作为范围字段，之后的字段不再使用
+ * 被范围完全表达的条件不需要在取出元组后再判断，其余条件作为剩余条件(residual_conds)
+ */
+class IndexRange {
+   private:
+    // 一个字段上合并后的上下界，值指向条件中的rhs_val
+    struct Bound {
+        const char *lower = nullptr;
+        bool lower_inclusive = true;
+        const char *upper = nullptr;
+        bool upper_inclusive = true;
+    };
+
+    IndexMeta index_;
+    int num_eq_ = 0;                        // 等值匹配的前缀字段数量
+    bool has_range_ = false;                // 第num_eq_个字段上是否有范围条件
+    std::vector<char> lower_key_;           // 扫描起点的key
+    std::vector<char> upper_key_;           // 扫描终点的key
+    bool lower_use_upper_bound_ = false;    // 起点不包含lower_key_本身，用upper_bound定位
+    bool upper_use_lower_bound_ = false;    // 终点不包含upper_key_本身，用lower_bound定位
+    bool empty_ = false;
+    std::vector<Condition> residual_conds_;
+    std::vector<bool> used_conds_;          // 每个条件是否已经被范围完全表达
+
+   public:
+    IndexRange(const IndexMeta &index, const std::string &tab_name, const std::vector<Condition> &conds)
+        : index_(index) {
+        std::vector<Bound> bounds(index_.col_num);
+        std::vector<bool> &used = used_conds_;
+        used.assign(conds.size(), false);
+        for (int i = 0; i < index_.col_num; i++) {
+            const ColMeta &col = index_.cols[i];
+            for (size_t j = 0; j < conds.size(); j++) {
+                if (is_sargable(conds[j], tab_name, col)) {
+                    add_bound(bounds[i], conds[j], col);
+                    used[j] = true;
+                }
+            }
+            if (bounds[i].lower == nullptr && bounds[i].upper == nullptr) {
+                break;
+            }
+            empty_ = empty_ || is_contradictory(bounds[i], col);
+            if (!is_point(bounds[i], col)) {
+                has_range_ = true;
+                break;
+            }
+            num_eq_++;
+        }
+        for (size_t j = 0; j < conds.size(); j++) {
+            if (!used[j]) {
+                residual_conds_.push_back(conds[j]);
+            }
+        }
+        build_keys(bounds);
+    }
+
+    /** 能用于确定范围的条件：本表字段与同类型常量的比较，不等于(!=)除外 */
+    static bool is_sargable(const Condition &cond, const std::string &tab_name, const ColMeta &col) {
+        return cond.is_rhs_val && cond.op != OP_NE && cond.lhs_col.tab_name == tab_name &&
+               cond.lhs_col.col_name == col.name && cond.rhs_val.type == col.type && cond.rhs_val.raw != nullptr;
+    }
+
+    /** 用到的索引前缀字段数量（等值字段加上范围字段），为0时该索引不能缩小扫描范围 */
+    int num_matched_cols() const { return num_eq_ + (has_range_ ? 1 : 0); }
+
+    /** 所有索引字段都是等值条件，最多匹配一个key */
+    bool is_point() const { return num_eq_ == index_.col_num; }
+
+    /** is_point()时范围内唯一的key */
+    const char *point_key() const { return lower_key_.data(); }
+
+    /** 条件互相矛盾，范围内没有key */
+    bool is_empty() const { return empty_; }
+
+    const std::vector<Condition> &residual_conds() const { return residual_conds_; }
+
+    /** 构造时传入的第i个条件是否已经被范围完全表达 */
+    bool uses_cond(size_t i) const { return used_conds_[i]; }
+
+    Iid lower(IxIndexHandle *ih) const {
+        return lower_use_upper_bound_ ? ih->upper_bound(lower_key_.data()) : ih->lower_bound(lower_key_.data());
+    }
+
+    Iid upper(IxIndexHandle *ih) const {
+        return upper_use_lower_bound_ ? ih->lower_bound(upper_key_.data()) : ih->upper_bound(upper_key_.data());
+    }
+
+   private:
+    static int compare(const char *a, const char *b, const ColMeta &col) { return ix_compare(a, b, col.type, col.len); }
+
+    /** 把一个条件合并到字段的上下界中，保留更紧的一个 */
+    static void add_bound(Bound &bound, const Condition &cond, const ColMeta &col) {
+        const char *val = cond.rhs_val.raw->data;
+        bool lower = cond.op == OP_EQ || cond.op == OP_GT || cond.op == OP_GE;
+        bool upper = cond.op == OP_EQ || cond.op == OP_LT || cond.op == OP_LE;
+        if (lower) {
+            bool inclusive = cond.op != OP_GT;
+            int res = bound.lower == nullptr ? 1 : compare(val, bound.lower, col);
+            if (res > 0 || (res == 0 && !inclusive)) {
+                bound.lower = val;
+                bound.lower_inclusive = inclusive;
+            }
+        }
+        if (upper) {
+            bool inclusive = cond.op != OP_LT;
+            int res = bound.upper == nullptr ? -1 : compare(val, bound.upper, col);
+            if (res < 0 || (res == 0 && !inclusive)) {
+                bound.upper = val;
+                bound.upper_inclusive = inclusive;
+            }
+        }
+    }
+
+    static bool is_point(const Bound &bound, const ColMeta &col) {
+        return bound.lower != nullptr && bound.upper != nullptr && bound.lower_inclusive && bound.upper_inclusive &&
+               compare(bound.lower, bound.upper, col) == 0;
+    }
+
+    /** 下界大于上界，或者上下界相等但有一侧不包含，例如a > 3 AND a <= 3 */
+    static bool is_contradictory(const Bound &bound, const ColMeta &col) {
+        if (bound.lower == nullptr || bound.upper == nullptr) {
+            return false;
+        }
+        int res = compare(bound.lower, bound.upper, col);
+        return res > 0 || (res == 0 && !(bound.lower_inclusive && bound.upper_inclusive));
+    }
+
+    /** 用字段类型的最小值或最大值填充key中的一个字段 */
+    static void fill_extreme(char *dest, const ColMeta &col, bool max) {
+        if (col.type == TYPE_INT) {
+            int v = max ? INT_MAX : INT_MIN;
+            memcpy(dest, &v, sizeof(int));
+        } else if (col.type == TYPE_FLOAT) {
+            float v = max ? std::numeric_limits<float>::infinity() : -std::numeric_limits<float>::infinity();
+            memcpy(dest, &v, sizeof(float));
+        } else {
+            memset(dest, max ? 0xFF : 0, col.len);
+        }
+    }
+
+    /**
+     * @brief 拼出扫描的起点和终点
+     * 起点：等值字段 + 范围字段的下界，其后的字段在包含下界时填最小值并用lower_bound，不包含时填最大值并用upper_bound
+     * 终点：等值字段 + 范围字段的上界，其后的字段在包含上界时填最大值并用upper_bound，不包含时填最小值并用lower_bound
+     */
+    void build_keys(const std::vector<Bound> &bounds) {
+        lower_key_.assign(index_.col_tot_len, 0);
+        upper_key_.assign(index_.col_tot_len, 0);
+        int offset = 0;
+        bool lower_fill_max = false, upper_fill_max = true;
+        bool lower_open = true, upper_open = true;  // 之后的字段是否还需要填充
+        for (int i = 0; i < index_.col_num; i++) {
+            const ColMeta &col = index_.cols[i];
+            bool in_range = i < num_matched_cols();
+            if (in_range && lower_open && bounds[i].lower != nullptr) {
+                memcpy(lower_key_.data() + offset, bounds[i].lower, col.len);
+                if (i >= num_eq_) {
+                    lower_fill_max = !bounds[i].lower_inclusive;
+                }
+            } else {
+                fill_extreme(lower_key_.data() + offset, col, lower_fill_max);
+                lower_open = false;
+            }
+            if (in_range && upper_open && bounds[i].upper != nullptr) {
+                memcpy(upper_key_.data() + offset, bounds[i].upper, col.len);
+                if (i >= num_eq_) {
+                    upper_fill_max = bounds[i].upper_inclusive;
+                }
+            } else {
+                fill_extreme(upper_key_.data() + offset, col, upper_fill_max);
+                upper_open = false;
+            }
+            offset += col.len;
+        }
+        lower_use_upper_bound_ = lower_fill_max;
+        upper_use_lower_bound_ = !upper_fill_max;
+
+        // 只有起点用upper_bound、终点用lower_bound时，相同的key才会使起点在终点之后
+        std::vector<ColType> col_types;
+        std::vector<int> col_lens;
+        for (auto &col : index_.cols) {
+            col_types.push_back(col.type);
+            col_lens.push_back(col.len);
+        }
+        int res = ix_compare(lower_key_.data(), upper_key_.data(), col_types, col_lens);
+        empty_ = empty_ || res > 0 || (res == 0 && lower_use_upper_bound_ && upper_use_lower_bound_);
+    }
+};
@@ -51,6 +51,9 @@ void QlManager::run_mutli_query(std::shared_ptr<Plan> plan, Context *context){
             case T_CreateTable:
             {
                 sm_manager_->create_table(x->tab_name_, x->cols_, context);
+                if (!x->tab_col_names_.empty()) {
+                    sm_manager_->create_index(x->tab_name_, x->tab_col_names_, context, true);
+                }
                 break;
             }
             case T_DropTable:
@@ -60,7 +63,7 @@ void QlManager::run_mutli_query(std::shared_ptr<Plan> plan, Context *context){
             }
             case T_CreateIndex:
             {
-                sm_manager_->create_index(x->tab_name_, x->tab_col_names_, context);
+                sm_manager_->create_index(x->tab_name_, x->tab_col_names_, context, x->unique_, x->index_type_);
                 break;
             }
             case T_DropIndex:
@@ -130,7 +133,7 @@ void QlManager::run_cmd_utility(std::shared_ptr<Plan> plan, txn_id_t *txn_id, Co
 // 执行select语句，select语句的输出除了需要返回客户端外，还需要写入output.txt文件中
 void QlManager::select_from(std::unique_ptr<AbstractExecutor> executorTreeRoot, std::vector<TabCol> sel_cols, 
                             Context *context) {
-    RmFileHandle * fh_;
+    RmFileHandle * fh_ = nullptr;
     auto temp = dynamic_cast<ProjectionExecutor*>(executorTreeRoot.get());
     if(temp != nullptr)
     {
@@ -141,7 +144,8 @@ void QlManager::select_from(std::unique_ptr<AbstractExecutor> executorTreeRoot,
         }
     }
 
-    if(context)
+    // 只对投影下面直接是顺序扫描的表加表锁，下面是连接、聚合、排序等算子时fh_为空
+    if(context && fh_ != nullptr)
     {
         context->lock_mgr_->lock_shared_on_table(context->txn_, fh_->GetFd());
     }
@@ -168,32 +172,35 @@ void QlManager::select_from(std::unique_ptr<AbstractExecutor> executorTreeRoot,
 
     // Print records
     size_t num_rec = 0;
-    // 执行query_plan
-    for (executorTreeRoot->beginTuple(); !executorTreeRoot->is_end(); executorTreeRoot->nextTuple()) {
-        auto Tuple = executorTreeRoot->Next();
-        std::vector<std::string> columns;
-        for (auto &col : executorTreeRoot->cols()) {
-            std::string col_str;
-            char *rec_buf = Tuple->data + col.offset;
-            if (col.type == TYPE_INT) {
-                col_str = std::to_string(*(int *)rec_buf);
-            } else if (col.type == TYPE_FLOAT) {
-                col_str = std::to_string(*(float *)rec_buf);
-            } else if (col.type == TYPE_STRING) {
-                col_str = std::string((char *)rec_buf, col.len);
-                col_str.resize(strlen(col_str.c_str()));
+    // 执行query_plan，按批读取结果
+    TupleBatch batch;
+    for (executorTreeRoot->beginTuple(); executorTreeRoot->next_batch(&batch);) {
+        for (size_t tuple_idx = 0; tuple_idx < batch.size(); tuple_idx++) {
+            const char *Tuple = batch.get(tuple_idx);
+            std::vector<std::string> columns;
+            for (auto &col : executorTreeRoot->cols()) {
+                std::string col_str;
+                const char *rec_buf = Tuple + col.offset;
+                if (col.type == TYPE_INT) {
+                    col_str = std::to_string(*(int *)rec_buf);
+                } else if (col.type == TYPE_FLOAT) {
+                    col_str = std::to_string(*(float *)rec_buf);
+                } else if (col.type == TYPE_STRING) {
+                    col_str = std::string((char *)rec_buf, col.len);
+                    col_str.resize(strlen(col_str.c_str()));
+                }
+                columns.push_back(col_str);
             }
-            columns.push_back(col_str);
-        }
-        // print record into buffer
-        rec_printer.print_record(columns, context);
-        // print record into file
-        outfile << "|";
-        for(int i = 0; i < columns.size(); ++i) {
-            outfile << " " << columns[i] << " |";
+            // print record into buffer
+            rec_printer.print_record(columns, context);
+            // print record into file
+            outfile << "|";
+            for(size_t i = 0; i < columns.size(); ++i) {
+                outfile << " " << columns[i] << " |";
+            }
+            outfile << "\n";
+            num_rec++;
         }
-        outfile << "\n";
-        num_rec++;
     }
     outfile.close();
     // Print footer into buffer
@@ -0,0 +1,206 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define PAGE_FILTER_HAS_AVX2 1
+#endif
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "execution_conds.h"
+
+/**
+ * 对一个数据页上全部槽中的元组一次判断条件，得到选择掩码：第i个槽对应mask[i / 8]的第i % 8位（低位在前）
+ * 元组定长连续存放，某个字段在各个槽中的值就是步长为记录长度的一列，
+ * INT/FLOAT字段与常量比较的条件在CPU支持AVX2时每次gather 8个槽的值一起比较，否则逐个比较
+ */
+
+/** 运行时检测一次CPU是否支持AVX2 */
+inline bool page_filter_use_avx2() {
+#ifdef PAGE_FILTER_HAS_AVX2
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+template <typename T, CompOp op>
+inline bool page_filter_test(T val, T target) {
+    switch (op) {
+        case OP_EQ: return val == target;
+        case OP_NE: return val != target;
+        case OP_LT: return val < target;
+        case OP_GT: return val > target;
+        case OP_LE: return val <= target;
+        case OP_GE: return val >= target;
+    }
+    return false;
+}
+
+/**
+ * @brief 逐个判断槽[begin, n)中col字段的值，不满足的槽在mask中清零
+ */
+template <typename T, CompOp op>
+inline void page_filter_scalar(const char *col, int stride, int begin, int n, T target, uint8_t *mask) {
+    for (int i = begin; i < n; i++) {
+        T val;
+        memcpy(&val, col + static_cast<size_t>(i) * stride, sizeof(T));
+        if (!page_filter_test<T, op>(val, target)) {
+            mask[i >> 3] &= static_cast<uint8_t>(~(1u << (i & 7)));
+        }
+    }
+}
+
+#ifdef PAGE_FILTER_HAS_AVX2
+/**
+ * @brief 每次gather 8个槽的col字段与target比较，8个槽的结果正好是mask的一个字节；掩码已经为0的8个槽跳过
+ * @return 已经处理的槽数，是8的倍数，剩下不足8个的槽由调用者逐个判断
+ */
+template <CompOp op>
+__attribute__((target("avx2"))) inline int page_filter_avx2(const char *col, int stride, int n, int target, uint8_t *mask) {
+    __m256i t = _mm256_set1_epi32(target);
+    __m256i idx = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(stride));
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        if (mask[i >> 3] == 0) {
+            continue;
+        }
+        __m256i v = _mm256_i32gather_epi32(reinterpret_cast<const int *>(col + static_cast<size_t>(i) * stride), idx, 1);
+        // 只有相等和大于两种比较，其余由它们交换两侧或者取反得到
+        __m256i cmp;
+        bool negate = false;
+        switch (op) {
+            case OP_EQ: cmp = _mm256_cmpeq_epi32(v, t); break;
+            case OP_NE: cmp = _mm256_cmpeq_epi32(v, t); negate = true; break;
+            case OP_LT: cmp = _mm256_cmpgt_epi32(t, v); break;
+            case OP_GT: cmp = _mm256_cmpgt_epi32(v, t); break;
+            case OP_LE: cmp = _mm256_cmpgt_epi32(v, t); negate = true; break;
+            case OP_GE: cmp = _mm256_cmpgt_epi32(t, v); negate = true; break;
+        }
+        unsigned bits = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(cmp)));
+        mask[i >> 3] &= static_cast<uint8_t>(negate ? ~bits : bits);
+    }
+    return i;
+}
+
+template <CompOp op>
+__attribute__((target("avx2"))) inline int page_filter_avx2(const char *col, int stride, int n, float target, uint8_t *mask) {
+    __m256 t = _mm256_set1_ps(target);
+    __m256i idx = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(stride));
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        if (mask[i >> 3] == 0) {
+            continue;
+        }
+        __m256 v = _mm256_i32gather_ps(reinterpret_cast<const float *>(col + static_cast<size_t>(i) * stride), idx, 1);
+        __m256 cmp;
+        switch (op) {
+            case OP_EQ: cmp = _mm256_cmp_ps(v, t, _CMP_EQ_OQ); break;
+            case OP_NE: cmp = _mm256_cmp_ps(v, t, _CMP_NEQ_UQ); break;
+            case OP_LT: cmp = _mm256_cmp_ps(v, t, _CMP_LT_OQ); break;
+            case OP_GT: cmp = _mm256_cmp_ps(v, t, _CMP_GT_OQ); break;
+            case OP_LE: cmp = _mm256_cmp_ps(v, t, _CMP_LE_OQ); break;
+            case OP_GE: cmp = _mm256_cmp_ps(v, t, _CMP_GE_OQ); break;
+        }
+        mask[i >> 3] &= static_cast<uint8_t>(_mm256_movemask_ps(cmp));
+    }
+    return i;
+}
+#endif
+
+template <typename T, CompOp op>
+inline void page_filter(const char *col, int stride, int n, T target, uint8_t *mask, bool use_avx2) {
+    int done = 0;
+#ifdef PAGE_FILTER_HAS_AVX2
+    if (use_avx2) {
+        done = page_filter_avx2<op>(col, stride, n, target, mask);
+    }
+#endif
+    page_filter_scalar<T, op>(col, stride, done, n, target, mask);
+}
+
+template <typename T>
+inline void page_filter(const char *col, int stride, int n, CompOp op, T target, uint8_t *mask, bool use_avx2) {
+    switch (op) {
+        case OP_EQ: page_filter<T, OP_EQ>(col, stride, n, target, mask, use_avx2); break;
+        case OP_NE: page_filter<T, OP_NE>(col, stride, n, target, mask, use_avx2); break;
+        case OP_LT: page_filter<T, OP_LT>(col, stride, n, target, mask, use_avx2); break;
+        case OP_GT: page_filter<T, OP_GT>(col, stride, n, target, mask, use_avx2); break;
+        case OP_LE: page_filter<T, OP_LE>(col, stride, n, target, mask, use_avx2); break;
+        case OP_GE: page_filter<T, OP_GE>(col, stride, n, target, mask, use_avx2); break;
+    }
+}
+
+/**
+ * 扫描算子的条件分成两部分：INT/FLOAT字段与常量比较的条件在页面上批量判断，其余条件（字符串、两个字段比较）
+ * 在元组复制出页面之后再用ResolvedCond判断
+ */
+class PageFilter {
+   private:
+    std::vector<ResolvedCond> page_conds_;      // 在页面上批量判断的条件
+    std::vector<ResolvedCond> residual_conds_;  // 复制出页面之后判断的条件
+    bool use_avx2_;
+
+   public:
+    PageFilter() = default;
+
+    explicit PageFilter(const std::vector<ResolvedCond> &conds, bool use_avx2 = page_filter_use_avx2())
+        : use_avx2_(use_avx2) {
+        for (auto &cond : conds) {
+            bool numeric = cond.type() == TYPE_INT || cond.type() == TYPE_FLOAT;
+            (numeric && cond.rhs_val() != nullptr ? page_conds_ : residual_conds_).push_back(cond);
+        }
+    }
+
+    const std::vector<ResolvedCond> &residual_conds() const { return residual_conds_; }
+
+    /**
+     * @brief 由页面的bitmap和在页面上判断的条件得到选择掩码
+     * @param bitmap 页面的bitmap，第i个槽对应第i / 8个字节从高位开始的第i % 8位
+     * @param slots 页面上第一个槽的地址
+     * @param mask 输出的选择掩码，长度为(num_slots + 7) / 8
+     */
+    void eval(const char *bitmap, const char *slots, int record_size, int num_slots, std::vector<uint8_t> *mask) const {
+        int mask_size = (num_slots + 7) / 8;
+        mask->resize(mask_size);
+        for (int i = 0; i < mask_size; i++) {
+            (*mask)[i] = reverse_bits(static_cast<uint8_t>(bitmap[i]));
+        }
+        if (num_slots % 8 != 0) {
+            (*mask)[mask_size - 1] &= static_cast<uint8_t>((1u << (num_slots % 8)) - 1);
+        }
+        for (auto &cond : page_conds_) {
+            const char *col = slots + cond.lhs_offset();
+            if (cond.type() == TYPE_INT) {
+                int target;
+                memcpy(&target, cond.rhs_val(), sizeof(int));
+                page_filter<int>(col, record_size, num_slots, cond.op(), target, mask->data(), use_avx2_);
+            } else {
+                float target;
+                memcpy(&target, cond.rhs_val(), sizeof(float));
+                page_filter<float>(col, record_size, num_slots, cond.op(), target, mask->data(), use_avx2_);
+            }
+        }
+    }
+
+   private:
+    static uint8_t reverse_bits(uint8_t b) {
+        b = static_cast<uint8_t>((b & 0xF0) >> 4 | (b & 0x0F) << 4);
+        b = static_cast<uint8_t>((b & 0xCC) >> 2 | (b & 0x33) << 2);
+        b = static_cast<uint8_t>((b & 0xAA) >> 1 | (b & 0x55) << 1);
+        return b;
+    }
+};
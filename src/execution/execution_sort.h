@@ -9,41 +9,339 @@ MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
 See the Mulan PSL v2 for more details. */
 
 #pragma once
+
+#include <algorithm>
+
+#include "execution_conds.h"
 #include "execution_defs.h"
 #include "execution_manager.h"
+#include "execution_spill.h"
 #include "executor_abstract.h"
 #include "index/ix.h"
 #include "system/sm.h"
 
+/**
+ * 排序键：多个排序字段，每个字段可以分别升序或降序
+ */
+class SortKeys {
+   private:
+    /* 排序字段在元组中的位置 */
+    struct SortKey {
+        int offset;
+        ColType type;
+        int len;
+        bool is_desc;
+    };
+
+    std::vector<SortKey> keys_;
+
+   public:
+    /**
+     * @param cols 元组的字段
+     * @param sel_cols 排序字段，依次作为第一、第二...排序键
+     * @param is_descs 每个排序字段是否降序
+     */
+    SortKeys(const std::vector<ColMeta> &cols, const std::vector<TabCol> &sel_cols, const std::vector<bool> &is_descs) {
+        for (size_t i = 0; i < sel_cols.size(); i++) {
+            auto col = ResolvedCond::find_col(cols, sel_cols[i]);
+            keys_.push_back(SortKey{col->offset, col->type, col->len, is_descs[i]});
+        }
+        assert(!keys_.empty());
+    }
+
+    /** 按所有排序字段比较两个元组 */
+    int compare(const char *a, const char *b) const {
+        for (auto &key : keys_) {
+            int result = ix_compare(a + key.offset, b + key.offset, key.type, key.len);
+            if (result != 0) {
+                return key.is_desc ? -result : result;
+            }
+        }
+        return 0;
+    }
+
+    /**
+     * @brief 把第一个排序字段编码成8字节前缀，前缀按无符号整数比较的顺序与这个字段的顺序一致：
+     * 整数翻转符号位，浮点数负数按位取反、非负数翻转符号位（-0.0按0.0编码），字符串取前8个字节；降序时整体取反
+     */
+    uint64_t make_prefix(const char *tuple) const {
+        const SortKey &key = keys_[0];
+        const char *val = tuple + key.offset;
+        uint64_t prefix = 0;
+        switch (key.type) {
+            case TYPE_INT: {
+                uint32_t bits;
+                memcpy(&bits, val, sizeof(bits));
+                prefix = static_cast<uint64_t>(bits ^ 0x80000000u) << 32;
+                break;
+            }
+            case TYPE_FLOAT: {
+                uint32_t bits;
+                memcpy(&bits, val, sizeof(bits));
+                if (bits == 0x80000000u) {
+                    bits = 0;  // -0.0与0.0比较时相等，前缀也必须相同
+                }
+                bits = (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+                prefix = static_cast<uint64_t>(bits) << 32;
+                break;
+            }
+            case TYPE_STRING:
+                for (int i = 0; i < std::min(key.len, 8); i++) {
+                    prefix |= static_cast<uint64_t>(static_cast<uint8_t>(val[i])) << (56 - 8 * i);
+                }
+                break;
+        }
+        return key.is_desc ? ~prefix : prefix;
+    }
+};
+
+/**
+ * 排序：内存中的元组依次存放，排序的对象是(第一个排序字段编码成的8字节前缀, 元组下标)，
+ * 大多数比较只比较前缀，前缀相同时再比较元组；
+ * 输入超过内存预算时，把排好序的一段写到临时文件，最后多路归并所有的段
+ */
 class SortExecutor : public AbstractExecutor {
    private:
+    /* 排序的对象 */
+    struct SortEntry {
+        uint64_t prefix;
+        uint32_t idx;       // 元组在tuples_中的下标
+    };
+
     std::unique_ptr<AbstractExecutor> prev_;
-    ColMeta cols_;                              // 框架中只支持一个键排序，需要自行修改数据结构支持多个键排序
-    size_t tuple_num;
-    bool is_desc_;
-    std::vector<size_t> used_tuple;
-    std::unique_ptr<RmRecord> current_tuple;
+    SortKeys keys_;
+    size_t len_;
+    size_t max_tuples_;                         // 内存中最多容纳的元组数量
+
+    std::vector<char> tuples_;                  // 内存中的元组
+    std::vector<SortEntry> entries_;
+    size_t pos_ = 0;                            // 内存中排序时当前输出的entries_下标
+
+    std::vector<std::unique_ptr<SpillFile>> runs_;  // 写到临时文件中的有序段
+    std::vector<std::vector<char>> run_heads_;  // 归并时每个有序段当前的元组
+    std::vector<size_t> heap_;                  // 归并时当前元组最小的有序段在堆顶
+    bool is_end_ = true;
 
    public:
-    SortExecutor(std::unique_ptr<AbstractExecutor> prev, TabCol sel_cols, bool is_desc) {
-        prev_ = std::move(prev);
-        cols_ = prev_->get_col_offset(sel_cols);
-        is_desc_ = is_desc;
-        tuple_num = 0;
-        used_tuple.clear();
+    /**
+     * @param sel_cols 排序字段，依次作为第一、第二...排序键
+     * @param is_descs 每个排序字段是否降序
+     * @param mem_budget 排序可使用的内存大小(字节)
+     */
+    SortExecutor(std::unique_ptr<AbstractExecutor> prev, const std::vector<TabCol> &sel_cols,
+                 const std::vector<bool> &is_descs, size_t mem_budget = SORT_MEM_BUDGET)
+        : prev_(std::move(prev)), keys_(prev_->cols(), sel_cols, is_descs) {
+        len_ = prev_->tupleLen();
+        max_tuples_ = std::max<size_t>(1, mem_budget / (len_ + sizeof(SortEntry)));
     }
 
-    void beginTuple() override { 
-        
+    bool is_end() const override { return is_end_; }
+
+    size_t tupleLen() const override { return len_; }
+
+    const std::vector<ColMeta> &cols() const override { return prev_->cols(); }
+
+    std::string getType() override { return "SortExecutor"; }
+
+    /**
+     * @brief 读入并排序全部输入；输入超过内存预算时每攒满一次内存写出一个有序段，最后开始归并
+     */
+    void beginTuple() override {
+        tuples_.clear();
+        entries_.clear();
+        runs_.clear();
+        pos_ = 0;
+        BatchReader input;
+        for (input.begin(prev_.get()); !input.is_end(); input.next()) {
+            if (entries_.size() == max_tuples_) {
+                spill_run();
+            }
+            const char *rec = input.get();
+            entries_.push_back(SortEntry{keys_.make_prefix(rec), static_cast<uint32_t>(entries_.size())});
+            tuples_.insert(tuples_.end(), rec, rec + len_);
+        }
+        if (runs_.empty()) {
+            sort_entries();
+            is_end_ = entries_.empty();
+            return;
+        }
+        if (!entries_.empty()) {
+            spill_run();
+        }
+        while (runs_.size() > SORT_MERGE_FANIN) {
+            merge_runs();
+        }
+        start_merge();
     }
 
     void nextTuple() override {
-        
+        assert(!is_end());
+        if (runs_.empty()) {
+            is_end_ = ++pos_ == entries_.size();
+            return;
+        }
+        std::pop_heap(heap_.begin(), heap_.end(), heap_cmp());
+        size_t run = heap_.back();
+        heap_.pop_back();
+        if (runs_[run]->read(run_heads_[run].data())) {
+            heap_.push_back(run);
+            std::push_heap(heap_.begin(), heap_.end(), heap_cmp());
+        }
+        is_end_ = heap_.empty();
     }
 
     std::unique_ptr<RmRecord> Next() override {
-        return nullptr;
+        assert(!is_end());
+        auto record = std::make_unique<RmRecord>(len_);
+        memcpy(record->data, current(), len_);
+        return record;
     }
 
     Rid &rid() override { return _abstract_rid; }
-};
\ No newline at end of file
+
+   private:
+    const char *current() const {
+        if (runs_.empty()) {
+            return tuples_.data() + static_cast<size_t>(entries_[pos_].idx) * len_;
+        }
+        return run_heads_[heap_.front()].data();
+    }
+
+    void sort_entries() {
+        std::sort(entries_.begin(), entries_.end(), [&](const SortEntry &a, const SortEntry &b) {
+            if (a.prefix != b.prefix) {
+                return a.prefix < b.prefix;
+            }
+            return keys_.compare(tuples_.data() + static_cast<size_t>(a.idx) * len_,
+                           tuples_.data() + static_cast<size_t>(b.idx) * len_) < 0;
+        });
+    }
+
+    /**
+     * @brief 排序内存中的元组，按顺序写出成一个有序段，然后清空内存
+     */
+    void spill_run() {
+        sort_entries();
+        auto run = std::make_unique<SpillFile>("sort", len_);
+        for (auto &entry : entries_) {
+            run->append(tuples_.data() + static_cast<size_t>(entry.idx) * len_);
+        }
+        run->rewind();
+        runs_.push_back(std::move(run));
+        tuples_.clear();
+        entries_.clear();
+    }
+
+    /* 归并用的堆的比较函数，堆顶是当前元组最小的有序段 */
+    struct HeapCmp {
+        const SortExecutor *sort;
+        bool operator()(size_t a, size_t b) const {
+            return sort->keys_.compare(sort->run_heads_[a].data(), sort->run_heads_[b].data()) > 0;
+        }
+    };
+
+    HeapCmp heap_cmp() const { return HeapCmp{this}; }
+
+    /**
+     * @brief 读入每个有序段的第一个元组，建立归并用的堆
+     */
+    void start_merge() {
+        run_heads_.assign(runs_.size(), std::vector<char>(len_));
+        heap_.clear();
+        for (size_t i = 0; i < runs_.size(); i++) {
+            if (runs_[i]->read(run_heads_[i].data())) {
+                heap_.push_back(i);
+            }
+        }
+        std::make_heap(heap_.begin(), heap_.end(), heap_cmp());
+        is_end_ = heap_.empty();
+    }
+
+    /**
+     * @brief 有序段太多时，把最前面的SORT_MERGE_FANIN个段归并成一个段放到最后
+     */
+    void merge_runs() {
+        std::vector<std::unique_ptr<SpillFile>> rest(std::make_move_iterator(runs_.begin() + SORT_MERGE_FANIN),
+                                                     std::make_move_iterator(runs_.end()));
+        runs_.resize(SORT_MERGE_FANIN);
+        auto merged = std::make_unique<SpillFile>("sort", len_);
+        for (start_merge(); !is_end_; nextTuple()) {
+            merged->append(current());
+        }
+        merged->rewind();
+        runs_ = std::move(rest);
+        runs_.push_back(std::move(merged));
+    }
+};
+
+/**
+ * 带LIMIT的排序：只需要前n个元组时，用大小为n的堆保留当前最小的n个元组，堆顶是其中最大的，
+ * 新元组比堆顶小时替换堆顶；内存只与n有关，读完输入后把堆中的元组排好序输出
+ */
+class TopNExecutor : public AbstractExecutor {
+   private:
+    std::unique_ptr<AbstractExecutor> prev_;
+    SortKeys keys_;
+    size_t len_;
+    size_t limit_;                              // 保留的元组数量n
+
+    std::vector<char> tuples_;                  // 堆中的元组，每个位置存放一个
+    std::vector<uint32_t> heap_;                // 元组在tuples_中的位置，读完输入后按顺序排列
+    size_t pos_ = 0;                            // 当前输出的heap_下标
+
+   public:
+    TopNExecutor(std::unique_ptr<AbstractExecutor> prev, const std::vector<TabCol> &sel_cols,
+                 const std::vector<bool> &is_descs, size_t limit)
+        : prev_(std::move(prev)), keys_(prev_->cols(), sel_cols, is_descs), limit_(limit) {
+        len_ = prev_->tupleLen();
+    }
+
+    bool is_end() const override { return pos_ >= heap_.size(); }
+
+    size_t tupleLen() const override { return len_; }
+
+    const std::vector<ColMeta> &cols() const override { return prev_->cols(); }
+
+    std::string getType() override { return "TopNExecutor"; }
+
+    void beginTuple() override {
+        tuples_.clear();
+        heap_.clear();
+        pos_ = 0;
+        if (limit_ == 0) {
+            return;
+        }
+        auto cmp = [&](uint32_t a, uint32_t b) { return keys_.compare(tuple(a), tuple(b)) < 0; };
+        BatchReader input;
+        for (input.begin(prev_.get()); !input.is_end(); input.next()) {
+            const char *rec = input.get();
+            if (heap_.size() < limit_) {
+                tuples_.insert(tuples_.end(), rec, rec + len_);
+                heap_.push_back(static_cast<uint32_t>(heap_.size()));
+                std::push_heap(heap_.begin(), heap_.end(), cmp);
+            } else if (keys_.compare(rec, tuple(heap_.front())) < 0) {
+                std::pop_heap(heap_.begin(), heap_.end(), cmp);
+                memcpy(tuples_.data() + static_cast<size_t>(heap_.back()) * len_, rec, len_);
+                std::push_heap(heap_.begin(), heap_.end(), cmp);
+            }
+        }
+        std::sort_heap(heap_.begin(), heap_.end(), cmp);
+    }
+
+    void nextTuple() override {
+        assert(!is_end());
+        pos_++;
+    }
+
+    std::unique_ptr<RmRecord> Next() override {
+        assert(!is_end());
+        auto record = std::make_unique<RmRecord>(len_);
+        memcpy(record->data, tuple(heap_[pos_]), len_);
+        return record;
+    }
+
+    Rid &rid() override { return _abstract_rid; }
+
+   private:
+    const char *tuple(uint32_t slot) const { return tuples_.data() + static_cast<size_t>(slot) * len_; }
+};
@@ -0,0 +1,72 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <unistd.h>
+
+#include <atomic>
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "errors.h"
+
+/**
+ * 执行算子内存不够时使用的临时文件：依次写入定长的元组，写完后从头顺序读取，析构时删除
+ * 文件建在当前目录（数据库目录）下，文件名由前缀、进程号和进程内递增的编号组成，并发的查询不会冲突
+ */
+class SpillFile {
+   private:
+    std::string name_;
+    size_t tuple_len_;
+    std::fstream file_;
+    size_t num_tuples_ = 0;
+    bool reading_ = false;
+
+   public:
+    SpillFile(const std::string &prefix, size_t tuple_len) : tuple_len_(tuple_len) {
+        static std::atomic<uint64_t> next_id{0};
+        name_ = prefix + "." + std::to_string(getpid()) + "." + std::to_string(next_id++) + ".tmp";
+        file_.open(name_, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file_.is_open()) {
+            throw UnixError();
+        }
+    }
+
+    ~SpillFile() {
+        file_.close();
+        std::remove(name_.c_str());
+    }
+
+    size_t size() const { return num_tuples_; }
+
+    void append(const char *tuple) {
+        assert(!reading_);
+        file_.write(tuple, tuple_len_);
+        num_tuples_++;
+    }
+
+    /** 从头开始读取，可以多次调用 */
+    void rewind() {
+        file_.flush();
+        file_.clear();
+        file_.seekg(0);
+        reading_ = true;
+    }
+
+    /** 读出下一个元组，读完时返回false */
+    bool read(char *tuple) {
+        assert(reading_);
+        file_.read(tuple, tuple_len_);
+        return static_cast<size_t>(file_.gcount()) == tuple_len_;
+    }
+};
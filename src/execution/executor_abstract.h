@@ -10,6 +10,7 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include "execution_batch.h"
 #include "execution_defs.h"
 #include "common/common.h"
 #include "index/ix.h"
@@ -44,6 +45,20 @@ class AbstractExecutor {
 
     virtual std::unique_ptr<RmRecord> Next() = 0;
 
+    /**
+     * @brief 按批读取输出：beginTuple()之后反复调用，每次清空batch并放入下一批元组，
+     * 同一个算子只能使用逐个元组和按批两种读取方式中的一种
+     * 默认逐个元组读取后放入batch，算子可以覆盖它，减少逐个元组的虚函数调用和内存分配
+     * @return batch中是否有元组，为false时已经读完
+     */
+    virtual bool next_batch(TupleBatch *batch) {
+        batch->reset(tupleLen());
+        for (; !is_end() && !batch->full(); nextTuple()) {
+            batch->append(Next()->data);
+        }
+        return !batch->empty();
+    }
+
     virtual ColMeta get_col_offset(const TabCol &target) { return ColMeta();};
 
     std::vector<ColMeta>::const_iterator get_col(const std::vector<ColMeta> &rec_cols, const TabCol &target) {
@@ -55,4 +70,34 @@ class AbstractExecutor {
         }
         return pos;
     }
-};
\ No newline at end of file
+};
+
+/**
+ * 上层算子按批读取子节点，再从批中逐个取出元组使用
+ */
+class BatchReader {
+   private:
+    AbstractExecutor *child_ = nullptr;
+    TupleBatch batch_;
+    size_t pos_ = 0;
+    bool is_end_ = true;
+
+   public:
+    void begin(AbstractExecutor *child) {
+        child_ = child;
+        child_->beginTuple();
+        pos_ = 0;
+        is_end_ = !child_->next_batch(&batch_);
+    }
+
+    bool is_end() const { return is_end_; }
+
+    const char *get() const { return batch_.get(pos_); }
+
+    void next() {
+        if (++pos_ == batch_.size()) {
+            pos_ = 0;
+            is_end_ = !child_->next_batch(&batch_);
+        }
+    }
+};
@@ -0,0 +1,402 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <deque>
+
+#include "execution_defs.h"
+#include "execution_manager.h"
+#include "execution_spill.h"
+#include "executor_abstract.h"
+#include "index/ix.h"
+#include "system/sm.h"
+
+/**
+ * 哈希聚合：按分组字段的值在开放寻址的哈希表中找到分组，更新它的各个聚合状态
+ * 每个分组是一个定长的表项，分组key和各个聚合状态依次内联存放，所有表项连续存放在一块内存中
+ * 分组数超过内存预算时，已经在表中的分组继续在内存中聚合，新分组的元组按哈希值分区写到临时文件，
+ * 输出内存中的分组之后再逐个分区聚合，分区仍然放不下时用哈希值的下一段再分区
+ * 输出的元组是分组字段拼接各个聚合函数的结果；没有分组字段时整个输入是一组，输入为空也输出一个元组
+ */
+class AggregateExecutor : public AbstractExecutor {
+   private:
+    static constexpr uint32_t EMPTY_SLOT = UINT32_MAX;
+
+    /* 一个聚合函数：输入字段的位置，聚合状态在表项中的位置，结果在输出元组中的位置 */
+    struct AggSpec {
+        AggType type;
+        ColType in_type;
+        int in_offset;
+        int in_len;
+        int state_offset;
+        int out_offset;
+    };
+
+    /* 写到临时文件中的一个分区，depth为已经用于分区的哈希值段数 */
+    struct Partition {
+        std::unique_ptr<SpillFile> file;
+        int depth;
+    };
+
+    std::unique_ptr<AbstractExecutor> prev_;    // 儿子节点
+    size_t prev_len_;
+    size_t len_;                                // 输出的每条记录的长度
+    std::vector<ColMeta> cols_;                 // 输出的字段，分组字段在前，聚合函数的结果在后
+
+    std::vector<int> key_offs_;                 // 各个分组字段在输入元组中的位置
+    std::vector<ColType> key_types_;
+    std::vector<int> key_lens_;
+    int key_len_ = 0;
+    IxKeyComparator key_cmp_;
+    std::vector<AggSpec> aggs_;
+    size_t state_base_;                         // 聚合状态在表项中的起始位置
+    size_t entry_len_;                          // 表项长度，按8字节对齐
+    size_t max_groups_;                         // 内存中最多容纳的分组数量
+
+    // 哈希表：各个分组的表项依次存放在entries_中，slots_线性探测，存放entries_的下标
+    std::vector<char> entries_;
+    std::vector<uint64_t> hashes_;
+    std::vector<uint32_t> slots_;
+    size_t num_groups_ = 0;
+
+    std::deque<Partition> partitions_;          // 尚未处理的分区
+    std::vector<std::unique_ptr<SpillFile>> spill_parts_;  // 正在写出的分区，没有写出时为空
+    TupleBatch in_batch_;                       // 按批读取儿子节点
+    std::vector<char> key_;
+    size_t emit_pos_ = 0;                       // 当前输出的分组
+    bool is_end_ = true;
+
+   public:
+    /**
+     * @param group_cols 分组字段
+     * @param agg_cols 聚合函数及其作用的字段，COUNT(*)的col_name为"*"
+     * @param mem_budget 哈希表可使用的内存大小(字节)
+     */
+    AggregateExecutor(std::unique_ptr<AbstractExecutor> prev, const std::vector<TabCol> &group_cols,
+                      const std::vector<TabCol> &agg_cols, size_t mem_budget = AGG_MEM_BUDGET) {
+        prev_ = std::move(prev);
+        prev_len_ = prev_->tupleLen();
+        auto &prev_cols = prev_->cols();
+
+        size_t out_offset = 0;
+        for (auto &group_col : group_cols) {
+            auto col = *get_col(prev_cols, group_col);
+            key_offs_.push_back(col.offset);
+            key_types_.push_back(col.type);
+            key_lens_.push_back(col.len);
+            key_len_ += col.len;
+            col.offset = out_offset;
+            out_offset += col.len;
+            cols_.push_back(col);
+        }
+        key_cmp_ = IxKeyComparator(key_types_, key_lens_);
+
+        // 聚合状态：COUNT为int64计数，SUM为int64或double的和，AVG为double的和加int64计数，MIN/MAX为字段的原始值
+        state_base_ = align8(key_len_);
+        size_t state_offset = state_base_;
+        for (auto &agg_col : agg_cols) {
+            AggSpec agg{agg_col.agg_type, TYPE_INT, 0, 0, static_cast<int>(state_offset), 0};
+            if (agg_col.col_name != "*") {
+                auto in_col = get_col(prev_cols, {.tab_name = agg_col.tab_name, .col_name = agg_col.col_name});
+                agg.in_type = in_col->type;
+                agg.in_offset = in_col->offset;
+                agg.in_len = in_col->len;
+            }
+            ColMeta out_col = {.tab_name = agg_col.tab_name, .name = agg_col.caption(), .type = TYPE_INT,
+                               .len = sizeof(int), .offset = 0, .index = false};
+            size_t state_len = sizeof(int64_t);
+            if (agg.type == AGG_SUM) {
+                out_col.type = agg.in_type;
+            } else if (agg.type == AGG_AVG) {
+                out_col.type = TYPE_FLOAT;
+                state_len = sizeof(double) + sizeof(int64_t);
+            } else if (agg.type == AGG_MIN || agg.type == AGG_MAX) {
+                out_col.type = agg.in_type;
+                out_col.len = agg.in_len;
+                state_len = align8(agg.in_len);
+            }
+            out_col.offset = out_offset;
+            agg.out_offset = out_offset;
+            out_offset += out_col.len;
+            state_offset += state_len;
+            cols_.push_back(out_col);
+            aggs_.push_back(agg);
+        }
+        len_ = out_offset;
+        entry_len_ = align8(state_offset);
+
+        size_t group_mem = entry_len_ + sizeof(uint64_t) + 2 * sizeof(uint32_t);
+        max_groups_ = std::max<size_t>(1, mem_budget / group_mem);
+        key_.resize(key_len_);
+    }
+
+    bool is_end() const override { return is_end_; }
+
+    size_t tupleLen() const override { return len_; }
+
+    const std::vector<ColMeta> &cols() const override { return cols_; }
+
+    std::string getType() override { return "AggregateExecutor"; }
+
+    /**
+     * @brief 读入全部输入聚合到哈希表中，放不下的分组写出到分区
+     */
+    void beginTuple() override {
+        partitions_.clear();
+        clear_table();
+        is_end_ = false;
+        for (prev_->beginTuple(); prev_->next_batch(&in_batch_);) {
+            for (size_t i = 0; i < in_batch_.size(); i++) {
+                consume(in_batch_.get(i), 0);
+            }
+        }
+        add_partitions(1);
+        if (key_offs_.empty() && num_groups_ == 0) {
+            insert_group(nullptr, hash_key(key_.data()));  // 没有分组字段时，输入为空也输出一组
+        }
+        emit_pos_ = 0;
+        settle();
+    }
+
+    void nextTuple() override {
+        assert(!is_end());
+        emit_pos_++;
+        settle();
+    }
+
+    std::unique_ptr<RmRecord> Next() override {
+        assert(!is_end());
+        auto record = std::make_unique<RmRecord>(len_);
+        finalize(entry(emit_pos_), record->data);
+        return record;
+    }
+
+    /**
+     * @brief 把连续的分组的结果直接写入batch，不为每个元组分配记录
+     */
+    bool next_batch(TupleBatch *batch) override {
+        batch->reset(len_);
+        for (; !is_end_ && !batch->full(); nextTuple()) {
+            finalize(entry(emit_pos_), batch->append());
+        }
+        return !batch->empty();
+    }
+
+    Rid &rid() override { return _abstract_rid; }
+
+   private:
+    static size_t align8(size_t len) { return (len + 7) & ~static_cast<size_t>(7); }
+
+    template <typename T>
+    static T load(const char *src) {
+        T val;
+        memcpy(&val, src, sizeof(T));
+        return val;
+    }
+
+    template <typename T>
+    static void store(char *dst, T val) {
+        memcpy(dst, &val, sizeof(T));
+    }
+
+    void make_key(const char *tuple, char *key) const {
+        for (size_t i = 0; i < key_offs_.size(); i++) {
+            memcpy(key, tuple + key_offs_[i], key_lens_[i]);
+            key += key_lens_[i];
+        }
+    }
+
+    uint64_t hash_key(const char *key) const { return IxHashIndexHandle::hash_key(key, key_types_, key_lens_); }
+
+    /** 分区使用哈希值的高位，第depth次分区使用第depth段；哈希表的槽使用低位 */
+    static size_t partition_of(uint64_t hash, int depth) {
+        int shift = 64 - AGG_PARTITION_BITS * (depth + 1);
+        return (hash >> shift) & ((1u << AGG_PARTITION_BITS) - 1);
+    }
+
+    char *entry(size_t idx) { return entries_.data() + idx * entry_len_; }
+
+    void clear_table() {
+        entries_.clear();
+        hashes_.clear();
+        slots_.assign(16, EMPTY_SLOT);
+        num_groups_ = 0;
+    }
+
+    /**
+     * @brief 把一个输入元组聚合到它的分组；分组不在表中并且表已满时，把元组写到第depth段哈希值对应的分区
+     */
+    void consume(const char *tuple, int depth) {
+        make_key(tuple, key_.data());
+        uint64_t hash = hash_key(key_.data());
+        size_t mask = slots_.size() - 1;
+        for (size_t pos = hash & mask; slots_[pos] != EMPTY_SLOT; pos = (pos + 1) & mask) {
+            uint32_t idx = slots_[pos];
+            if (hashes_[idx] == hash && (key_len_ == 0 || key_cmp_(entry(idx), key_.data()) == 0)) {
+                update(entry(idx), tuple);
+                return;
+            }
+        }
+        if (num_groups_ < max_groups_ || depth >= AGG_MAX_DEPTH) {
+            update(insert_group(tuple, hash), tuple);
+            return;
+        }
+        if (spill_parts_.empty()) {
+            for (int i = 0; i < (1 << AGG_PARTITION_BITS); i++) {
+                spill_parts_.push_back(std::make_unique<SpillFile>("aggregate", prev_len_));
+            }
+        }
+        spill_parts_[partition_of(hash, depth)]->append(tuple);
+    }
+
+    /**
+     * @brief 在表中加入一个分组，聚合状态清零，MIN/MAX的状态取这个元组的值；槽的数量保持为分组数量的2倍以上
+     * @param tuple 分组的第一个元组，为空时只加入清零的分组
+     * @return 新分组的表项
+     */
+    char *insert_group(const char *tuple, uint64_t hash) {
+        entries_.resize((num_groups_ + 1) * entry_len_);
+        char *group = entry(num_groups_);
+        memset(group, 0, entry_len_);
+        memcpy(group, key_.data(), key_len_);
+        for (auto &agg : aggs_) {
+            if (tuple != nullptr && (agg.type == AGG_MIN || agg.type == AGG_MAX)) {
+                memcpy(group + agg.state_offset, tuple + agg.in_offset, agg.in_len);
+            }
+        }
+        hashes_.push_back(hash);
+        num_groups_++;
+        if (2 * num_groups_ > slots_.size()) {
+            slots_.assign(slots_.size() * 2, EMPTY_SLOT);
+            for (size_t i = 0; i + 1 < num_groups_; i++) {
+                place(i);
+            }
+        }
+        place(num_groups_ - 1);
+        return group;
+    }
+
+    void place(size_t idx) {
+        size_t mask = slots_.size() - 1;
+        size_t pos = hashes_[idx] & mask;
+        while (slots_[pos] != EMPTY_SLOT) {
+            pos = (pos + 1) & mask;
+        }
+        slots_[pos] = static_cast<uint32_t>(idx);
+    }
+
+    /**
+     * @brief 用一个输入元组更新分组的各个聚合状态
+     */
+    void update(char *group, const char *tuple) const {
+        for (auto &agg : aggs_) {
+            char *s = group + agg.state_offset;
+            const char *val = tuple + agg.in_offset;
+            switch (agg.type) {
+                case AGG_COUNT:
+                    store<int64_t>(s, load<int64_t>(s) + 1);
+                    break;
+                case AGG_SUM:
+                    if (agg.in_type == TYPE_INT) {
+                        store<int64_t>(s, load<int64_t>(s) + load<int>(val));
+                    } else {
+                        store<double>(s, load<double>(s) + load<float>(val));
+                    }
+                    break;
+                case AGG_AVG:
+                    store<double>(s, load<double>(s) + (agg.in_type == TYPE_INT ? load<int>(val) : load<float>(val)));
+                    store<int64_t>(s + sizeof(double), load<int64_t>(s + sizeof(double)) + 1);
+                    break;
+                case AGG_MIN:
+                case AGG_MAX: {
+                    int cmp = ix_compare(val, s, agg.in_type, agg.in_len);
+                    if (agg.type == AGG_MIN ? cmp < 0 : cmp > 0) {
+                        memcpy(s, val, agg.in_len);
+                    }
+                    break;
+                }
+                case AGG_NONE:
+                    break;
+            }
+        }
+    }
+
+    /**
+     * @brief 由分组的表项写出输出元组：分组字段，以及由聚合状态得到的各个聚合函数的结果
+     */
+    void finalize(const char *group, char *out) const {
+        int offset = 0;
+        for (size_t i = 0; i < key_lens_.size(); i++) {
+            memcpy(out + offset, group + offset, key_lens_[i]);
+            offset += key_lens_[i];
+        }
+        for (auto &agg : aggs_) {
+            const char *s = group + agg.state_offset;
+            char *dst = out + agg.out_offset;
+            switch (agg.type) {
+                case AGG_COUNT:
+                    store<int>(dst, static_cast<int>(load<int64_t>(s)));
+                    break;
+                case AGG_SUM:
+                    if (agg.in_type == TYPE_INT) {
+                        store<int>(dst, static_cast<int>(load<int64_t>(s)));
+                    } else {
+                        store<float>(dst, static_cast<float>(load<double>(s)));
+                    }
+                    break;
+                case AGG_AVG: {
+                    int64_t count = load<int64_t>(s + sizeof(double));
+                    store<float>(dst, count == 0 ? 0 : static_cast<float>(load<double>(s) / count));
+                    break;
+                }
+                case AGG_MIN:
+                case AGG_MAX:
+                    memcpy(dst, s, agg.in_len);
+                    break;
+                case AGG_NONE:
+                    break;
+            }
+        }
+    }
+
+    /** 把正在写出的非空分区加入待处理队列 */
+    void add_partitions(int depth) {
+        for (auto &part : spill_parts_) {
+            if (part->size() == 0) {
+                continue;
+            }
+            part->rewind();
+            partitions_.push_back(Partition{std::move(part), depth});
+        }
+        spill_parts_.clear();
+    }
+
+    /**
+     * @brief 当前表中的分组都已输出时，取出下一个分区重新聚合，直到有分组可以输出或者没有分区
+     */
+    void settle() {
+        while (emit_pos_ >= num_groups_) {
+            if (partitions_.empty()) {
+                is_end_ = true;
+                return;
+            }
+            Partition part = std::move(partitions_.front());
+            partitions_.pop_front();
+            clear_table();
+            std::vector<char> tuple(prev_len_);
+            while (part.file->read(tuple.data())) {
+                consume(tuple.data(), part.depth);
+            }
+            add_partitions(part.depth + 1);
+            emit_pos_ = 0;
+        }
+    }
+};
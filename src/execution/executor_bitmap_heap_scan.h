@@ -0,0 +1,182 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+
+#include "execution_conds.h"
+#include "execution_defs.h"
+#include "execution_index_range.h"
+#include "execution_manager.h"
+#include "executor_abstract.h"
+#include "executor_index_scan.h"
+#include "index/ix.h"
+#include "system/sm.h"
+
+/**
+ * 一组按(page_no, slot_no)排好序、没有重复的Rid，多个索引扫描的结果之间可以求交(AND)
+ */
+class RidBitmap {
+   private:
+    std::vector<Rid> rids_;
+
+    static bool rid_less(const Rid &x, const Rid &y) {
+        return x.page_no != y.page_no ? x.page_no < y.page_no : x.slot_no < y.slot_no;
+    }
+
+   public:
+    RidBitmap() = default;
+
+    /** 收集索引上[lower, upper)范围内的所有Rid */
+    RidBitmap(IxIndexHandle *ih, const Iid &lower, const Iid &upper, BufferPoolManager *bpm) {
+        for (IxScan scan(ih, lower, upper, bpm); !scan.is_end(); scan.next()) {
+            rids_.push_back(scan.rid());
+        }
+        std::sort(rids_.begin(), rids_.end(), rid_less);
+        rids_.erase(std::unique(rids_.begin(), rids_.end()), rids_.end());
+    }
+
+    void intersect(const RidBitmap &other) {
+        std::vector<Rid> res;
+        std::set_intersection(rids_.begin(), rids_.end(), other.rids_.begin(), other.rids_.end(),
+                              std::back_inserter(res), rid_less);
+        rids_ = std::move(res);
+    }
+
+    const std::vector<Rid> &rids() const { return rids_; }
+};
+
+/**
+ * 位图扫描：先从一个或多个索引的范围扫描中收集Rid，求交后按页号排序，
+ * 再按页面顺序读取元组，每个数据页只读取一次，避免按key顺序回表造成的随机访问
+ */
+class BitmapHeapScanExecutor : public AbstractExecutor {
+   private:
+    std::string tab_name_;                                  // 表名称
+    TabMeta tab_;                                           // 表的元数据
+    std::vector<Condition> conds_;                          // 扫描条件
+    RmFileHandle *fh_;                                      // 表的数据文件句柄
+    std::vector<ColMeta> cols_;                             // 需要读取的字段
+    size_t len_;                                            // 选取出来的一条记录的长度
+    std::vector<std::vector<std::string>> index_col_names_; // 参与扫描的每个索引包含的字段
+    std::vector<Condition> residual_conds_;                 // 所有索引范围之外还需要对取出的元组判断的条件
+    std::vector<ResolvedCond> resolved_conds_;              // 编译好的residual_conds_
+
+    RidBitmap bitmap_;                                      // 满足所有索引范围的Rid
+    size_t bitmap_pos_;                                     // 下一个要读取的数据页在bitmap_中的起始位置
+    std::vector<std::pair<Rid, std::unique_ptr<RmRecord>>> page_tuples_;  // 当前数据页中满足条件的元组
+    size_t tuple_pos_;                                      // 当前元组在page_tuples_中的位置
+
+    SmManager *sm_manager_;
+
+   public:
+    BitmapHeapScanExecutor(SmManager *sm_manager, std::string tab_name, std::vector<Condition> conds,
+                           std::vector<std::vector<std::string>> index_col_names, Context *context) {
+        sm_manager_ = sm_manager;
+        context_ = context;
+        tab_name_ = std::move(tab_name);
+        tab_ = sm_manager_->db_.get_table(tab_name_);
+        conds_ = IndexScanExecutor::swap_conds(std::move(conds), tab_name_);
+        index_col_names_ = std::move(index_col_names);
+        fh_ = sm_manager_->fhs_.at(tab_name_).get();
+        cols_ = tab_.cols;
+        len_ = cols_.back().offset + cols_.back().len;
+        bitmap_pos_ = tuple_pos_ = 0;
+
+        if (context) {
+            context->lock_mgr_->lock_shared_on_table(context->txn_, fh_->GetFd());
+        }
+    }
+
+    bool is_end() const override { return tuple_pos_ >= page_tuples_.size(); }
+
+    size_t tupleLen() const override { return len_; }
+
+    const std::vector<ColMeta> &cols() const override { return cols_; }
+
+    RmFileHandle *get_fh() const override { return fh_; }
+
+    /**
+     * @brief 扫描每个索引上由条件推出的范围，对得到的Rid求交，然后读取第一个有满足条件元组的数据页
+     */
+    void beginTuple() override {
+        std::vector<bool> used(conds_.size(), false);
+        bool empty = false;
+        for (size_t i = 0; i < index_col_names_.size() && !empty; i++) {
+            IndexRange range(*tab_.get_index_meta(index_col_names_[i]), tab_name_, conds_);
+            for (size_t j = 0; j < conds_.size(); j++) {
+                used[j] = used[j] || range.uses_cond(j);
+            }
+            if (range.is_empty()) {
+                bitmap_ = RidBitmap();
+                empty = true;
+                break;
+            }
+            IxIndexHandle *ih =
+                sm_manager_->ihs_.at(sm_manager_->get_ix_manager()->get_index_name(tab_name_, index_col_names_[i])).get();
+            RidBitmap rids(ih, range.lower(ih), range.upper(ih), sm_manager_->get_bpm());
+            if (i == 0) {
+                bitmap_ = std::move(rids);
+            } else {
+                bitmap_.intersect(rids);
+            }
+            empty = bitmap_.rids().empty();
+        }
+        residual_conds_.clear();
+        for (size_t j = 0; j < conds_.size(); j++) {
+            if (!used[j]) {
+                residual_conds_.push_back(conds_[j]);
+            }
+        }
+        resolved_conds_ = ResolvedCond::resolve(cols_, residual_conds_);
+        bitmap_pos_ = 0;
+        load_next_page();
+    }
+
+    void nextTuple() override {
+        assert(!is_end());
+        if (++tuple_pos_ == page_tuples_.size()) {
+            load_next_page();
+        }
+    }
+
+    std::unique_ptr<RmRecord> Next() override {
+        assert(!is_end());
+        return std::make_unique<RmRecord>(*page_tuples_[tuple_pos_].second);
+    }
+
+    Rid &rid() override { return page_tuples_[tuple_pos_].first; }
+
+   private:
+    /**
+     * @brief 从bitmap_pos_开始按页读取元组，直到某个数据页中有满足剩余条件的元组或者Rid全部读完
+     */
+    void load_next_page() {
+        page_tuples_.clear();
+        tuple_pos_ = 0;
+        const auto &rids = bitmap_.rids();
+        while (page_tuples_.empty() && bitmap_pos_ < rids.size()) {
+            int page_no = rids[bitmap_pos_].page_no;
+            std::vector<int> slot_nos;
+            size_t begin = bitmap_pos_;
+            for (; bitmap_pos_ < rids.size() && rids[bitmap_pos_].page_no == page_no; bitmap_pos_++) {
+                slot_nos.push_back(rids[bitmap_pos_].slot_no);
+            }
+            auto recs = fh_->get_records(page_no, slot_nos, context_);
+            for (size_t i = 0; i < recs.size(); i++) {
+                if (ResolvedCond::eval_all(resolved_conds_, recs[i]->data)) {
+                    page_tuples_.emplace_back(rids[begin + i], std::move(recs[i]));
+                }
+            }
+        }
+    }
+};
@@ -41,34 +41,51 @@ class DeleteExecutor : public AbstractExecutor {
         }
     }
 
+    /**
+     * @brief 先删除所有记录并收集每个索引中要删除的key，再对每个索引批量删除，
+     * B+树中同一个叶子结点的键值对一次删除，每个叶子结点只合并或重分配一次
+     */
     std::unique_ptr<RmRecord> Next() override {
-        for (auto &rid : rids_) {
+        std::vector<std::vector<char>> index_keys(tab_.indexes.size());
+        for (size_t i = 0; i < tab_.indexes.size(); ++i) {
+            index_keys[i].resize(rids_.size() * tab_.indexes[i].col_tot_len);
+        }
+
+        for (size_t r = 0; r < rids_.size(); ++r) {
+            auto &rid = rids_[r];
             auto rec = fh_->get_record(rid, context_);
 
-            // Remove old entry from index
+            // collect old entries to remove from indexes
             for (size_t i = 0; i < tab_.indexes.size(); ++i) {
                 auto& index = tab_.indexes[i];
-                auto ih = sm_manager_->ihs_.at(sm_manager_->get_ix_manager()->get_index_name(tab_name_, index.cols)).get();
-                char* key = new char[index.col_tot_len];
+                char* key = index_keys[i].data() + r * index.col_tot_len;
                 int offset = 0;
-                for (size_t i = 0; i < index.col_num; ++i) {
-                    memcpy(key + offset, rec->data + index.cols[i].offset, index.cols[i].len);
-                    offset += index.cols[i].len;
+                for (size_t j = 0; j < index.cols.size(); ++j) {
+                    memcpy(key + offset, rec->data + index.cols[j].offset, index.cols[j].len);
+                    offset += index.cols[j].len;
                 }
-                ih->delete_entry(key, context_->txn_);
-                delete[] key;
             }
 
             // record a delete operation into the transaction
             WriteRecord* wr = new WriteRecord(WType::DELETE_TUPLE, tab_name_, rid, *rec);
             context_->txn_->append_write_record(wr);
-            
-            RmRecord delete_record{rec->size};
-            memcpy(delete_record.data, rec->data, rec->size);
 
             // delete record in record file
             fh_->delete_record(rid, context_);
+        }
 
+        // Remove old entries from indexes
+        for (size_t i = 0; i < tab_.indexes.size(); ++i) {
+            auto& index = tab_.indexes[i];
+            sm_manager_->get_index(index)->delete_entries(index_keys[i].data(), index.col_tot_len, rids_.data(),
+                                                          static_cast<int>(rids_.size()), context_->txn_);
+            // record the removed entries so that abort puts them back
+            auto col_names = index.col_names();
+            for (size_t r = 0; r < rids_.size(); ++r) {
+                RmRecord key(index.col_tot_len, index_keys[i].data() + r * index.col_tot_len);
+                context_->txn_->append_write_record(
+                    new WriteRecord(WType::DELETE_ENTRY, tab_name_, rids_[r], key, col_names));
+            }
         }
 
         return nullptr;
@@ -0,0 +1,406 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <deque>
+
+#include "execution_conds.h"
+#include "execution_defs.h"
+#include "execution_manager.h"
+#include "execution_spill.h"
+#include "executor_abstract.h"
+#include "index/ix.h"
+#include "system/sm.h"
+
+/**
+ * 等值连接：在一侧输入（建表侧）的连接key上建立开放寻址的哈希表，逐个读取另一侧（探测侧）的元组查找
+ * 建表侧超过内存预算时改为Grace哈希连接：两侧都按key的哈希值分区写到临时文件中，再逐个分区建表和探测，
+ * 分区仍然放不下时用哈希值的下一段再分区
+ * 输出的元组总是左侧元组拼接右侧元组
+ */
+class HashJoinExecutor : public AbstractExecutor {
+   private:
+    static constexpr uint32_t EMPTY_SLOT = UINT32_MAX;
+
+    /* 写到临时文件中的一对分区，depth为已经用于分区的哈希值段数 */
+    struct Partition {
+        std::unique_ptr<SpillFile> build;
+        std::unique_ptr<SpillFile> probe;
+        int depth;
+    };
+
+    std::unique_ptr<AbstractExecutor> left_;    // 左儿子节点（需要join的表）
+    std::unique_ptr<AbstractExecutor> right_;   // 右儿子节点（需要join的表）
+    size_t len_;                                // join后获得的每条记录的长度
+    std::vector<ColMeta> cols_;                 // join后获得的记录的字段
+    std::vector<Condition> fed_conds_;          // join条件
+
+    AbstractExecutor *build_;                   // 建表侧
+    AbstractExecutor *probe_;                   // 探测侧
+    BatchReader build_in_;                      // 按批读取建表侧
+    BatchReader probe_in_;                      // 按批读取探测侧
+    size_t build_len_;
+    size_t probe_len_;
+    size_t build_offset_;                       // 建表侧元组在连接后的元组中的位置
+    size_t probe_offset_;
+    std::vector<int> build_key_offs_;           // 各个key字段在建表侧元组中的位置
+    std::vector<int> probe_key_offs_;           // 各个key字段在探测侧元组中的位置
+    std::vector<ColType> key_types_;
+    std::vector<int> key_lens_;
+    int key_len_ = 0;
+    IxKeyComparator key_cmp_;
+    std::vector<ResolvedCond> residual_conds_;  // 不能作为key的其他连接条件，对连接后的元组判断
+    size_t max_build_tuples_;                   // 内存中最多容纳的建表侧元组数量
+
+    // 哈希表：建表侧元组连同key依次存放在entries_中，slots_线性探测，存放entries_的下标
+    std::vector<char> entries_;
+    std::vector<uint64_t> hashes_;
+    std::vector<uint32_t> slots_;
+    size_t num_entries_ = 0;
+
+    std::deque<Partition> partitions_;          // 尚未处理的分区
+    bool spilled_ = false;                      // 是否分区写出到了临时文件
+    std::unique_ptr<SpillFile> probe_file_;     // 当前分区的探测侧，没有分区时直接从probe_读取
+    std::vector<char> probe_tuple_;             // 当前探测元组
+    std::vector<char> probe_key_;
+    uint64_t probe_hash_ = 0;
+    size_t slot_pos_ = 0;                       // 当前探测元组接下来要检查的槽
+    bool probing_ = false;                      // probe_tuple_是否有效
+    std::vector<char> joined_;                  // 当前输出的元组
+    bool is_end_ = true;
+
+   public:
+    /**
+     * @param conds 连接条件，至少有一个左右两侧类型相同的等值条件
+     * @param build_left 在左侧输入上建表（左侧较小），否则在右侧建表
+     * @param mem_budget 建表可使用的内存大小(字节)
+     */
+    HashJoinExecutor(std::unique_ptr<AbstractExecutor> left, std::unique_ptr<AbstractExecutor> right,
+                     std::vector<Condition> conds, bool build_left = false,
+                     size_t mem_budget = HASH_JOIN_MEM_BUDGET) {
+        left_ = std::move(left);
+        right_ = std::move(right);
+        len_ = left_->tupleLen() + right_->tupleLen();
+        cols_ = left_->cols();
+        auto right_cols = right_->cols();
+        for (auto &col : right_cols) {
+            col.offset += left_->tupleLen();
+        }
+        cols_.insert(cols_.end(), right_cols.begin(), right_cols.end());
+        fed_conds_ = std::move(conds);
+
+        build_ = build_left ? left_.get() : right_.get();
+        probe_ = build_left ? right_.get() : left_.get();
+        build_len_ = build_->tupleLen();
+        probe_len_ = probe_->tupleLen();
+        build_offset_ = build_left ? 0 : left_->tupleLen();
+        probe_offset_ = build_left ? left_->tupleLen() : 0;
+
+        std::vector<Condition> residual;
+        for (auto &cond : fed_conds_) {
+            if (!is_key_cond(cond)) {
+                residual.push_back(cond);
+                continue;
+            }
+            auto lhs_col = get_col(cols_, cond.lhs_col);
+            auto rhs_col = get_col(cols_, cond.rhs_col);
+            // 两侧字段分别属于左右两侧，较短的字段决定key的长度
+            int left_offset = std::min(lhs_col->offset, rhs_col->offset);
+            int right_offset = std::max(lhs_col->offset, rhs_col->offset) - left_->tupleLen();
+            build_key_offs_.push_back(build_left ? left_offset : right_offset);
+            probe_key_offs_.push_back(build_left ? right_offset : left_offset);
+            key_types_.push_back(lhs_col->type);
+            key_lens_.push_back(std::min(lhs_col->len, rhs_col->len));
+            key_len_ += key_lens_.back();
+        }
+        assert(!key_lens_.empty());
+        residual_conds_ = ResolvedCond::resolve(cols_, residual);
+        key_cmp_ = IxKeyComparator(key_types_, key_lens_);
+
+        size_t entry_mem = key_len_ + build_len_ + sizeof(uint64_t) + 2 * sizeof(uint32_t);
+        max_build_tuples_ = std::max<size_t>(1, mem_budget / entry_mem);
+        probe_tuple_.resize(probe_len_);
+        probe_key_.resize(key_len_);
+        joined_.resize(len_);
+    }
+
+    /**
+     * @brief 条件能否作为哈希连接的key：两侧字段分属左右输入、类型相同的等值条件
+     */
+    static bool is_key_cond(const Condition &cond, const std::vector<ColMeta> &cols, size_t left_len) {
+        if (cond.is_rhs_val || cond.op != OP_EQ) {
+            return false;
+        }
+        auto lhs_col = ResolvedCond::find_col(cols, cond.lhs_col);
+        auto rhs_col = ResolvedCond::find_col(cols, cond.rhs_col);
+        return lhs_col->type == rhs_col->type &&
+               (static_cast<size_t>(lhs_col->offset) < left_len) != (static_cast<size_t>(rhs_col->offset) < left_len);
+    }
+
+    bool is_end() const override { return is_end_; }
+
+    size_t tupleLen() const override { return len_; }
+
+    const std::vector<ColMeta> &cols() const override { return cols_; }
+
+    std::string getType() override { return "HashJoinExecutor"; }
+
+    /**
+     * @brief 读入建表侧：全部放得下时在内存中建表，否则两侧都分区写出，从第一个分区开始
+     */
+    void beginTuple() override {
+        partitions_.clear();
+        probe_file_.reset();
+        clear_table();
+        probing_ = false;
+        spilled_ = false;
+        is_end_ = false;
+
+        for (build_in_.begin(build_); !build_in_.is_end() && num_entries_ < max_build_tuples_; build_in_.next()) {
+            add_entry(build_in_.get());
+        }
+        if (build_in_.is_end()) {
+            if (num_entries_ == 0) {
+                is_end_ = true;  // 建表侧为空，不需要读取探测侧
+                return;
+            }
+            build_table();
+            probe_in_.begin(probe_);
+        } else {
+            spilled_ = true;
+            spill_inputs();
+            if (!next_partition()) {
+                is_end_ = true;
+                return;
+            }
+        }
+        find_next();
+    }
+
+    void nextTuple() override {
+        assert(!is_end());
+        find_next();
+    }
+
+    std::unique_ptr<RmRecord> Next() override {
+        assert(!is_end());
+        auto record = std::make_unique<RmRecord>(len_);
+        memcpy(record->data, joined_.data(), len_);
+        return record;
+    }
+
+    /**
+     * @brief 连续查找连接结果直接放入batch，不为每个元组分配记录
+     */
+    bool next_batch(TupleBatch *batch) override {
+        batch->reset(len_);
+        for (; !is_end_ && !batch->full(); find_next()) {
+            batch->append(joined_.data());
+        }
+        return !batch->empty();
+    }
+
+    Rid &rid() override { return _abstract_rid; }
+
+   private:
+    bool is_key_cond(const Condition &cond) const { return is_key_cond(cond, cols_, left_->tupleLen()); }
+
+    void make_key(const char *tuple, const std::vector<int> &key_offs, char *key) const {
+        for (size_t i = 0; i < key_offs.size(); i++) {
+            memcpy(key, tuple + key_offs[i], key_lens_[i]);
+            key += key_lens_[i];
+        }
+    }
+
+    uint64_t hash_key(const char *key) const { return IxHashIndexHandle::hash_key(key, key_types_, key_lens_); }
+
+    uint64_t hash_tuple(const char *tuple, const std::vector<int> &key_offs) const {
+        std::vector<char> key(key_len_);
+        make_key(tuple, key_offs, key.data());
+        return hash_key(key.data());
+    }
+
+    /** 分区使用哈希值的高位，第depth次分区使用第depth段；哈希表的槽使用低位 */
+    static size_t partition_of(uint64_t hash, int depth) {
+        int shift = 64 - HASH_JOIN_PARTITION_BITS * (depth + 1);
+        return (hash >> shift) & ((1u << HASH_JOIN_PARTITION_BITS) - 1);
+    }
+
+    size_t entry_len() const { return key_len_ + build_len_; }
+
+    const char *entry_key(size_t idx) const { return entries_.data() + idx * entry_len(); }
+
+    const char *entry_tuple(size_t idx) const { return entry_key(idx) + key_len_; }
+
+    void clear_table() {
+        entries_.clear();
+        hashes_.clear();
+        slots_.clear();
+        num_entries_ = 0;
+    }
+
+    void add_entry(const char *tuple) {
+        entries_.resize((num_entries_ + 1) * entry_len());
+        char *entry = entries_.data() + num_entries_ * entry_len();
+        make_key(tuple, build_key_offs_, entry);
+        memcpy(entry + key_len_, tuple, build_len_);
+        hashes_.push_back(hash_key(entry));
+        num_entries_++;
+    }
+
+    /**
+     * @brief 按加入的顺序把元组放入槽中，槽的数量至少是元组数量的2倍；
+     * 相同key的元组在探测序列中保持加入的顺序
+     */
+    void build_table() {
+        size_t capacity = 2;
+        while (capacity < 2 * num_entries_) {
+            capacity <<= 1;
+        }
+        slots_.assign(capacity, EMPTY_SLOT);
+        for (size_t i = 0; i < num_entries_; i++) {
+            size_t pos = hashes_[i] & (capacity - 1);
+            while (slots_[pos] != EMPTY_SLOT) {
+                pos = (pos + 1) & (capacity - 1);
+            }
+            slots_[pos] = static_cast<uint32_t>(i);
+        }
+    }
+
+    std::vector<std::unique_ptr<SpillFile>> make_partitions(size_t tuple_len) const {
+        std::vector<std::unique_ptr<SpillFile>> parts;
+        for (int i = 0; i < (1 << HASH_JOIN_PARTITION_BITS); i++) {
+            parts.push_back(std::make_unique<SpillFile>("hash_join", tuple_len));
+        }
+        return parts;
+    }
+
+    /** 把成对的分区加入待处理队列，任意一侧为空的分区不会有结果 */
+    void add_partitions(std::vector<std::unique_ptr<SpillFile>> &build_parts,
+                        std::vector<std::unique_ptr<SpillFile>> &probe_parts, int depth) {
+        for (size_t i = 0; i < build_parts.size(); i++) {
+            if (build_parts[i]->size() == 0 || probe_parts[i]->size() == 0) {
+                continue;
+            }
+            build_parts[i]->rewind();
+            probe_parts[i]->rewind();
+            partitions_.push_back(Partition{std::move(build_parts[i]), std::move(probe_parts[i]), depth});
+        }
+    }
+
+    /**
+     * @brief 建表侧超过内存预算：已经读入的和剩余的建表侧元组、探测侧的所有元组按哈希值的第一段分区写出
+     */
+    void spill_inputs() {
+        auto build_parts = make_partitions(build_len_);
+        auto probe_parts = make_partitions(probe_len_);
+        for (size_t i = 0; i < num_entries_; i++) {
+            build_parts[partition_of(hashes_[i], 0)]->append(entry_tuple(i));
+        }
+        clear_table();
+        for (; !build_in_.is_end(); build_in_.next()) {
+            build_parts[partition_of(hash_tuple(build_in_.get(), build_key_offs_), 0)]->append(build_in_.get());
+        }
+        for (probe_in_.begin(probe_); !probe_in_.is_end(); probe_in_.next()) {
+            probe_parts[partition_of(hash_tuple(probe_in_.get(), probe_key_offs_), 0)]->append(probe_in_.get());
+        }
+        add_partitions(build_parts, probe_parts, 1);
+    }
+
+    /**
+     * @brief 取出下一个分区建表，分区仍然超过内存预算时用哈希值的下一段再分区
+     * @return 是否还有分区
+     */
+    bool next_partition() {
+        while (!partitions_.empty()) {
+            Partition part = std::move(partitions_.front());
+            partitions_.pop_front();
+            if (part.build->size() > max_build_tuples_ && part.depth < HASH_JOIN_MAX_DEPTH) {
+                auto build_parts = make_partitions(build_len_);
+                auto probe_parts = make_partitions(probe_len_);
+                std::vector<char> tuple(std::max(build_len_, probe_len_));
+                while (part.build->read(tuple.data())) {
+                    build_parts[partition_of(hash_tuple(tuple.data(), build_key_offs_), part.depth)]->append(tuple.data());
+                }
+                while (part.probe->read(tuple.data())) {
+                    probe_parts[partition_of(hash_tuple(tuple.data(), probe_key_offs_), part.depth)]->append(tuple.data());
+                }
+                add_partitions(build_parts, probe_parts, part.depth + 1);
+                continue;
+            }
+            clear_table();
+            std::vector<char> tuple(build_len_);
+            while (part.build->read(tuple.data())) {
+                add_entry(tuple.data());
+            }
+            build_table();
+            probe_file_ = std::move(part.probe);
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief 读入下一个探测元组，当前分区读完时换到下一个分区
+     * @return 是否还有探测元组
+     */
+    bool next_probe() {
+        while (true) {
+            if (probe_file_ == nullptr) {
+                if (spilled_ || probe_in_.is_end()) {
+                    return false;
+                }
+                memcpy(probe_tuple_.data(), probe_in_.get(), probe_len_);
+                probe_in_.next();
+                break;
+            }
+            if (probe_file_->read(probe_tuple_.data())) {
+                break;
+            }
+            probe_file_.reset();
+            if (!next_partition()) {
+                return false;
+            }
+        }
+        make_key(probe_tuple_.data(), probe_key_offs_, probe_key_.data());
+        probe_hash_ = hash_key(probe_key_.data());
+        slot_pos_ = probe_hash_ & (slots_.size() - 1);
+        return true;
+    }
+
+    /**
+     * @brief 从当前探测元组的探测序列中接着查找，直到找到key相等并满足其余条件的元组对
+     */
+    void find_next() {
+        while (true) {
+            if (probing_) {
+                while (slots_[slot_pos_] != EMPTY_SLOT) {
+                    uint32_t idx = slots_[slot_pos_];
+                    slot_pos_ = (slot_pos_ + 1) & (slots_.size() - 1);
+                    if (hashes_[idx] != probe_hash_ || key_cmp_(entry_key(idx), probe_key_.data()) != 0) {
+                        continue;
+                    }
+                    memcpy(joined_.data() + build_offset_, entry_tuple(idx), build_len_);
+                    memcpy(joined_.data() + probe_offset_, probe_tuple_.data(), probe_len_);
+                    if (ResolvedCond::eval_all(residual_conds_, joined_.data())) {
+                        return;
+                    }
+                }
+                probing_ = false;
+            }
+            if (!next_probe()) {
+                is_end_ = true;
+                return;
+            }
+            probing_ = true;
+        }
+    }
+};
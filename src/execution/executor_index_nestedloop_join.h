@@ -0,0 +1,222 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "execution_conds.h"
+#include "execution_defs.h"
+#include "execution_manager.h"
+#include "executor_abstract.h"
+#include "index/ix.h"
+#include "system/sm.h"
+
+/**
+ * 索引嵌套循环连接：内层是一张表，索引的每个字段都与外层的某个字段等值连接；
+ * 对每个外层元组，用它的字段值拼出key在内层的索引（B+树或哈希索引）中查找，只取出匹配的内层元组，不扫描内层表
+ * 输出的元组是左侧元组拼接右侧元组，内层可以是左侧也可以是右侧
+ */
+class IndexNestedLoopJoinExecutor : public AbstractExecutor {
+   private:
+    std::unique_ptr<AbstractExecutor> outer_;   // 外层节点
+    BatchReader outer_in_;                      // 按批读取外层
+    std::string tab_name_;                      // 内层表名称
+    RmFileHandle *fh_;                          // 内层表的数据文件句柄
+    IxIndex *index_;                            // 内层表上查找使用的索引
+    size_t len_;                                // join后获得的每条记录的长度
+    std::vector<ColMeta> cols_;                 // join后获得的记录的字段
+    std::vector<Condition> fed_conds_;          // join条件
+
+    size_t outer_len_;
+    size_t inner_len_;
+    size_t outer_offset_;                       // 外层元组在连接后的元组中的位置
+    size_t inner_offset_;
+    std::vector<int> key_offs_;                 // 索引的各个字段对应的外层字段在外层元组中的位置
+    std::vector<int> key_lens_;
+    std::vector<ResolvedCond> inner_conds_;     // 内层表自身的条件，对取出的内层元组判断
+    std::vector<ResolvedCond> residual_conds_;  // 索引之外的连接条件，对连接后的元组判断
+
+    std::vector<char> key_;
+    std::vector<Rid> rids_;                     // 当前外层元组在索引中查到的内层元组
+    size_t rid_pos_ = 0;
+    std::vector<char> joined_;                  // 当前输出的元组
+    bool is_end_ = true;
+
+    SmManager *sm_manager_;
+
+   public:
+    /**
+     * @param inner_conds 内层表自身的条件
+     * @param index_col_names 内层表上使用的索引包含的字段，每个字段都必须在conds中与外层字段等值连接，并且类型和长度相同
+     * @param inner_left 内层是连接的左侧
+     */
+    IndexNestedLoopJoinExecutor(std::unique_ptr<AbstractExecutor> outer, SmManager *sm_manager, std::string tab_name,
+                                std::vector<Condition> inner_conds, std::vector<std::string> index_col_names,
+                                std::vector<Condition> conds, bool inner_left, Context *context) {
+        outer_ = std::move(outer);
+        sm_manager_ = sm_manager;
+        context_ = context;
+        tab_name_ = std::move(tab_name);
+        TabMeta &tab = sm_manager_->db_.get_table(tab_name_);
+        IndexMeta &index_meta = *tab.get_index_meta(index_col_names);
+        fh_ = sm_manager_->fhs_.at(tab_name_).get();
+        index_ = sm_manager_->get_index(index_meta);
+
+        std::vector<ColMeta> inner_cols = tab.cols;
+        outer_len_ = outer_->tupleLen();
+        inner_len_ = inner_cols.back().offset + inner_cols.back().len;
+        len_ = outer_len_ + inner_len_;
+        inner_conds_ = ResolvedCond::resolve(inner_cols, inner_conds);
+
+        outer_offset_ = inner_left ? inner_len_ : 0;
+        inner_offset_ = inner_left ? 0 : outer_len_;
+        std::vector<ColMeta> outer_cols = outer_->cols();
+        for (auto &col : outer_cols) {
+            col.offset += outer_offset_;
+        }
+        for (auto &col : inner_cols) {
+            col.offset += inner_offset_;
+        }
+        cols_ = inner_left ? inner_cols : outer_cols;
+        auto &right_cols = inner_left ? outer_cols : inner_cols;
+        cols_.insert(cols_.end(), right_cols.begin(), right_cols.end());
+
+        // 为索引的每个字段找一个等值连接条件，用来拼key，其余条件对连接后的元组判断
+        fed_conds_ = std::move(conds);
+        std::vector<bool> used(fed_conds_.size(), false);
+        for (auto &index_col : index_meta.cols) {
+            for (size_t i = 0; i < fed_conds_.size(); i++) {
+                auto &cond = fed_conds_[i];
+                if (used[i] || cond.is_rhs_val || cond.op != OP_EQ) {
+                    continue;
+                }
+                const TabCol *outer_col = nullptr;
+                if (cond.lhs_col.tab_name == tab_name_ && cond.lhs_col.col_name == index_col.name) {
+                    outer_col = &cond.rhs_col;
+                } else if (cond.rhs_col.tab_name == tab_name_ && cond.rhs_col.col_name == index_col.name) {
+                    outer_col = &cond.lhs_col;
+                }
+                if (outer_col == nullptr || outer_col->tab_name == tab_name_) {
+                    continue;
+                }
+                auto col = get_col(cols_, *outer_col);
+                assert(col->type == index_col.type && col->len == index_col.len);
+                key_offs_.push_back(col->offset - outer_offset_);
+                key_lens_.push_back(col->len);
+                used[i] = true;
+                break;
+            }
+        }
+        assert(key_offs_.size() == index_meta.cols.size());
+        std::vector<Condition> residual;
+        for (size_t i = 0; i < fed_conds_.size(); i++) {
+            if (!used[i]) {
+                residual.push_back(fed_conds_[i]);
+            }
+        }
+        residual_conds_ = ResolvedCond::resolve(cols_, residual);
+
+        key_.resize(index_meta.col_tot_len);
+        joined_.resize(len_);
+
+        if(context)
+        {
+            context->lock_mgr_->lock_shared_on_table(context->txn_, fh_->GetFd());
+        }
+    }
+
+    bool is_end() const override { return is_end_; }
+
+    size_t tupleLen() const override { return len_; }
+
+    const std::vector<ColMeta> &cols() const override { return cols_; }
+
+    std::string getType() override { return "IndexNestedLoopJoinExecutor"; }
+
+    void beginTuple() override {
+        is_end_ = false;
+        rids_.clear();
+        rid_pos_ = 0;
+        outer_in_.begin(outer_.get());
+        if (!outer_in_.is_end()) {
+            probe();
+        }
+        find_next();
+    }
+
+    void nextTuple() override {
+        assert(!is_end());
+        find_next();
+    }
+
+    std::unique_ptr<RmRecord> Next() override {
+        assert(!is_end());
+        auto record = std::make_unique<RmRecord>(len_);
+        memcpy(record->data, joined_.data(), len_);
+        return record;
+    }
+
+    /**
+     * @brief 连续查找连接结果直接放入batch，不为每个元组分配记录
+     */
+    bool next_batch(TupleBatch *batch) override {
+        batch->reset(len_);
+        for (; !is_end_ && !batch->full(); find_next()) {
+            batch->append(joined_.data());
+        }
+        return !batch->empty();
+    }
+
+    Rid &rid() override { return _abstract_rid; }
+
+   private:
+    /**
+     * @brief 读入当前外层元组，用它的字段值拼出key在索引中查找
+     */
+    void probe() {
+        const char *rec = outer_in_.get();
+        memcpy(joined_.data() + outer_offset_, rec, outer_len_);
+        char *key = key_.data();
+        for (size_t i = 0; i < key_offs_.size(); i++) {
+            memcpy(key, rec + key_offs_[i], key_lens_[i]);
+            key += key_lens_[i];
+        }
+        rids_.clear();
+        rid_pos_ = 0;
+        index_->get_value(key_.data(), &rids_, context_ ? context_->txn_ : nullptr);
+    }
+
+    /**
+     * @brief 依次取出当前外层元组查到的内层元组，直到满足所有条件；查到的都取完后换到下一个外层元组
+     */
+    void find_next() {
+        while (true) {
+            while (rid_pos_ < rids_.size()) {
+                auto rec = fh_->get_record(rids_[rid_pos_++], context_);
+                if (!ResolvedCond::eval_all(inner_conds_, rec->data)) {
+                    continue;
+                }
+                memcpy(joined_.data() + inner_offset_, rec->data, inner_len_);
+                if (ResolvedCond::eval_all(residual_conds_, joined_.data())) {
+                    return;
+                }
+            }
+            if (outer_in_.is_end()) {
+                is_end_ = true;
+                return;
+            }
+            outer_in_.next();
+            if (outer_in_.is_end()) {
+                is_end_ = true;
+                return;
+            }
+            probe();
+        }
+    }
+};
@@ -10,8 +10,10 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include "execution_conds.h"
 #include "execution_defs.h"
 #include "execution_manager.h"
+#include "execution_index_range.h"
 #include "executor_abstract.h"
 #include "index/ix.h"
 #include "system/sm.h"
@@ -28,15 +30,26 @@ class IndexScanExecutor : public AbstractExecutor {
 
     std::vector<std::string> index_col_names_;  // index scan涉及到的索引包含的字段
     IndexMeta index_meta_;                      // index scan涉及到的索引元数据
+    IxIndexHandle *ih_ = nullptr;               // index scan涉及到的B+树索引，哈希索引时为nullptr
+    IxIndex *index_;                            // 点查询使用的索引，B+树或哈希索引
+    IndexRange range_;                          // 由扫描条件推出的key范围
+    std::vector<Condition> residual_conds_;     // 范围之外还需要对取出的元组判断的条件
+    std::vector<ResolvedCond> resolved_conds_;  // 编译好的residual_conds_
+    bool covering_;                             // 只读索引：需要的字段都在索引key中，元组按key的格式直接由叶子结点给出
+    bool probe_;                                // 点查询：只查找一次key，依次取出得到的元组（唯一索引上最多一个）
+    std::vector<Rid> probe_rids_;               // 点查询得到的rid
+    size_t probe_pos_ = 0;                      // 点查询当前取到的位置
 
     Rid rid_;
-    std::unique_ptr<RecScan> scan_;
+    std::unique_ptr<IxScan> scan_;
 
     SmManager *sm_manager_;
 
    public:
     IndexScanExecutor(SmManager *sm_manager, std::string tab_name, std::vector<Condition> conds, std::vector<std::string> index_col_names,
-                    Context *context) {
+                    Context *context, bool covering = false)
+        : range_(sm_manager->db_.get_table(tab_name).get_index_meta(index_col_names)[0], tab_name,
+                 swap_conds(conds, tab_name)), covering_(covering) {
         sm_manager_ = sm_manager;
         context_ = context;
         tab_name_ = std::move(tab_name);
@@ -46,125 +59,141 @@ class IndexScanExecutor : public AbstractExecutor {
         index_col_names_ = index_col_names; 
         index_meta_ = *(tab_.get_index_meta(index_col_names_));
         fh_ = sm_manager_->fhs_.at(tab_name_).get();
-        cols_ = tab_.cols;
-        len_ = cols_.back().offset + cols_.back().len;
+        index_ = sm_manager_->get_index(index_meta_);
+        if (index_meta_.type == INDEX_BTREE) {
+            ih_ = sm_manager_->ihs_.at(sm_manager_->get_ix_manager()->get_index_name(tab_name_, index_col_names_)).get();
+        }
+        if (covering_) {
+            // 输出的元组就是索引的key，字段的offset按key中的位置重新计算
+            cols_ = index_meta_.cols;
+            len_ = 0;
+            for (auto &col : cols_) {
+                col.offset = len_;
+                len_ += col.len;
+            }
+        } else {
+            cols_ = tab_.cols;
+            len_ = cols_.back().offset + cols_.back().len;
+        }
+        conds_ = swap_conds(conds_, tab_name_);
+        fed_conds_ = conds_;
+        residual_conds_ = range_.residual_conds();
+        resolved_conds_ = ResolvedCond::resolve(cols_, residual_conds_);
+        // 哈希索引只会被用于所有索引字段上的等值查询
+        probe_ = (index_meta_.unique && range_.is_point()) || index_meta_.type == INDEX_HASH;
+        assert(!probe_ || range_.is_point());
+
+        if(context)
+        {
+            context->lock_mgr_->lock_shared_on_table(context->txn_, fh_->GetFd());
+        }
+    }
+
+    /**
+     * @brief 把条件统一成左边是本表字段的形式
+     */
+    static std::vector<Condition> swap_conds(std::vector<Condition> conds, const std::string &tab_name) {
         std::map<CompOp, CompOp> swap_op = {
             {OP_EQ, OP_EQ}, {OP_NE, OP_NE}, {OP_LT, OP_GT}, {OP_GT, OP_LT}, {OP_LE, OP_GE}, {OP_GE, OP_LE},
         };
-
-        for (auto &cond : conds_) {
-            if (cond.lhs_col.tab_name != tab_name_) {
+        for (auto &cond : conds) {
+            if (cond.lhs_col.tab_name != tab_name) {
                 // lhs is on other table, now rhs must be on this table
-                assert(!cond.is_rhs_val && cond.rhs_col.tab_name == tab_name_);
+                assert(!cond.is_rhs_val && cond.rhs_col.tab_name == tab_name);
                 // swap lhs and rhs
                 std::swap(cond.lhs_col, cond.rhs_col);
                 cond.op = swap_op.at(cond.op);
             }
         }
-        fed_conds_ = conds_;
-
-        if(context)
-        {
-            context->lock_mgr_->lock_shared_on_table(context->txn_, fh_->GetFd());
-        }
+        return conds;
     }
 
+    bool is_end() const override { return probe_ ? probe_pos_ >= probe_rids_.size() : scan_->is_end(); }
+
+    size_t tupleLen() const override { return len_; }
+
+    const std::vector<ColMeta> &cols() const override { return cols_; }
+
+    RmFileHandle* get_fh() const override { return fh_; }
+
+    /**
+     * @brief 根据扫描条件确定叶子结点上的起止位置[lower, upper)，沿叶子链表扫描，直到第一个满足剩余条件的元组；
+     * 点查询只查找一次key
+     */
     void beginTuple() override {
-        // auto ih = sm_manager_->ihs_.at(sm_manager_->get_ix_manager()->get_index_name(tab_name_, index_col_names_)).get();
-        // auto lower_leaf = ih->leaf_begin();
-        // auto upper_leaf = ih->leaf_end();
-        
-        // //如果条件是在建立索引的列上，那么可以采用区间查询
-        // for(auto &cond : fed_conds_)
-        // {
-        //     if(index_established(cond.lhs_col))
-        // }
+        if (probe_) {
+            probe_rids_.clear();
+            probe_pos_ = 0;
+            if (!range_.is_empty()) {
+                index_->get_value(range_.point_key(), &probe_rids_, context_ ? context_->txn_ : nullptr);
+            }
+            find_next_probe();
+            return;
+        }
+        Iid lower = range_.lower(ih_);
+        Iid upper = range_.is_empty() ? lower : range_.upper(ih_);
+        scan_ = std::make_unique<IxScan>(ih_, lower, upper, sm_manager_->get_bpm());
+        find_next();
     }
 
+    /**
+     * @brief 从下一个索引项开始，找到第一个满足剩余条件的元组
+     */
     void nextTuple() override {
-        
+        assert(!is_end());
+        if (probe_) {
+            probe_pos_++;
+            find_next_probe();
+            return;
+        }
+        scan_->next();
+        find_next();
     }
 
     std::unique_ptr<RmRecord> Next() override {
-        return nullptr;
+        assert(!is_end());
+        return fetch_tuple();
     }
 
     Rid &rid() override { return rid_; }
 
     /**
-    * @description: 判断元组是否满足单个谓词条件
-    * @return {bool} true: 满足 , false: 不满足 
-    * @param {std::vector<ColMeta> &} rec_cols scan后生成的记录的字段
-    * @param {Condition &} cond 谓词条件
-    * @param {RmRecord *} rec scan后生成的记录
-    */
-    bool eval_cond(const std::vector<ColMeta> &rec_cols, const Condition &cond, const RmRecord *rec)
-    {
-        //需判断左侧字段是否有效和右侧值是否有效，根据测试文件得出
-
-
-        //找到谓词条件中的那个字段（get_col函数可以检查左侧字段是否有效）
-        auto lhs_col = get_col(rec_cols, cond.lhs_col);
-
-        //得到该字段对应的值
-        char *lhs = rec->data + lhs_col->offset;
-
-        //条件右侧的类型
-        ColType rhs_type;
-        //条件右侧的值
-        char *rhs;
-
-        //判断条件右侧
-        if(cond.is_rhs_val)//如果条件右端是值
-        {
-            rhs_type = cond.rhs_val.type;//条件右侧的类型
-            rhs = cond.rhs_val.raw->data;//条件右侧的值
-        }
-        else//如果条件右端是列名
-        {
-            auto rhs_col = get_col(rec_cols, cond.rhs_col);
-            rhs_type = rhs_col->type;
-            rhs = cond.rhs_val.raw->data;//此处可能有问题
+     * @brief 取出scan_当前位置的元组：只读索引时由key拼出，不访问表的数据文件
+     */
+    std::unique_ptr<RmRecord> fetch_tuple() {
+        if (covering_) {
+            auto rec = std::make_unique<RmRecord>(len_);
+            if (probe_) {
+                memcpy(rec->data, range_.point_key(), len_);
+            } else {
+                scan_->key(rec->data);
+            }
+            return rec;
         }
-
-        //判断左侧字段是否满足条件
-        int result = ix_compare(lhs, rhs, rhs_type, lhs_col->len);//比较左侧和右侧值的大小
-        if(cond.op == OP_EQ)
-            return result == 0;
-        else if(cond.op == OP_NE)
-            return result != 0;
-        else if(cond.op == OP_LT)
-            return result < 0;
-        else if(cond.op == OP_GT)
-            return result > 0;
-        else if(cond.op == OP_LE)
-            return result <= 0;
-        else if (cond.op == OP_GE)
-            return result >= 0;
-
+        return fh_->get_record(rid_, context_);
     }
 
     /**
-    * @description: 判断元组是否满足所有谓词条件
-    * @return {bool} true: 满足 , false: 不满足 
-    * @param {std::vector<ColMeta> &} rec_cols scan后生成的记录的字段
-    * @param {std::vector<Condition> &} conds 谓词条件
-    * @param {RmRecord *} rec scan后生成的记录
-    */
-    bool eval_conds(const std::vector<ColMeta> &rec_cols, const std::vector<Condition> &conds, const RmRecord *rec)
-    {
-        for(auto &cond: conds)
-        {
-            if(eval_cond(rec_cols, cond, rec))
-                continue;
-            else
-                return false;
+     * @brief 从scan_当前位置开始，跳过不满足剩余条件的元组；范围条件已经由索引保证，不再判断
+     */
+    void find_next() {
+        for (; !scan_->is_end(); scan_->next()) {
+            rid_ = scan_->rid();
+            if (resolved_conds_.empty() || ResolvedCond::eval_all(resolved_conds_, fetch_tuple()->data)) {
+                break;
+            }
         }
-        return true;
     }
 
-    bool index_established(TabCol target)
-    {
-        return get_col(tab_.cols, target)->index;
+    /**
+     * @brief 从probe_pos_开始，跳过点查询得到的不满足剩余条件的元组
+     */
+    void find_next_probe() {
+        for (; probe_pos_ < probe_rids_.size(); probe_pos_++) {
+            rid_ = probe_rids_[probe_pos_];
+            if (resolved_conds_.empty() || ResolvedCond::eval_all(resolved_conds_, fetch_tuple()->data)) {
+                break;
+            }
+        }
     }
-};
\ No newline at end of file
+};
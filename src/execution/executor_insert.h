@@ -57,21 +57,41 @@ class InsertExecutor : public AbstractExecutor {
         // Insert into record file
         rid_ = fh_->insert_record(rec.data, context_);
 
-        // record a update operation into the transaction
-        WriteRecord* wr = new WriteRecord(WType::INSERT_TUPLE, tab_name_, rid_);
-        context_->txn_->append_write_record(wr);
-        
         // Insert into index
+        // 唯一索引在插入时发现key已存在，撤销已经插入的索引项和记录，语句失败
+        std::vector<std::pair<size_t, std::vector<char>>> inserted;    // (索引, key)
         for(size_t i = 0; i < tab_.indexes.size(); ++i) {
             auto& index = tab_.indexes[i];
-            auto ih = sm_manager_->ihs_.at(sm_manager_->get_ix_manager()->get_index_name(tab_name_, index.cols)).get();
-            char* key = new char[index.col_tot_len];
+            auto ih = sm_manager_->get_index(index);
+            std::vector<char> key(index.col_tot_len);
             int offset = 0;
             for(size_t i = 0; i < index.col_num; ++i) {
-                memcpy(key + offset, rec.data + index.cols[i].offset, index.cols[i].len);
+                memcpy(key.data() + offset, rec.data + index.cols[i].offset, index.cols[i].len);
                 offset += index.cols[i].len;
             }
-            ih->insert_entry(key, rid_, context_->txn_);
+            if (ih->insert_entry(key.data(), rid_, context_->txn_) != IX_NO_PAGE) {
+                inserted.emplace_back(i, std::move(key));
+            } else if (index.unique) {
+                for (auto &[j, prev_key] : inserted) {
+                    sm_manager_->get_index(tab_.indexes[j])->delete_entry(prev_key.data(), rid_, context_->txn_);
+                }
+                fh_->delete_record(rid_, context_);
+                std::vector<std::string> col_names;
+                for (auto &col : index.cols) {
+                    col_names.push_back(col.name);
+                }
+                throw UniqueConstraintError(tab_name_, col_names);
+            }
+        }
+
+        // record a update operation into the transaction
+        WriteRecord* wr = new WriteRecord(WType::INSERT_TUPLE, tab_name_, rid_);
+        context_->txn_->append_write_record(wr);
+        // record the inserted entries so that abort removes them
+        for (auto &[i, key] : inserted) {
+            context_->txn_->append_write_record(new WriteRecord(WType::INSERT_ENTRY, tab_name_, rid_,
+                                                                RmRecord(key.size(), key.data()),
+                                                                tab_.indexes[i].col_names()));
         }
         return nullptr;
     }
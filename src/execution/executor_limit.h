@@ -0,0 +1,69 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "execution_defs.h"
+#include "execution_manager.h"
+#include "executor_abstract.h"
+#include "index/ix.h"
+#include "system/sm.h"
+
+/**
+ * LIMIT/OFFSET：跳过前offset个元组，最多输出limit个；输出够limit个后不再向子节点要下一个元组，
+ * 子节点（例如扫描）随之提前停止
+ */
+class LimitExecutor : public AbstractExecutor {
+   private:
+    std::unique_ptr<AbstractExecutor> prev_;
+    size_t limit_;                              // 最多输出的元组数量
+    size_t offset_;                             // 跳过的元组数量
+    size_t count_ = 0;                          // 已经输出的元组数量
+
+   public:
+    LimitExecutor(std::unique_ptr<AbstractExecutor> prev, size_t limit, size_t offset) {
+        prev_ = std::move(prev);
+        limit_ = limit;
+        offset_ = offset;
+    }
+
+    bool is_end() const override { return count_ >= limit_ || prev_->is_end(); }
+
+    size_t tupleLen() const override { return prev_->tupleLen(); }
+
+    const std::vector<ColMeta> &cols() const override { return prev_->cols(); }
+
+    std::string getType() override { return "LimitExecutor"; }
+
+    void beginTuple() override {
+        count_ = 0;
+        if (limit_ == 0) {
+            return;
+        }
+        prev_->beginTuple();
+        for (size_t i = 0; i < offset_ && !prev_->is_end(); i++) {
+            prev_->nextTuple();
+        }
+    }
+
+    void nextTuple() override {
+        assert(!is_end());
+        if (++count_ < limit_) {
+            prev_->nextTuple();
+        }
+    }
+
+    std::unique_ptr<RmRecord> Next() override {
+        assert(!is_end());
+        return prev_->Next();
+    }
+
+    Rid &rid() override { return prev_->rid(); }
+};
@@ -0,0 +1,200 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "execution_conds.h"
+#include "execution_defs.h"
+#include "execution_manager.h"
+#include "executor_abstract.h"
+#include "index/ix.h"
+#include "system/sm.h"
+
+/**
+ * 归并连接：两侧输入都已经按连接key升序排列（例如在key上的索引扫描），同时向前扫描一遍两侧完成连接
+ * 右侧key相同的一段元组缓存在内存中，左侧key相同的每个元组都与这一段连接
+ * 输出的元组是左侧元组拼接右侧元组，按key升序排列
+ */
+class MergeJoinExecutor : public AbstractExecutor {
+   private:
+    std::unique_ptr<AbstractExecutor> left_;    // 左儿子节点（需要join的表）
+    std::unique_ptr<AbstractExecutor> right_;   // 右儿子节点（需要join的表）
+    BatchReader left_in_;                       // 按批读取左侧
+    BatchReader right_in_;                      // 按批读取右侧
+    size_t len_;                                // join后获得的每条记录的长度
+    std::vector<ColMeta> cols_;                 // join后获得的记录的字段
+    std::vector<Condition> fed_conds_;          // join条件，第一个是两侧输入排序所按的等值条件
+
+    size_t left_len_;
+    size_t right_len_;
+    int left_key_off_;                          // key在左侧元组中的位置
+    int right_key_off_;                         // key在右侧元组中的位置
+    IxKeyComparator key_cmp_;
+    std::vector<ResolvedCond> residual_conds_;  // 其余的连接条件，对连接后的元组判断
+
+    std::vector<char> joined_;                  // 当前输出的元组，左半部分是当前左侧元组
+    bool has_left_ = false;                     // 左侧是否还有元组
+    std::vector<char> run_;                     // 右侧key相同的一段元组
+    size_t run_size_ = 0;
+    size_t run_pos_ = 0;                        // 当前左侧元组接下来要连接的段中元组
+    bool run_valid_ = false;                    // run_是否对应某个左侧元组的key
+    std::vector<char> run_key_;
+    bool is_end_ = true;
+
+   public:
+    /**
+     * @param conds 连接条件，第一个必须是两侧类型和长度都相同的等值条件，两侧输入都按它的字段升序排列
+     */
+    MergeJoinExecutor(std::unique_ptr<AbstractExecutor> left, std::unique_ptr<AbstractExecutor> right,
+                      std::vector<Condition> conds) {
+        left_ = std::move(left);
+        right_ = std::move(right);
+        left_len_ = left_->tupleLen();
+        right_len_ = right_->tupleLen();
+        len_ = left_len_ + right_len_;
+        cols_ = left_->cols();
+        auto right_cols = right_->cols();
+        for (auto &col : right_cols) {
+            col.offset += left_len_;
+        }
+        cols_.insert(cols_.end(), right_cols.begin(), right_cols.end());
+        fed_conds_ = std::move(conds);
+
+        assert(!fed_conds_.empty() && fed_conds_[0].op == OP_EQ && !fed_conds_[0].is_rhs_val);
+        auto lhs_col = get_col(cols_, fed_conds_[0].lhs_col);
+        auto rhs_col = get_col(cols_, fed_conds_[0].rhs_col);
+        if (lhs_col->offset > rhs_col->offset) {
+            std::swap(lhs_col, rhs_col);
+        }
+        assert(lhs_col->type == rhs_col->type && lhs_col->len == rhs_col->len);
+        left_key_off_ = lhs_col->offset;
+        right_key_off_ = rhs_col->offset - left_len_;
+        key_cmp_ = IxKeyComparator({lhs_col->type}, {lhs_col->len});
+        residual_conds_ = ResolvedCond::resolve(cols_, std::vector<Condition>(fed_conds_.begin() + 1, fed_conds_.end()));
+
+        joined_.resize(len_);
+        run_key_.resize(lhs_col->len);
+    }
+
+    bool is_end() const override { return is_end_; }
+
+    size_t tupleLen() const override { return len_; }
+
+    const std::vector<ColMeta> &cols() const override { return cols_; }
+
+    std::string getType() override { return "MergeJoinExecutor"; }
+
+    void beginTuple() override {
+        is_end_ = false;
+        run_valid_ = false;
+        left_in_.begin(left_.get());
+        right_in_.begin(right_.get());
+        load_left();
+        find_next();
+    }
+
+    void nextTuple() override {
+        assert(!is_end());
+        find_next();
+    }
+
+    std::unique_ptr<RmRecord> Next() override {
+        assert(!is_end());
+        auto record = std::make_unique<RmRecord>(len_);
+        memcpy(record->data, joined_.data(), len_);
+        return record;
+    }
+
+    /**
+     * @brief 连续查找连接结果直接放入batch，不为每个元组分配记录
+     */
+    bool next_batch(TupleBatch *batch) override {
+        batch->reset(len_);
+        for (; !is_end_ && !batch->full(); find_next()) {
+            batch->append(joined_.data());
+        }
+        return !batch->empty();
+    }
+
+    Rid &rid() override { return _abstract_rid; }
+
+   private:
+    const char *left_key() const { return joined_.data() + left_key_off_; }
+
+    void load_left() {
+        has_left_ = !left_in_.is_end();
+        if (has_left_) {
+            memcpy(joined_.data(), left_in_.get(), left_len_);
+        }
+    }
+
+    void advance_left() {
+        left_in_.next();
+        load_left();
+    }
+
+    /**
+     * @brief 从右侧当前位置开始，读入key等于run_key_的一段元组，之后右侧停在下一个key上
+     */
+    void load_run() {
+        memcpy(run_key_.data(), right_in_.get() + right_key_off_, run_key_.size());
+        run_.clear();
+        run_size_ = 0;
+        do {
+            run_.insert(run_.end(), right_in_.get(), right_in_.get() + right_len_);
+            run_size_++;
+            right_in_.next();
+        } while (!right_in_.is_end() && key_cmp_(right_in_.get() + right_key_off_, run_key_.data()) == 0);
+        run_pos_ = 0;
+        run_valid_ = true;
+    }
+
+    /**
+     * @brief 当前左侧元组与key相同的右侧段中的元组依次连接；段连接完后取下一个左侧元组，
+     * key与段相同时重新从段的开头连接，否则两侧交替前进到key相等的位置并读入新的段
+     */
+    void find_next() {
+        while (true) {
+            if (!has_left_) {
+                is_end_ = true;
+                return;
+            }
+            if (run_valid_ && key_cmp_(left_key(), run_key_.data()) == 0) {
+                while (run_pos_ < run_size_) {
+                    memcpy(joined_.data() + left_len_, run_.data() + run_pos_ * right_len_, right_len_);
+                    run_pos_++;
+                    if (ResolvedCond::eval_all(residual_conds_, joined_.data())) {
+                        return;
+                    }
+                }
+                advance_left();
+                run_pos_ = 0;
+                continue;
+            }
+            run_valid_ = false;
+            int result = 0;
+            for (; !right_in_.is_end(); right_in_.next()) {
+                result = key_cmp_(right_in_.get() + right_key_off_, left_key());
+                if (result >= 0) {
+                    break;
+                }
+            }
+            if (right_in_.is_end()) {
+                is_end_ = true;
+                return;
+            }
+            if (result > 0) {
+                advance_left();
+                continue;
+            }
+            load_run();
+        }
+    }
+};
@@ -9,25 +9,44 @@ MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
 See the Mulan PSL v2 for more details. */
 
 #pragma once
+#include "execution_conds.h"
 #include "execution_defs.h"
 #include "execution_manager.h"
 #include "executor_abstract.h"
 #include "index/ix.h"
 #include "system/sm.h"
 
+/**
+ * 块嵌套循环连接：每次读入不超过内存预算的一块左侧（外层）元组，对这一块只扫描一遍右侧（内层），
+ * 内层扫描次数从外层元组数减少到块数；用于不能使用哈希连接的非等值连接和笛卡尔积
+ */
 class NestedLoopJoinExecutor : public AbstractExecutor {
    private:
     std::unique_ptr<AbstractExecutor> left_;    // 左儿子节点（需要join的表）
     std::unique_ptr<AbstractExecutor> right_;   // 右儿子节点（需要join的表）
+    BatchReader left_in_;                       // 按批读取外层
+    BatchReader right_in_;                      // 按批读取内层
     size_t len_;                                // join后获得的每条记录的长度
     std::vector<ColMeta> cols_;                 // join后获得的记录的字段
 
     std::vector<Condition> fed_conds_;          // join条件
-    bool isend;
+    std::vector<ResolvedCond> conds_;           // 构造时确定了字段位置的join条件，对连接后的元组判断
+    size_t left_len_;
+    size_t right_len_;
+    size_t max_block_tuples_;                   // 一块中最多容纳的外层元组数量
+
+    std::vector<char> block_;                   // 当前块中的外层元组
+    size_t block_size_ = 0;
+    size_t block_pos_ = 0;                      // 当前内层元组接下来要连接的外层元组
+    std::vector<char> joined_;                  // 当前输出的元组，右半部分是当前内层元组
+    bool is_end_ = true;
 
    public:
+    /**
+     * @param mem_budget 一块外层元组可使用的内存大小(字节)
+     */
     NestedLoopJoinExecutor(std::unique_ptr<AbstractExecutor> left, std::unique_ptr<AbstractExecutor> right, 
-                            std::vector<Condition> conds) {
+                            std::vector<Condition> conds, size_t mem_budget = NLJ_BLOCK_MEM_BUDGET) {
         left_ = std::move(left);
         right_ = std::move(right);
         len_ = left_->tupleLen() + right_->tupleLen();
@@ -38,134 +57,105 @@ class NestedLoopJoinExecutor : public AbstractExecutor {
         }
 
         cols_.insert(cols_.end(), right_cols.begin(), right_cols.end());
-        isend = false;
         fed_conds_ = std::move(conds);
+        conds_ = ResolvedCond::resolve(cols_, fed_conds_);
 
+        left_len_ = left_->tupleLen();
+        right_len_ = right_->tupleLen();
+        max_block_tuples_ = std::max<size_t>(1, mem_budget / left_len_);
+        joined_.resize(len_);
     }
 
-    bool is_end() const override { return left_->is_end(); }
+    bool is_end() const override { return is_end_; }
 
     size_t tupleLen() const override { return len_; }
 
     const std::vector<ColMeta> &cols() const override { return cols_; }
 
+    std::string getType() override { return "NestedLoopJoinExecutor"; }
+
     void beginTuple() override {
-        left_->beginTuple();
-        right_->beginTuple();
-        while(!is_end())
-        {
-            if(eval_conds(cols_, fed_conds_, left_->Next().get(), right_->Next().get()))
-                break;
-            right_->nextTuple();
-            if(right_->is_end())
-            {
-                left_->nextTuple();
-                right_->beginTuple();
-            }
+        is_end_ = false;
+        left_in_.begin(left_.get());
+        if (!next_block()) {
+            return;
         }
-
+        find_next();
     }
 
     void nextTuple() override {
-        right_->nextTuple();
-        if(right_->is_end())
-        {
-            left_->nextTuple();
-            right_->beginTuple();
-        }
-        while(!is_end())
-        {
-            if(eval_conds(cols_, fed_conds_, left_->Next().get(), right_->Next().get()))
-                break;
-            right_->nextTuple();
-            if(right_->is_end())
-            {
-                left_->nextTuple();
-                right_->beginTuple();
-            }
-        }
+        assert(!is_end());
+        find_next();
     }
 
     std::unique_ptr<RmRecord> Next() override {
+        assert(!is_end());
         auto record = std::make_unique<RmRecord>(len_);
-        auto left_rec = left_->Next();
-        auto right_rec = right_->Next();
-
-        memcpy(record->data, left_rec->data, left_rec->size);
-        memcpy(record->data + left_rec->size, right_rec->data, right_rec->size);
+        memcpy(record->data, joined_.data(), len_);
         return record;
     }
 
+    /**
+     * @brief 连续查找连接结果直接放入batch，不为每个元组分配记录
+     */
+    bool next_batch(TupleBatch *batch) override {
+        batch->reset(len_);
+        for (; !is_end_ && !batch->full(); find_next()) {
+            batch->append(joined_.data());
+        }
+        return !batch->empty();
+    }
+
     Rid &rid() override { return _abstract_rid; }
 
+   private:
     /**
-    * @description: 判断左面的元组和右面的元组是否满足连接条件
-    * @return {bool} true: 满足 , false: 不满足 
-    * @param {std::vector<ColMeta> &} rec_cols 连接后的元组的字段
-    * @param {Condition &} cond 谓词条件
-    * @param {RmRecord *} lrec 左元组的记录
-    * @param {RmRecord *} rrec 右元组的记录
-    */
-    bool eval_cond(const std::vector<ColMeta> &rec_cols, const Condition &cond, const RmRecord *lrec, const RmRecord *rrec)
-    {
-        //找到连接条件中左侧的字段（get_col函数可以检查左侧字段是否有效）
-        auto lhs_col = get_col(rec_cols, cond.lhs_col);
-
-        //得到该字段对应的值
-        char *lhs = lrec->data + lhs_col->offset;
-
-        //条件右侧的类型
-        ColType rhs_type;
-        //条件右侧的值
-        char *rhs;
-
-        //判断条件右侧
-        if(cond.is_rhs_val)//如果条件右端是值
-        {
-            rhs_type = cond.rhs_val.type;//条件右侧的类型
-            rhs = cond.rhs_val.raw->data;//条件右侧的值
+     * @brief 读入下一块外层元组，并从头扫描内层
+     * @return 是否还有要连接的元组；外层读完或者内层为空时置为结束
+     */
+    bool next_block() {
+        block_.clear();
+        block_size_ = 0;
+        for (; !left_in_.is_end() && block_size_ < max_block_tuples_; left_in_.next()) {
+            block_.insert(block_.end(), left_in_.get(), left_in_.get() + left_len_);
+            block_size_++;
         }
-        else//如果条件右端是列名
-        {
-            auto rhs_col = get_col(rec_cols, cond.rhs_col);
-            rhs_type = rhs_col->type;
-            rhs = rrec->data + rhs_col->offset - left_->tupleLen();//条件右端列的值
+        if (block_size_ == 0) {
+            is_end_ = true;
+            return false;
         }
+        right_in_.begin(right_.get());
+        if (right_in_.is_end()) {
+            is_end_ = true;
+            return false;
+        }
+        load_inner();
+        return true;
+    }
 
-        //判断是否满足连接条件
-        int result = ix_compare(lhs, rhs, rhs_type, lhs_col->len);//比较左侧和右侧值的大小
-        if(cond.op == OP_EQ)
-            return result == 0;
-        else if(cond.op == OP_NE)
-            return result != 0;
-        else if(cond.op == OP_LT)
-            return result < 0;
-        else if(cond.op == OP_GT)
-            return result > 0;
-        else if(cond.op == OP_LE)
-            return result <= 0;
-        else if (cond.op == OP_GE)
-            return result >= 0;
-
+    void load_inner() {
+        memcpy(joined_.data() + left_len_, right_in_.get(), right_len_);
+        block_pos_ = 0;
     }
 
     /**
-    * @description: 判断元组是否满足所有谓词条件
-    * @return {bool} true: 满足 , false: 不满足 
-    * @param {std::vector<ColMeta> &} rec_cols 连接后的元组的字段
-    * @param {Condition &} cond 谓词条件
-    * @param {RmRecord *} lrec 左元组的记录
-    * @param {RmRecord *} rrec 右元组的记录
-    */
-    bool eval_conds(const std::vector<ColMeta> &rec_cols, const std::vector<Condition> &conds, const RmRecord *lrec, const RmRecord *rrec)
-    {
-        for(auto &cond: conds)
-        {
-            if(eval_cond(rec_cols, cond, lrec, rrec))
-                continue;
-            else
-                return false;
+     * @brief 当前内层元组依次与块中的外层元组连接，块中的都连接过后换到下一个内层元组，内层读完后换到下一块
+     */
+    void find_next() {
+        while (true) {
+            while (block_pos_ < block_size_) {
+                memcpy(joined_.data(), block_.data() + block_pos_ * left_len_, left_len_);
+                block_pos_++;
+                if (ResolvedCond::eval_all(conds_, joined_.data())) {
+                    return;
+                }
+            }
+            right_in_.next();
+            if (!right_in_.is_end()) {
+                load_inner();
+            } else if (!next_block()) {
+                return;
+            }
         }
-        return true;
     }
-};
\ No newline at end of file
+};
@@ -21,6 +21,7 @@ class ProjectionExecutor : public AbstractExecutor {
     std::vector<ColMeta> cols_;                     // 需要投影的字段
     size_t len_;                                    // 字段总长度
     std::vector<size_t> sel_idxs_;                  
+    TupleBatch prev_batch_;                         // 按批读取时儿子节点的一批元组
 
    public:
     ProjectionExecutor(std::unique_ptr<AbstractExecutor> prev, const std::vector<TabCol> &sel_cols) {
@@ -75,5 +76,25 @@ class ProjectionExecutor : public AbstractExecutor {
         return proj_rec;
     }
 
+    /**
+     * @brief 读入儿子节点的一批元组，把其中的有效元组逐个投影到batch中
+     */
+    bool next_batch(TupleBatch *batch) override {
+        batch->reset(len_);
+        if (!prev_->next_batch(&prev_batch_)) {
+            return false;
+        }
+        auto &prev_cols = prev_->cols();
+        for (size_t i = 0; i < prev_batch_.size(); i++) {
+            const char *prev_tuple = prev_batch_.get(i);
+            char *proj_tuple = batch->append();
+            for (size_t proj_idx = 0; proj_idx < cols_.size(); proj_idx++) {
+                auto &prev_col = prev_cols[sel_idxs_[proj_idx]];
+                memcpy(proj_tuple + cols_[proj_idx].offset, prev_tuple + prev_col.offset, prev_col.len);
+            }
+        }
+        return true;
+    }
+
     Rid &rid() override { return _abstract_rid; }
 };
\ No newline at end of file
@@ -10,8 +10,10 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include "execution_conds.h"
 #include "execution_defs.h"
 #include "execution_manager.h"
+#include "execution_page_filter.h"
 #include "executor_abstract.h"
 #include "index/ix.h"
 #include "system/sm.h"
@@ -28,6 +30,11 @@ class SeqScanExecutor : public AbstractExecutor {
     Rid rid_;
     std::unique_ptr<RecScan> scan_;     // table_iterator
 
+    std::vector<ResolvedCond> resolved_conds_;  // 构造时编译好的条件，判断元组时依次执行
+    PageFilter page_filter_;            // 按批读取时在页面上批量判断的条件
+    std::vector<uint8_t> page_mask_;    // 当前页面的选择掩码
+    Rid batch_rid_;                     // 按批读取时最后读到的位置
+
     SmManager *sm_manager_;
 
    public:
@@ -43,6 +50,8 @@ class SeqScanExecutor : public AbstractExecutor {
         context_ = context;
 
         fed_conds_ = conds_;
+        resolved_conds_ = ResolvedCond::resolve(cols_, fed_conds_);
+        page_filter_ = PageFilter(resolved_conds_);
 
         // if(context)
         // {
@@ -73,13 +82,14 @@ class SeqScanExecutor : public AbstractExecutor {
             rid_ = scan_->rid();
             try {
                 auto rec = fh_->get_record(rid_, context_);
-                if (eval_conds(cols_, fed_conds_, rec.get())) {
+                if (ResolvedCond::eval_all(resolved_conds_, rec->data)) {
                     break;
                 }
             } catch (RecordNotFoundError &e) {
                 std::cerr << e.what() << std::endl;
             }
         }
+        batch_rid_ = scan_->is_end() ? Rid{fh_->get_file_hdr().num_pages, -1} : Rid{rid_.page_no, rid_.slot_no - 1};
     }
 
     /**
@@ -91,7 +101,7 @@ class SeqScanExecutor : public AbstractExecutor {
         {
             rid_ = scan_->rid();//得到元组
             //扫描到第一个谓词条件的元组停止
-            if(eval_conds(cols_, fed_conds_, fh_->get_record(rid_, context_).get()))
+            if(ResolvedCond::eval_all(resolved_conds_, fh_->get_record(rid_, context_)->data))
                 break;
         }
     }
@@ -106,77 +116,62 @@ class SeqScanExecutor : public AbstractExecutor {
         return fh_->get_record(rid_, context_);
     }
 
-    Rid &rid() override { return rid_; }
-
     /**
-    * @description: 判断元组是否满足单个谓词条件
-    * @return {bool} true: 满足 , false: 不满足 
-    * @param {std::vector<ColMeta> &} rec_cols scan后生成的记录的字段
-    * @param {Condition &} cond 谓词条件
-    * @param {RmRecord *} rec scan后生成的记录
-    */
-    bool eval_cond(const std::vector<ColMeta> &rec_cols, const Condition &cond, const RmRecord *rec)
-    {
-        //需判断左侧字段是否有效和右侧值是否有效，根据测试文件得出
-
-
-        //找到谓词条件中的那个字段（get_col函数可以检查左侧字段是否有效）
-        auto lhs_col = get_col(rec_cols, cond.lhs_col);
-
-        //得到该字段对应的值
-        char *lhs = rec->data + lhs_col->offset;
-
-        //条件右侧的类型
-        ColType rhs_type;
-        //条件右侧的值
-        char *rhs;
-
-        //判断条件右侧
-        if(cond.is_rhs_val)//如果条件右端是值
-        {
-            rhs_type = cond.rhs_val.type;//条件右侧的类型
-            rhs = cond.rhs_val.raw->data;//条件右侧的值
-        }
-        else//如果条件右端是列名
-        {
-            auto rhs_col = get_col(rec_cols, cond.rhs_col);
-            rhs_type = rhs_col->type;
-            rhs = cond.rhs_val.raw->data;//此处可能有问题
+     * @brief 按页读取：先在页面上对全部槽批量判断数值条件得到选择掩码，只把选中的元组复制到batch中，
+     * 攒满一批后再判断其余条件，不满足的从选择向量中去掉
+     */
+    bool next_batch(TupleBatch *batch) override {
+        batch->reset(len_);
+        int num_pages = fh_->get_file_hdr().num_pages;
+        while (batch_rid_.page_no < num_pages) {
+            batch->clear();
+            while (!batch->full() && batch_rid_.page_no < num_pages) {
+                read_page(batch);
+            }
+            ResolvedCond::filter(page_filter_.residual_conds(), batch);
+            if (!batch->empty()) {
+                return true;
+            }
         }
-
-        //判断左侧字段是否满足条件
-        int result = ix_compare(lhs, rhs, rhs_type, lhs_col->len);//比较左侧和右侧值的大小
-        if(cond.op == OP_EQ)
-            return result == 0;
-        else if(cond.op == OP_NE)
-            return result != 0;
-        else if(cond.op == OP_LT)
-            return result < 0;
-        else if(cond.op == OP_GT)
-            return result > 0;
-        else if(cond.op == OP_LE)
-            return result <= 0;
-        else if (cond.op == OP_GE)
-            return result >= 0;
-
+        return false;
     }
 
+    Rid &rid() override { return rid_; }
+
+   private:
     /**
-    * @description: 判断元组是否满足所有谓词条件
-    * @return {bool} true: 满足 , false: 不满足 
-    * @param {std::vector<ColMeta> &} rec_cols scan后生成的记录的字段
-    * @param {std::vector<Condition> &} conds 谓词条件
-    * @param {RmRecord *} rec scan后生成的记录
-    */
-    bool eval_conds(const std::vector<ColMeta> &rec_cols, const std::vector<Condition> &conds, const RmRecord *rec)
-    {
-        for(auto &cond: conds)
-        {
-            if(eval_cond(rec_cols, cond, rec))
-                continue;
-            else
-                return false;
+     * @brief 从batch_rid_之后开始，把当前页面上选中的元组复制到batch中，直到batch满或者页面读完
+     */
+    void read_page(TupleBatch *batch) {
+        RmFileHdr file_hdr = fh_->get_file_hdr();
+        RmPageHandle page_handle = fh_->fetch_page_handle(batch_rid_.page_no);
+        try {
+            page_filter_.eval(page_handle.bitmap, page_handle.slots, file_hdr.record_size,
+                              file_hdr.num_records_per_page, &page_mask_);
+            int slot_no = batch_rid_.slot_no + 1;
+            for (; slot_no < file_hdr.num_records_per_page && !batch->full(); slot_no++) {
+                unsigned bits = page_mask_[slot_no >> 3] >> (slot_no & 7);
+                if (bits == 0) {
+                    slot_no |= 7;  // 同一个字节中剩下的槽都没有选中
+                    continue;
+                }
+                if ((bits & 1) == 0) {
+                    continue;
+                }
+                if (context_) {
+                    context_->lock_mgr_->lock_shared_on_record(context_->txn_, Rid{batch_rid_.page_no, slot_no},
+                                                               fh_->GetFd());
+                }
+                memcpy(batch->append(), page_handle.get_slot(slot_no), len_);
+                batch_rid_.slot_no = slot_no;
+            }
+            if (slot_no >= file_hdr.num_records_per_page) {
+                batch_rid_ = Rid{batch_rid_.page_no + 1, -1};
+            }
+        } catch (...) {
+            fh_->unpin_page_handle(page_handle);
+            throw;
         }
-        return true;
+        fh_->unpin_page_handle(page_handle);
     }
 };
\ No newline at end of file
@@ -43,54 +43,130 @@ class UpdateExecutor : public AbstractExecutor {
         }
     }
     
+    /**
+     * @brief 更新所有目标记录
+     * 只改写key发生变化的索引项：没有字段出现在set从句中的索引不访问，新旧key相同的记录也不改写。
+     * 先删除这些旧索引项，再插入新索引项，唯一索引上的冲突在插入时发现；
+     * 有冲突时撤销已插入的新索引项、恢复旧索引项，语句失败且不修改任何记录。
+     * 分成两步可以让 set id = id + 1 这类更新不会与尚未更新的记录误判冲突
+     */
     std::unique_ptr<RmRecord> Next() override {
+        std::vector<IxIndex *> ihs;
+        for (auto &index : tab_.indexes) {
+            ihs.push_back(sm_manager_->get_index(index));
+        }
+
+        std::vector<std::unique_ptr<RmRecord>> old_recs;
+        std::vector<RmRecord> new_recs;
         for (auto &rid : rids_) {
             auto rec = fh_->get_record(rid, context_);
-
-            // Remove old entry from index
-            for (size_t i = 0; i < tab_.indexes.size(); ++i) {
-                auto& index = tab_.indexes[i];
-                auto ih = sm_manager_->ihs_.at(sm_manager_->get_ix_manager()->get_index_name(tab_name_, index.cols)).get();
-                char* key = new char[index.col_tot_len];
-                int offset = 0;
-                for (size_t i = 0; i < index.col_num; ++i) {
-                    memcpy(key + offset, rec->data + index.cols[i].offset, index.cols[i].len);
-                    offset += index.cols[i].len;
-                }
-                ih->delete_entry(key, context_->txn_);
-                delete[] key;
-            }
-
-            // record a update operation into the transaction
-            WriteRecord* wr = new WriteRecord(WType::UPDATE_TUPLE, tab_name_, rid, *rec);
-            context_->txn_->append_write_record(wr);
-            
             RmRecord update_record{rec->size};
             memcpy(update_record.data, rec->data, rec->size);
             for (auto &set_clause : set_clauses_) {
                 auto lhs_col = tab_.get_col(set_clause.lhs.col_name);
                 memcpy(update_record.data + lhs_col->offset, set_clause.rhs.raw->data, lhs_col->len);
             }
+            old_recs.push_back(std::move(rec));
+            new_recs.push_back(update_record);
+        }
+
+        // (索引, 记录)：key发生变化、需要改写的索引项
+        std::vector<std::pair<size_t, size_t>> changed;
+        for (size_t i = 0; i < tab_.indexes.size(); ++i) {
+            if (!is_updated(tab_.indexes[i])) {
+                continue;
+            }
+            for (size_t r = 0; r < rids_.size(); ++r) {
+                if (make_key(tab_.indexes[i], old_recs[r]->data) != make_key(tab_.indexes[i], new_recs[r].data)) {
+                    changed.emplace_back(i, r);
+                }
+            }
+        }
 
-            // Update record in record file
-            fh_->update_record(rid, update_record.data, context_);
+        // Remove old entry from index
+        std::vector<std::pair<size_t, size_t>> removed;     // 只记录确实删除了的索引项
+        for (auto &[i, r] : changed) {
+            auto key = make_key(tab_.indexes[i], old_recs[r]->data);
+            if (ihs[i]->delete_entry(key.data(), rids_[r], context_->txn_)) {
+                removed.emplace_back(i, r);
+            }
+        }
 
-            // Insert new entry into index
-            for (size_t i = 0; i < tab_.indexes.size(); ++i) {
-                auto& index = tab_.indexes[i];
-                auto ih = sm_manager_->ihs_.at(sm_manager_->get_ix_manager()->get_index_name(tab_name_, index.cols)).get();
-                char* key = new char[index.col_tot_len];
-                int offset = 0;
-                for (size_t j = 0; j < index.col_num; ++j) {
-                    memcpy(key + offset, update_record.data + index.cols[j].offset, index.cols[j].len);
-                    offset += index.cols[j].len;
+        // Insert new entry into index
+        std::vector<std::pair<size_t, size_t>> inserted;
+        for (auto &[i, r] : changed) {
+            auto &index = tab_.indexes[i];
+            auto key = make_key(index, new_recs[r].data);
+            if (ihs[i]->insert_entry(key.data(), rids_[r], context_->txn_) != IX_NO_PAGE) {
+                inserted.emplace_back(i, r);
+            } else if (index.unique) {
+                for (auto &[j, k] : inserted) {
+                    ihs[j]->delete_entry(make_key(tab_.indexes[j], new_recs[k].data).data(), rids_[k],
+                                         context_->txn_);
+                }
+                for (auto &[j, k] : removed) {
+                    ihs[j]->insert_entry(make_key(tab_.indexes[j], old_recs[k]->data).data(), rids_[k],
+                                         context_->txn_);
                 }
-                ih->insert_entry(key, rid, context_->txn_);
-                delete[] key;
+                std::vector<std::string> col_names;
+                for (auto &col : index.cols) {
+                    col_names.push_back(col.name);
+                }
+                throw UniqueConstraintError(tab_name_, col_names);
             }
         }
+
+        // record the index changes, abort undoes them in reverse: remove new entries, then restore old ones
+        for (auto &[i, r] : removed) {
+            auto key = make_key(tab_.indexes[i], old_recs[r]->data);
+            context_->txn_->append_write_record(new WriteRecord(WType::DELETE_ENTRY, tab_name_, rids_[r],
+                                                                RmRecord(key.size(), key.data()),
+                                                                tab_.indexes[i].col_names()));
+        }
+        for (auto &[i, r] : inserted) {
+            auto key = make_key(tab_.indexes[i], new_recs[r].data);
+            context_->txn_->append_write_record(new WriteRecord(WType::INSERT_ENTRY, tab_name_, rids_[r],
+                                                                RmRecord(key.size(), key.data()),
+                                                                tab_.indexes[i].col_names()));
+        }
+
+        for (size_t r = 0; r < rids_.size(); ++r) {
+            // record a update operation into the transaction
+            WriteRecord* wr = new WriteRecord(WType::UPDATE_TUPLE, tab_name_, rids_[r], *old_recs[r]);
+            context_->txn_->append_write_record(wr);
+
+            // Update record in record file
+            fh_->update_record(rids_[r], new_recs[r].data, context_);
+        }
         return nullptr;
     }
 
+    /**
+     * @brief 索引中是否有字段出现在set从句中
+     */
+    bool is_updated(const IndexMeta &index) const {
+        for (auto &set_clause : set_clauses_) {
+            for (auto &col : index.cols) {
+                if (col.name == set_clause.lhs.col_name) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief 从记录中取出索引字段拼成key
+     */
+    static std::vector<char> make_key(const IndexMeta &index, const char *rec) {
+        std::vector<char> key(index.col_tot_len);
+        int offset = 0;
+        for (size_t i = 0; i < index.cols.size(); ++i) {
+            memcpy(key.data() + offset, rec + index.cols[i].offset, index.cols[i].len);
+            offset += index.cols[i].len;
+        }
+        return key;
+    }
+
     Rid &rid() override { return _abstract_rid; }
 }; 
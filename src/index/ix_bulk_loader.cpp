@@ -0,0 +1,362 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "ix_bulk_loader.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <queue>
+
+namespace {
+
+/* 顺序读取一个有序段，每次从文件中读入一批条目 */
+struct RunReader {
+    std::ifstream in;
+    std::vector<char> buf;
+    int entry_len;
+    size_t num = 0;  // buf中的条目数量
+    size_t pos = 0;  // 当前条目在buf中的位置
+
+    RunReader(const std::string &name, int entry_len_, size_t batch)
+        : in(name, std::ios::binary), buf(batch * entry_len_), entry_len(entry_len_) {}
+
+    // 读入下一批条目，文件读完时返回false
+    bool load() {
+        in.read(buf.data(), buf.size());
+        num = in.gcount() / entry_len;
+        pos = 0;
+        return num > 0;
+    }
+
+    bool advance() { return ++pos < num || load(); }
+
+    const char *cur() const { return buf.data() + pos * entry_len; }
+};
+
+}  // namespace
+
+IxBulkLoader::IxBulkLoader(IxIndexHandle *ih, const std::string &run_prefix, size_t mem_budget)
+    : ih_(ih), file_hdr_(ih->file_hdr_), run_prefix_(run_prefix) {
+    entry_len_ = file_hdr_->col_tot_len_ + sizeof(Rid);
+    max_buffered_ = std::max<size_t>(1, mem_budget / entry_len_);
+    last_key_.resize(file_hdr_->col_tot_len_);
+}
+
+IxBulkLoader::~IxBulkLoader() {
+    for (auto &run : runs_) {
+        std::remove(run.c_str());
+    }
+}
+
+/**
+ * @brief 添加一个待插入索引的键值对，内存中的条目达到上限时写出一个有序段
+ */
+void IxBulkLoader::add(const char *key, const Rid &rid) {
+    char key_buf[IX_MAX_KEY_LEN];
+    size_t offset = num_buffered_ * entry_len_;
+    if (buffer_.size() < offset + entry_len_) {
+        buffer_.resize(offset + entry_len_);
+    }
+    // 条目中的key与结点中保存的一致，非唯一索引附加了rid
+    memcpy(buffer_.data() + offset, ih_->make_key(key, rid, key_buf), file_hdr_->col_tot_len_);
+    memcpy(buffer_.data() + offset + file_hdr_->col_tot_len_, &rid, sizeof(Rid));
+    if (++num_buffered_ == max_buffered_) {
+        spill_run();
+    }
+}
+
+/**
+ * @brief 所有键值对添加完毕后，归并有序段并自底向上构建B+树
+ *
+ * @param fill_factor 每个结点的填充率，会被限制在[min_size, btree_order]之间
+ * @note 只能在空索引上调用，构建出的树与逐条insert_entry()得到的树满足相同的约束
+ */
+void IxBulkLoader::finish(double fill_factor) {
+    IxNodeHandle *root = ih_->fetch_node(file_hdr_->root_page_);
+    bool is_empty = root->get_page_no() == IX_INIT_ROOT_PAGE && root->is_leaf_page() && root->get_size() == 0;
+    int min_size = root->get_min_size();
+    ih_->buffer_pool_manager_->unpin_page(root->get_page_id(), false);
+    delete root;
+    if (!is_empty) {
+        throw InternalError("IxBulkLoader::finish: index is not empty");
+    }
+
+    int max_size = file_hdr_->btree_order_;
+    fill_factor_ = fill_factor;
+    target_size_ = std::clamp(static_cast<int>(fill_factor * max_size), min_size, max_size);
+
+    // 1. 按序填充叶子层
+    Level leaves(true);
+    merge_runs(leaves);
+    flush_level(leaves);
+    if (leaves.num_parents == 0) {
+        return;  // 表中没有记录，保留创建索引时的空根结点
+    }
+
+    // 2. 维护叶子链表的头结点，第一个叶子结点复用原来的根结点
+    Rid last_leaf;
+    memcpy(&last_leaf, leaves.parents.data() + (leaves.num_parents - 1) * entry_len_ + file_hdr_->col_tot_len_,
+           sizeof(Rid));
+    ih_->file_hdr_->first_leaf_ = IX_INIT_ROOT_PAGE;
+    ih_->file_hdr_->last_leaf_ = last_leaf.page_no;
+    IxNodeHandle *leaf_header = ih_->fetch_node(IX_LEAF_HEADER_PAGE);
+    leaf_header->set_next_leaf(IX_INIT_ROOT_PAGE);
+    leaf_header->set_prev_leaf(last_leaf.page_no);
+    ih_->buffer_pool_manager_->unpin_page(leaf_header->get_page_id(), true);
+    delete leaf_header;
+
+    // 3. 逐层向上构建内部结点，直到只剩一个结点，即为根结点
+    std::vector<char> children = std::move(leaves.parents);
+    int num_children = leaves.num_parents;
+    while (num_children > 1) {
+        Level level(false);
+        for (int i = 0; i < num_children; i++) {
+            push_entry(level, children.data() + i * entry_len_);
+        }
+        flush_level(level);
+        children = std::move(level.parents);
+        num_children = level.num_parents;
+    }
+    Rid root_rid;
+    memcpy(&root_rid, children.data() + file_hdr_->col_tot_len_, sizeof(Rid));
+    ih_->update_root_page_no(root_rid.page_no);
+    ih_->update_file_hdr(nullptr);
+}
+
+/**
+ * @brief 比较两个条目，先比较key，key相同时按rid排序，保证排序结果确定
+ */
+bool IxBulkLoader::entry_less(const char *a, const char *b) const {
+    int res = file_hdr_->key_cmp_(a, b);
+    if (res != 0) {
+        return res < 0;
+    }
+    Rid ra, rb;
+    memcpy(&ra, a + file_hdr_->col_tot_len_, sizeof(Rid));
+    memcpy(&rb, b + file_hdr_->col_tot_len_, sizeof(Rid));
+    return ra.page_no < rb.page_no || (ra.page_no == rb.page_no && ra.slot_no < rb.slot_no);
+}
+
+/**
+ * @brief 对内存中缓存的条目排序，只交换指针而不移动条目本身
+ */
+std::vector<const char *> IxBulkLoader::sort_buffer() const {
+    std::vector<const char *> order(num_buffered_);
+    for (size_t i = 0; i < num_buffered_; i++) {
+        order[i] = buffer_.data() + i * entry_len_;
+    }
+    std::sort(order.begin(), order.end(), [this](const char *a, const char *b) { return entry_less(a, b); });
+    return order;
+}
+
+/**
+ * @brief 将内存中的条目排序后写出到临时文件，形成一个有序段
+ */
+void IxBulkLoader::spill_run() {
+    std::string name = run_prefix_ + ".run" + std::to_string(runs_.size());
+    std::ofstream out(name, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw UnixError();
+    }
+    runs_.push_back(name);
+    for (auto entry : sort_buffer()) {
+        out.write(entry, entry_len_);
+    }
+    num_buffered_ = 0;
+}
+
+/**
+ * @brief 按key从小到大的顺序将所有条目送入叶子层
+ * 条目全部在内存中时直接排序，否则对所有有序段进行多路归并
+ */
+void IxBulkLoader::merge_runs(Level &leaves) {
+    if (runs_.empty()) {
+        for (auto entry : sort_buffer()) {
+            feed_leaf(leaves, entry);
+        }
+        return;
+    }
+    if (num_buffered_ > 0) {
+        spill_run();
+    }
+    buffer_.clear();
+    buffer_.shrink_to_fit();
+
+    // 每个有序段平分内存预算作为读缓冲
+    size_t batch = std::max<size_t>(1, max_buffered_ / runs_.size());
+    std::vector<std::unique_ptr<RunReader>> readers;
+    auto cmp = [this](const RunReader *a, const RunReader *b) { return entry_less(b->cur(), a->cur()); };
+    std::priority_queue<RunReader *, std::vector<RunReader *>, decltype(cmp)> heap(cmp);
+    for (auto &run : runs_) {
+        readers.push_back(std::make_unique<RunReader>(run, entry_len_, batch));
+        if (readers.back()->load()) {
+            heap.push(readers.back().get());
+        }
+    }
+    while (!heap.empty()) {
+        RunReader *reader = heap.top();
+        heap.pop();
+        feed_leaf(leaves, reader->cur());
+        if (reader->advance()) {
+            heap.push(reader);
+        }
+    }
+}
+
+/**
+ * @brief 向叶子层追加一个条目
+ * @note 与insert_entry()保持一致，相同的key只保留第一个（非唯一索引的key带有rid，只有重复添加同一个键值对时才会相同）
+ */
+void IxBulkLoader::feed_leaf(Level &leaves, const char *entry) {
+    if (has_last_key_ && file_hdr_->key_cmp_(entry, last_key_.data()) == 0) {
+        has_duplicate_ = true;
+        return;
+    }
+    memcpy(last_key_.data(), entry, file_hdr_->col_tot_len_);
+    has_last_key_ = true;
+    push_entry(leaves, entry);
+}
+
+/**
+ * @brief 向某一层追加一个条目
+ * 只有确认后面至少还有min_size个条目时才写出一个target_size_大小的结点，
+ * 这样本层最后剩下的条目总能凑成一个或两个不小于min_size的结点
+ */
+void IxBulkLoader::push_entry(Level &level, const char *entry) {
+    if (file_hdr_->compress_) {
+        push_compressed(level, entry);
+        return;
+    }
+    int min_size = (file_hdr_->btree_order_ + 1) / 2;
+    size_t offset = level.num_pending * entry_len_;
+    if (level.pending.size() < offset + entry_len_) {
+        level.pending.resize(offset + entry_len_);
+    }
+    memcpy(level.pending.data() + offset, entry, entry_len_);
+    if (++level.num_pending == target_size_ + min_size) {
+        emit_node(level, level.pending.data(), target_size_);
+        memmove(level.pending.data(), level.pending.data() + target_size_ * entry_len_, min_size * entry_len_);
+        level.num_pending = min_size;
+    }
+}
+
+/**
+ * @brief 压缩索引向某一层追加一个条目
+ * 结点的容量取决于其中key的公共前缀和最大长度，因此贪心地累积条目，
+ * 超过当前容量乘以fill_factor时，把除最后一个条目以外的部分写出为一个结点
+ */
+void IxBulkLoader::push_compressed(Level &level, const char *entry) {
+    int len = file_hdr_->col_tot_len_;
+    size_t offset = level.num_pending * entry_len_;
+    if (level.pending.size() < offset + entry_len_) {
+        level.pending.resize(offset + entry_len_);
+    }
+    memcpy(level.pending.data() + offset, entry, entry_len_);
+    int end = ix_significant_len(entry, len);
+    if (level.num_pending == 0) {
+        level.prefix_len = len;
+        level.key_end = end;
+    } else {
+        level.prefix_len = ix_common_prefix_len(level.pending.data(), entry, level.prefix_len);
+        level.key_end = std::max(level.key_end, end);
+    }
+    level.num_pending++;
+
+    int slots = IxNodeHandle::compressed_slots(level.prefix_len, std::max(0, level.key_end - level.prefix_len));
+    if (level.num_pending > std::max(1, static_cast<int>(slots * fill_factor_))) {
+        emit_node(level, level.pending.data(), level.num_pending - 1);
+        memmove(level.pending.data(), level.pending.data() + offset, entry_len_);
+        level.num_pending = 1;
+        level.prefix_len = len;
+        level.key_end = end;
+    }
+}
+
+/**
+ * @brief 本层的条目已全部给出，写出剩余的条目
+ */
+void IxBulkLoader::flush_level(Level &level) {
+    int rest = level.num_pending;
+    if (file_hdr_->compress_) {
+        if (rest > 0) {
+            emit_node(level, level.pending.data(), rest);  // push_compressed()保证剩余的条目放得进一个结点
+        }
+    } else if (rest > file_hdr_->btree_order_) {
+        emit_node(level, level.pending.data(), rest / 2);
+        emit_node(level, level.pending.data() + rest / 2 * entry_len_, rest - rest / 2);
+    } else if (rest > 0) {
+        emit_node(level, level.pending.data(), rest);
+    }
+    level.num_pending = 0;
+    if (level.last != nullptr) {
+        ih_->buffer_pool_manager_->unpin_page(level.last->get_page_id(), true);
+        delete level.last;
+        level.last = nullptr;
+    }
+}
+
+/**
+ * @brief 用连续的n个条目生成本层的下一个结点
+ * 叶子结点接到叶子链表的末尾；内部结点需要更新所有孩子结点的父结点信息
+ */
+void IxBulkLoader::emit_node(Level &level, const char *entries, int n) {
+    IxNodeHandle *node;
+    if (level.is_leaf && level.last == nullptr) {
+        node = ih_->fetch_node(IX_INIT_ROOT_PAGE);  // 第一个叶子结点复用创建索引时的空根结点
+    } else {
+        node = ih_->create_node();
+    }
+    node->page_hdr->prefix_len = 0;
+    node->page_hdr->suffix_len = 0;
+    node->page_hdr->parent = IX_NO_PAGE;
+    node->page_hdr->is_leaf = level.is_leaf;
+    int len = file_hdr_->col_tot_len_;
+    std::vector<char> keys(n * len);
+    std::vector<Rid> rids(n);
+    for (int i = 0; i < n; i++) {
+        memcpy(keys.data() + i * len, entries + i * entry_len_, len);
+        memcpy(&rids[i], entries + i * entry_len_ + len, sizeof(Rid));
+    }
+    node->set_size(0);
+    node->insert_pairs(0, keys.data(), rids.data(), n);
+
+    if (level.is_leaf) {
+        node->set_prev_leaf(level.last == nullptr ? IX_LEAF_HEADER_PAGE : level.last->get_page_no());
+        node->set_next_leaf(IX_LEAF_HEADER_PAGE);
+        if (level.last != nullptr) {
+            level.last->set_next_leaf(node->get_page_no());
+        }
+    } else {
+        for (int i = 0; i < n; i++) {
+            ih_->maintain_child(node, i);
+        }
+    }
+    // 记录(首个key, page_no)，作为上一层的条目；压缩索引的叶子层记录与前一个结点最后一个key之间的最短分隔key
+    Rid child = {.page_no = node->get_page_no(), .slot_no = -1};
+    size_t offset = level.num_parents * entry_len_;
+    level.parents.resize(offset + entry_len_);
+    char *sep = level.parents.data() + offset;
+    if (file_hdr_->compress_ && level.is_leaf && level.last != nullptr) {
+        std::vector<char> prev_last(len);
+        level.last->copy_keys(level.last->get_size() - 1, 1, prev_last.data());
+        ix_make_separator(prev_last.data(), keys.data(), len, sep);
+    } else {
+        memcpy(sep, keys.data(), len);
+    }
+    memcpy(sep + len, &child, sizeof(Rid));
+    if (level.last != nullptr) {
+        ih_->buffer_pool_manager_->unpin_page(level.last->get_page_id(), true);
+        delete level.last;
+    }
+    level.last = node;
+    level.num_parents++;
+}
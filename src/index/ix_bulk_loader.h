@@ -0,0 +1,84 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "ix_index_handle.h"
+
+/**
+ * 批量构建B+树（用于在已有数据的表上CREATE INDEX）
+ * 1. add()收集(key, rid)，内存中的条目超过预算时排序后写出到临时文件（一个有序段）
+ * 2. finish()对所有有序段进行多路归并，按序自底向上填充叶子结点和各层内部结点
+ * 构建过程不经过insert_entry()，因此不会产生分裂，每个结点按fill_factor填充
+ */
+class IxBulkLoader {
+   private:
+    // 构建某一层结点时的状态
+    struct Level {
+        bool is_leaf;
+        std::vector<char> pending;  // 尚未写入结点的条目
+        int num_pending = 0;
+        IxNodeHandle *last = nullptr;  // 本层最后写出的结点，叶子层需要用它维护next_leaf指针
+        std::vector<char> parents;  // 本层每个结点的(首个key, page_no)，作为上一层的输入
+        int num_parents = 0;
+        int prefix_len = 0;  // 压缩索引：pending中所有key的公共前缀长度
+        int key_end = 0;     // 压缩索引：pending中所有key去掉末尾的0之后的最大长度
+
+        explicit Level(bool is_leaf_) : is_leaf(is_leaf_) {}
+    };
+
+    IxIndexHandle *ih_;
+    const IxFileHdr *file_hdr_;
+    std::string run_prefix_;         // 有序段临时文件名的前缀
+    int entry_len_;                  // 每个条目(key + rid)的长度
+    size_t max_buffered_;            // 内存中最多缓存的条目数量
+    std::vector<char> buffer_;       // 尚未排序的条目
+    size_t num_buffered_ = 0;
+    std::vector<std::string> runs_;  // 已写出的有序段文件名
+
+    std::vector<char> last_key_;     // 上一个写入叶子层的key，用于跳过重复key
+    bool has_last_key_ = false;
+    bool has_duplicate_ = false;     // 是否遇到过重复的key，唯一索引据此判断能否建立
+    int target_size_ = 0;            // 每个结点的目标键值对数量
+    double fill_factor_ = IX_BULK_LOAD_FILL_FACTOR;
+
+   public:
+    IxBulkLoader(IxIndexHandle *ih, const std::string &run_prefix, size_t mem_budget = IX_BULK_LOAD_MEM_BUDGET);
+
+    ~IxBulkLoader();
+
+    void add(const char *key, const Rid &rid);
+
+    void finish(double fill_factor = IX_BULK_LOAD_FILL_FACTOR);
+
+    bool has_duplicate() const { return has_duplicate_; }
+
+   private:
+    bool entry_less(const char *a, const char *b) const;
+
+    std::vector<const char *> sort_buffer() const;
+
+    void spill_run();
+
+    void merge_runs(Level &leaves);
+
+    void feed_leaf(Level &leaves, const char *entry);
+
+    void push_entry(Level &level, const char *entry);
+
+    void push_compressed(Level &level, const char *entry);
+
+    void flush_level(Level &level);
+
+    void emit_node(Level &level, const char *entries, int n);
+};
@@ -0,0 +1,119 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <cstring>
+#include <vector>
+
+#include "defs.h"
+#include "errors.h"
+
+inline int ix_compare(const char *a, const char *b, ColType type, int col_len) {//比较key的大小关系
+    switch (type) {
+        case TYPE_INT: {
+            int ia = *(int *)a;
+            int ib = *(int *)b;
+            return (ia < ib) ? -1 : ((ia > ib) ? 1 : 0);
+        }
+        case TYPE_FLOAT: {
+            float fa = *(float *)a;
+            float fb = *(float *)b;
+            return (fa < fb) ? -1 : ((fa > fb) ? 1 : 0);
+        }
+        case TYPE_STRING:
+            return memcmp(a, b, col_len);
+        default:
+            throw InternalError("Unexpected data type");
+    }
+}
+
+inline int ix_compare(const char* a, const char* b, const std::vector<ColType>& col_types, const std::vector<int>& col_lens) {
+    int offset = 0;
+    for(size_t i = 0; i < col_types.size(); ++i) {
+        int res = ix_compare(a + offset, b + offset, col_types[i], col_lens[i]);
+        if(res != 0) return res;
+        offset += col_lens[i];
+    }
+    return 0;
+}
+
+/**
+ * 按照key的字段类型预先选好的比较函数，与ix_compare(a, b, col_types, col_lens)的结果一致
+ * 构造时根据字段类型选择一个模板实例：int、float、int+int、定长字符串、int/float+定长字符串（非唯一索引附加了rid），
+ * 其余情况使用逐字段比较
+ * 比较时只有一次函数指针调用，不再对每个字段判断类型
+ */
+class IxKeyComparator {
+   public:
+    IxKeyComparator() = default;
+
+    IxKeyComparator(const std::vector<ColType> &col_types, const std::vector<int> &col_lens)
+        : col_types_(col_types), col_lens_(col_lens) {
+        tot_len_ = 0;
+        for (int len : col_lens_) {
+            tot_len_ += len;
+        }
+        if (col_types_.size() == 1 && col_types_[0] == TYPE_INT && col_lens_[0] == sizeof(int)) {
+            cmp_ = &compare_scalar<int>;
+        } else if (col_types_.size() == 1 && col_types_[0] == TYPE_FLOAT && col_lens_[0] == sizeof(float)) {
+            cmp_ = &compare_scalar<float>;
+        } else if (col_types_.size() == 2 && col_types_[0] == TYPE_INT && col_types_[1] == TYPE_INT &&
+                   col_lens_[0] == sizeof(int) && col_lens_[1] == sizeof(int)) {
+            cmp_ = &compare_int_int;
+        } else if (col_types_.size() == 1 && col_types_[0] == TYPE_STRING) {
+            cmp_ = &compare_string;
+        } else if (col_types_.size() == 2 && col_types_[0] == TYPE_INT && col_types_[1] == TYPE_STRING &&
+                   col_lens_[0] == sizeof(int)) {
+            cmp_ = &compare_scalar_string<int>;
+        } else if (col_types_.size() == 2 && col_types_[0] == TYPE_FLOAT && col_types_[1] == TYPE_STRING &&
+                   col_lens_[0] == sizeof(float)) {
+            cmp_ = &compare_scalar_string<float>;
+        } else {
+            cmp_ = &compare_generic;
+        }
+    }
+
+    inline int operator()(const char *a, const char *b) const { return cmp_(a, b, *this); }
+
+   private:
+    using CompareFn = int (*)(const char *, const char *, const IxKeyComparator &);
+
+    template <typename T>
+    static int compare_scalar(const char *a, const char *b, const IxKeyComparator &) {
+        T va = *reinterpret_cast<const T *>(a);
+        T vb = *reinterpret_cast<const T *>(b);
+        return (va < vb) ? -1 : ((va > vb) ? 1 : 0);
+    }
+
+    static int compare_int_int(const char *a, const char *b, const IxKeyComparator &self) {
+        int res = compare_scalar<int>(a, b, self);
+        return res != 0 ? res : compare_scalar<int>(a + sizeof(int), b + sizeof(int), self);
+    }
+
+    template <typename T>
+    static int compare_scalar_string(const char *a, const char *b, const IxKeyComparator &self) {
+        int res = compare_scalar<T>(a, b, self);
+        return res != 0 ? res : memcmp(a + sizeof(T), b + sizeof(T), self.tot_len_ - sizeof(T));
+    }
+
+    static int compare_string(const char *a, const char *b, const IxKeyComparator &self) {
+        return memcmp(a, b, self.tot_len_);
+    }
+
+    static int compare_generic(const char *a, const char *b, const IxKeyComparator &self) {
+        return ix_compare(a, b, self.col_types_, self.col_lens_);
+    }
+
+    CompareFn cmp_ = &compare_generic;
+    std::vector<ColType> col_types_;
+    std::vector<int> col_lens_;
+    int tot_len_ = 0;
+};
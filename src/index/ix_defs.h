@@ -10,9 +10,13 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <algorithm>
+#include <climits>
+#include <cstdint>
 #include <vector>
 
 #include "defs.h"
+#include "ix_compare.h"
 #include "storage/buffer_pool_manager.h"
 
 constexpr int IX_NO_PAGE = -1;
@@ -20,23 +24,76 @@ constexpr int IX_FILE_HDR_PAGE = 0;
 constexpr int IX_LEAF_HEADER_PAGE = 1;
 constexpr int IX_INIT_ROOT_PAGE = 2;
 constexpr int IX_INIT_NUM_PAGES = 3;
+constexpr int IX_FILE_HDR_OFFSET = Page::OFFSET_PAGE_HDR;  // 第0页中序列化的文件头的起始位置，之前是页面的lsn
 constexpr int IX_MAX_COL_LEN = 512;
+constexpr double IX_BULK_LOAD_FILL_FACTOR = 0.9;        // 批量构建B+树时每个结点的填充率
+constexpr size_t IX_BULK_LOAD_MEM_BUDGET = 64 << 20;    // 批量构建B+树时排序可使用的内存大小(字节)
+constexpr int IX_OPTIMISTIC_MAX_RETRIES = 8;            // 乐观读失败多少次后退化为加读锁的查找
+constexpr bool IX_KEY_COMPRESSION = true;               // 新建的字符串索引默认是否对结点做前缀压缩
+constexpr int IX_COMPRESS_MIN_KEY_LEN = 16;             // key长度不小于该值的字符串索引才做前缀压缩
+constexpr bool IX_ADAPTIVE_HASH = true;                 // 是否为反复查找的key建立自适应哈希，直接定位到叶子结点
+constexpr int IX_AHI_BUILD_THRESHOLD = 3;               // 同一个key被抽样记录多少次后开始使用自适应哈希
+constexpr int IX_AHI_SAMPLE_RATE = 8;                   // 从根结点查找到key时，平均每多少次记录一次所在的叶子结点
+constexpr size_t IX_AHI_SLOTS = 1 << 12;                // 自适应哈希的槽数，必须是2的幂；哈希冲突的key互相覆盖
+constexpr int IX_RID_KEY_LEN = 2 * sizeof(int);          // 非唯一索引在结点中的key之后附加的rid的长度
+constexpr int IX_MAX_KEY_LEN = IX_MAX_COL_LEN + IX_RID_KEY_LEN;
+constexpr Rid IX_MIN_RID = {INT_MIN, INT_MIN};           // 编码后全为0，用于定位某个key的第一个键值对
+constexpr Rid IX_MAX_RID = {INT_MAX, INT_MAX};           // 编码后全为0xFF，用于定位某个key的最后一个键值对
+constexpr int IX_HASH_INIT_DIR_PAGE = 1;                 // 哈希索引初始的目录页
+constexpr int IX_HASH_INIT_BUCKET_PAGE = 2;              // 哈希索引初始的桶
+constexpr int IX_HASH_INIT_NUM_PAGES = 3;
+constexpr int IX_HASH_MAX_DEPTH = 16;                    // 目录最多翻倍到2^16项，之后满的桶只能挂溢出页
+constexpr int IX_HASH_DIR_SLOTS = (PAGE_SIZE - Page::OFFSET_PAGE_HDR) / sizeof(page_id_t);  // 每个目录页中的目录项数
+
+/**
+ * 非唯一索引的结点中保存的是(key, rid)：rid的page_no和slot_no翻转符号位后按大端序写在key之后，
+ * 作为一个定长字符串字段按字节比较，顺序与先比较page_no再比较slot_no一致。
+ * 这样相同的key也是互不相同的键值对，按rid排列，删除时可以直接定位到其中一个
+ */
+inline void ix_encode_rid(const Rid &rid, char *dest) {
+    for (int v : {rid.page_no, rid.slot_no}) {
+        uint32_t u = static_cast<uint32_t>(v) ^ 0x80000000u;
+        for (int i = 3; i >= 0; i--) {
+            *dest++ = static_cast<char>(u >> (i * 8));
+        }
+    }
+}
+
+class IxPageHdr {
+public:
+    int16_t prefix_len;             // 压缩结点中所有key的公共前缀长度，前缀只在结点中保存一次
+    int16_t suffix_len;             // 压缩结点中每个key去掉前缀后保存的长度，之后的字节都是0
+    page_id_t parent;               // 父亲节点所在页面的页号
+    int num_key;                    // # current keys (always equals to #child - 1) 已插入的keys数量，key_idx∈[0,num_key)
+    bool is_leaf;                   // 是否为叶节点
+    uint16_t smo_version;           // 结点分裂、合并、重分配的次数，自适应哈希据此判断记录的叶子结点是否失效
+    page_id_t prev_leaf;            // previous leaf node's page_no, effective only when is_leaf is true
+    page_id_t next_leaf;            // next leaf node's page_no, effective only when is_leaf is true
+};
+
+// 结点内查找key的方式，打开索引时根据索引字段确定，不写入磁盘
+enum IxKeyKind { IX_KEY_GENERIC, IX_KEY_INT, IX_KEY_FLOAT };
 
 class IxFileHdr {
 public: 
     page_id_t first_free_page_no_;      // 文件中第一个空闲的磁盘页面的页面号
     int num_pages_;                     // 磁盘文件中页面的数量
     page_id_t root_page_;               // B+树根节点对应的页面号
-    int col_num_;                       // 索引包含的字段数量
+    int col_num_;                       // 结点中key的字段数量，非唯一索引包括最后附加的rid字段
     std::vector<ColType> col_types_;    // 字段的类型
     std::vector<int> col_lens_;         // 字段的长度
-    int col_tot_len_;                   // 索引包含的字段的总长度
+    int col_tot_len_;                   // 结点中key的总长度，非唯一索引包括最后附加的rid
     int btree_order_;                   // # children per page 每个结点最多可插入的键值对数量
     int keys_size_;                     // keys_size = (btree_order + 1) * col_tot_len
     // first_leaf初始化之后没有进行修改，只不过是在测试文件中遍历叶子结点的时候用了
     page_id_t first_leaf_;              // 首叶节点对应的页号，在上层IxManager的open函数进行初始化，初始化为root page_no
     page_id_t last_leaf_;               // 尾叶节点对应的页号
     int tot_len_;                       // 记录结构体的整体长度
+    bool unique_ = false;               // 是否为唯一索引（UNIQUE/PRIMARY KEY），插入已存在的key时失败
+    IxKeyKind key_kind_ = IX_KEY_GENERIC;  // 单列INT/FLOAT索引（非唯一索引附加rid）使用专门的结点内查找
+    IxKeyComparator key_cmp_;           // 按索引字段类型选好的key比较函数
+    bool compress_ = false;             // 结点是否按前缀压缩的格式存放key，创建索引时确定并写入文件头
+    int compress_split_keys_ = 0;       // 压缩结点一次分裂最多向父结点插入的key数量
 
     IxFileHdr() {
         tot_len_ = col_num_ = 0;
@@ -49,22 +106,55 @@ public:
                     tot_len_ = 0;
                 } 
 
+    /** 上层传入的key（即索引字段）的长度，非唯一索引结点中的key在此之后还有IX_RID_KEY_LEN字节的rid */
+    int key_len() const { return unique_ ? col_tot_len_ : col_tot_len_ - IX_RID_KEY_LEN; }
+
+    /** 只由字符串组成的key按字节序比较，才能在结点内只比较去掉公共前缀之后的部分；key太短时压缩的收益不大 */
+    bool can_compress() const {
+        if (col_tot_len_ < IX_COMPRESS_MIN_KEY_LEN) {
+            return false;
+        }
+        return std::all_of(col_types_.begin(), col_types_.end(), [](ColType type) { return type == TYPE_STRING; });
+    }
+
+    // 打开索引时根据字段类型确定结点内查找方式和key比较函数
+    void init_key_compare() {
+        key_cmp_ = IxKeyComparator(col_types_, col_lens_);
+        key_kind_ = IX_KEY_GENERIC;
+        // 非唯一索引的key是(索引字段, rid)，结点内按第一个字段查找，相等时再比较rid
+        int user_cols = unique_ ? col_num_ : col_num_ - 1;
+        if (user_cols == 1 && col_types_[0] == TYPE_INT && col_lens_[0] == sizeof(int)) {
+            key_kind_ = IX_KEY_INT;
+        } else if (user_cols == 1 && col_types_[0] == TYPE_FLOAT && col_lens_[0] == sizeof(float)) {
+            key_kind_ = IX_KEY_FLOAT;
+        }
+
+        // 结点最多有(可用空间 / (1 + sizeof(Rid)))个键值对（每个key至少保存1字节），加上一次插入的k个key后，
+        // 按每个结点至少能放下不压缩时的键值对数量来分，最多向父结点插入的key数量k取满足该关系的不动点
+        int avail = PAGE_SIZE - sizeof(IxPageHdr);
+        int max_keys = avail / (1 + sizeof(Rid));
+        int min_keys = avail / (col_tot_len_ + sizeof(Rid));
+        compress_split_keys_ = 1;
+        while ((max_keys + compress_split_keys_ + min_keys - 1) / min_keys - 1 > compress_split_keys_) {
+            compress_split_keys_++;
+        }
+    }
+
     void update_tot_len() {
         tot_len_ = 0;
-        tot_len_ += sizeof(page_id_t) * 4 + sizeof(int) * 6;
+        tot_len_ += sizeof(page_id_t) * 4 + sizeof(int) * 6 + sizeof(bool) * 2;
         tot_len_ += sizeof(ColType) * col_num_ + sizeof(int) * col_num_;
     }
 
-    void serialize(char* dest) {
+    /**
+     * 文件头在第0页中的布局：Page::OFFSET_LSN处为页面的lsn，从IX_FILE_HDR_OFFSET开始为序列化的文件头，
+     * 其中会随结点分裂、合并变化的页号字段放在最前面，位置固定，修改时只需要写这一部分（见serialize_page_nos）
+     */
+    void serialize(char* dest) const {
         int offset = 0;
         memcpy(dest + offset, &tot_len_, sizeof(int));
         offset += sizeof(int);
-        memcpy(dest + offset, &first_free_page_no_, sizeof(page_id_t));
-        offset += sizeof(page_id_t);
-        memcpy(dest + offset, &num_pages_, sizeof(int));
-        offset += sizeof(int);
-        memcpy(dest + offset, &root_page_, sizeof(page_id_t));
-        offset += sizeof(page_id_t);
+        offset += serialize_page_nos(dest + offset);
         memcpy(dest + offset, &col_num_, sizeof(int));
         offset += sizeof(int);
         for(int i = 0; i < col_num_; ++i) {
@@ -81,60 +171,141 @@ public:
         offset += sizeof(int);
         memcpy(dest + offset, &keys_size_, sizeof(int));
         offset += sizeof(int);
-        memcpy(dest + offset, &first_leaf_, sizeof(page_id_t));
-        offset += sizeof(page_id_t);
-        memcpy(dest + offset, &last_leaf_, sizeof(page_id_t));
-        offset += sizeof(page_id_t);
+        memcpy(dest + offset, &unique_, sizeof(bool));
+        offset += sizeof(bool);
+        memcpy(dest + offset, &compress_, sizeof(bool));
+        offset += sizeof(bool);
         assert(offset == tot_len_);
     }
 
-    void deserialize(char* src) {
+    /** serialize()中紧跟tot_len_之后的页号字段，返回写出的长度 */
+    int serialize_page_nos(char* dest) const {
+        int offset = 0;
+        for (page_id_t page_no : {first_free_page_no_, num_pages_, root_page_, first_leaf_, last_leaf_}) {
+            memcpy(dest + offset, &page_no, sizeof(page_id_t));
+            offset += sizeof(page_id_t);
+        }
+        return offset;
+    }
+
+    static constexpr int PAGE_NOS_OFFSET = sizeof(int);     // 页号字段在序列化结果中的偏移
+    static constexpr int PAGE_NOS_LEN = 5 * sizeof(page_id_t);
+
+    void deserialize(const char* src) {
         int offset = 0;
         tot_len_ = *reinterpret_cast<const int*>(src + offset);
         offset += sizeof(int);
         first_free_page_no_ = *reinterpret_cast<const page_id_t*>(src + offset);
-        offset += sizeof(int);
+        offset += sizeof(page_id_t);
         num_pages_ = *reinterpret_cast<const int*>(src + offset);
         offset += sizeof(int);
         root_page_ = *reinterpret_cast<const page_id_t*>(src + offset);
         offset += sizeof(page_id_t);
+        first_leaf_ = *reinterpret_cast<const page_id_t*>(src+ offset);
+        offset += sizeof(page_id_t);
+        last_leaf_ = *reinterpret_cast<const page_id_t*>(src + offset);
+        offset += sizeof(page_id_t);
         col_num_ = *reinterpret_cast<const int*>(src + offset);
         offset += sizeof(int);
-        std::cout << col_num_ << "\n";
-        for(int i = 0; i < col_num_; ++i) {
-            // col_types_[i] = *reinterpret_cast<const ColType*>(src + offset);
-            ColType type = *reinterpret_cast<const ColType*>(src + offset);
-            offset += sizeof(ColType);
-            col_types_.push_back(type);
-        }
-        for(int i = 0; i < col_num_; ++i) {
-            // col_lens_[i] = *reinterpret_cast<const int*>(src + offset);
-            int len = *reinterpret_cast<const int*>(src + offset);
-            offset += sizeof(int);
-            col_lens_.push_back(len);
-        }
+        col_types_.resize(col_num_);
+        col_lens_.resize(col_num_);
+        memcpy(col_types_.data(), src + offset, sizeof(ColType) * col_num_);
+        offset += sizeof(ColType) * col_num_;
+        memcpy(col_lens_.data(), src + offset, sizeof(int) * col_num_);
+        offset += sizeof(int) * col_num_;
         col_tot_len_ = *reinterpret_cast<const int*>(src + offset);
         offset += sizeof(int);
         btree_order_ = *reinterpret_cast<const int*>(src + offset);
         offset += sizeof(int);
         keys_size_ = *reinterpret_cast<const int*>(src + offset);
         offset += sizeof(int);
-        first_leaf_ = *reinterpret_cast<const page_id_t*>(src+ offset);
-        offset += sizeof(page_id_t);
-        last_leaf_ = *reinterpret_cast<const page_id_t*>(src + offset);
-        offset += sizeof(page_id_t);
+        unique_ = *reinterpret_cast<const bool*>(src + offset);
+        offset += sizeof(bool);
+        compress_ = *reinterpret_cast<const bool*>(src + offset);
+        offset += sizeof(bool);
         assert(offset == tot_len_);
+        init_key_compare();
     }
 };
 
-class IxPageHdr {
+/**
+ * 可扩展哈希索引的文件头，布局与IxFileHdr相同：位于第0页的IX_FILE_HDR_OFFSET处，打开期间一直pin在缓冲池中
+ * 目录保存在dir_pages_列出的目录页中，第i项是低global_depth_位为i的key所在的桶
+ */
+class IxHashFileHdr {
 public:
-    page_id_t next_free_page_no;    // unused
-    page_id_t parent;               // 父亲节点所在页面的页号
-    int num_key;                    // # current keys (always equals to #child - 1) 已插入的keys数量，key_idx∈[0,num_key)
-    bool is_leaf;                   // 是否为叶节点
-    page_id_t prev_leaf;            // previous leaf node's page_no, effective only when is_leaf is true
-    page_id_t next_leaf;            // next leaf node's page_no, effective only when is_leaf is true
+    int tot_len_ = 0;                   // 记录结构体的整体长度
+    int num_pages_ = 0;                 // 磁盘文件中页面的数量
+    int global_depth_ = 0;              // 目录项数量为2^global_depth_
+    int col_num_ = 0;                   // key的字段数量
+    std::vector<ColType> col_types_;    // 字段的类型
+    std::vector<int> col_lens_;         // 字段的长度
+    int col_tot_len_ = 0;               // key的总长度
+    int bucket_capacity_ = 0;           // 每个桶页面最多存放的键值对数量
+    bool unique_ = false;               // 是否为唯一索引，插入已存在的key时失败
+    std::vector<page_id_t> dir_pages_;  // 依次存放目录项的目录页
+    IxKeyComparator key_cmp_;           // 按索引字段类型选好的key比较函数，打开索引时确定
+
+    void update_tot_len() {
+        tot_len_ = sizeof(int) * 7 + sizeof(bool) + (sizeof(ColType) + sizeof(int)) * col_num_ +
+                   sizeof(page_id_t) * dir_pages_.size();
+    }
+
+    void serialize(char *dest) const {
+        int offset = 0;
+        for (int v : {tot_len_, num_pages_, global_depth_, col_num_}) {
+            memcpy(dest + offset, &v, sizeof(int));
+            offset += sizeof(int);
+        }
+        memcpy(dest + offset, col_types_.data(), sizeof(ColType) * col_num_);
+        offset += sizeof(ColType) * col_num_;
+        memcpy(dest + offset, col_lens_.data(), sizeof(int) * col_num_);
+        offset += sizeof(int) * col_num_;
+        int num_dir_pages = dir_pages_.size();
+        for (int v : {col_tot_len_, bucket_capacity_, num_dir_pages}) {
+            memcpy(dest + offset, &v, sizeof(int));
+            offset += sizeof(int);
+        }
+        memcpy(dest + offset, &unique_, sizeof(bool));
+        offset += sizeof(bool);
+        memcpy(dest + offset, dir_pages_.data(), sizeof(page_id_t) * num_dir_pages);
+        offset += sizeof(page_id_t) * num_dir_pages;
+        assert(offset == tot_len_);
+    }
+
+    void deserialize(const char *src) {
+        int offset = 0;
+        for (int *v : {&tot_len_, &num_pages_, &global_depth_, &col_num_}) {
+            memcpy(v, src + offset, sizeof(int));
+            offset += sizeof(int);
+        }
+        col_types_.resize(col_num_);
+        col_lens_.resize(col_num_);
+        memcpy(col_types_.data(), src + offset, sizeof(ColType) * col_num_);
+        offset += sizeof(ColType) * col_num_;
+        memcpy(col_lens_.data(), src + offset, sizeof(int) * col_num_);
+        offset += sizeof(int) * col_num_;
+        int num_dir_pages;
+        for (int *v : {&col_tot_len_, &bucket_capacity_, &num_dir_pages}) {
+            memcpy(v, src + offset, sizeof(int));
+            offset += sizeof(int);
+        }
+        memcpy(&unique_, src + offset, sizeof(bool));
+        offset += sizeof(bool);
+        dir_pages_.resize(num_dir_pages);
+        memcpy(dir_pages_.data(), src + offset, sizeof(page_id_t) * num_dir_pages);
+        offset += sizeof(page_id_t) * num_dir_pages;
+        assert(offset == tot_len_);
+        key_cmp_ = IxKeyComparator(col_types_, col_lens_);
+    }
+};
+
+/** 哈希桶页面的页头，位于Page::OFFSET_PAGE_HDR处，之后依次存放num_entries个(key, rid) */
+class IxHashBucketHdr {
+public:
+    int local_depth;                // 桶中所有key的哈希值低local_depth位相同
+    int num_entries;                // 页面中键值对的数量
+    page_id_t next_page;            // 溢出页的页号，哈希值完全相同的key放不下时才挂溢出页，没有时为IX_NO_PAGE
 };
 
 class Iid {
@@ -0,0 +1,327 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "ix_hash_index_handle.h"
+
+#include <algorithm>
+#include <mutex>
+
+IxHashIndexHandle::IxHashIndexHandle(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager, int fd)
+    : disk_manager_(disk_manager), buffer_pool_manager_(buffer_pool_manager), fd_(fd) {
+    // 与B+树相同，文件头所在的页面一直留在缓冲池中
+    file_hdr_page_ = buffer_pool_manager_->fetch_page(PageId{fd, IX_FILE_HDR_PAGE});
+    file_hdr_ = new IxHashFileHdr();
+    file_hdr_->deserialize(file_hdr_page_->get_data() + IX_FILE_HDR_OFFSET);
+
+    // 从文件末尾开始分配新的page_no，避免新页面覆盖已有的桶和目录页
+    int file_pages = disk_manager_->get_file_size(disk_manager_->get_file_name(fd)) / PAGE_SIZE;
+    disk_manager_->set_fd2pageno(fd, std::max(disk_manager_->get_fd2pageno(fd), file_pages));
+}
+
+/**
+ * @brief 逐字段计算key的哈希值（FNV-1a，最后再混合一次使低位分布均匀）
+ * @note float的0和-0比较结果相等，按0计算；字符串按定长的全部字节计算，与memcmp比较一致
+ */
+uint64_t IxHashIndexHandle::hash_key(const char *key, const std::vector<ColType> &col_types,
+                                     const std::vector<int> &col_lens) {
+    uint64_t h = 0xcbf29ce484222325ull;
+    auto mix = [&h](const char *data, int len) {
+        for (int i = 0; i < len; i++) {
+            h ^= static_cast<unsigned char>(data[i]);
+            h *= 0x100000001b3ull;
+        }
+    };
+    int offset = 0;
+    for (size_t i = 0; i < col_types.size(); i++) {
+        if (col_types[i] == TYPE_FLOAT && *reinterpret_cast<const float *>(key + offset) == 0) {
+            float zero = 0;
+            mix(reinterpret_cast<const char *>(&zero), sizeof(float));
+        } else {
+            mix(key + offset, col_lens[i]);
+        }
+        offset += col_lens[i];
+    }
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+/**
+ * @brief 查找key对应的所有rid
+ * @param key 要查找的key
+ * @param result 按rid的顺序追加找到的rid，与按表中位置排列的顺序一致
+ * @return 是否找到
+ */
+bool IxHashIndexHandle::get_value(const char *key, std::vector<Rid> *result, Transaction *transaction) {
+    std::shared_lock lock{latch_};
+    size_t old_size = result->size();
+    page_id_t page_no = get_dir(dir_index(hash(key)));
+    while (page_no != IX_NO_PAGE) {
+        IxHashBucketHandle bucket = fetch_bucket(page_no);
+        for (int i = 0; i < bucket.get_size(); i++) {
+            if (file_hdr_->key_cmp_(bucket.get_key(i), key) == 0) {
+                result->push_back(*bucket.get_rid(i));
+            }
+        }
+        page_no = bucket.bucket_hdr->next_page;
+        release_bucket(bucket, false);
+    }
+    std::sort(result->begin() + old_size, result->end(), [](const Rid &a, const Rid &b) {
+        return std::make_pair(a.page_no, a.slot_no) < std::make_pair(b.page_no, b.slot_no);
+    });
+    return result->size() > old_size;
+}
+
+/**
+ * @brief 插入键值对，桶满时分裂，无法分裂时挂溢出页
+ * @return 插入的键值对所在的页号；唯一索引中key已存在、非唯一索引中(key, value)已存在时返回IX_NO_PAGE
+ */
+page_id_t IxHashIndexHandle::insert_entry(const char *key, const Rid &value, Transaction *transaction) {
+    std::unique_lock lock{latch_};
+    uint64_t h = hash(key);
+    if (find_entry(get_dir(dir_index(h)), key, file_hdr_->unique_ ? nullptr : &value, nullptr, nullptr)) {
+        return IX_NO_PAGE;
+    }
+    while (true) {
+        int idx = dir_index(h);
+        page_id_t head = get_dir(idx);
+        page_id_t page_no = head;
+        page_id_t last = IX_NO_PAGE;
+        while (page_no != IX_NO_PAGE) {
+            IxHashBucketHandle bucket = fetch_bucket(page_no);
+            if (!bucket.is_full()) {
+                bucket.append(key, value);
+                release_bucket(bucket, true);
+                update_file_hdr(transaction);
+                return page_no;
+            }
+            last = page_no;
+            page_no = bucket.bucket_hdr->next_page;
+            release_bucket(bucket, false);
+        }
+        if (can_split(head, h)) {
+            split_bucket(idx);
+            continue;
+        }
+        // 桶中的key与新key的哈希值完全相同，分裂不能把它们分开，只能挂溢出页
+        IxHashBucketHandle prev = fetch_bucket(last);
+        IxHashBucketHandle overflow = create_bucket(prev.bucket_hdr->local_depth);
+        prev.bucket_hdr->next_page = overflow.get_page_no();
+        overflow.append(key, value);
+        page_no = overflow.get_page_no();
+        release_bucket(prev, true);
+        release_bucket(overflow, true);
+        update_file_hdr(transaction);
+        return page_no;
+    }
+}
+
+/**
+ * @brief 删除键值对(key, value)，桶变空后不合并
+ * @return 键值对是否存在
+ */
+bool IxHashIndexHandle::delete_entry(const char *key, const Rid &value, Transaction *transaction) {
+    std::unique_lock lock{latch_};
+    page_id_t page_no;
+    int pos;
+    if (!find_entry(get_dir(dir_index(hash(key))), key, &value, &page_no, &pos)) {
+        return false;
+    }
+    IxHashBucketHandle bucket = fetch_bucket(page_no);
+    bucket.erase(pos);
+    release_bucket(bucket, true);
+    return true;
+}
+
+page_id_t IxHashIndexHandle::get_dir(int idx) const {
+    Page *page = buffer_pool_manager_->fetch_page(PageId{fd_, file_hdr_->dir_pages_[idx / IX_HASH_DIR_SLOTS]});
+    page_id_t page_no;
+    memcpy(&page_no, page->get_data() + Page::OFFSET_PAGE_HDR + idx % IX_HASH_DIR_SLOTS * sizeof(page_id_t),
+           sizeof(page_id_t));
+    buffer_pool_manager_->unpin_page(page->get_page_id(), false);
+    return page_no;
+}
+
+void IxHashIndexHandle::set_dir(int idx, page_id_t page_no) {
+    Page *page = buffer_pool_manager_->fetch_page(PageId{fd_, file_hdr_->dir_pages_[idx / IX_HASH_DIR_SLOTS]});
+    memcpy(page->get_data() + Page::OFFSET_PAGE_HDR + idx % IX_HASH_DIR_SLOTS * sizeof(page_id_t), &page_no,
+           sizeof(page_id_t));
+    buffer_pool_manager_->unpin_page(page->get_page_id(), true);
+}
+
+/** @note pin the page, remember to call release_bucket() */
+IxHashBucketHandle IxHashIndexHandle::fetch_bucket(page_id_t page_no) const {
+    return IxHashBucketHandle(file_hdr_, buffer_pool_manager_->fetch_page(PageId{fd_, page_no}));
+}
+
+/** @note pin the page, remember to call release_bucket() */
+IxHashBucketHandle IxHashIndexHandle::create_bucket(int local_depth) {
+    file_hdr_->num_pages_++;
+    PageId new_page_id = {.fd = fd_, .page_no = INVALID_PAGE_ID};
+    IxHashBucketHandle bucket(file_hdr_, buffer_pool_manager_->new_page(&new_page_id));
+    *bucket.bucket_hdr = {.local_depth = local_depth, .num_entries = 0, .next_page = IX_NO_PAGE};
+    return bucket;
+}
+
+void IxHashIndexHandle::release_bucket(const IxHashBucketHandle &bucket, bool is_dirty) const {
+    buffer_pool_manager_->unpin_page(bucket.page->get_page_id(), is_dirty);
+}
+
+/**
+ * @brief 在从bucket_page开始的桶链中查找key
+ * @param value 不为nullptr时，只有rid与之相等的键值对才算找到
+ * @param[out] page_no, pos 不为nullptr时返回找到的键值对所在的页号和位置
+ */
+bool IxHashIndexHandle::find_entry(page_id_t bucket_page, const char *key, const Rid *value, page_id_t *page_no,
+                                   int *pos) const {
+    while (bucket_page != IX_NO_PAGE) {
+        IxHashBucketHandle bucket = fetch_bucket(bucket_page);
+        for (int i = 0; i < bucket.get_size(); i++) {
+            if (file_hdr_->key_cmp_(bucket.get_key(i), key) == 0 && (value == nullptr || *bucket.get_rid(i) == *value)) {
+                if (page_no != nullptr) {
+                    *page_no = bucket_page;
+                    *pos = i;
+                }
+                release_bucket(bucket, false);
+                return true;
+            }
+        }
+        page_id_t next = bucket.bucket_hdr->next_page;
+        release_bucket(bucket, false);
+        bucket_page = next;
+    }
+    return false;
+}
+
+/**
+ * @brief 满的桶能否通过分裂腾出位置：还没有到最大深度，并且桶中有key的哈希值与新key不同
+ */
+bool IxHashIndexHandle::can_split(page_id_t bucket_page, uint64_t hash) const {
+    IxHashBucketHandle head = fetch_bucket(bucket_page);
+    bool can = head.bucket_hdr->local_depth < IX_HASH_MAX_DEPTH;
+    release_bucket(head, false);
+    while (can && bucket_page != IX_NO_PAGE) {
+        IxHashBucketHandle bucket = fetch_bucket(bucket_page);
+        for (int i = 0; i < bucket.get_size(); i++) {
+            if (this->hash(bucket.get_key(i)) != hash) {
+                release_bucket(bucket, false);
+                return true;
+            }
+        }
+        bucket_page = bucket.bucket_hdr->next_page;
+        release_bucket(bucket, false);
+    }
+    return false;
+}
+
+/**
+ * @brief 分裂第idx个目录项指向的桶：哈希值第local_depth位为1的键值对移到新桶，指向原桶的目录项中该位为1的改为指向新桶
+ * @note local_depth等于global_depth时先把目录翻倍；原桶的溢出页保留在原桶的链上继续使用
+ */
+void IxHashIndexHandle::split_bucket(int idx) {
+    page_id_t old_page = get_dir(idx);
+    IxHashBucketHandle head = fetch_bucket(old_page);
+    int depth = head.bucket_hdr->local_depth;
+    release_bucket(head, false);
+    if (depth == file_hdr_->global_depth_) {
+        double_directory();
+    }
+
+    // 取出桶链中的所有键值对，清空原桶链
+    int entry_len = file_hdr_->col_tot_len_ + sizeof(Rid);
+    std::vector<char> entries;
+    for (page_id_t page_no = old_page; page_no != IX_NO_PAGE;) {
+        IxHashBucketHandle bucket = fetch_bucket(page_no);
+        entries.insert(entries.end(), bucket.entries, bucket.entries + bucket.get_size() * entry_len);
+        bucket.bucket_hdr->num_entries = 0;
+        bucket.bucket_hdr->local_depth = depth + 1;
+        page_no = bucket.bucket_hdr->next_page;
+        release_bucket(bucket, true);
+    }
+    IxHashBucketHandle new_bucket = create_bucket(depth + 1);
+    page_id_t new_page = new_bucket.get_page_no();
+    release_bucket(new_bucket, true);
+
+    for (int i = idx & ((1 << depth) - 1); i < (1 << file_hdr_->global_depth_); i += 1 << depth) {
+        if (i >> depth & 1) {
+            set_dir(i, new_page);
+        }
+    }
+
+    // 按第depth位把键值对分别写回两条桶链，写满一页后使用链上的下一页，没有时挂溢出页
+    auto fill = [&](page_id_t page_no, int bit) {
+        IxHashBucketHandle bucket = fetch_bucket(page_no);
+        for (size_t off = 0; off < entries.size(); off += entry_len) {
+            const char *key = entries.data() + off;
+            if ((hash(key) >> depth & 1) != static_cast<uint64_t>(bit)) {
+                continue;
+            }
+            while (bucket.is_full()) {
+                page_id_t next = bucket.bucket_hdr->next_page;
+                if (next == IX_NO_PAGE) {
+                    IxHashBucketHandle overflow = create_bucket(depth + 1);
+                    bucket.bucket_hdr->next_page = overflow.get_page_no();
+                    release_bucket(bucket, true);
+                    bucket = overflow;
+                } else {
+                    release_bucket(bucket, true);
+                    bucket = fetch_bucket(next);
+                }
+            }
+            bucket.append(key, *reinterpret_cast<const Rid *>(key + file_hdr_->col_tot_len_));
+        }
+        release_bucket(bucket, true);
+    };
+    fill(old_page, 0);
+    fill(new_page, 1);
+}
+
+/**
+ * @brief 目录翻倍：新的第n + i项与第i项指向同一个桶，目录页不够时分配新的目录页
+ */
+void IxHashIndexHandle::double_directory() {
+    int n = 1 << file_hdr_->global_depth_;
+    assert(file_hdr_->global_depth_ < IX_HASH_MAX_DEPTH);
+    while (static_cast<int>(file_hdr_->dir_pages_.size()) * IX_HASH_DIR_SLOTS < 2 * n) {
+        file_hdr_->num_pages_++;
+        PageId new_page_id = {.fd = fd_, .page_no = INVALID_PAGE_ID};
+        Page *page = buffer_pool_manager_->new_page(&new_page_id);
+        file_hdr_->dir_pages_.push_back(new_page_id.page_no);
+        buffer_pool_manager_->unpin_page(page->get_page_id(), true);
+    }
+    for (int i = 0; i < n; i++) {
+        set_dir(n + i, get_dir(i));
+    }
+    file_hdr_->global_depth_++;
+    file_hdr_->update_tot_len();
+}
+
+/**
+ * @brief 文件头有变化时重新写入缓冲池中的文件头页面并标记为脏页
+ * @param transaction 修改索引的事务，不为空时用事务最后一条日志的lsn标记文件头页面
+ */
+void IxHashIndexHandle::update_file_hdr(Transaction *transaction) {
+    assert(IX_FILE_HDR_OFFSET + file_hdr_->tot_len_ <= PAGE_SIZE);
+    std::vector<char> buf(file_hdr_->tot_len_);
+    file_hdr_->serialize(buf.data());
+    char *dest = file_hdr_page_->get_data() + IX_FILE_HDR_OFFSET;
+    if (memcmp(dest, buf.data(), buf.size()) == 0) {
+        return;
+    }
+    memcpy(dest, buf.data(), buf.size());
+    if (transaction != nullptr && transaction->get_prev_lsn() > file_hdr_page_->get_page_lsn()) {
+        file_hdr_page_->set_page_lsn(transaction->get_prev_lsn());
+    }
+    buffer_pool_manager_->fetch_page(file_hdr_page_->get_page_id());
+    buffer_pool_manager_->unpin_page(file_hdr_page_->get_page_id(), true);
+}
@@ -0,0 +1,121 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <shared_mutex>
+
+#include "ix_defs.h"
+#include "ix_index.h"
+
+/* 管理哈希索引的一个桶页面（包括溢出页） */
+class IxHashBucketHandle {
+    friend class IxHashIndexHandle;
+
+   private:
+    const IxHashFileHdr *file_hdr;  // 桶所在文件的头部信息
+    Page *page;                     // 存储桶的页面
+    IxHashBucketHdr *bucket_hdr;    // 页面lsn之后的页头
+    char *entries;                  // 页头之后依次存放的(key, rid)，每项长度为col_tot_len_ + sizeof(Rid)
+
+   public:
+    IxHashBucketHandle(const IxHashFileHdr *file_hdr_, Page *page_) : file_hdr(file_hdr_), page(page_) {
+        bucket_hdr = reinterpret_cast<IxHashBucketHdr *>(page->get_data() + Page::OFFSET_PAGE_HDR);
+        entries = page->get_data() + Page::OFFSET_PAGE_HDR + sizeof(IxHashBucketHdr);
+    }
+
+    int get_size() const { return bucket_hdr->num_entries; }
+
+    bool is_full() const { return bucket_hdr->num_entries >= file_hdr->bucket_capacity_; }
+
+    page_id_t get_page_no() const { return page->get_page_id().page_no; }
+
+    char *get_key(int i) const { return entries + i * entry_len(); }
+
+    Rid *get_rid(int i) const { return reinterpret_cast<Rid *>(get_key(i) + file_hdr->col_tot_len_); }
+
+    void append(const char *key, const Rid &rid) {
+        assert(!is_full());
+        memcpy(get_key(bucket_hdr->num_entries), key, file_hdr->col_tot_len_);
+        *get_rid(bucket_hdr->num_entries) = rid;
+        bucket_hdr->num_entries++;
+    }
+
+    /** 把最后一个键值对移到位置i，桶内的键值对不需要有序 */
+    void erase(int i) {
+        bucket_hdr->num_entries--;
+        if (i != bucket_hdr->num_entries) {
+            memcpy(get_key(i), get_key(bucket_hdr->num_entries), entry_len());
+        }
+    }
+
+   private:
+    int entry_len() const { return file_hdr->col_tot_len_ + sizeof(Rid); }
+};
+
+/**
+ * 可扩展哈希索引，只支持等值查找
+ * 目录有2^global_depth项，key的哈希值取低global_depth位找到目录项，目录项指向桶页面，多个目录项可以指向同一个桶。
+ * 桶满时分裂：local_depth等于global_depth时先把目录翻倍，再按第local_depth位把桶中的键值对分到两个桶中；
+ * 桶中所有key的哈希值都相同（如非唯一索引中大量相同的key）时分裂没有用，改为在桶后面挂溢出页。
+ * 所有页面都通过缓冲池读写，整个索引用一把读写锁保护
+ */
+class IxHashIndexHandle : public IxIndex {
+    friend class IxManager;
+
+   private:
+    DiskManager *disk_manager_;
+    BufferPoolManager *buffer_pool_manager_;
+    int fd_;                            // 存储哈希索引的文件
+    IxHashFileHdr *file_hdr_;
+    Page *file_hdr_page_;               // 文件头所在的第0页，打开期间一直pin在缓冲池中
+    std::shared_mutex latch_;           // 查找加读锁，插入和删除加写锁
+
+   public:
+    IxHashIndexHandle(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager, int fd);
+
+    ~IxHashIndexHandle() override { delete file_hdr_; }
+
+    bool get_value(const char *key, std::vector<Rid> *result, Transaction *transaction) override;
+
+    page_id_t insert_entry(const char *key, const Rid &value, Transaction *transaction) override;
+
+    bool delete_entry(const char *key, const Rid &value, Transaction *transaction) override;
+
+    int get_global_depth() const { return file_hdr_->global_depth_; }
+
+    /** 计算key的哈希值，与key_cmp_一致：比较结果相等的key哈希值相同 */
+    static uint64_t hash_key(const char *key, const std::vector<ColType> &col_types, const std::vector<int> &col_lens);
+
+   private:
+    uint64_t hash(const char *key) const { return hash_key(key, file_hdr_->col_types_, file_hdr_->col_lens_); }
+
+    int dir_index(uint64_t hash) const { return static_cast<int>(hash & ((1ull << file_hdr_->global_depth_) - 1)); }
+
+    page_id_t get_dir(int idx) const;
+
+    void set_dir(int idx, page_id_t page_no);
+
+    IxHashBucketHandle fetch_bucket(page_id_t page_no) const;
+
+    IxHashBucketHandle create_bucket(int local_depth);
+
+    void release_bucket(const IxHashBucketHandle &bucket, bool is_dirty) const;
+
+    bool find_entry(page_id_t bucket_page, const char *key, const Rid *value, page_id_t *page_no, int *pos) const;
+
+    bool can_split(page_id_t bucket_page, uint64_t hash) const;
+
+    void split_bucket(int idx);
+
+    void double_directory();
+
+    void update_file_hdr(Transaction *transaction);
+};
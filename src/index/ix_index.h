@@ -0,0 +1,46 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <vector>
+
+#include "defs.h"
+#include "transaction/transaction.h"
+
+/**
+ * 索引的点操作接口：B+树（IxIndexHandle）和可扩展哈希（IxHashIndexHandle）都实现，
+ * 执行器维护索引、按key查找时不需要区分索引类型；范围扫描只有B+树支持
+ */
+class IxIndex {
+   public:
+    virtual ~IxIndex() = default;
+
+    /** 查找key对应的所有rid，追加到result中，返回是否找到 */
+    virtual bool get_value(const char *key, std::vector<Rid> *result, Transaction *transaction) = 0;
+
+    /** 插入(key, value)，唯一索引中key已存在（非唯一索引中(key, value)已存在）时返回IX_NO_PAGE */
+    virtual page_id_t insert_entry(const char *key, const Rid &value, Transaction *transaction) = 0;
+
+    /** 删除(key, value)，返回键值对是否存在 */
+    virtual bool delete_entry(const char *key, const Rid &value, Transaction *transaction) = 0;
+
+    /**
+     * 批量删除n个键值对，keys中依次存放n个key，返回实际删除的数量；
+     * 默认逐个调用delete_entry，B+树按叶子结点成批删除
+     */
+    virtual int delete_entries(const char *keys, int key_len, const Rid *values, int n, Transaction *transaction) {
+        int deleted = 0;
+        for (int i = 0; i < n; i++) {
+            deleted += delete_entry(keys + static_cast<size_t>(i) * key_len, values[i], transaction);
+        }
+        return deleted;
+    }
+};
@@ -10,8 +10,37 @@ See the Mulan PSL v2 for more details. */
 
 #include "ix_index_handle.h"
 
+#include <algorithm>
+
+#include "ix_node_search.h"
 #include "ix_scan.h"
 
+/**
+ * @brief 单列INT/FLOAT索引在keys[lo, hi)中查找第一个>=target（Upper为true时是>target）的位置
+ * 非唯一索引的key附加了rid：先按第一个字段找出与target相等的区间，再在区间内按rid的字节序二分
+ */
+template <typename T, bool Upper>
+static int scalar_key_search(const char *keys, int lo, int hi, const char *target, const IxFileHdr *file_hdr) {
+    const T *first = reinterpret_cast<const T *>(keys);
+    T prefix = *reinterpret_cast<const T *>(target);
+    if (file_hdr->unique_) {
+        return ix_node_search<T, Upper>(first, lo, hi, prefix, ix_search_use_avx2());
+    }
+    int stride = file_hdr->col_tot_len_ / sizeof(T);
+    int begin = ix_node_search<T, false>(first, lo, hi, prefix, ix_search_use_avx2(), stride);
+    int end = ix_node_search<T, true>(first, begin, hi, prefix, ix_search_use_avx2(), stride);
+    while (begin < end) {
+        int mid = (begin + end) / 2;
+        int res = memcmp(keys + mid * file_hdr->col_tot_len_ + sizeof(T), target + sizeof(T), IX_RID_KEY_LEN);
+        if (Upper ? res <= 0 : res < 0) {
+            begin = mid + 1;
+        } else {
+            end = mid;
+        }
+    }
+    return begin;
+}
+
 /**
  * @brief 在当前node中查找第一个>=target的key_idx
  *
@@ -21,18 +50,32 @@ See the Mulan PSL v2 for more details. */
 int IxNodeHandle::lower_bound(const char *target) const {
     // Todo:
     // 查找当前节点中第一个大于等于target的key，并返回key的位置给上层
-    // 提示: 可以采用多种查找方式，如顺序遍历、二分查找等；使用ix_compare()函数进行比较
+    // 提示: 可以采用多种查找方式，如顺序遍历、二分查找等；使用file_hdr->key_cmp_进行比较
+
+    if (is_compressed()) {
+        return compressed_search(target, 0, false);
+    }
+    int num_key = page_hdr->num_key;
+    switch (file_hdr->key_kind_) {
+        case IX_KEY_INT:
+            return scalar_key_search<int, false>(keys, 0, num_key, target, file_hdr);
+        case IX_KEY_FLOAT:
+            return scalar_key_search<float, false>(keys, 0, num_key, target, file_hdr);
+        default:
+            break;
+    }
 
     //采用二分查找
     int low = 0, high = page_hdr->num_key - 1;
     while(low <= high)
     {
         int mid = (low + high)/2;
-        if(ix_compare(get_key(mid), target, file_hdr->col_types_, file_hdr->col_lens_) == 0)
+        int res = file_hdr->key_cmp_(get_key(mid), target);
+        if(res == 0)
         {
             return mid;
         }
-        else if(ix_compare(get_key(mid), target, file_hdr->col_types_, file_hdr->col_lens_) > 0)
+        else if(res > 0)
         {
             high = mid - 1;
         }
@@ -55,18 +98,32 @@ int IxNodeHandle::lower_bound(const char *target) const {
 int IxNodeHandle::upper_bound(const char *target) const {
     // Todo:
     // 查找当前节点中第一个大于target的key，并返回key的位置给上层
-    // 提示: 可以采用多种查找方式：顺序遍历、二分查找等；使用ix_compare()函数进行比较
+    // 提示: 可以采用多种查找方式：顺序遍历、二分查找等；使用file_hdr->key_cmp_进行比较
+
+    if (is_compressed()) {
+        return compressed_search(target, 1, true);
+    }
+    int num_key = page_hdr->num_key;
+    switch (file_hdr->key_kind_) {
+        case IX_KEY_INT:
+            return scalar_key_search<int, true>(keys, 1, num_key, target, file_hdr);
+        case IX_KEY_FLOAT:
+            return scalar_key_search<float, true>(keys, 1, num_key, target, file_hdr);
+        default:
+            break;
+    }
 
     // //采用二分查找
     int low = 1, high = page_hdr->num_key - 1;
     while(low <= high)
     {
         int mid = (low + high)/2;
-        if(ix_compare(get_key(mid), target, file_hdr->col_types_, file_hdr->col_lens_) == 0)
+        int res = file_hdr->key_cmp_(get_key(mid), target);
+        if(res == 0)
         {
             return (mid + 1);
         }
-        else if(ix_compare(get_key(mid), target, file_hdr->col_types_, file_hdr->col_lens_) > 0)
+        else if(res > 0)
         {
             high = mid - 1;
         }
@@ -98,7 +155,7 @@ bool IxNodeHandle::leaf_lookup(const char *key, Rid **value) {
     //获取目标key的位置
     int key_pos = lower_bound(key);
     //存在
-    if(key_pos != page_hdr->num_key && ix_compare(key, get_key(key_pos), file_hdr->col_types_, file_hdr->col_lens_) == 0)
+    if(key_pos != page_hdr->num_key && file_hdr->key_cmp_(key, get_key(key_pos)) == 0)
     {
         *value = get_rid(key_pos);
         return true;
@@ -148,7 +205,31 @@ void IxNodeHandle::insert_pairs(int pos, const char *key, const Rid *rid, int n)
     //pos不合法
     if(!(pos >= 0 && pos <= size))
         return;
-    
+
+    if (is_compressed()) {
+        if (n == 0) {
+            return;
+        }
+        page->mark_modified();
+        // 新的key可能不共享原来的前缀或者更长，先按新的布局重排整个结点；
+        // 空结点中留下的前缀长度可能恰好相同而内容不同，总是重写
+        int prefix, suffix;
+        compressed_layout(key, n, &prefix, &suffix);
+        if (size == 0 || prefix != prefix_len() || suffix != suffix_len()) {
+            relayout(prefix, suffix, key);
+        }
+        assert(size + n <= compressed_slots(prefix, suffix));
+        Rid *rid_base = compressed_rids();
+        memmove(key_suffix(pos + n), key_suffix(pos), (size - pos) * suffix);
+        memmove(rid_base + pos + n, rid_base + pos, (size - pos) * sizeof(Rid));
+        for (int i = 0; i < n; i++) {
+            memcpy(key_suffix(pos + i), key + file_hdr->col_tot_len_ * i + prefix, suffix);
+            rid_base[pos + i] = rid[i];
+        }
+        set_size(size + n);
+        return;
+    }
+
     //pos合法
     //腾出空间
     for(int i = size - 1; i >= pos; i--)
@@ -183,7 +264,7 @@ int IxNodeHandle::insert(const char *key, const Rid &value) {
     // 4. 返回完成插入操作之后的键值对数量
 
     int pos = lower_bound(key);
-    if(ix_compare(key, get_key(pos), file_hdr->col_types_, file_hdr->col_lens_) != 0)
+    if(pos == get_size() || file_hdr->key_cmp_(key, get_key(pos)) != 0)
     {
         insert_pair(pos, key, value);
         return get_size();
@@ -203,6 +284,16 @@ void IxNodeHandle::erase_pair(int pos) {
     // 2. 删除该位置的rid
     // 3. 更新结点的键值对数量
 
+    page->mark_modified();
+    if (is_compressed()) {
+        int suffix = suffix_len();
+        Rid *rid_base = compressed_rids();
+        memmove(key_suffix(pos), key_suffix(pos + 1), (get_size() - pos - 1) * suffix);
+        memmove(rid_base + pos, rid_base + pos + 1, (get_size() - pos - 1) * sizeof(Rid));
+        set_size(get_size() - 1);
+        return;
+    }
+
     memmove(keys + pos * file_hdr->col_tot_len_, keys + (pos + 1) * file_hdr->col_tot_len_, (page_hdr->num_key - pos - 1) * file_hdr->col_tot_len_);
     //memmove(rids + pos * sizeof(Rid), rids + (pos + 1) * sizeof(Rid), (page_hdr->num_key - pos - 1) * sizeof(Rid));
 
@@ -213,6 +304,31 @@ void IxNodeHandle::erase_pair(int pos) {
     set_size(get_size() - 1);
 }
 
+/**
+ * @brief 一次删除结点中若干位置的键值对，每段保留的键值对只移动一次
+ * @param pos 要删除的位置，严格递增
+ * @param n 要删除的数量
+ */
+void IxNodeHandle::erase_pairs(const int *pos, int n) {
+    if (n == 0) {
+        return;
+    }
+    page->mark_modified();
+    int size = get_size();
+    int len = is_compressed() ? suffix_len() : file_hdr->col_tot_len_;
+    char *key_base = is_compressed() ? key_suffix(0) : keys;
+    Rid *rid_base = is_compressed() ? compressed_rids() : rids;
+    int dest = pos[0];
+    for (int i = 0; i < n; i++) {
+        int begin = pos[i] + 1;
+        int end = i + 1 < n ? pos[i + 1] : size;
+        memmove(key_base + dest * len, key_base + begin * len, (end - begin) * len);
+        memmove(rid_base + dest, rid_base + begin, (end - begin) * sizeof(Rid));
+        dest += end - begin;
+    }
+    set_size(size - n);
+}
+
 /**
  * @brief 用于在结点中删除指定key的键值对。函数返回删除后的键值对数量
  *        调用erase_pair
@@ -226,7 +342,7 @@ int IxNodeHandle::remove(const char *key) {
     // 3. 返回完成删除操作后的键值对数量
 
     int pos = lower_bound(key);
-    if(ix_compare(key, get_key(pos), file_hdr->col_types_, file_hdr->col_lens_) == 0)
+    if(pos < get_size() && file_hdr->key_cmp_(key, get_key(pos)) == 0)
     {
         erase_pair(pos);
     }
@@ -234,19 +350,167 @@ int IxNodeHandle::remove(const char *key) {
     return get_size();
 }
 
+/**
+ * @brief 拼出压缩结点中第key_idx个完整的key，保存在key_buf_中轮流使用的两个位置之一
+ */
+char *IxNodeHandle::materialize_key(int key_idx) const {
+    int len = file_hdr->col_tot_len_;
+    if (key_buf_ == nullptr) {
+        key_buf_ = std::make_unique<char[]>(2 * len);
+    }
+    key_buf_pos_ ^= 1;
+    char *buf = key_buf_.get() + key_buf_pos_ * len;
+    copy_keys(key_idx, 1, buf);
+    return buf;
+}
+
+/**
+ * @brief 将从pos开始的n个完整的key连续地复制到dest
+ */
+void IxNodeHandle::copy_keys(int pos, int n, char *dest) const {
+    int len = file_hdr->col_tot_len_;
+    if (!is_compressed()) {
+        memcpy(dest, keys + pos * len, n * len);
+        return;
+    }
+    int prefix = prefix_len();
+    int suffix = suffix_len();
+    for (int i = 0; i < n; i++) {
+        char *key = dest + i * len;
+        memcpy(key, key_prefix(), prefix);
+        memcpy(key + prefix, key_suffix(pos + i), suffix);
+        memset(key + prefix + suffix, 0, len - prefix - suffix);
+    }
+}
+
+/**
+ * @brief 在压缩结点[lo, num_key)中查找第一个>=target（upper为true时是>target）的位置
+ * target与公共前缀不同时，它一定排在所有key之前或之后；否则只需比较后缀，target在后缀之后还有非0字节时更大
+ */
+int IxNodeHandle::compressed_search(const char *target, int lo, bool upper) const {
+    int prefix = prefix_len();
+    int suffix = suffix_len();
+    int n = std::min(get_size(), compressed_slots(prefix, suffix));
+    if (n <= lo) {
+        return lo;
+    }
+    int res = memcmp(target, key_prefix(), prefix);
+    if (res != 0) {
+        return res < 0 ? lo : n;
+    }
+    const char *target_suffix = target + prefix;
+    bool longer = ix_significant_len(target, file_hdr->col_tot_len_) > prefix + suffix;
+    int low = lo, high = n;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        res = memcmp(key_suffix(mid), target_suffix, suffix);
+        if (res == 0 && longer) {
+            res = -1;
+        }
+        if (upper ? res <= 0 : res < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+/**
+ * @brief 计算压缩结点加入n个连续有序的key之后的布局：前缀为所有key中最小和最大者的公共前缀，
+ * 后缀要能容纳所有key的非0部分（原有key的非0部分不超过prefix_len + suffix_len）
+ */
+void IxNodeHandle::compressed_layout(const char *new_keys, int n, int *prefix, int *suffix) {
+    int len = file_hdr->col_tot_len_;
+    const char *lo = new_keys;
+    const char *hi = new_keys + (n - 1) * len;
+    int end = 0;
+    for (int i = 0; i < n; i++) {
+        end = std::max(end, ix_significant_len(new_keys + i * len, len));
+    }
+    if (get_size() > 0) {
+        const char *first = get_key(0);
+        const char *last = get_key(get_size() - 1);
+        lo = memcmp(first, lo, len) < 0 ? first : lo;
+        hi = memcmp(last, hi, len) > 0 ? last : hi;
+        end = std::max(end, prefix_len() + suffix_len());
+    }
+    *prefix = ix_common_prefix_len(lo, hi, len);
+    *suffix = std::max(0, end - *prefix);
+}
+
+/**
+ * @brief 压缩结点能否在不分裂的情况下插入n个连续有序的key
+ */
+bool IxNodeHandle::can_insert(const char *key, int n) {
+    int prefix, suffix;
+    compressed_layout(key, n, &prefix, &suffix);
+    return get_size() + n <= compressed_slots(prefix, suffix);
+}
+
+/**
+ * @brief 按新的前缀长度和后缀长度重写压缩结点中所有的键值对
+ * @param prefix_src 任意一个以新前缀开头的key，用于写入前缀
+ */
+void IxNodeHandle::relayout(int prefix, int suffix, const char *prefix_src) {
+    int size = get_size();
+    int len = file_hdr->col_tot_len_;
+    std::vector<char> old_keys(size * len);
+    std::vector<Rid> old_rids(compressed_rids(), compressed_rids() + size);
+    copy_keys(0, size, old_keys.data());
+    std::vector<char> new_prefix(prefix_src, prefix_src + prefix);
+
+    page_hdr->prefix_len = static_cast<int16_t>(prefix);
+    page_hdr->suffix_len = static_cast<int16_t>(suffix);
+    memcpy(key_prefix(), new_prefix.data(), prefix);
+    Rid *rid_base = compressed_rids();
+    for (int i = 0; i < size; i++) {
+        memcpy(key_suffix(i), old_keys.data() + i * len + prefix, suffix);
+        rid_base[i] = old_rids[i];
+    }
+}
+
 IxIndexHandle::IxIndexHandle(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager, int fd)
     : disk_manager_(disk_manager), buffer_pool_manager_(buffer_pool_manager), fd_(fd) {
-    // init file_hdr_
-    disk_manager_->read_page(fd, IX_FILE_HDR_PAGE, (char *)&file_hdr_, sizeof(file_hdr_));
-    char* buf = new char[PAGE_SIZE];
-    memset(buf, 0, PAGE_SIZE);
-    disk_manager_->read_page(fd, IX_FILE_HDR_PAGE, buf, PAGE_SIZE);
+    // init file_hdr_，文件头所在的页面一直留在缓冲池中，之后只修改其中的页号字段
+    file_hdr_page_ = buffer_pool_manager_->fetch_page(PageId{fd, IX_FILE_HDR_PAGE});
     file_hdr_ = new IxFileHdr();
-    file_hdr_->deserialize(buf);
+    file_hdr_->deserialize(file_hdr_page_->get_data() + IX_FILE_HDR_OFFSET);
     
-    // disk_manager管理的fd对应的文件中，设置从file_hdr_->num_pages开始分配page_no
-    int now_page_no = disk_manager_->get_fd2pageno(fd);
-    disk_manager_->set_fd2pageno(fd, now_page_no + 1);
+    // disk_manager管理的fd对应的文件中，从文件末尾开始分配新的page_no，避免新结点覆盖已有的结点
+    int file_pages = disk_manager_->get_file_size(disk_manager_->get_file_name(fd)) / PAGE_SIZE;
+    disk_manager_->set_fd2pageno(fd, std::max(disk_manager_->get_fd2pageno(fd), file_pages));
+
+    if (IX_ADAPTIVE_HASH) {
+        ahi_slots_ = std::make_unique<IxAhiSlot[]>(IX_AHI_SLOTS);
+        ahi_keys_ = std::make_unique<char[]>(IX_AHI_SLOTS * file_hdr_->key_len());
+    }
+}
+
+thread_local uint64_t IxIndexHandle::ahi_hits_ = 0;
+
+/**
+ * @brief 把file_hdr_中的页号字段（根结点、首尾叶子结点、页面数量）写入缓冲池中的文件头页面，
+ * 页面标记为脏页，随缓冲池刷盘写回，不需要在关闭时重新序列化整个文件头
+ *
+ * @param transaction 修改索引的事务，不为空时用事务最后一条日志的lsn标记文件头页面
+ * @note 每次写操作结束时调用；页号字段没有变化时不修改页面
+ */
+void IxIndexHandle::update_file_hdr(Transaction *transaction) {
+    char page_nos[IxFileHdr::PAGE_NOS_LEN];
+    std::scoped_lock lock{file_hdr_latch_};
+    file_hdr_->serialize_page_nos(page_nos);
+    char *dest = file_hdr_page_->get_data() + IX_FILE_HDR_OFFSET + IxFileHdr::PAGE_NOS_OFFSET;
+    if (memcmp(dest, page_nos, IxFileHdr::PAGE_NOS_LEN) == 0) {
+        return;
+    }
+    memcpy(dest, page_nos, IxFileHdr::PAGE_NOS_LEN);
+    if (transaction != nullptr && transaction->get_prev_lsn() > file_hdr_page_->get_page_lsn()) {
+        file_hdr_page_->set_page_lsn(transaction->get_prev_lsn());
+    }
+    // 再pin一次并以脏页unpin，只是为了给页面加上脏标记
+    buffer_pool_manager_->fetch_page(file_hdr_page_->get_page_id());
+    buffer_pool_manager_->unpin_page(file_hdr_page_->get_page_id(), true);
 }
 
 /**
@@ -257,6 +521,10 @@ IxIndexHandle::IxIndexHandle(DiskManager *disk_manager, BufferPoolManager *buffe
  * @return [leaf node] and [root_is_latched] 返回目标叶子结点以及根结点是否加锁
  * @note need to Unlatch and unpin the leaf node outside!
  * 注意：用了FindLeafPage之后一定要unlatch叶结点，否则下次latch该结点会堵塞！
+ * FIND：先尝试find_leaf_page_optimistic()，多次失败后逐层加读锁，拿到孩子结点的读锁后立即释放父结点，
+ * 两种方式都返回加了读锁的叶子结点，需要在外面runlatch并unpin
+ * INSERT/DELETE：逐层加写锁并放入transaction的index_latch_page_set，一旦当前结点安全就释放所有祖先结点，
+ * 返回时路径上仍持有写锁的结点都在index_latch_page_set中，需要在外面调用release_latches()
  */
 std::pair<IxNodeHandle *, bool> IxIndexHandle::find_leaf_page(const char *key, Operation operation,
                                                             Transaction *transaction, bool find_first) {
@@ -265,14 +533,49 @@ std::pair<IxNodeHandle *, bool> IxIndexHandle::find_leaf_page(const char *key, O
     // 2. 从根节点开始不断向下查找目标key
     // 3. 找到包含该key值的叶子结点停止查找，并返回叶子节点
 
-    IxNodeHandle *root_node = fetch_node(file_hdr_->root_page_);
-    assert( root_node != nullptr );
-    while( !root_node -> is_leaf_page() ) {
-        root_node = fetch_node(root_node -> internal_lookup(key));
-        buffer_pool_manager_ -> unpin_page({.fd = root_node->get_page_id().fd, root_node->get_parent_page_no()}, false);
+    if (operation == Operation::FIND) {
+        for (int i = 0; i < IX_OPTIMISTIC_MAX_RETRIES; i++) {
+            IxNodeHandle *leaf = find_leaf_page_optimistic(key);
+            if (leaf != nullptr) {
+                return std::make_pair(leaf, false);
+            }
+        }
     }
-    return std::make_pair(root_node, true);
-    
+
+    root_latch_.lock();
+    bool root_is_latched = true;
+    IxNodeHandle *node = fetch_node(file_hdr_->root_page_);
+
+    if (operation == Operation::FIND) {
+        node->page->rlatch();
+        root_latch_.unlock();
+        while (!node->is_leaf_page()) {
+            IxNodeHandle *child = fetch_node(node->internal_lookup(key));
+            child->page->rlatch();
+            node->page->runlatch();
+            buffer_pool_manager_->unpin_page(node->get_page_id(), false);
+            delete node;
+            node = child;
+        }
+        return std::make_pair(node, false);
+    }
+
+    node->page->wlatch();
+    transaction->append_index_latch_page_set(node->page);
+    while (true) {
+        if (is_safe(node, key, operation)) {
+            release_ancestors(transaction, &root_is_latched);
+        }
+        if (node->is_leaf_page()) {
+            break;
+        }
+        IxNodeHandle *child = fetch_node(node->internal_lookup(key));
+        child->page->wlatch();
+        transaction->append_index_latch_page_set(child->page);
+        delete node;
+        node = child;
+    }
+    return std::make_pair(node, root_is_latched);
 }
 
 /**
@@ -282,6 +585,7 @@ std::pair<IxNodeHandle *, bool> IxIndexHandle::find_leaf_page(const char *key, O
  * @param result 用于存放结果的容器
  * @param transaction 事务指针
  * @return bool 返回目标键值对是否存在
+ * @note 非唯一索引中相同的key按rid排列在一起，从(key, IX_MIN_RID)开始取到(key, IX_MAX_RID)为止，可能跨越多个叶子结点
  */
 bool IxIndexHandle::get_value(const char *key, std::vector<Rid> *result, Transaction *transaction) {
     // Todo:
@@ -290,20 +594,169 @@ bool IxIndexHandle::get_value(const char *key, std::vector<Rid> *result, Transac
     // 3. 把rid存入result参数中
     // 提示：使用完buffer_pool提供的page之后，记得unpin page；记得处理并发的上锁
 
-    std::scoped_lock lock{root_latch_};
+    bool found;
+    if (IX_ADAPTIVE_HASH && ahi_get_value(key, result, &found)) {
+        return found;
+    }
 
-    auto leaf = find_leaf_page(key, Operation::FIND, transaction, false).first;
-    Rid ** rid = new Rid*();
-    bool key_exist = leaf->leaf_lookup(key, rid);
-    if(key_exist)
-    {
-        result->push_back(**rid);
+    if (file_hdr_->unique_) {
+        auto leaf = find_leaf_page(key, Operation::FIND, transaction, false).first;
+        Rid *rid;
+        bool key_exist = leaf->leaf_lookup(key, &rid);
+        if(key_exist)
+        {
+            result->push_back(*rid);
+        }
+        if (IX_ADAPTIVE_HASH && key_exist) {
+            ahi_record(key, leaf->get_page_no(), leaf->get_smo_version());
+        }
+        leaf->page->runlatch();
         buffer_pool_manager_->unpin_page(leaf->get_page_id(), false);
-        return true;
+        delete leaf;
+        return key_exist;
     }
 
-    return false;
+    char lower[IX_MAX_KEY_LEN], upper[IX_MAX_KEY_LEN];
+    make_key(key, IX_MIN_RID, lower);
+    make_key(key, IX_MAX_RID, upper);
+    size_t old_size = result->size();
+    while (true) {
+        IxNodeHandle *leaf = find_leaf_page(lower, Operation::FIND, transaction, false).first;
+        int pos = leaf->lower_bound(lower);
+        page_id_t leaf_page_no = leaf->get_page_no();
+        uint16_t smo_version = leaf->get_smo_version();
+        // 第一个键值对不在结点开头时，之后直接访问这个结点就能确定前一个结点中没有这个key
+        bool cacheable = pos < leaf->get_size() && file_hdr_->key_cmp_(leaf->get_key(pos), upper) <= 0 &&
+                         (pos > 0 || leaf_page_no == file_hdr_->first_leaf_);
+        if (collect_equal(leaf, pos, upper, result)) {
+            if (IX_ADAPTIVE_HASH && cacheable) {
+                ahi_record(key, leaf_page_no, smo_version);
+            }
+            return result->size() > old_size;
+        }
+        // 移动到下一个叶子结点时前一个结点被修改过，重新查找
+        result->resize(old_size);
+    }
+}
 
+/**
+ * @brief 从加了读锁的叶子结点的pos位置开始，沿叶子链表收集key不大于upper的键值对的rid
+ * @param leaf 加了读锁的叶子结点，函数内释放
+ * @return 是否收集完整；移动到下一个叶子结点时前一个结点被修改过则返回false，由调用者重新查找
+ */
+bool IxIndexHandle::collect_equal(IxNodeHandle *leaf, int pos, const char *upper, std::vector<Rid> *result) const {
+    while (true) {
+        for (; pos < leaf->get_size() && file_hdr_->key_cmp_(leaf->get_key(pos), upper) <= 0; pos++) {
+            result->push_back(*leaf->get_rid(pos));
+        }
+        if (pos < leaf->get_size() || leaf->get_page_no() == file_hdr_->last_leaf_) {
+            break;
+        }
+        leaf = next_leaf_unlatched(leaf);
+        if (leaf == nullptr) {
+            return false;
+        }
+        pos = 0;
+    }
+    leaf->page->runlatch();
+    buffer_pool_manager_->unpin_page(leaf->get_page_id(), false);
+    delete leaf;
+    return true;
+}
+
+/**
+ * @brief 用自适应哈希查找key：记录有效时直接给记录的叶子结点加读锁，在结点内查找，不经过内部结点
+ * @param[out] found key是否存在
+ * @return 是否由自适应哈希得到了结果；没有记录、记录已失效、key不在记录的叶子结点中时返回false，由调用者从根结点查找
+ * @note 只读取槽，不修改任何共享的数据
+ */
+bool IxIndexHandle::ahi_get_value(const char *key, std::vector<Rid> *result, bool *found) {
+    int len = file_hdr_->key_len();
+    size_t slot_no = ahi_slot_no(key);
+    IxAhiSlot &slot = ahi_slots_[slot_no];
+    uint32_t seq = slot.seq.load(std::memory_order_acquire);
+    if (seq & 1) {
+        return false;
+    }
+    page_id_t leaf_page_no = slot.leaf_page_no;
+    uint16_t smo_version = slot.smo_version;
+    bool valid = slot.hits >= IX_AHI_BUILD_THRESHOLD && memcmp(ahi_keys_.get() + slot_no * len, key, len) == 0;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (!valid || leaf_page_no == IX_NO_PAGE || slot.seq.load(std::memory_order_relaxed) != seq) {
+        return false;
+    }
+
+    IxNodeHandle *leaf = fetch_node(leaf_page_no);
+    leaf->page->rlatch();
+    // 移动键值对或释放结点之前都会在写锁下增加smo_version，持有读锁时版本仍然相同，
+    // 说明这个叶子结点还在树中，记录之后没有键值对被移到别的结点
+    bool hit = leaf->is_leaf_page() && leaf->get_smo_version() == smo_version;
+    if (hit && file_hdr_->unique_) {
+        Rid *rid;
+        hit = leaf->leaf_lookup(key, &rid);
+        if (hit) {
+            result->push_back(*rid);
+        }
+    } else if (hit) {
+        char lower[IX_MAX_KEY_LEN], upper[IX_MAX_KEY_LEN];
+        make_key(key, IX_MIN_RID, lower);
+        make_key(key, IX_MAX_RID, upper);
+        int pos = leaf->lower_bound(lower);
+        hit = pos < leaf->get_size() && file_hdr_->key_cmp_(leaf->get_key(pos), upper) <= 0 &&
+              (pos > 0 || leaf->get_page_no() == file_hdr_->first_leaf_);
+        if (hit) {
+            size_t old_size = result->size();
+            if (!collect_equal(leaf, pos, upper, result)) {
+                result->resize(old_size);
+                return false;
+            }
+            ahi_hits_++;
+            *found = true;
+            return true;
+        }
+    }
+    leaf->page->runlatch();
+    buffer_pool_manager_->unpin_page(leaf->get_page_id(), false);
+    delete leaf;
+    if (hit) {
+        ahi_hits_++;
+        *found = true;
+    }
+    return hit;
+}
+
+/**
+ * @brief 从根结点查找到key之后，按IX_AHI_SAMPLE_RATE抽样记录它所在的叶子结点，
+ * 同一个key被记录IX_AHI_BUILD_THRESHOLD次后开始使用；其它线程正在写同一个槽时放弃这次记录
+ * @param smo_version 查找时持有读锁读到的叶子结点的smo_version
+ */
+void IxIndexHandle::ahi_record(const char *key, page_id_t leaf_page_no, uint16_t smo_version) {
+    static thread_local uint32_t rng = 2463534242u;  // xorshift32，每个线程独立抽样
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    if (rng % IX_AHI_SAMPLE_RATE != 0) {
+        return;
+    }
+
+    int len = file_hdr_->key_len();
+    size_t slot_no = ahi_slot_no(key);
+    IxAhiSlot &slot = ahi_slots_[slot_no];
+    uint32_t seq = slot.seq.load(std::memory_order_relaxed);
+    if ((seq & 1) || !slot.seq.compare_exchange_strong(seq, seq + 1, std::memory_order_acquire)) {
+        return;
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    char *slot_key = ahi_keys_.get() + slot_no * len;
+    if (slot.leaf_page_no != IX_NO_PAGE && memcmp(slot_key, key, len) == 0) {
+        slot.hits = std::min(slot.hits + 1, IX_AHI_BUILD_THRESHOLD);
+    } else {
+        memcpy(slot_key, key, len);  // 哈希冲突时覆盖原来的key，重新统计
+        slot.hits = 1;
+    }
+    slot.leaf_page_no = leaf_page_no;
+    slot.smo_version = smo_version;
+    slot.seq.store(seq + 2, std::memory_order_release);
 }
 
 /**
@@ -321,6 +774,7 @@ IxNodeHandle *IxIndexHandle::split(IxNodeHandle *node) {
     //    为新节点分配键值对，更新旧节点的键值对数记录
     // 3. 如果新的右兄弟结点不是叶子结点，更新该结点的所有孩子结点的父节点信息(使用IxIndexHandle::maintain_child())
 
+    node->bump_smo_version();
     IxNodeHandle * new_node = create_node();
 
     //如果节点是叶子节点
@@ -332,14 +786,17 @@ IxNodeHandle *IxIndexHandle::split(IxNodeHandle *node) {
         {
             file_hdr_->last_leaf_ = new_node->get_page_no();
         }
-        //修改指针
+        //修改指针，右边的叶子结点不在查找路径上，需要单独加写锁（总是从左往右加锁，不会死锁）
         IxNodeHandle * node_next = fetch_node(node->get_next_leaf());
+        node_next->page->wlatch();
         new_node->set_next_leaf(node_next->get_page_no());
         new_node->set_prev_leaf(node->get_page_no());
         node_next->set_prev_leaf(new_node->get_page_no());
         node->set_next_leaf(new_node->get_page_no());
 
+        node_next->page->wunlatch();
         buffer_pool_manager_->unpin_page(node_next->get_page_id(), true);
+        delete node_next;
     }
 
     int n = (node->get_size() + 1) / 2;
@@ -409,11 +866,164 @@ void IxIndexHandle::insert_into_parent(IxNodeHandle *old_node, const char *key,
     buffer_pool_manager_->unpin_page(parent->get_page_id(), true);
 }
 
+/**
+ * @brief 压缩结点放不下新插入的n个连续键值对时，将原有的键值对和新键值对一起平均分到m个结点中，
+ * 再把后面m-1个结点一次性插入父结点，父结点放不下时递归分裂
+ * 新的key可能使公共前缀变短、后缀变长，结点容量随之变小，因此m不一定是2，取能放下所有键值对的最小值；
+ * 第一个结点复用node。叶子结点向父结点插入的是后缀截断后的最短分隔key
+ *
+ * @param node 要分裂的结点
+ * @param pos 新键值对在node中的插入位置
+ * @param (key, rid) n个连续有序的新键值对，内部结点中rid为孩子结点
+ * @return 第一个新键值对所在结点的页号
+ * @note 压缩索引的父结点中的key只需满足 左边子树的key < 分隔key <= 右边子树的key，不要求等于孩子的第一个key；
+ * 每一层最多向父结点插入file_hdr_->compress_split_keys_个key，is_safe()据此判断内部结点是否安全
+ */
+page_id_t IxIndexHandle::split_compressed(IxNodeHandle *node, int pos, const char *key, const Rid *rid, int n,
+                                          Transaction *transaction) {
+    node->bump_smo_version();
+    int len = file_hdr_->col_tot_len_;
+    int size = node->get_size();
+    int tot = size + n;
+    std::vector<char> keys(tot * len);
+    std::vector<Rid> rids(tot);
+    node->copy_keys(0, pos, keys.data());
+    node->copy_keys(pos, size - pos, keys.data() + (pos + n) * len);
+    memcpy(keys.data() + pos * len, key, n * len);
+    for (int i = 0; i < size; i++) {
+        rids[i < pos ? i : i + n] = *node->get_rid(i);
+    }
+    std::copy(rid, rid + n, rids.begin() + pos);
+
+    // bounds[j]为第j个结点的第一个键值对，每个结点的键值对数量相差不超过1
+    std::vector<int> bounds;
+    for (int m = 2;; m++) {
+        bounds.clear();
+        for (int j = 0; j <= m; j++) {
+            bounds.push_back(static_cast<int>(static_cast<long long>(j) * tot / m));
+        }
+        bool fit = true;
+        for (int j = 0; j < m && fit; j++) {
+            int end = 0;
+            for (int i = bounds[j]; i < bounds[j + 1]; i++) {
+                end = std::max(end, ix_significant_len(keys.data() + i * len, len));
+            }
+            int prefix = ix_common_prefix_len(keys.data() + bounds[j] * len, keys.data() + (bounds[j + 1] - 1) * len, len);
+            fit = bounds[j + 1] - bounds[j] <= IxNodeHandle::compressed_slots(prefix, std::max(0, end - prefix));
+        }
+        if (fit) {
+            break;
+        }
+    }
+    int m = static_cast<int>(bounds.size()) - 1;
+
+    std::vector<IxNodeHandle *> nodes = {node};
+    for (int j = 1; j < m; j++) {
+        IxNodeHandle *new_node = create_node();
+        new_node->page_hdr->is_leaf = node->is_leaf_page();
+        new_node->set_parent_page_no(node->get_parent_page_no());
+        nodes.push_back(new_node);
+    }
+    int key_node = 0;
+    for (int j = 0; j < m; j++) {
+        nodes[j]->set_size(0);
+        nodes[j]->insert_pairs(0, keys.data() + bounds[j] * len, rids.data() + bounds[j], bounds[j + 1] - bounds[j]);
+        if (pos >= bounds[j]) {
+            key_node = j;
+        }
+    }
+
+    if (node->is_leaf_page()) {
+        // 右边的叶子结点不在查找路径上，需要单独加写锁
+        IxNodeHandle *node_next = fetch_node(node->get_next_leaf());
+        node_next->page->wlatch();
+        for (int j = 1; j < m; j++) {
+            nodes[j]->set_prev_leaf(nodes[j - 1]->get_page_no());
+            nodes[j - 1]->set_next_leaf(nodes[j]->get_page_no());
+        }
+        nodes[m - 1]->set_next_leaf(node_next->get_page_no());
+        node_next->set_prev_leaf(nodes[m - 1]->get_page_no());
+        if (file_hdr_->last_leaf_ == node->get_page_no()) {
+            file_hdr_->last_leaf_ = nodes[m - 1]->get_page_no();
+        }
+        node_next->page->wunlatch();
+        buffer_pool_manager_->unpin_page(node_next->get_page_id(), true);
+        delete node_next;
+    } else {
+        for (int j = 1; j < m; j++) {
+            for (int i = 0; i < nodes[j]->get_size(); i++) {
+                maintain_child(nodes[j], i);
+            }
+        }
+        for (int i = pos; i < std::min(pos + n, bounds[1]); i++) {
+            maintain_child(node, i);
+        }
+    }
+
+    // 后面m-1个结点的分隔key和页号
+    std::vector<char> seps((m - 1) * len);
+    std::vector<Rid> children(m - 1);
+    for (int j = 1; j < m; j++) {
+        const char *first = keys.data() + bounds[j] * len;
+        if (node->is_leaf_page()) {
+            ix_make_separator(first - len, first, len, seps.data() + (j - 1) * len);
+        } else {
+            memcpy(seps.data() + (j - 1) * len, first, len);
+        }
+        children[j - 1] = Rid{.page_no = nodes[j]->get_page_no(), .slot_no = -1};
+    }
+
+    IxNodeHandle *parent;
+    if (node->is_root_page()) {
+        // 根结点发生变化，此时仍持有root_latch_
+        parent = create_node();
+        update_root_page_no(parent->get_page_no());
+        parent->set_parent_page_no(INVALID_PAGE_ID);
+        parent->insert_pair(0, keys.data(), Rid{.page_no = node->get_page_no(), .slot_no = -1});
+        node->set_parent_page_no(parent->get_page_no());
+    } else {
+        parent = fetch_node(node->get_parent_page_no());
+    }
+    int parent_pos = parent->find_child(node) + 1;
+    if (parent->can_insert(seps.data(), m - 1)) {
+        parent->insert_pairs(parent_pos, seps.data(), children.data(), m - 1);
+        for (int j = 1; j < m; j++) {
+            nodes[j]->set_parent_page_no(parent->get_page_no());
+        }
+    } else {
+        split_compressed(parent, parent_pos, seps.data(), children.data(), m - 1, transaction);
+    }
+    buffer_pool_manager_->unpin_page(parent->get_page_id(), true);
+    delete parent;
+
+    page_id_t page_no = nodes[key_node]->get_page_no();
+    for (int j = 1; j < m; j++) {
+        buffer_pool_manager_->unpin_page(nodes[j]->get_page_id(), true);
+        delete nodes[j];
+    }
+    return page_no;
+}
+
+/**
+ * @brief 判断两个相邻的压缩结点合并后能否放进一个结点
+ * @param (left, right) 左右两个非空结点
+ */
+bool IxIndexHandle::can_merge(IxNodeHandle *left, IxNodeHandle *right) {
+    int len = file_hdr_->col_tot_len_;
+    std::vector<char> first(len), last(len);
+    left->copy_keys(0, 1, first.data());
+    right->copy_keys(right->get_size() - 1, 1, last.data());
+    int prefix = ix_common_prefix_len(first.data(), last.data(), len);
+    int end = std::max(left->prefix_len() + left->suffix_len(), right->prefix_len() + right->suffix_len());
+    return left->get_size() + right->get_size() <= IxNodeHandle::compressed_slots(prefix, std::max(0, end - prefix));
+}
+
 /**
  * @brief 将指定键值对插入到B+树中
  * @param (key, value) 要插入的键值对
  * @param transaction 事务指针
- * @return page_id_t 插入到的叶结点的page_no
+ * @return page_id_t 插入到的叶结点的page_no；唯一索引中key已经存在（非唯一索引中(key, value)已经存在）时不插入，返回IX_NO_PAGE
+ * @note 唯一性在插入的同一次下降中、在持有叶结点写锁时判断，不需要额外的查找
  */
 page_id_t IxIndexHandle::insert_entry(const char *key, const Rid &value, Transaction *transaction) {
     // Todo:
@@ -422,64 +1032,201 @@ page_id_t IxIndexHandle::insert_entry(const char *key, const Rid &value, Transac
     // 3. 如果结点已满，分裂结点，并把新结点的相关信息插入父节点
     // 提示：记得unpin page；若当前叶子节点是最右叶子节点，则需要更新file_hdr_.last_leaf；记得处理并发的上锁
 
-    std::scoped_lock lock{root_latch_};
-    
-    IxNodeHandle * leaf = find_leaf_page(key, Operation::INSERT, transaction, false).first;
-    int size_prev = leaf->get_size();
-    int size_now = leaf->insert(key, value);
-    bool success = (size_now != -1 && size_now != size_prev);
-    if(leaf->get_size() == leaf->get_max_size())
+    Transaction local_txn(INVALID_TXN_ID);  // 上层没有传入事务时，用于记录加锁的页面
+    if (transaction == nullptr) {
+        transaction = &local_txn;
+    }
+    char key_buf[IX_MAX_KEY_LEN];
+    key = make_key(key, value, key_buf);
+
+    auto [leaf, root_is_latched] = find_leaf_page(key, Operation::INSERT, transaction, false);
+    page_id_t page_no = leaf->get_page_no();
+    bool split_node = false;    // 分裂会改变文件头中的页面数量、根结点和尾叶子结点
+    if (file_hdr_->compress_) {
+        int pos = leaf->lower_bound(key);
+        if (pos == leaf->get_size() || file_hdr_->key_cmp_(key, leaf->get_key(pos)) != 0) {
+            if (leaf->can_insert(key)) {
+                leaf->insert_pair(pos, key, value);
+            } else {
+                page_no = split_compressed(leaf, pos, key, &value, 1, transaction);
+                split_node = true;
+            }
+        } else {
+            page_no = IX_NO_PAGE;
+        }
+        delete leaf;
+        release_latches(transaction, &root_is_latched);
+        if (split_node) {
+            update_file_hdr(transaction);
+        }
+        return page_no;
+    }
+
+    if (leaf->insert(key, value) == -1) {
+        page_no = IX_NO_PAGE;
+    } else if(leaf->get_size() == leaf->get_max_size())
     {
         auto new_node = split(leaf);
         insert_into_parent(leaf, new_node->get_key(0), new_node, transaction);
+        if (file_hdr_->key_cmp_(key, new_node->get_key(0)) >= 0) {
+            page_no = new_node->get_page_no();
+        }
         buffer_pool_manager_->unpin_page(new_node->get_page_id(), true);
+        delete new_node;
+        split_node = true;
+    }
+    delete leaf;
+    release_latches(transaction, &root_is_latched);
+    if (split_node) {
+        update_file_hdr(transaction);
     }
-    buffer_pool_manager_->unpin_page(leaf->get_page_id(), success);
 
-    IxNodeHandle * leaf1 = find_leaf_page(key, Operation::FIND, transaction, false).first;
-    buffer_pool_manager_->unpin_page(leaf1->get_page_id(), success);
-    return leaf1->get_page_no();
+    return page_no;
 
 }
 
 /**
- * @brief 用于删除B+树中含有指定key的键值对
+ * @brief 用于删除B+树中含有指定key的键值对，非唯一索引中有多个时删除rid最小的一个
  * @param key 要删除的key值
  * @param transaction 事务指针
  */
 bool IxIndexHandle::delete_entry(const char *key, Transaction *transaction) {
+    if (file_hdr_->unique_) {
+        return erase_entry(key, nullptr, transaction);
+    }
+    std::vector<Rid> rids;
+    if (!get_value(key, &rids, transaction)) {
+        return false;
+    }
+    return delete_entry(key, rids[0], transaction);
+}
+
+/**
+ * @brief 删除键值对(key, value)，非唯一索引中直接定位到这一个键值对，不需要逐个比较相同key的rid
+ * @param (key, value) 要删除的键值对
+ * @param transaction 事务指针
+ * @return 键值对是否存在
+ */
+bool IxIndexHandle::delete_entry(const char *key, const Rid &value, Transaction *transaction) {
+    char key_buf[IX_MAX_KEY_LEN];
+    return erase_entry(make_key(key, value, key_buf), &value, transaction);
+}
+
+/**
+ * @brief 删除结点中的key为key的键值对
+ * @param key 结点中的key（非唯一索引已经附加了rid）
+ * @param value 不为nullptr时，只有键值对的rid与之相等才删除
+ * @param transaction 事务指针
+ */
+bool IxIndexHandle::erase_entry(const char *key, const Rid *value, Transaction *transaction) {
     // Todo:
     // 1. 获取该键值对所在的叶子结点
     // 2. 在该叶子结点中删除键值对
     // 3. 如果删除成功需要调用CoalesceOrRedistribute来进行合并或重分配操作，并根据函数返回结果判断是否有结点需要删除
     // 4. 如果需要并发，并且需要删除叶子结点，则需要在事务的delete_page_set中添加删除结点的对应页面；记得处理并发的上锁
 
-    std::scoped_lock lock{root_latch_};
-
-    auto result = find_leaf_page(key, Operation::DELETE, transaction, false);
-    IxNodeHandle * leaf_node = result.first;
-    bool root_is_latch = result.second;
-
-    int prev_size = leaf_node->get_size();
-    int now_size = leaf_node->remove(key);
-    bool success = now_size < prev_size;
+    Transaction local_txn(INVALID_TXN_ID);  // 上层没有传入事务时，用于记录加锁和删除的页面
+    if (transaction == nullptr) {
+        transaction = &local_txn;
+    }
 
-    maintain_parent(leaf_node);
+    auto [leaf_node, root_is_latched] = find_leaf_page(key, Operation::DELETE, transaction, false);
 
+    int pos = leaf_node->lower_bound(key);
+    bool success = pos < leaf_node->get_size() &&
+                   file_hdr_->key_cmp_(key, leaf_node->get_key(pos)) == 0 &&
+                   (value == nullptr || *leaf_node->get_rid(pos) == *value);
+    bool merged = false;
     if(success)
     {
-        bool need_delete = coalesce_or_redistribute(leaf_node, transaction, &root_is_latch);
-        if (need_delete)
-        {
-            transaction->append_index_deleted_page(leaf_node->page);
+        leaf_node->erase_pair(pos);
+        // 只有删除了第一个key时才需要修改父结点，此时find_leaf_page保证了父结点仍被持有
+        if (pos == 0) {
+            maintain_parent(leaf_node);
         }
+        // 删除了结点时文件头中的页面数量、根结点或尾叶子结点可能改变
+        merged = coalesce_or_redistribute(leaf_node, transaction, &root_is_latched);
+    }
+    delete leaf_node;
+    release_latches(transaction, &root_is_latched);
+    if (merged) {
+        update_file_hdr(transaction);
     }
-
-    buffer_pool_manager_->unpin_page(leaf_node->get_page_id(), true);
 
     return success;
 }
 
+/**
+ * @brief 批量删除键值对：先按结点中key的顺序排序，落在同一个叶子结点中的键值对一次删除，
+ * 之后对这个叶子结点只做一次合并或重分配，而不是每删除一个键值对调整一次
+ * @param keys 依次存放的n个key，每个长度为key_len
+ * @param values 对应的rid，与delete_entry(key, value)相同，rid不相等的键值对不删除
+ * @return 实际删除的键值对数量
+ */
+int IxIndexHandle::delete_entries(const char *keys, int key_len, const Rid *values, int n, Transaction *transaction) {
+    assert(key_len == file_hdr_->key_len());
+    Transaction local_txn(INVALID_TXN_ID);
+    if (transaction == nullptr) {
+        transaction = &local_txn;
+    }
+
+    int len = file_hdr_->col_tot_len_;
+    std::vector<char> node_keys(static_cast<size_t>(n) * len);
+    std::vector<int> order(n);
+    for (int i = 0; i < n; i++) {
+        char *dest = node_keys.data() + static_cast<size_t>(i) * len;
+        memcpy(dest, make_key(keys + static_cast<size_t>(i) * key_len, values[i], dest), len);
+        order[i] = i;
+    }
+    auto node_key = [&](int i) { return node_keys.data() + static_cast<size_t>(order[i]) * len; };
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        return file_hdr_->key_cmp_(node_keys.data() + static_cast<size_t>(a) * len,
+                                   node_keys.data() + static_cast<size_t>(b) * len) < 0;
+    });
+
+    int deleted = 0;
+    std::vector<char> last_key(len);
+    std::vector<int> positions;
+    for (int i = 0; i < n;) {
+        auto [leaf, root_is_latched] = find_leaf_page(node_key(i), Operation::DELETE_BATCH, transaction, false);
+        // 从第i个key开始，不大于结点中最后一个key的都落在这个叶子结点中；最右叶子结点包括之后所有key
+        bool is_last = leaf->get_page_no() == file_hdr_->last_leaf_;
+        int size = leaf->get_size();
+        if (size > 0) {
+            memcpy(last_key.data(), leaf->get_key(size - 1), len);
+        }
+        positions.clear();
+        int pos = leaf->lower_bound(node_key(i));
+        int begin = i;
+        for (; i < n && (i == begin || is_last || (size > 0 && file_hdr_->key_cmp_(node_key(i), last_key.data()) <= 0));
+             i++) {
+            while (pos < size && file_hdr_->key_cmp_(leaf->get_key(pos), node_key(i)) < 0) {
+                pos++;
+            }
+            if (pos < size && file_hdr_->key_cmp_(leaf->get_key(pos), node_key(i)) == 0 &&
+                *leaf->get_rid(pos) == values[order[i]]) {
+                positions.push_back(pos++);
+            }
+        }
+
+        bool merged = false;
+        if (!positions.empty()) {
+            leaf->erase_pairs(positions.data(), static_cast<int>(positions.size()));
+            deleted += static_cast<int>(positions.size());
+            if (positions[0] == 0 && leaf->get_size() > 0) {
+                maintain_parent(leaf);
+            }
+            merged = coalesce_or_redistribute(leaf, transaction, &root_is_latched);
+        }
+        delete leaf;
+        release_latches(transaction, &root_is_latched);
+        if (merged) {
+            update_file_hdr(transaction);
+        }
+    }
+    return deleted;
+}
+
 /**
  * @brief 用于处理合并和重分配的逻辑，用于删除键值对后调用
  *
@@ -504,7 +1251,7 @@ bool IxIndexHandle::coalesce_or_redistribute(IxNodeHandle *node, Transaction *tr
 
     if(node->is_root_page())//如果是根节点
     {
-        return adjust_root(node);
+        return adjust_root(node, transaction);
     }
     else//如果不是根节点
     {
@@ -513,9 +1260,37 @@ bool IxIndexHandle::coalesce_or_redistribute(IxNodeHandle *node, Transaction *tr
     }
 
     //不是根节点且需要合并或重分配
+    //此时父结点一定仍被当前线程持有；兄弟结点与node同属一个父结点，持有父结点时加锁不会死锁
     IxNodeHandle * parent_node = fetch_node(node->get_parent_page_no());
     int pos = parent_node->find_child(node);
     IxNodeHandle * sibling;
+    if (file_hdr_->compress_) {
+        // 压缩结点的容量取决于key：两个结点放得进一个结点时合并，否则从兄弟结点移过来放得下的一部分键值对
+        if (parent_node->get_size() == 1) {
+            buffer_pool_manager_->unpin_page(parent_node->get_page_id(), false);
+            delete parent_node;
+            return false;
+        }
+        sibling = fetch_node(parent_node->get_rid(pos ? pos - 1 : pos + 1)->page_no);
+        sibling->page->wlatch();
+        bool need_delete = node->get_size() == 0 || sibling->get_size() == 0 ||
+                           (pos ? can_merge(sibling, node) : can_merge(node, sibling));
+        bool modified = need_delete;
+        if (need_delete) {
+            coalesce(&sibling, &node, &parent_node, pos, transaction, root_is_latched);
+        } else {
+            modified = pos ? redistribute_compressed(sibling, node, parent_node, pos, false)
+                           : redistribute_compressed(node, sibling, parent_node, 1, true);
+        }
+        buffer_pool_manager_->unpin_page(parent_node->get_page_id(), modified);
+        if (pos != 0 || !need_delete) {
+            sibling->page->wunlatch();
+            buffer_pool_manager_->unpin_page(sibling->get_page_id(), modified);
+        }
+        delete parent_node;
+        delete sibling;
+        return need_delete;
+    }
     if(node->is_leaf_page())
     {
         sibling = fetch_node(pos ? node->get_prev_leaf() : node->get_next_leaf());
@@ -526,12 +1301,14 @@ bool IxIndexHandle::coalesce_or_redistribute(IxNodeHandle *node, Transaction *tr
         int sibling_page_no = parent_node->get_rid(sibling_index)->page_no;
         sibling = fetch_node(sibling_page_no);
     }
+    sibling->page->wlatch();
 
     bool need_delete = !(node->get_size() + sibling->get_size() >= 2 * node->get_min_size());
 
     if (!need_delete)
     {
-        redistribute(sibling, node, parent_node, pos);
+        // 批量删除后node可能缺少多个键值对，一次借够
+        redistribute(sibling, node, parent_node, pos, node->get_min_size() - node->get_size());
         maintain_parent(node);
         maintain_parent(sibling);
     }
@@ -541,7 +1318,13 @@ bool IxIndexHandle::coalesce_or_redistribute(IxNodeHandle *node, Transaction *tr
     }
     
     buffer_pool_manager_->unpin_page(parent_node->get_page_id(), true);
-    buffer_pool_manager_->unpin_page(sibling->get_page_id(), true);
+    // 被删除的兄弟结点保留写锁和pin，由release_latches()统一释放
+    if (pos != 0 || !need_delete) {
+        sibling->page->wunlatch();
+        buffer_pool_manager_->unpin_page(sibling->get_page_id(), true);
+    }
+    delete parent_node;
+    delete sibling;
 
     return need_delete;
 }
@@ -552,31 +1335,25 @@ bool IxIndexHandle::coalesce_or_redistribute(IxNodeHandle *node, Transaction *tr
  * @return bool 根结点是否需要被删除
  * @note size of root page can be less than min size and this method is only called within coalesce_or_redistribute()
  */
-bool IxIndexHandle::adjust_root(IxNodeHandle *old_root_node) {
+bool IxIndexHandle::adjust_root(IxNodeHandle *old_root_node, Transaction *transaction) {
     // Todo:
     // 1. 如果old_root_node是内部结点，并且大小为1，则直接把它的孩子更新成新的根结点
     // 2. 如果old_root_node是叶结点，且大小为0，则直接更新root page
     // 3. 除了上述两种情况，不需要进行操作
 
-    if(!old_root_node->is_leaf_page())//如果old_root_node是内部节点
+    // 叶子结点作为根时即使为空也保留，与创建索引时的空树一致
+    if(!old_root_node->is_leaf_page() && old_root_node->get_size() == 1)//如果old_root_node是内部节点
     {
-        if (old_root_node->get_size() == 1)
-        {
-            int new_root_page_no = old_root_node->get_rid(0)->page_no;
-            update_root_page_no(new_root_page_no);
-            IxNodeHandle * new_root_node = fetch_node(new_root_page_no);
-            new_root_node->set_parent_page_no(INVALID_PAGE_ID);
-            return false;
-        }
-    }
-    else//如果old_root_node是叶子节点
-    {
-        if(old_root_node->get_size() == 0)
-        {
-            release_node_handle(*old_root_node);
-            update_root_page_no(INVALID_PAGE_ID);
-            return true;
-        }
+        // 根结点发生变化，find_leaf_page保证了此时仍持有root_latch_
+        int new_root_page_no = old_root_node->get_rid(0)->page_no;
+        update_root_page_no(new_root_page_no);
+        IxNodeHandle * new_root_node = fetch_node(new_root_page_no);
+        new_root_node->set_parent_page_no(INVALID_PAGE_ID);
+        buffer_pool_manager_->unpin_page(new_root_node->get_page_id(), true);
+        delete new_root_node;
+        release_node_handle(*old_root_node);
+        transaction->append_index_deleted_page(old_root_node->page);
+        return true;
     }
 
     return false;
@@ -591,32 +1368,116 @@ bool IxIndexHandle::adjust_root(IxNodeHandle *old_root_node) {
  * @param node input from method coalesceOrRedistribute()
  * @param parent the parent of "node" and "neighbor_node"
  * @param index node在parent中的rid_idx
+ * @param n 移动的键值对数量，批量删除后可能大于1
  * @note node是之前刚被删除过一个key的结点
  * index=0，则neighbor是node后继结点，表示：node(left)      neighbor(right)
  * index>0，则neighbor是node前驱结点，表示：neighbor(left)  node(right)
  * 注意更新parent结点的相关kv对
  */
-void IxIndexHandle::redistribute(IxNodeHandle *neighbor_node, IxNodeHandle *node, IxNodeHandle *parent, int index) {
+void IxIndexHandle::redistribute(IxNodeHandle *neighbor_node, IxNodeHandle *node, IxNodeHandle *parent, int index,
+                                 int n) {
     // Todo:
     // 1. 通过index判断neighbor_node是否为node的前驱结点
-    // 2. 从neighbor_node中移动一个键值对到node结点中
+    // 2. 从neighbor_node中移动n个键值对到node结点中
     // 3. 更新父节点中的相关信息，并且修改移动键值对对应孩字结点的父结点信息（maintain_child函数）
     // 注意：neighbor_node的位置不同，需要移动的键值对不同，需要分类讨论
+    neighbor_node->bump_smo_version();
+    node->bump_smo_version();
+
+    int src = index ? neighbor_node->get_size() - n : 0;  // 前驱结点移出最后n个，后继结点移出最前n个
+    std::vector<char> keys(n * file_hdr_->col_tot_len_);
+    std::vector<Rid> rids(n);
+    std::vector<int> positions(n);
+    neighbor_node->copy_keys(src, n, keys.data());
+    for (int i = 0; i < n; i++) {
+        rids[i] = *neighbor_node->get_rid(src + i);
+        positions[i] = src + i;
+    }
+    neighbor_node->erase_pairs(positions.data(), n);
 
-    if(index)//如果neighbor是前驱节点
-    {
-        int pos = neighbor_node->get_size() - 1;
-        node->insert_pair(0, neighbor_node->get_key(pos), *neighbor_node->get_rid(pos));
-        neighbor_node->erase_pair(pos);
-        maintain_child(node, 0);
+    int pos = index ? 0 : node->get_size();
+    node->insert_pairs(pos, keys.data(), rids.data(), n);
+    for (int i = 0; i < n; i++) {
+        maintain_child(node, pos + i);
     }
-    else//如果neighbor是后继节点
-    {
-        int pos = node->get_size();
-        node->insert_pair(pos, neighbor_node->get_key(0), *neighbor_node->get_rid(0));
-        neighbor_node->erase_pair(0);
-        maintain_child(node, pos);
+}
+
+/**
+ * @brief 压缩结点不满并且与兄弟结点合并后放不下时，从兄弟结点移过来一部分键值对，再替换父结点中右结点的分隔key
+ * 移动的键值对在接收结点中、新的分隔key在父结点中放不下时逐个减少移动的数量，一个都放不下时不做修改
+ *
+ * @param left,right 父结点中相邻的两个孩子结点，right是parent的第right_idx个孩子
+ * @param to_left true时从right的开头移到left的末尾，否则从left的末尾移到right的开头
+ * @return 是否移动了键值对
+ * @note 内部结点中right原来的第一个key（从right移到left时是移过去的第一个key）不一定是有效的分隔key，
+ * 与coalesce()一样换成父结点中原来的分隔key；叶子结点向父结点写入的是后缀截断后的最短分隔key
+ */
+bool IxIndexHandle::redistribute_compressed(IxNodeHandle *left, IxNodeHandle *right, IxNodeHandle *parent,
+                                            int right_idx, bool to_left) {
+    int len = file_hdr_->col_tot_len_;
+    bool is_leaf = left->is_leaf_page();
+    IxNodeHandle *from = to_left ? right : left;
+    IxNodeHandle *to = to_left ? left : right;
+    std::vector<char> old_sep(len), bound(len), sep(len);
+    parent->copy_keys(right_idx, 1, old_sep.data());
+    for (int n = (from->get_size() - to->get_size()) / 2; n > 0; n--) {
+        int src = to_left ? 0 : from->get_size() - n;
+        int m = !to_left && !is_leaf ? n + 1 : n;  // 内部结点从左向右移动时，right原来的第一个键值对换上分隔key后重新插入
+        std::vector<char> keys(m * len);
+        std::vector<Rid> rids(m);
+        from->copy_keys(src, n, keys.data());
+        for (int i = 0; i < n; i++) {
+            rids[i] = *from->get_rid(src + i);
+        }
+        if (!is_leaf && to_left) {
+            memcpy(keys.data(), old_sep.data(), len);
+        } else if (!is_leaf) {
+            memcpy(keys.data() + n * len, old_sep.data(), len);
+            rids[n] = *right->get_rid(0);
+        }
+        // 移动之后right的第一个key
+        if (to_left) {
+            right->copy_keys(n, 1, bound.data());
+        } else {
+            memcpy(bound.data(), keys.data(), len);
+        }
+        if (is_leaf) {
+            std::vector<char> last(len);  // 移动之后left的最后一个key
+            if (to_left) {
+                memcpy(last.data(), keys.data() + (n - 1) * len, len);
+            } else {
+                left->copy_keys(src - 1, 1, last.data());
+            }
+            ix_make_separator(last.data(), bound.data(), len, sep.data());
+        } else {
+            sep = bound;
+        }
+        if (!to->can_insert(keys.data(), m) || !parent->can_insert(sep.data())) {
+            continue;
+        }
+
+        left->bump_smo_version();
+        right->bump_smo_version();
+        std::vector<int> positions(n);
+        for (int i = 0; i < n; i++) {
+            positions[i] = src + i;
+        }
+        int dest = to_left ? to->get_size() : 0;
+        if (!to_left && !is_leaf) {
+            right->erase_pair(0);
+        }
+        from->erase_pairs(positions.data(), n);
+        to->insert_pairs(dest, keys.data(), rids.data(), m);
+        for (int i = 0; i < m; i++) {
+            maintain_child(to, dest + i);
+        }
+        // 删除后父结点的布局不变，再插入新的分隔key不会超过can_insert()判断时的布局
+        Rid child = *parent->get_rid(right_idx);
+        parent->erase_pair(right_idx);
+        parent->insert_pair(right_idx, sep.data(), child);
+        return true;
     }
+    return false;
 }
 
 /**
@@ -640,13 +1501,26 @@ bool IxIndexHandle::coalesce(IxNodeHandle **neighbor_node, IxNodeHandle **node,
     // 2. 把node结点的键值对移动到neighbor_node中，并更新node结点孩子结点的父节点信息（调用maintain_child函数）
     // 3. 释放和删除node结点，并删除parent中node结点的信息，返回parent是否需要被删除
     // 提示：如果是叶子结点且为最右叶子结点，需要更新file_hdr_.last_leaf
+    (*neighbor_node)->bump_smo_version();
+    (*node)->bump_smo_version();
 
     if(index == 0)//交换
     {
         std::swap(node, neighbor_node);
         index = 1;
     }
-    (*neighbor_node)->insert_pairs((*neighbor_node)->get_size(), (*node)->keys, (*node)->rids, (*node)->get_size());
+    // 内部结点的第一个key换成父结点中的分隔key，合并后仍能正确区分左右两部分的孩子
+    int len = file_hdr_->col_tot_len_;
+    std::vector<char> keys((*node)->get_size() * len);
+    std::vector<Rid> rids((*node)->get_size());
+    (*node)->copy_keys(0, (*node)->get_size(), keys.data());
+    for (int i = 0; i < (*node)->get_size(); i++) {
+        rids[i] = *(*node)->get_rid(i);
+    }
+    if (!(*node)->is_leaf_page() && (*node)->get_size() > 0) {
+        memcpy(keys.data(), (*parent)->get_key(index), len);
+    }
+    (*neighbor_node)->insert_pairs((*neighbor_node)->get_size(), keys.data(), rids.data(), (*node)->get_size());
     for(int i = 0; i < (*node)->get_size(); i++)
     {
         maintain_child((*neighbor_node), (*neighbor_node)->get_size() - (i + 1));
@@ -660,6 +1534,7 @@ bool IxIndexHandle::coalesce(IxNodeHandle **neighbor_node, IxNodeHandle **node,
     }
     
     release_node_handle(**node);
+    transaction->append_index_deleted_page((*node)->page);
     (*parent)->erase_pair(index);
 
     return coalesce_or_redistribute(*parent, transaction, root_is_latched);
@@ -683,21 +1558,39 @@ Rid IxIndexHandle::get_rid(const Iid &iid) const {
     return *node->get_rid(iid.slot_no);
 }
 
+/**
+ * @brief 把iid对应的索引槽中的key复制到key中，供只读索引的扫描使用
+ *
+ * @param iid
+ * @param key 长度至少为file_hdr_->key_len()，非唯一索引附加的rid不复制
+ */
+void IxIndexHandle::get_key(const Iid &iid, char *key) const {
+    IxNodeHandle *node = fetch_node(iid.page_no);
+    if (iid.slot_no >= node->get_size()) {
+        buffer_pool_manager_->unpin_page(node->get_page_id(), false);
+        delete node;
+        throw IndexEntryNotFoundError();
+    }
+    memcpy(key, node->get_key(iid.slot_no), file_hdr_->key_len());
+    buffer_pool_manager_->unpin_page(node->get_page_id(), false);
+    delete node;
+}
+
 /**
  * @brief FindLeafPage + lower_bound
  *
  * @param key
  * @return Iid
  * @note 上层传入的key本来是int类型，通过(const char *)&key进行了转换
- * 可用*(int *)key转换回去
+ * 可用*(int *)key转换回去；非唯一索引附加最小的rid，定位到第一个key大于等于key的键值对
  */
 Iid IxIndexHandle::lower_bound(const char *key) {
+    char key_buf[IX_MAX_KEY_LEN];
+    key = make_key(key, IX_MIN_RID, key_buf);
 
     auto it = find_leaf_page(key, Operation::FIND, nullptr, false);
     IxNodeHandle * leaf_node = it.first;
-    int slot_no = leaf_node->lower_bound(key);
-    buffer_pool_manager_->unpin_page(leaf_node->get_page_id(), false);
-    return Iid{leaf_node->get_page_no(), slot_no};
+    return normalize_iid(leaf_node, leaf_node->lower_bound(key));
 }
 
 /**
@@ -705,21 +1598,20 @@ Iid IxIndexHandle::lower_bound(const char *key) {
  *
  * @param key
  * @return Iid
+ * @note 非唯一索引附加最大的rid，定位到第一个key大于key的键值对
  */
 Iid IxIndexHandle::upper_bound(const char *key) {
+    char key_buf[IX_MAX_KEY_LEN];
+    key = make_key(key, IX_MAX_RID, key_buf);
     
     auto it = find_leaf_page(key, Operation::FIND, nullptr, false);
     IxNodeHandle * leaf_node = it.first;
+    // 结点的upper_bound按内部结点的约定从1开始找，叶子结点的第0个key也可能大于key
     int slot_no = leaf_node->upper_bound(key);
-    if(slot_no == leaf_node->get_size())
-    {
-        if(leaf_node->get_page_no() != file_hdr_->last_leaf_)
-        {
-            buffer_pool_manager_->unpin_page(leaf_node->get_page_id(), false);
-            return Iid{leaf_node->get_next_leaf(), 0};
-        }
+    if (slot_no == 1 && (leaf_node->get_size() == 0 || file_hdr_->key_cmp_(key, leaf_node->get_key(0)) < 0)) {
+        slot_no = 0;
     }
-    return Iid{leaf_node->get_page_no(), slot_no};
+    return normalize_iid(leaf_node, slot_no);
 }
 
 /**
@@ -742,7 +1634,32 @@ Iid IxIndexHandle::leaf_end() const {
  * @return Iid
  */
 Iid IxIndexHandle::leaf_begin() const {
-    Iid iid = {.page_no = file_hdr_->first_leaf_, .slot_no = 0};
+    IxNodeHandle *node = fetch_node(file_hdr_->first_leaf_);
+    node->page->rlatch();
+    return normalize_iid(node, 0);
+}
+
+/**
+ * @brief 叶子结点末尾的位置与下一个叶子结点的开头是同一个位置，统一表示为后者（最后一个叶子结点除外），
+ * 这样IxScan可以直接比较Iid判断是否结束。压缩索引中可能留下空的叶子结点，需要连续跳过
+ *
+ * @param leaf 加了读锁的叶子结点，函数内释放读锁并unpin
+ * @param slot_no leaf中的位置
+ */
+Iid IxIndexHandle::normalize_iid(IxNodeHandle *leaf, int slot_no) const {
+    while (slot_no == leaf->get_size() && leaf->get_page_no() != file_hdr_->last_leaf_) {
+        IxNodeHandle *next = fetch_node(leaf->get_next_leaf());
+        next->page->rlatch();
+        leaf->page->runlatch();
+        buffer_pool_manager_->unpin_page(leaf->get_page_id(), false);
+        delete leaf;
+        leaf = next;
+        slot_no = 0;
+    }
+    Iid iid = {.page_no = leaf->get_page_no(), .slot_no = slot_no};
+    leaf->page->runlatch();
+    buffer_pool_manager_->unpin_page(leaf->get_page_id(), false);
+    delete leaf;
     return iid;
 }
 
@@ -772,7 +1689,10 @@ IxNodeHandle *IxIndexHandle::fetch_node(int page_no) const {
  */
 IxNodeHandle *IxIndexHandle::create_node() {
     IxNodeHandle *node;
-    file_hdr_->num_pages_++;
+    {
+        std::scoped_lock lock{file_hdr_latch_};
+        file_hdr_->num_pages_++;
+    }
 
     PageId new_page_id = {.fd = fd_, .page_no = INVALID_PAGE_ID};
     // 从3开始分配page_no，第一次分配之后，new_page_id.page_no=3，file_hdr_.num_pages=4
@@ -787,6 +1707,9 @@ IxNodeHandle *IxIndexHandle::create_node() {
  * @param node
  */
 void IxIndexHandle::maintain_parent(IxNodeHandle *node) {
+    if (file_hdr_->compress_) {
+        return;  // 压缩索引的父结点中保存的是分隔key，孩子的第一个key变大后仍然有效
+    }
     IxNodeHandle *curr = node;
     while (curr->get_parent_page_no() != IX_NO_PAGE) {
         // Load its parent
@@ -798,10 +1721,13 @@ void IxIndexHandle::maintain_parent(IxNodeHandle *node) {
             assert(buffer_pool_manager_->unpin_page(parent->get_page_id(), true));
             break;
         }
-        memcpy(parent_key, child_first_key, file_hdr_->col_tot_len_);  // 修改了parent node
+        parent->set_key(rank, child_first_key);  // 修改了parent node
         curr = parent;
 
         assert(buffer_pool_manager_->unpin_page(parent->get_page_id(), true));
+        if (rank != 0) {
+            break;  // parent的第一个key没有变化，不需要继续向上更新
+        }
     }
 }
 
@@ -813,12 +1739,15 @@ void IxIndexHandle::maintain_parent(IxNodeHandle *node) {
 void IxIndexHandle::erase_leaf(IxNodeHandle *leaf) {
     assert(leaf->is_leaf_page());
 
+    // 前驱结点是合并的目标结点，已经被当前线程持有；后继结点需要单独加写锁
     IxNodeHandle *prev = fetch_node(leaf->get_prev_leaf());
     prev->set_next_leaf(leaf->get_next_leaf());
     buffer_pool_manager_->unpin_page(prev->get_page_id(), true);
 
     IxNodeHandle *next = fetch_node(leaf->get_next_leaf());
+    next->page->wlatch();
     next->set_prev_leaf(leaf->get_prev_leaf());  // 注意此处是SetPrevLeaf()
+    next->page->wunlatch();
     buffer_pool_manager_->unpin_page(next->get_page_id(), true);
 }
 
@@ -828,6 +1757,7 @@ void IxIndexHandle::erase_leaf(IxNodeHandle *leaf) {
  * @param node
  */
 void IxIndexHandle::release_node_handle(IxNodeHandle &node) {
+    std::scoped_lock lock{file_hdr_latch_};
     file_hdr_->num_pages_--;
 }
 
@@ -842,4 +1772,159 @@ void IxIndexHandle::maintain_child(IxNodeHandle *node, int child_idx) {
         child->set_parent_page_no(node->get_page_no());
         buffer_pool_manager_->unpin_page(child->get_page_id(), true);
     }
-}
\ No newline at end of file
+}
+/**
+ * @brief 判断结点在本次写操作中是否"安全"，安全的结点不会修改其父结点，因此可以释放所有祖先结点的锁
+ * INSERT：插入后不会分裂
+ * DELETE：删除后不会合并或重分配，并且不会改变结点的第一个key（否则需要通过maintain_parent修改父结点）
+ * 根结点没有父结点，只需要保证根结点本身不会发生变化
+ * 压缩索引：叶子结点能直接放下key；内部结点按最坏情况（不压缩）也能放下孩子分裂时插入的所有key；
+ * 删除时不修改父结点中的key
+ */
+bool IxIndexHandle::is_safe(IxNodeHandle *node, const char *key, Operation operation) {
+    if (operation == Operation::INSERT) {
+        if (file_hdr_->compress_) {
+            return node->is_leaf_page() ? node->can_insert(key)
+                                        : node->get_size() + file_hdr_->compress_split_keys_ <=
+                                              IxNodeHandle::compressed_slots(0, file_hdr_->col_tot_len_);
+        }
+        return node->get_size() + 1 < node->get_max_size();
+    }
+    if (node->is_root_page()) {
+        return node->is_leaf_page() || node->get_size() > 2;
+    }
+    if (operation == Operation::DELETE_BATCH && node->is_leaf_page()) {
+        return false;  // 删除的数量要到叶子结点中才知道，保留路径上的写锁
+    }
+    if (node->get_size() <= node->get_min_size()) {
+        return false;
+    }
+    if (file_hdr_->compress_) {
+        return true;
+    }
+    if (node->is_leaf_page()) {
+        return file_hdr_->key_cmp_(key, node->get_key(0)) != 0;
+    }
+    return node->upper_bound(key) - 1 != 0;
+}
+
+/**
+ * @brief 释放index_latch_page_set中除最后一个结点（当前结点）以外的所有结点，以及root_latch_
+ * @note 祖先结点在释放前没有被修改过
+ */
+void IxIndexHandle::release_ancestors(Transaction *transaction, bool *root_is_latched) {
+    if (*root_is_latched) {
+        root_latch_.unlock();
+        *root_is_latched = false;
+    }
+    auto page_set = transaction->get_index_latch_page_set();
+    while (page_set->size() > 1) {
+        Page *page = page_set->front();
+        page_set->pop_front();
+        page->wunlatch();
+        buffer_pool_manager_->unpin_page(page->get_page_id(), false);
+    }
+}
+
+/**
+ * @brief 写操作结束后，释放index_latch_page_set中所有结点的写锁并unpin，然后释放root_latch_
+ * 在本次操作中被删除的结点（index_deleted_page_set）最后释放，并从缓冲池中删除
+ */
+void IxIndexHandle::release_latches(Transaction *transaction, bool *root_is_latched) {
+    auto page_set = transaction->get_index_latch_page_set();
+    auto deleted_set = transaction->get_index_deleted_page_set();
+    for (auto page : *page_set) {
+        if (std::find(deleted_set->begin(), deleted_set->end(), page) == deleted_set->end()) {
+            page->wunlatch();
+            buffer_pool_manager_->unpin_page(page->get_page_id(), true);
+        }
+    }
+    page_set->clear();
+    for (auto page : *deleted_set) {
+        PageId page_id = page->get_page_id();
+        page->wunlatch();
+        // 释放的结点增加过smo_version，其它线程还pin着这个页面而没能从缓冲池删除时，也要把新版本写回
+        buffer_pool_manager_->unpin_page(page_id, true);
+        buffer_pool_manager_->delete_page(page_id);
+    }
+    deleted_set->clear();
+    if (*root_is_latched) {
+        root_latch_.unlock();
+        *root_is_latched = false;
+    }
+}
+
+/**
+ * @brief 检查结点在读取之后是否被修改过：期间有写者修改过结点，版本号就会改变
+ */
+static inline bool validate_version(const Page *page, uint64_t version) {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return page->get_version() == version;
+}
+
+/**
+ * @brief 乐观地查找key所在的叶子结点：内部结点只读取版本号，不加锁也不获取root_latch_
+ * 读取孩子指针后先验证父结点版本号，保证指针有效；读取孩子版本号后再验证一次父结点，保证孩子没有被分裂或删除
+ * @return 加了读锁的叶子结点；读取过程中遇到写者则返回nullptr，由调用者重试
+ * @note 缓冲池的fetch/unpin仍需要获取缓冲池的锁
+ */
+IxNodeHandle *IxIndexHandle::find_leaf_page_optimistic(const char *key) {
+    page_id_t root_page_no = file_hdr_->root_page_;
+    IxNodeHandle *node = fetch_node(root_page_no);
+    uint64_t version = node->page->get_version();
+    // 根结点可能在读取root_page_之后被替换
+    bool valid = (version & 1) == 0 && file_hdr_->root_page_ == root_page_no;
+
+    while (valid && !node->is_leaf_page()) {
+        page_id_t child_page_no = node->internal_lookup(key);
+        if (!validate_version(node->page, version)) {
+            valid = false;
+            break;
+        }
+        IxNodeHandle *child = fetch_node(child_page_no);
+        uint64_t child_version = child->page->get_version();
+        valid = (child_version & 1) == 0 && validate_version(node->page, version);
+        buffer_pool_manager_->unpin_page(node->get_page_id(), false);
+        delete node;
+        node = child;
+        version = child_version;
+    }
+
+    if (valid) {
+        node->page->rlatch();
+        if (node->page->get_version() == version) {
+            return node;
+        }
+        node->page->runlatch();
+    }
+    buffer_pool_manager_->unpin_page(node->get_page_id(), false);
+    delete node;
+    return nullptr;
+}
+
+/**
+ * @brief 从加了读锁的叶子结点移动到下一个叶子结点，不同时持有两个结点的锁：
+ * 写者合并或重分配时会在持有右边结点的写锁时给左边结点加锁，读者从左向右同时持有两个锁可能死锁。
+ * 先释放leaf的读锁，给下一个结点加读锁之后再检查leaf的版本号，leaf没有被修改过（分裂、合并、重分配都会修改leaf）
+ * 说明取到的仍是它的后继结点
+ *
+ * @param leaf 加了读锁的叶子结点，不能是最后一个叶子结点，函数内unpin并delete
+ * @return 加了读锁的下一个叶子结点；leaf在此期间被修改过时返回nullptr，由调用者重新查找
+ */
+IxNodeHandle *IxIndexHandle::next_leaf_unlatched(IxNodeHandle *leaf) const {
+    uint64_t version = leaf->page->get_version();
+    page_id_t next_page_no = leaf->get_next_leaf();
+    leaf->page->runlatch();
+    IxNodeHandle *next = fetch_node(next_page_no);
+    next->page->rlatch();
+    bool valid = validate_version(leaf->page, version);
+    buffer_pool_manager_->unpin_page(leaf->get_page_id(), false);
+    delete leaf;
+    if (!valid) {
+        next->page->runlatch();
+        buffer_pool_manager_->unpin_page(next->get_page_id(), false);
+        delete next;
+        return nullptr;
+    }
+    return next;
+}
@@ -10,46 +10,52 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <string_view>
+
 #include "ix_defs.h"
+#include "ix_index.h"
 #include "transaction/transaction.h"
 
-enum class Operation { FIND = 0, INSERT, DELETE };  // 三种操作：查找、插入、删除
+enum class Operation { FIND = 0, INSERT, DELETE, DELETE_BATCH };  // 查找、插入、删除、在一个叶子结点中批量删除
 
 static const bool binary_search = false;
 
-inline int ix_compare(const char *a, const char *b, ColType type, int col_len) {//比较key的大小关系
-    switch (type) {
-        case TYPE_INT: {
-            int ia = *(int *)a;
-            int ib = *(int *)b;
-            return (ia < ib) ? -1 : ((ia > ib) ? 1 : 0);
-        }
-        case TYPE_FLOAT: {
-            float fa = *(float *)a;
-            float fb = *(float *)b;
-            return (fa < fb) ? -1 : ((fa > fb) ? 1 : 0);
-        }
-        case TYPE_STRING:
-            return memcmp(a, b, col_len);
-        default:
-            throw InternalError("Unexpected data type");
+/** 去掉末尾的0之后key的长度（定长字符串不足的部分用0填充） */
+inline int ix_significant_len(const char *key, int len) {
+    while (len > 0 && key[len - 1] == 0) {
+        len--;
     }
+    return len;
 }
 
-inline int ix_compare(const char* a, const char* b, const std::vector<ColType>& col_types, const std::vector<int>& col_lens) {
-    int offset = 0;
-    for(size_t i = 0; i < col_types.size(); ++i) {
-        int res = ix_compare(a + offset, b + offset, col_types[i], col_lens[i]);
-        if(res != 0) return res;
-        offset += col_lens[i];
+/** 两个key的公共前缀长度 */
+inline int ix_common_prefix_len(const char *a, const char *b, int len) {
+    int i = 0;
+    while (i < len && a[i] == b[i]) {
+        i++;
     }
-    return 0;
+    return i;
+}
+
+/**
+ * @brief 后缀截断：生成满足 left < sep <= right 的最短分隔key，即right保留到第一个与left不同的字节，其余填0
+ * @note 要求left < right
+ */
+inline void ix_make_separator(const char *left, const char *right, int len, char *sep) {
+    int n = std::min(ix_common_prefix_len(left, right, len) + 1, len);
+    memcpy(sep, right, n);
+    memset(sep + n, 0, len - n);
 }
 
 /* 管理B+树中的每个节点 */
 class IxNodeHandle {
     friend class IxIndexHandle;
     friend class IxScan;
+    friend class IxBulkLoader;
 
    private:
     const IxFileHdr *file_hdr;      // 节点所在文件的头部信息
@@ -57,6 +63,10 @@ class IxNodeHandle {
     IxPageHdr *page_hdr;            // page->data的第一部分，指针指向首地址，长度为sizeof(IxPageHdr)
     char *keys;                     // page->data的第二部分，指针指向首地址，长度为file_hdr->keys_size，每个key的长度为file_hdr->col_len
     Rid *rids;                      // page->data的第三部分，指针指向首地址，内节点存页号，页节点存元组
+    // 压缩结点（file_hdr->compress_）的page->data在IxPageHdr之后依次为：公共前缀、每个key的后缀、rids，
+    // 各部分的长度由page_hdr中的prefix_len和suffix_len决定，keys和rids两个指针不再使用
+    mutable std::unique_ptr<char[]> key_buf_;  // 压缩结点中get_key()拼出完整key的缓冲区，可同时保存两个key
+    mutable int key_buf_pos_ = 0;
 
    public:
     IxNodeHandle() = default;
@@ -67,11 +77,16 @@ class IxNodeHandle {
         rids = reinterpret_cast<Rid *>(keys + file_hdr->keys_size_);
     }
 
-    int get_size() { return page_hdr->num_key; }
+    int get_size() const { return page_hdr->num_key; }
 
-    void set_size(int size) { page_hdr->num_key = size; }
+    void set_size(int size) {
+        page->mark_modified();
+        page_hdr->num_key = size;
+    }
 
-    int get_max_size() { return file_hdr->btree_order_ + 1; }//页中最多能存几个key
+    int get_max_size() {//页中最多能存几个key
+        return is_compressed() ? compressed_slots(prefix_len(), suffix_len()) : file_hdr->btree_order_ + 1;
+    }
 
     int get_min_size() { return get_max_size() / 2; }
 
@@ -94,24 +109,81 @@ class IxNodeHandle {
 
     bool is_root_page() { return get_parent_page_no() == INVALID_PAGE_ID; }//如果父节点页号无效则为根节点
 
-    void set_next_leaf(page_id_t page_no) { page_hdr->next_leaf = page_no; }
+    uint16_t get_smo_version() { return page_hdr->smo_version; }
 
-    void set_prev_leaf(page_id_t page_no) { page_hdr->prev_leaf = page_no; }
+    /** 即将在结点之间移动键值对或释放结点，自适应哈希中记录的这个结点全部失效；需要持有结点的写锁 */
+    void bump_smo_version() {
+        page->mark_modified();
+        page_hdr->smo_version++;
+    }
 
+    void set_next_leaf(page_id_t page_no) {
+        page->mark_modified();
+        page_hdr->next_leaf = page_no;
+    }
+
+    void set_prev_leaf(page_id_t page_no) {
+        page->mark_modified();
+        page_hdr->prev_leaf = page_no;
+    }
+
+    // 分裂、合并时会修改没有加锁的孩子结点的父结点页号，乐观读不读取这个字段，不改变版本号
     void set_parent_page_no(page_id_t parent) { page_hdr->parent = parent; }
 
-    char *get_key(int key_idx) const { return keys + key_idx * file_hdr->col_tot_len_; }
+    /** @note 压缩结点返回的是拼出的完整key的副本，不能通过它修改结点，并且只在接下来两次get_key()之内有效 */
+    char *get_key(int key_idx) const {
+        if (is_compressed()) {
+            return materialize_key(key_idx);
+        }
+        return keys + key_idx * file_hdr->col_tot_len_;
+    }
+
+    Rid *get_rid(int rid_idx) const { return is_compressed() ? &compressed_rids()[rid_idx] : &rids[rid_idx]; }
 
-    Rid *get_rid(int rid_idx) const { return &rids[rid_idx]; }
+    void set_key(int key_idx, const char *key) {
+        page->mark_modified();
+        if (is_compressed()) {
+            memcpy(key_suffix(key_idx), key + prefix_len(), suffix_len());
+            return;
+        }
+        memcpy(keys + key_idx * file_hdr->col_tot_len_, key, file_hdr->col_tot_len_);
+    }
+
+    void set_rid(int rid_idx, const Rid &rid) {
+        page->mark_modified();
+        *get_rid(rid_idx) = rid;
+    }
 
-    void set_key(int key_idx, const char *key) { memcpy(keys + key_idx * file_hdr->col_tot_len_, key, file_hdr->col_tot_len_); }
+    bool is_compressed() const { return file_hdr->compress_; }
+
+    // 从page_hdr读出的长度限制在合法范围内，乐观读读到不一致的结点时也不会越界
+    int prefix_len() const { return std::clamp<int>(page_hdr->prefix_len, 0, file_hdr->col_tot_len_); }
+
+    int suffix_len() const { return std::clamp<int>(page_hdr->suffix_len, 0, file_hdr->col_tot_len_ - prefix_len()); }
+
+    /** 压缩结点在给定前缀长度和后缀长度下最多能存的键值对数量 */
+    static int compressed_slots(int prefix_len, int suffix_len) {
+        return static_cast<int>((PAGE_SIZE - sizeof(IxPageHdr) - prefix_len) / (suffix_len + sizeof(Rid)));
+    }
 
-    void set_rid(int rid_idx, const Rid &rid) { rids[rid_idx] = rid; }
+    char *key_prefix() const { return page->get_data() + sizeof(IxPageHdr); }
+
+    char *key_suffix(int key_idx) const { return key_prefix() + prefix_len() + key_idx * suffix_len(); }
+
+    Rid *compressed_rids() const {
+        return reinterpret_cast<Rid *>(key_prefix() + prefix_len() + compressed_slots(prefix_len(), suffix_len()) * suffix_len());
+    }
+
+    void copy_keys(int pos, int n, char *dest) const;
+
+    bool can_insert(const char *key, int n = 1);
 
     int lower_bound(const char *target) const;//查小于该键值的key，用于区间查询
 
     int upper_bound(const char *target) const;
 
+    int compressed_search(const char *target, int lo, bool upper) const;
+
     void insert_pairs(int pos, const char *key, const Rid *rid, int n);
 
     page_id_t internal_lookup(const char *key);
@@ -125,8 +197,19 @@ class IxNodeHandle {
 
     void erase_pair(int pos);
 
+    void erase_pairs(const int *pos, int n);
+
     int remove(const char *key);
 
+   private:
+    char *materialize_key(int key_idx) const;
+
+    void compressed_layout(const char *keys, int n, int *prefix_len, int *suffix_len);
+
+    void relayout(int prefix_len, int suffix_len, const char *prefix_src);
+
+   public:
+
     /**
      * @brief used in internal node to remove the last key in root node, and return the last child
      *
@@ -157,42 +240,72 @@ class IxNodeHandle {
     }
 };
 
+/**
+ * 自适应哈希的一个槽：最近一次抽样记录的key所在的叶子结点，key本身保存在IxIndexHandle::ahi_keys_中。
+ * 读者不加锁也不写槽，按顺序锁的方式读取：前后两次读到的seq相同且为偶数时内容完整
+ */
+struct IxAhiSlot {
+    std::atomic<uint32_t> seq{0};           // 写者修改期间为奇数
+    page_id_t leaf_page_no = IX_NO_PAGE;    // key（非唯一索引为key的第一个键值对）所在的叶子结点
+    uint16_t smo_version = 0;               // 记录时叶子结点的smo_version，之后结点分裂、合并、重分配过则失效
+    int hits = 0;                           // 抽样记录到该key的次数，达到IX_AHI_BUILD_THRESHOLD后才使用
+};
+
 /* B+树 */
-class IxIndexHandle {
+class IxIndexHandle : public IxIndex {
     friend class IxScan;
     friend class IxManager;
+    friend class IxBulkLoader;
 
    private:
     DiskManager *disk_manager_;
     BufferPoolManager *buffer_pool_manager_;
     int fd_;                                    // 存储B+树的文件
     IxFileHdr* file_hdr_;                       // 存了root_page，但其初始化为2（第0页存FILE_HDR_PAGE，第1页存LEAF_HEADER_PAGE）
-    std::mutex root_latch_;
+    Page *file_hdr_page_;                       // 文件头所在的第0页，打开期间一直pin在缓冲池中
+    std::mutex root_latch_;                     // 保护root_page_，根结点可能发生变化的写操作需要一直持有
+    std::mutex file_hdr_latch_;                 // 保护file_hdr_中的num_pages_，不同结点的分裂/合并可能并发修改
+    // 自适应哈希：get_value()反复查找的key -> 所在的叶子结点，命中时不再从根结点向下查找
+    std::unique_ptr<IxAhiSlot[]> ahi_slots_;    // IX_AHI_SLOTS个槽，由key的哈希值决定
+    std::unique_ptr<char[]> ahi_keys_;          // 每个槽记录的key，各占key_len()字节
+    static thread_local uint64_t ahi_hits_;     // 当前线程自适应哈希命中的次数，用于测试
 
    public:
     IxIndexHandle(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager, int fd);
 
     // for search
-    bool get_value(const char *key, std::vector<Rid> *result, Transaction *transaction);
+    bool get_value(const char *key, std::vector<Rid> *result, Transaction *transaction) override;
 
     std::pair<IxNodeHandle *, bool> find_leaf_page(const char *key, Operation operation, Transaction *transaction,
                                                  bool find_first = false);
 
     // for insert
-    page_id_t insert_entry(const char *key, const Rid &value, Transaction *transaction);
+    page_id_t insert_entry(const char *key, const Rid &value, Transaction *transaction) override;
 
     IxNodeHandle *split(IxNodeHandle *node);
 
     void insert_into_parent(IxNodeHandle *old_node, const char *key, IxNodeHandle *new_node, Transaction *transaction);
 
+    page_id_t split_compressed(IxNodeHandle *node, int pos, const char *key, const Rid *rid, int n,
+                               Transaction *transaction);
+
+    bool can_merge(IxNodeHandle *left, IxNodeHandle *right);
+
     // for delete
     bool delete_entry(const char *key, Transaction *transaction);
 
+    bool delete_entry(const char *key, const Rid &value, Transaction *transaction) override;
+
+    int delete_entries(const char *keys, int key_len, const Rid *values, int n, Transaction *transaction) override;
+
     bool coalesce_or_redistribute(IxNodeHandle *node, Transaction *transaction = nullptr,
                                 bool *root_is_latched = nullptr);
-    bool adjust_root(IxNodeHandle *old_root_node);
+    bool adjust_root(IxNodeHandle *old_root_node, Transaction *transaction);
 
-    void redistribute(IxNodeHandle *neighbor_node, IxNodeHandle *node, IxNodeHandle *parent, int index);//借
+    void redistribute(IxNodeHandle *neighbor_node, IxNodeHandle *node, IxNodeHandle *parent, int index, int n = 1);//借
+
+    bool redistribute_compressed(IxNodeHandle *left, IxNodeHandle *right, IxNodeHandle *parent, int right_idx,
+                                 bool to_left);
 
     bool coalesce(IxNodeHandle **neighbor_node, IxNodeHandle **node, IxNodeHandle **parent, int index,
                   Transaction *transaction, bool *root_is_latched);//合并
@@ -206,6 +319,35 @@ class IxIndexHandle {
     Iid leaf_begin() const;
 
    private:
+    Iid normalize_iid(IxNodeHandle *leaf, int slot_no) const;
+
+    /** 非唯一索引在key之后附加编码后的rid，拼出结点中实际保存的key；唯一索引的key就是结点中的key */
+    const char *make_key(const char *key, const Rid &rid, char *buf) const {
+        if (file_hdr_->unique_) {
+            return key;
+        }
+        memcpy(buf, key, file_hdr_->key_len());
+        ix_encode_rid(rid, buf + file_hdr_->key_len());
+        return buf;
+    }
+
+    bool erase_entry(const char *key, const Rid *value, Transaction *transaction);
+
+    IxNodeHandle *next_leaf_unlatched(IxNodeHandle *leaf) const;
+
+    bool collect_equal(IxNodeHandle *leaf, int pos, const char *upper, std::vector<Rid> *result) const;
+
+    // for adaptive hash
+    bool ahi_get_value(const char *key, std::vector<Rid> *result, bool *found);
+
+    void ahi_record(const char *key, page_id_t leaf_page_no, uint16_t smo_version);
+
+    size_t ahi_slot_no(const char *key) const {
+        return std::hash<std::string_view>{}(std::string_view(key, file_hdr_->key_len())) & (IX_AHI_SLOTS - 1);
+    }
+
+    void update_file_hdr(Transaction *transaction);
+
     // 辅助函数
     void update_root_page_no(page_id_t root) { file_hdr_->root_page_ = root; }
 
@@ -225,6 +367,18 @@ class IxIndexHandle {
 
     void maintain_child(IxNodeHandle *node, int child_idx);
 
+    // for latch crabbing
+    bool is_safe(IxNodeHandle *node, const char *key, Operation operation);
+
+    void release_ancestors(Transaction *transaction, bool *root_is_latched);
+
+    void release_latches(Transaction *transaction, bool *root_is_latched);
+
+    // for optimistic read
+    IxNodeHandle *find_leaf_page_optimistic(const char *key);
+
     // for index test
     Rid get_rid(const Iid &iid) const;
+
+    void get_key(const Iid &iid, char *key) const;
 };
\ No newline at end of file
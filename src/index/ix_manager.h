@@ -16,6 +16,7 @@ See the Mulan PSL v2 for more details. */
 #include "system/sm_meta.h"
 #include "ix_defs.h"
 #include "ix_index_handle.h"
+#include "ix_hash_index_handle.h"
 
 class IxManager {
    private:
@@ -54,7 +55,12 @@ class IxManager {
         return disk_manager_->is_file(ix_name);
     }
 
-    void create_index(const std::string &filename, const std::vector<ColMeta>& index_cols) {
+    /**
+     * @brief 创建B+树索引文件
+     * @param compress 是否按前缀压缩的格式存放key，只对足够长的字符串索引生效；写入文件头，打开索引时读出
+     */
+    void create_index(const std::string &filename, const std::vector<ColMeta>& index_cols, bool unique = false,
+                      bool compress = IX_KEY_COMPRESSION) {
         std::string ix_name = get_index_name(filename, index_cols);
         // Create index file
         disk_manager_->create_file(ix_name);
@@ -73,6 +79,11 @@ class IxManager {
         if (col_tot_len > IX_MAX_COL_LEN) {
             throw InvalidColLengthError(col_tot_len);
         }
+        // 非唯一索引在key之后附加rid作为最后一个字段，使相同的key也能区分开
+        if (!unique) {
+            col_num++;
+            col_tot_len += IX_RID_KEY_LEN;
+        }
         // 根据 |page_hdr| + (|attr| + |rid|) * (n + 1) <= PAGE_SIZE 求得n的最大值btree_order
         // 即 n <= btree_order，那么btree_order就是每个结点最多可插入的键值对数量（实际还多留了一个空位，但其不可插入）
         int btree_order = static_cast<int>((PAGE_SIZE - sizeof(IxPageHdr)) / (col_tot_len + sizeof(Rid)) - 1);
@@ -82,18 +93,29 @@ class IxManager {
         IxFileHdr* fhdr = new IxFileHdr(IX_NO_PAGE, IX_INIT_NUM_PAGES, IX_INIT_ROOT_PAGE,
                                 col_num, col_tot_len, btree_order, (btree_order + 1) * col_tot_len,
                                 IX_INIT_ROOT_PAGE, IX_INIT_ROOT_PAGE);
-        for(int i = 0; i < col_num; ++i) {
-            fhdr->col_types_.push_back(index_cols[i].type);
-            fhdr->col_lens_.push_back(index_cols[i].len);
+        for(auto& col: index_cols) {
+            fhdr->col_types_.push_back(col.type);
+            fhdr->col_lens_.push_back(col.len);
+        }
+        if (!unique) {
+            fhdr->col_types_.push_back(TYPE_STRING);
+            fhdr->col_lens_.push_back(IX_RID_KEY_LEN);
         }
+        fhdr->unique_ = unique;
+        fhdr->compress_ = compress && fhdr->can_compress();
         fhdr->update_tot_len();
-        
-        char* data = new char[fhdr->tot_len_];
-        fhdr->serialize(data);
-
-        disk_manager_->write_page(fd, IX_FILE_HDR_PAGE, data, fhdr->tot_len_);
+        assert(IX_FILE_HDR_OFFSET + fhdr->tot_len_ <= PAGE_SIZE);
 
         char page_buf[PAGE_SIZE];  // 在内存中初始化page_buf中的内容，然后将其写入磁盘
+        // 文件头页面与其他页面一样整页写入，之后由缓冲池管理
+        {
+            memset(page_buf, 0, PAGE_SIZE);
+            lsn_t lsn = INVALID_LSN;
+            memcpy(page_buf + Page::OFFSET_LSN, &lsn, sizeof(lsn_t));
+            fhdr->serialize(page_buf + IX_FILE_HDR_OFFSET);
+            disk_manager_->write_page(fd, IX_FILE_HDR_PAGE, page_buf, PAGE_SIZE);
+            delete fhdr;
+        }
         memset(page_buf, 0, PAGE_SIZE);
         // 注意leaf header页号为1，也标记为叶子结点，其前一个/后一个叶子均指向root node
         // Create leaf list header page and write to file
@@ -101,7 +123,8 @@ class IxManager {
             memset(page_buf, 0, PAGE_SIZE);
             auto phdr = reinterpret_cast<IxPageHdr *>(page_buf);
             *phdr = {
-                .next_free_page_no = IX_NO_PAGE,
+                .prefix_len = 0,
+                .suffix_len = 0,
                 .parent = IX_NO_PAGE,
                 .num_key = 0,
                 .is_leaf = true,
@@ -116,7 +139,8 @@ class IxManager {
             memset(page_buf, 0, PAGE_SIZE);
             auto phdr = reinterpret_cast<IxPageHdr *>(page_buf);
             *phdr = {
-                .next_free_page_no = IX_NO_PAGE,
+                .prefix_len = 0,
+                .suffix_len = 0,
                 .parent = IX_NO_PAGE,
                 .num_key = 0,
                 .is_leaf = true,
@@ -133,6 +157,56 @@ class IxManager {
         disk_manager_->close_file(fd);
     }
 
+    /**
+     * @brief 创建可扩展哈希索引：第0页为文件头，第1页为目录页，第2页为目录唯一一项指向的空桶
+     * @note 与B+树索引使用相同的文件名，同一组字段上只能有一种索引
+     */
+    void create_hash_index(const std::string &filename, const std::vector<ColMeta>& index_cols, bool unique = false) {
+        std::string ix_name = get_index_name(filename, index_cols);
+        disk_manager_->create_file(ix_name);
+        int fd = disk_manager_->open_file(ix_name);
+
+        IxHashFileHdr fhdr;
+        for (auto& col : index_cols) {
+            fhdr.col_types_.push_back(col.type);
+            fhdr.col_lens_.push_back(col.len);
+            fhdr.col_tot_len_ += col.len;
+        }
+        if (fhdr.col_tot_len_ > IX_MAX_COL_LEN) {
+            throw InvalidColLengthError(fhdr.col_tot_len_);
+        }
+        fhdr.col_num_ = index_cols.size();
+        fhdr.num_pages_ = IX_HASH_INIT_NUM_PAGES;
+        fhdr.global_depth_ = 0;
+        int max_entries = (PAGE_SIZE - Page::OFFSET_PAGE_HDR - sizeof(IxHashBucketHdr)) / (fhdr.col_tot_len_ + sizeof(Rid));
+        fhdr.bucket_capacity_ = std::min(BUCKET_SIZE, max_entries);
+        fhdr.unique_ = unique;
+        fhdr.dir_pages_.push_back(IX_HASH_INIT_DIR_PAGE);
+        fhdr.update_tot_len();
+
+        char page_buf[PAGE_SIZE];
+        lsn_t lsn = INVALID_LSN;
+        {
+            memset(page_buf, 0, PAGE_SIZE);
+            memcpy(page_buf + Page::OFFSET_LSN, &lsn, sizeof(lsn_t));
+            fhdr.serialize(page_buf + IX_FILE_HDR_OFFSET);
+            disk_manager_->write_page(fd, IX_FILE_HDR_PAGE, page_buf, PAGE_SIZE);
+        }
+        {
+            memset(page_buf, 0, PAGE_SIZE);
+            page_id_t bucket_page = IX_HASH_INIT_BUCKET_PAGE;
+            memcpy(page_buf + Page::OFFSET_PAGE_HDR, &bucket_page, sizeof(page_id_t));
+            disk_manager_->write_page(fd, IX_HASH_INIT_DIR_PAGE, page_buf, PAGE_SIZE);
+        }
+        {
+            memset(page_buf, 0, PAGE_SIZE);
+            auto bhdr = reinterpret_cast<IxHashBucketHdr *>(page_buf + Page::OFFSET_PAGE_HDR);
+            *bhdr = {.local_depth = 0, .num_entries = 0, .next_page = IX_NO_PAGE};
+            disk_manager_->write_page(fd, IX_HASH_INIT_BUCKET_PAGE, page_buf, PAGE_SIZE);
+        }
+        disk_manager_->close_file(fd);
+    }
+
     void destroy_index(const std::string &filename, const std::vector<ColMeta>& index_cols) {
         std::string ix_name = get_index_name(filename, index_cols);
         disk_manager_->destroy_file(ix_name);
@@ -156,12 +230,28 @@ class IxManager {
         return std::make_unique<IxIndexHandle>(disk_manager_, buffer_pool_manager_, fd);
     }
 
-    void close_index(const IxIndexHandle *ih) {
-        char* data = new char[ih->file_hdr_->tot_len_];
-        ih->file_hdr_->serialize(data);
-        disk_manager_->write_page(ih->fd_, IX_FILE_HDR_PAGE, data, ih->file_hdr_->tot_len_);
+    std::unique_ptr<IxHashIndexHandle> open_hash_index(const std::string &filename, const std::vector<ColMeta>& index_cols) {
+        std::string ix_name = get_index_name(filename, index_cols);
+        int fd = disk_manager_->open_file(ix_name);
+        return std::make_unique<IxHashIndexHandle>(disk_manager_, buffer_pool_manager_, fd);
+    }
+
+    void close_index(IxIndexHandle *ih) {
+        // 文件头的页号字段在每次修改后已经写入缓冲池中的文件头页面，这里只需要释放它
+        ih->update_file_hdr(nullptr);
+        buffer_pool_manager_->unpin_page(ih->file_hdr_page_->get_page_id(), false);
         // 缓冲区的所有页刷到磁盘，注意这句话必须写在close_file前面
         buffer_pool_manager_->flush_all_pages(ih->fd_);
+        // 关闭后fd可能被其他文件复用，缓存的页不能再留在缓冲池中
+        buffer_pool_manager_->drop_all_pages(ih->fd_);
+        disk_manager_->close_file(ih->fd_);
+    }
+
+    void close_hash_index(IxHashIndexHandle *ih) {
+        ih->update_file_hdr(nullptr);
+        buffer_pool_manager_->unpin_page(ih->file_hdr_page_->get_page_id(), false);
+        buffer_pool_manager_->flush_all_pages(ih->fd_);
+        buffer_pool_manager_->drop_all_pages(ih->fd_);
         disk_manager_->close_file(ih->fd_);
     }
 };
\ No newline at end of file
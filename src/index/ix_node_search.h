@@ -0,0 +1,135 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define IX_SEARCH_HAS_AVX2 1
+#endif
+
+/**
+ * 单列INT/FLOAT索引的结点内查找
+ * 1. 无分支二分：每一步只用条件传送移动base，把候选区间缩小到IX_SEARCH_WINDOW个key以内
+ * 2. 在剩下的窗口内统计"小于target"（upper_bound为"小于等于target"）的key个数，即为目标位置
+ *    CPU支持AVX2时每次比较8个key，否则逐个比较
+ * 结点中的key是连续存放的定长数组，因此可以直接当作int/float数组访问；
+ * 非唯一索引的key后面附加了rid，相邻两个key的第一个字段相隔stride个int/float，AVX2时用gather读取
+ */
+constexpr int IX_SEARCH_WINDOW = 16;
+
+/** 运行时检测一次CPU是否支持AVX2 */
+inline bool ix_search_use_avx2() {
+#ifdef IX_SEARCH_HAS_AVX2
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+template <typename T, bool Upper>
+inline bool ix_search_before(T key, T target) {
+    return Upper ? !(target < key) : key < target;
+}
+
+template <typename T, bool Upper>
+inline int ix_count_before_scalar(const T *keys, int n, T target, int stride) {
+    int cnt = 0;
+    for (int i = 0; i < n; i++) {
+        cnt += ix_search_before<T, Upper>(keys[i * stride], target);
+    }
+    return cnt;
+}
+
+#ifdef IX_SEARCH_HAS_AVX2
+/** gather读取时8个key相对于第一个key的下标：0, stride, ..., 7 * stride */
+__attribute__((target("avx2"))) inline __m256i ix_gather_index(int stride) {
+    return _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(stride));
+}
+
+/** 窗口末尾不足8个key时只gather前rest个 */
+__attribute__((target("avx2"))) inline __m256i ix_gather_mask(int rest) {
+    return _mm256_cmpgt_epi32(_mm256_set1_epi32(rest), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+/**
+ * @brief 统计keys[0, n)中排在target之前的key个数
+ * @note 连续存放时每次读取8个key，末尾不足8个时会读到n之后的内存，这部分仍在结点所在的页面内（keys后面是rids），其结果被掩码丢弃
+ */
+template <bool Upper>
+__attribute__((target("avx2"))) inline int ix_count_before_avx2(const int *keys, int n, int target, int stride) {
+    __m256i t = _mm256_set1_epi32(target);
+    __m256i index = ix_gather_index(stride);
+    int cnt = 0;
+    for (int i = 0; i < n; i += 8) {
+        __m256i k = stride == 1 ? _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys + i))
+                                : _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), keys + i * stride, index,
+                                                              ix_gather_mask(n - i), sizeof(int));
+        // Upper: key <= target 即 !(key > target)；否则：key < target 即 target > key
+        __m256i cmp = Upper ? _mm256_cmpgt_epi32(k, t) : _mm256_cmpgt_epi32(t, k);
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(cmp)));
+        if (Upper) {
+            mask = ~mask & 0xFF;
+        }
+        int rest = n - i;
+        if (rest < 8) {
+            mask &= (1u << rest) - 1;
+        }
+        cnt += __builtin_popcount(mask);
+    }
+    return cnt;
+}
+
+template <bool Upper>
+__attribute__((target("avx2"))) inline int ix_count_before_avx2(const float *keys, int n, float target, int stride) {
+    __m256 t = _mm256_set1_ps(target);
+    __m256i index = ix_gather_index(stride);
+    int cnt = 0;
+    for (int i = 0; i < n; i += 8) {
+        __m256 k = stride == 1 ? _mm256_loadu_ps(keys + i)
+                               : _mm256_mask_i32gather_ps(_mm256_setzero_ps(), keys + i * stride, index,
+                                                          _mm256_castsi256_ps(ix_gather_mask(n - i)), sizeof(float));
+        __m256 cmp = Upper ? _mm256_cmp_ps(k, t, _CMP_LE_OQ) : _mm256_cmp_ps(k, t, _CMP_LT_OQ);
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_ps(cmp));
+        int rest = n - i;
+        if (rest < 8) {
+            mask &= (1u << rest) - 1;
+        }
+        cnt += __builtin_popcount(mask);
+    }
+    return cnt;
+}
+#endif
+
+/**
+ * @brief 在keys[lo, hi)中查找第一个>=target（Upper为true时是>target）的位置，不存在时返回hi
+ * 第i个key位于keys[i * stride]
+ */
+template <typename T, bool Upper>
+inline int ix_node_search(const T *keys, int lo, int hi, T target, bool use_avx2, int stride = 1) {
+    if (hi <= lo) {
+        return lo;
+    }
+    int base = lo;
+    int n = hi - lo;
+    // 不变式：目标位置在[base, base + n]之间
+    while (n > IX_SEARCH_WINDOW) {
+        int half = n / 2;
+        base = ix_search_before<T, Upper>(keys[(base + half - 1) * stride], target) ? base + half : base;
+        n -= half;
+    }
+#ifdef IX_SEARCH_HAS_AVX2
+    if (use_avx2) {
+        return base + ix_count_before_avx2<Upper>(keys + base * stride, n, target, stride);
+    }
+#endif
+    return base + ix_count_before_scalar<T, Upper>(keys + base * stride, n, target, stride);
+}
@@ -21,11 +21,16 @@ void IxScan::next() {
     assert(iid_.slot_no < node->get_size());
     // increment slot no
     iid_.slot_no++;
-    if (iid_.page_no != ih_->file_hdr_->last_leaf_ && iid_.slot_no == node->get_size()) {
-        // go to next leaf
+    // go to next leaf，压缩索引中可能有空的叶子结点，需要连续跳过
+    while (iid_.page_no != ih_->file_hdr_->last_leaf_ && iid_.slot_no == node->get_size()) {
         iid_.slot_no = 0;
         iid_.page_no = node->get_next_leaf();
+        bpm_->unpin_page(node->get_page_id(), false);
+        delete node;
+        node = ih_->fetch_node(iid_.page_no);
     }
+    bpm_->unpin_page(node->get_page_id(), false);
+    delete node;
 }
 
 Rid IxScan::rid() const {
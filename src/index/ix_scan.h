@@ -34,5 +34,8 @@ class IxScan : public RecScan {
 
     Rid rid() const override;
 
+    /** 当前索引槽中的key（索引字段，不含非唯一索引附加的rid），复制到key中 */
+    void key(char *key) const { ih_->get_key(iid_, key); }
+
     const Iid &iid() const { return iid_; }
 };
\ No newline at end of file
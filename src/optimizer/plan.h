@@ -38,8 +38,14 @@ typedef enum PlanTag{
     T_Transaction_rollback,
     T_SeqScan,
     T_IndexScan,
+    T_BitmapHeapScan,
     T_NestLoop,
+    T_IndexNestLoop,
+    T_HashJoin,
+    T_MergeJoin,
+    T_Aggregate,
     T_Sort,
+    T_Limit,
     T_Projection
 } PlanTag;
 
@@ -74,6 +80,8 @@ class ScanPlan : public Plan
         size_t len_;                               
         std::vector<Condition> fed_conds_;
         std::vector<std::string> index_col_names_;
+        bool covering_ = false;                     // 索引扫描是否只读索引，不访问表的数据文件
+        std::vector<std::vector<std::string>> bitmap_index_cols_;  // 位图扫描中求交的各个索引包含的字段
     
 };
 
@@ -95,6 +103,11 @@ class JoinPlan : public Plan
         std::shared_ptr<Plan> right_;
         // 连接条件
         std::vector<Condition> conds_;
+        // 哈希连接是否在左侧建表
+        bool build_left_ = false;
+        // 索引嵌套循环连接的内层是否是左侧，以及内层表上查找使用的索引包含的字段
+        bool inner_left_ = false;
+        std::vector<std::string> index_col_names_;
         // future TODO: 后续可以支持的连接类型
         JoinType type;
         
@@ -115,23 +128,63 @@ class ProjectionPlan : public Plan
         
 };
 
+class AggregatePlan : public Plan
+{
+    public:
+        AggregatePlan(PlanTag tag, std::shared_ptr<Plan> subplan, std::vector<TabCol> group_cols,
+                      std::vector<TabCol> agg_cols)
+        {
+            Plan::tag = tag;
+            subplan_ = std::move(subplan);
+            group_cols_ = std::move(group_cols);
+            agg_cols_ = std::move(agg_cols);
+        }
+        ~AggregatePlan(){}
+        std::shared_ptr<Plan> subplan_;
+        // 分组字段，没有group by时整个输入是一组
+        std::vector<TabCol> group_cols_;
+        // 需要计算的聚合函数，输出的元组是分组字段拼接各个聚合函数的结果
+        std::vector<TabCol> agg_cols_;
+        
+};
+
 class SortPlan : public Plan
 {
     public:
-        SortPlan(PlanTag tag, std::shared_ptr<Plan> subplan, TabCol sel_col, bool is_desc)
+        SortPlan(PlanTag tag, std::shared_ptr<Plan> subplan, std::vector<TabCol> sel_cols, std::vector<bool> is_descs)
         {
             Plan::tag = tag;
             subplan_ = std::move(subplan);
-            sel_col_ = sel_col;
-            is_desc_ = is_desc;
+            sel_cols_ = std::move(sel_cols);
+            is_descs_ = std::move(is_descs);
         }
         ~SortPlan(){}
         std::shared_ptr<Plan> subplan_;
-        TabCol sel_col_;
-        bool is_desc_;
+        // 排序字段，依次作为第一、第二...排序键
+        std::vector<TabCol> sel_cols_;
+        // 每个排序字段是否降序
+        std::vector<bool> is_descs_;
+        // 只需要排在最前面的limit_个元组，-1表示需要全部元组
+        int limit_ = -1;
         
 };
 
+class LimitPlan : public Plan
+{
+    public:
+        LimitPlan(PlanTag tag, std::shared_ptr<Plan> subplan, int limit, int offset)
+        {
+            Plan::tag = tag;
+            subplan_ = std::move(subplan);
+            limit_ = limit;
+            offset_ = offset;
+        }
+        ~LimitPlan(){}
+        std::shared_ptr<Plan> subplan_;
+        int limit_;
+        int offset_;
+};
+
 // dml语句，包括insert; delete; update; select语句　
 class DMLPlan : public Plan
 {
@@ -168,8 +221,10 @@ class DDLPlan : public Plan
         }
         ~DDLPlan(){}
         std::string tab_name_;
-        std::vector<std::string> tab_col_names_;
+        std::vector<std::string> tab_col_names_;   // 索引包含的字段；建表时为主键字段
         std::vector<ColDef> cols_;
+        bool unique_ = false;                       // 是否建立唯一索引
+        IndexType index_type_ = INDEX_BTREE;        // 建立的索引的存储结构
 };
 
 // help; show tables; desc tables; begin; abort; commit; rollback语句对应的plan
@@ -10,8 +10,10 @@ See the Mulan PSL v2 for more details. */
 
 #include "planner.h"
 
+#include <climits>
 #include <memory>
 
+#include "execution/execution_index_range.h"
 #include "execution/executor_delete.h"
 #include "execution/executor_index_scan.h"
 #include "execution/executor_insert.h"
@@ -22,16 +24,88 @@ See the Mulan PSL v2 for more details. */
 #include "index/ix.h"
 #include "record_printer.h"
 
-// 目前的索引匹配规则为：完全匹配索引字段，且全部为单点查询，不会自动调整where条件的顺序
+// 索引匹配规则：条件能等值匹配索引的最左前缀，并且可以在紧接着的一个字段上有范围条件（<,<=,>,>=）
+// 选择用到字段最多的索引，与where条件的顺序无关，唯一索引或哈希索引上的等值查询优先；没有索引能用到任何字段时返回false
+// 哈希索引只有在所有索引字段上都是等值条件时才能使用
 bool Planner::get_index_cols(std::string tab_name, std::vector<Condition> curr_conds, std::vector<std::string>& index_col_names) {
     index_col_names.clear();
-    for(auto& cond: curr_conds) {
-        if(cond.is_rhs_val && cond.op == OP_EQ && cond.lhs_col.tab_name.compare(tab_name) == 0)
-            index_col_names.push_back(cond.lhs_col.col_name);
-    }
     TabMeta& tab = sm_manager_->db_.get_table(tab_name);
-    if(tab.is_index(index_col_names)) return true;
-    return false;
+    int best = 0;
+    bool best_is_probe = false;
+    for (auto &index : tab.indexes) {
+        IndexRange range(index, tab_name, curr_conds);
+        if (index.type == INDEX_HASH && !range.is_point()) {
+            continue;
+        }
+        int matched = range.num_matched_cols();
+        // 唯一索引上的等值查询最多只有一个元组，哈希索引上的等值查询只需要一次查找，都优先于其他索引
+        bool is_probe = (index.unique || index.type == INDEX_HASH) && range.is_point();
+        if (std::make_pair(is_probe, matched) > std::make_pair(best_is_probe, best)) {
+            best = matched;
+            best_is_probe = is_probe;
+            index_col_names.clear();
+            for (auto &col : index.cols) {
+                index_col_names.push_back(col.name);
+            }
+        }
+    }
+    return best > 0;
+}
+
+/**
+ * @brief 查询用到的本表字段是否都包含在索引中，是则索引扫描可以只读索引，不用再到表中取元组
+ *
+ * @param used_cols 查询用到的所有字段（投影列、条件中的列、排序列）
+ */
+bool Planner::is_covering(const std::string &tab_name, const std::vector<std::string> &index_col_names,
+                          const std::vector<TabCol> &used_cols) {
+    for (auto &col : used_cols) {
+        if (col.tab_name == tab_name &&
+            std::find(index_col_names.begin(), index_col_names.end(), col.col_name) == index_col_names.end()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 选出位图扫描要求交的索引：按用到的字段数从多到少，只保留能额外表达至少一个条件的索引
+ */
+std::vector<std::vector<std::string>> Planner::get_bitmap_indexes(const std::string &tab_name,
+                                                                  const std::vector<Condition> &curr_conds) {
+    TabMeta &tab = sm_manager_->db_.get_table(tab_name);
+    std::vector<std::pair<int, const IndexMeta *>> candidates;
+    for (auto &index : tab.indexes) {
+        if (index.type == INDEX_HASH) {
+            continue;  // 哈希索引不支持范围扫描
+        }
+        int matched = IndexRange(index, tab_name, curr_conds).num_matched_cols();
+        if (matched > 0) {
+            candidates.emplace_back(matched, &index);
+        }
+    }
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](const auto &a, const auto &b) { return a.first > b.first; });
+
+    std::vector<std::vector<std::string>> res;
+    std::vector<bool> used(curr_conds.size(), false);
+    for (auto &[matched, index] : candidates) {
+        IndexRange range(*index, tab_name, curr_conds);
+        bool useful = false;
+        for (size_t j = 0; j < curr_conds.size(); j++) {
+            if (range.uses_cond(j) && !used[j]) {
+                used[j] = useful = true;
+            }
+        }
+        if (useful) {
+            std::vector<std::string> col_names;
+            for (auto &col : index->cols) {
+                col_names.push_back(col.name);
+            }
+            res.push_back(std::move(col_names));
+        }
+    }
+    return res;
 }
 
 /**
@@ -131,9 +205,15 @@ std::shared_ptr<Plan> Planner::physical_optimization(std::shared_ptr<Query> quer
     
     // 其他物理优化
 
+    // 处理聚合函数和group by
+    plan = generate_agg_plan(query, std::move(plan));
+
     // 处理orderby
     plan = generate_sort_plan(query, std::move(plan)); 
 
+    // 处理limit
+    plan = generate_limit_plan(query, std::move(plan));
+
     return plan;
 }
 
@@ -141,8 +221,17 @@ std::shared_ptr<Plan> Planner::physical_optimization(std::shared_ptr<Query> quer
 
 std::shared_ptr<Plan> Planner::make_one_rel(std::shared_ptr<Query> query)
 {
-    auto x = std::dynamic_pointer_cast<ast::SelectStmt>(query->parse);
     std::vector<std::string> tables = query->tables;
+    // 查询用到的字段，用于判断索引扫描能否只读索引
+    std::vector<TabCol> used_cols = query->cols;
+    for (auto &cond : query->conds) {
+        used_cols.push_back(cond.lhs_col);
+        if (!cond.is_rhs_val) {
+            used_cols.push_back(cond.rhs_col);
+        }
+    }
+    used_cols.insert(used_cols.end(), query->order_cols.begin(), query->order_cols.end());
+    used_cols.insert(used_cols.end(), query->group_cols.begin(), query->group_cols.end());
     // // Scan table , 生成表算子列表tab_nodes
     std::vector<std::shared_ptr<Plan>> table_scan_executors(tables.size());
     for (size_t i = 0; i < tables.size(); i++) {
@@ -155,8 +244,20 @@ std::shared_ptr<Plan> Planner::make_one_rel(std::shared_ptr<Query> query)
             table_scan_executors[i] = 
                 std::make_shared<ScanPlan>(T_SeqScan, sm_manager_, tables[i], curr_conds, index_col_names);
         } else {  // 存在索引
-            table_scan_executors[i] =
-                std::make_shared<ScanPlan>(T_IndexScan, sm_manager_, tables[i], curr_conds, index_col_names);
+            auto scan = std::make_shared<ScanPlan>(T_IndexScan, sm_manager_, tables[i], curr_conds, index_col_names);
+            scan->covering_ = is_covering(tables[i], index_col_names, used_cols);
+            // 有多个索引可以求交时，需要回表的范围扫描先收集并求交Rid，再按数据页顺序读取；
+            // 位图扫描读出第一个元组前要收集完整个范围，有LIMIT时仍用可以提前停止的索引扫描
+            bool is_point = IndexRange(*sm_manager_->db_.get_table(tables[i]).get_index_meta(index_col_names),
+                                       tables[i], curr_conds).is_point();
+            if (!scan->covering_ && !is_point && query->limit < 0) {
+                auto bitmap_indexes = get_bitmap_indexes(tables[i], curr_conds);
+                if (bitmap_indexes.size() > 1) {
+                    scan->tag = T_BitmapHeapScan;
+                    scan->bitmap_index_cols_ = std::move(bitmap_indexes);
+                }
+            }
+            table_scan_executors[i] = scan;
         }
     }
     // 只有一个表，不需要join。
@@ -244,34 +345,203 @@ std::shared_ptr<Plan> Planner::make_one_rel(std::shared_ptr<Query> query)
         }
     }
 
+    choose_join_method(table_join_executors);
     return table_join_executors;
 
 }
 
+/**
+ * @brief 选择连接算法：两侧都是按等值连接字段有序的索引扫描时使用归并连接，不需要排序；
+ * 一侧是表并且它的某个索引的字段都与另一侧等值连接时使用索引嵌套循环连接，两侧都可以时较大的一侧作为内层；
+ * 有两侧类型相同的等值连接条件时使用哈希连接，在估计行数较少的一侧建表，行数相同时在右侧建表；
+ * 其余的连接使用块嵌套循环连接
+ */
+void Planner::choose_join_method(const std::shared_ptr<Plan> &plan) {
+    auto join = std::dynamic_pointer_cast<JoinPlan>(plan);
+    if (join == nullptr) {
+        return;
+    }
+    choose_join_method(join->left_);
+    choose_join_method(join->right_);
+    auto left = std::dynamic_pointer_cast<ScanPlan>(join->left_);
+    auto right = std::dynamic_pointer_cast<ScanPlan>(join->right_);
+    for (size_t i = 0; left != nullptr && right != nullptr && i < join->conds_.size(); i++) {
+        auto &cond = join->conds_[i];
+        if (cond.is_rhs_val || cond.op != OP_EQ) {
+            continue;
+        }
+        bool lhs_in_left = cond.lhs_col.tab_name == left->tab_name_;
+        const TabCol &left_col = lhs_in_left ? cond.lhs_col : cond.rhs_col;
+        const TabCol &right_col = lhs_in_left ? cond.rhs_col : cond.lhs_col;
+        auto left_meta = sm_manager_->db_.get_table(left_col.tab_name).get_col(left_col.col_name);
+        auto right_meta = sm_manager_->db_.get_table(right_col.tab_name).get_col(right_col.col_name);
+        if (left_meta->type != right_meta->type || left_meta->len != right_meta->len ||
+            !is_index_ordered(left, left_col) || !is_index_ordered(right, right_col)) {
+            continue;
+        }
+        // 位图扫描按数据页的顺序输出，改回按key顺序输出的索引扫描
+        for (auto &scan : {left, right}) {
+            if (scan->tag == T_BitmapHeapScan) {
+                scan->tag = T_IndexScan;
+                scan->bitmap_index_cols_.clear();
+            }
+        }
+        std::rotate(join->conds_.begin(), join->conds_.begin() + i, join->conds_.begin() + i + 1);
+        join->tag = T_MergeJoin;
+        return;
+    }
+    std::vector<std::string> left_index, right_index;
+    bool left_ok = left != nullptr && get_join_index(left, join->conds_, left_index);
+    bool right_ok = right != nullptr && get_join_index(right, join->conds_, right_index);
+    if (left_ok || right_ok) {
+        join->tag = T_IndexNestLoop;
+        join->inner_left_ = left_ok && (!right_ok || estimate_rows(left) > estimate_rows(right));
+        join->index_col_names_ = join->inner_left_ ? left_index : right_index;
+        return;
+    }
+    for (auto &cond : join->conds_) {
+        if (cond.is_rhs_val || cond.op != OP_EQ) {
+            continue;
+        }
+        auto lhs_col = sm_manager_->db_.get_table(cond.lhs_col.tab_name).get_col(cond.lhs_col.col_name);
+        auto rhs_col = sm_manager_->db_.get_table(cond.rhs_col.tab_name).get_col(cond.rhs_col.col_name);
+        if (lhs_col->type == rhs_col->type) {
+            join->tag = T_HashJoin;
+            join->build_left_ = estimate_rows(join->left_) < estimate_rows(join->right_);
+            break;
+        }
+    }
+}
 
-std::shared_ptr<Plan> Planner::generate_sort_plan(std::shared_ptr<Query> query, std::shared_ptr<Plan> plan)
+/**
+ * @brief 索引扫描的结果是否按col升序排列：使用的是以col为第一个字段的B+树索引
+ */
+bool Planner::is_index_ordered(const std::shared_ptr<ScanPlan> &scan, const TabCol &col) {
+    if ((scan->tag != T_IndexScan && scan->tag != T_BitmapHeapScan) || scan->tab_name_ != col.tab_name ||
+        scan->index_col_names_.empty() || scan->index_col_names_[0] != col.col_name) {
+        return false;
+    }
+    return sm_manager_->db_.get_table(scan->tab_name_).get_index_meta(scan->index_col_names_)->type == INDEX_BTREE;
+}
+
+/**
+ * @brief 找出inner表上可以用连接条件查找的索引：索引的每个字段都与另一侧类型和长度相同的字段等值连接；
+ * 有多个时优先唯一索引，其次字段多的索引
+ */
+bool Planner::get_join_index(const std::shared_ptr<ScanPlan> &inner, const std::vector<Condition> &conds,
+                             std::vector<std::string> &index_col_names) {
+    TabMeta &tab = sm_manager_->db_.get_table(inner->tab_name_);
+    auto bound = [&](const ColMeta &index_col) {
+        for (auto &cond : conds) {
+            if (cond.is_rhs_val || cond.op != OP_EQ) {
+                continue;
+            }
+            bool lhs_inner = cond.lhs_col.tab_name == inner->tab_name_ && cond.lhs_col.col_name == index_col.name;
+            bool rhs_inner = cond.rhs_col.tab_name == inner->tab_name_ && cond.rhs_col.col_name == index_col.name;
+            const TabCol &outer_col = lhs_inner ? cond.rhs_col : cond.lhs_col;
+            if (lhs_inner == rhs_inner || outer_col.tab_name == inner->tab_name_) {
+                continue;
+            }
+            auto col = sm_manager_->db_.get_table(outer_col.tab_name).get_col(outer_col.col_name);
+            if (col->type == index_col.type && col->len == index_col.len) {
+                return true;
+            }
+        }
+        return false;
+    };
+    const IndexMeta *best = nullptr;
+    for (auto &index : tab.indexes) {
+        if (!std::all_of(index.cols.begin(), index.cols.end(), bound)) {
+            continue;
+        }
+        if (best == nullptr || std::make_pair(index.unique, index.col_num) > std::make_pair(best->unique, best->col_num)) {
+            best = &index;
+        }
+    }
+    if (best == nullptr) {
+        return false;
+    }
+    index_col_names.clear();
+    for (auto &col : best->cols) {
+        index_col_names.push_back(col.name);
+    }
+    return true;
+}
+
+/**
+ * @brief 估计算子输出的行数：扫描取表中已分配的记录槽数，连接取两侧中较大的
+ */
+size_t Planner::estimate_rows(const std::shared_ptr<Plan> &plan) {
+    if (auto scan = std::dynamic_pointer_cast<ScanPlan>(plan)) {
+        RmFileHdr hdr = sm_manager_->fhs_.at(scan->tab_name_)->get_file_hdr();
+        return static_cast<size_t>(std::max(hdr.num_pages - 1, 0)) * hdr.num_records_per_page;
+    }
+    if (auto join = std::dynamic_pointer_cast<JoinPlan>(plan)) {
+        return std::max(estimate_rows(join->left_), estimate_rows(join->right_));
+    }
+    return 0;
+}
+
+
+/**
+ * @brief 聚合之后的字段按它在结果中的名称查找，聚合函数的结果名为SUM(score)这样的形式
+ */
+static std::vector<TabCol> agg_output_cols(const std::vector<TabCol> &cols) {
+    std::vector<TabCol> output_cols;
+    for (auto &col : cols) {
+        output_cols.push_back({.tab_name = col.tab_name, .col_name = col.caption()});
+    }
+    return output_cols;
+}
+
+/**
+ * @brief 有聚合函数或group by时加上AggregatePlan，计算select列表和order by中用到的所有聚合函数
+ */
+std::shared_ptr<Plan> Planner::generate_agg_plan(std::shared_ptr<Query> query, std::shared_ptr<Plan> plan)
 {
-    auto x = std::dynamic_pointer_cast<ast::SelectStmt>(query->parse);
-    if(!x->has_sort) {
+    if (!query->has_agg) {
         return plan;
     }
-    std::vector<std::string> tables = query->tables;
-    std::vector<ColMeta> all_cols;
-    for (auto &sel_tab_name : tables) {
-        // 这里db_不能写成get_db(), 注意要传指针
-        const auto &sel_tab_cols = sm_manager_->db_.get_table(sel_tab_name).cols;
-        all_cols.insert(all_cols.end(), sel_tab_cols.begin(), sel_tab_cols.end());
+    std::vector<TabCol> agg_cols;
+    for (auto *cols : {&query->cols, &query->order_cols}) {
+        for (auto &col : *cols) {
+            bool added = std::any_of(agg_cols.begin(), agg_cols.end(), [&](const TabCol &agg_col) {
+                return agg_col.tab_name == col.tab_name && agg_col.caption() == col.caption();
+            });
+            if (col.agg_type != AGG_NONE && !added) {
+                agg_cols.push_back(col);
+            }
+        }
     }
-    TabCol sel_col;
-    for (auto &col : all_cols) {
-        if(col.name.compare(x->order->cols->col_name) == 0 )
-        sel_col = {.tab_name = col.tab_name, .col_name = col.name};
+    return std::make_shared<AggregatePlan>(T_Aggregate, std::move(plan), query->group_cols, std::move(agg_cols));
+}
+
+std::shared_ptr<Plan> Planner::generate_sort_plan(std::shared_ptr<Query> query, std::shared_ptr<Plan> plan)
+{
+    if (query->order_cols.empty()) {
+        return plan;
     }
-    return std::make_shared<SortPlan>(T_Sort, std::move(plan), sel_col, 
-                                    x->order->orderby_dir == ast::OrderBy_DESC);
+    return std::make_shared<SortPlan>(T_Sort, std::move(plan), agg_output_cols(query->order_cols),
+                                      query->order_descs);
 }
 
 
+/**
+ * @brief 有limit时在最上层加上LimitPlan；下面是排序时只需要排在最前面的limit+offset个元组，改为top-N排序
+ */
+std::shared_ptr<Plan> Planner::generate_limit_plan(std::shared_ptr<Query> query, std::shared_ptr<Plan> plan)
+{
+    if (query->limit < 0) {
+        return plan;
+    }
+    if (auto sort = std::dynamic_pointer_cast<SortPlan>(plan)) {
+        if (query->offset <= INT_MAX - query->limit) {
+            sort->limit_ = query->limit + query->offset;
+        }
+    }
+    return std::make_shared<LimitPlan>(T_Limit, std::move(plan), query->limit, query->offset);
+}
+
 /**
  * @brief select plan 生成
  *
@@ -284,7 +554,7 @@ std::shared_ptr<Plan> Planner::generate_select_plan(std::shared_ptr<Query> query
     query = logical_optimization(std::move(query), context);
 
     //物理优化
-    auto sel_cols = query->cols;
+    auto sel_cols = agg_output_cols(query->cols);
     std::shared_ptr<Plan> plannerRoot = physical_optimization(query, context);
     plannerRoot = std::make_shared<ProjectionPlan>(T_Projection, std::move(plannerRoot), 
                                                         std::move(sel_cols));
@@ -299,23 +569,44 @@ std::shared_ptr<Plan> Planner::do_planner(std::shared_ptr<Query> query, Context
     if (auto x = std::dynamic_pointer_cast<ast::CreateTable>(query->parse)) {
         // create table;
         std::vector<ColDef> col_defs;
+        std::vector<std::string> primary_key;   // 主键字段，建表后在其上建立唯一索引
+        int num_primary_keys = 0;
         for (auto &field : x->fields) {
             if (auto sv_col_def = std::dynamic_pointer_cast<ast::ColDef>(field)) {
                 ColDef col_def = {.name = sv_col_def->col_name,
                                   .type = interp_sv_type(sv_col_def->type_len->type),
                                   .len = sv_col_def->type_len->len};
                 col_defs.push_back(col_def);
+                if (sv_col_def->primary_key) {
+                    primary_key = {sv_col_def->col_name};
+                    num_primary_keys++;
+                }
+            } else if (auto sv_primary_key = std::dynamic_pointer_cast<ast::PrimaryKey>(field)) {
+                primary_key = sv_primary_key->col_names;
+                num_primary_keys++;
             } else {
                 throw InternalError("Unexpected field type");
             }
         }
-        plannerRoot = std::make_shared<DDLPlan>(T_CreateTable, x->tab_name, std::vector<std::string>(), col_defs);
+        if (num_primary_keys > 1) {
+            throw InternalError("Multiple primary keys for table " + x->tab_name);
+        }
+        for (auto &col_name : primary_key) {
+            if (std::find_if(col_defs.begin(), col_defs.end(),
+                             [&](const ColDef &col_def) { return col_def.name == col_name; }) == col_defs.end()) {
+                throw ColumnNotFoundError(col_name);
+            }
+        }
+        plannerRoot = std::make_shared<DDLPlan>(T_CreateTable, x->tab_name, primary_key, col_defs);
     } else if (auto x = std::dynamic_pointer_cast<ast::DropTable>(query->parse)) {
         // drop table;
         plannerRoot = std::make_shared<DDLPlan>(T_DropTable, x->tab_name, std::vector<std::string>(), std::vector<ColDef>());
     } else if (auto x = std::dynamic_pointer_cast<ast::CreateIndex>(query->parse)) {
         // create index;
-        plannerRoot = std::make_shared<DDLPlan>(T_CreateIndex, x->tab_name, x->col_names, std::vector<ColDef>());
+        auto ddl = std::make_shared<DDLPlan>(T_CreateIndex, x->tab_name, x->col_names, std::vector<ColDef>());
+        ddl->unique_ = x->unique;
+        ddl->index_type_ = x->hash ? INDEX_HASH : INDEX_BTREE;
+        plannerRoot = ddl;
     } else if (auto x = std::dynamic_pointer_cast<ast::DropIndex>(query->parse)) {
         // drop index
         plannerRoot = std::make_shared<DDLPlan>(T_DropIndex, x->tab_name, x->col_names, std::vector<ColDef>());
@@ -42,7 +42,11 @@ class Planner {
 
     std::shared_ptr<Plan> make_one_rel(std::shared_ptr<Query> query);
 
+    std::shared_ptr<Plan> generate_agg_plan(std::shared_ptr<Query> query, std::shared_ptr<Plan> plan);
+
     std::shared_ptr<Plan> generate_sort_plan(std::shared_ptr<Query> query, std::shared_ptr<Plan> plan);
+
+    std::shared_ptr<Plan> generate_limit_plan(std::shared_ptr<Query> query, std::shared_ptr<Plan> plan);
     
     std::shared_ptr<Plan> generate_select_plan(std::shared_ptr<Query> query, Context *context);
 
@@ -50,6 +54,21 @@ class Planner {
     // int get_indexNo(std::string tab_name, std::vector<Condition> curr_conds);
     bool get_index_cols(std::string tab_name, std::vector<Condition> curr_conds, std::vector<std::string>& index_col_names);
 
+    bool is_covering(const std::string &tab_name, const std::vector<std::string> &index_col_names,
+                     const std::vector<TabCol> &used_cols);
+
+    std::vector<std::vector<std::string>> get_bitmap_indexes(const std::string &tab_name,
+                                                             const std::vector<Condition> &curr_conds);
+
+    void choose_join_method(const std::shared_ptr<Plan> &plan);
+
+    bool is_index_ordered(const std::shared_ptr<ScanPlan> &scan, const TabCol &col);
+
+    bool get_join_index(const std::shared_ptr<ScanPlan> &inner, const std::vector<Condition> &conds,
+                        std::vector<std::string> &index_col_names);
+
+    size_t estimate_rows(const std::shared_ptr<Plan> &plan);
+
     ColType interp_sv_type(ast::SvType sv_type) {
         std::map<ast::SvType, ColType> m = {
             {ast::SV_TYPE_INT, TYPE_INT}, {ast::SV_TYPE_FLOAT, TYPE_FLOAT}, {ast::SV_TYPE_STRING, TYPE_STRING}};
@@ -26,6 +26,10 @@ enum SvCompOp {
     SV_OP_EQ, SV_OP_NE, SV_OP_LT, SV_OP_GT, SV_OP_LE, SV_OP_GE
 };
 
+enum SvAggType {
+    SV_AGG_NONE, SV_AGG_COUNT, SV_AGG_SUM, SV_AGG_MIN, SV_AGG_MAX, SV_AGG_AVG
+};
+
 enum OrderByDir {
     OrderBy_DEFAULT,
     OrderBy_ASC,
@@ -68,9 +72,17 @@ struct Field : public TreeNode {
 struct ColDef : public Field {
     std::string col_name;
     std::shared_ptr<TypeLen> type_len;
+    bool primary_key;   // 列定义后带有PRIMARY KEY
+
+    ColDef(std::string col_name_, std::shared_ptr<TypeLen> type_len_, bool primary_key_ = false) :
+            col_name(std::move(col_name_)), type_len(std::move(type_len_)), primary_key(primary_key_) {}
+};
+
+// 表定义中的PRIMARY KEY (col, ...)
+struct PrimaryKey : public Field {
+    std::vector<std::string> col_names;
 
-    ColDef(std::string col_name_, std::shared_ptr<TypeLen> type_len_) :
-            col_name(std::move(col_name_)), type_len(std::move(type_len_)) {}
+    PrimaryKey(std::vector<std::string> col_names_) : col_names(std::move(col_names_)) {}
 };
 
 struct CreateTable : public TreeNode {
@@ -96,9 +108,11 @@ struct DescTable : public TreeNode {
 struct CreateIndex : public TreeNode {
     std::string tab_name;
     std::vector<std::string> col_names;
+    bool unique;
+    bool hash;      // USING HASH：建立可扩展哈希索引
 
-    CreateIndex(std::string tab_name_, std::vector<std::string> col_names_) :
-            tab_name(std::move(tab_name_)), col_names(std::move(col_names_)) {}
+    CreateIndex(std::string tab_name_, std::vector<std::string> col_names_, bool unique_ = false, bool hash_ = false) :
+            tab_name(std::move(tab_name_)), col_names(std::move(col_names_)), unique(unique_), hash(hash_) {}
 };
 
 struct DropIndex : public TreeNode {
@@ -136,9 +150,10 @@ struct StringLit : public Value {
 struct Col : public Expr {
     std::string tab_name;
     std::string col_name;
+    SvAggType agg_type;     // select列表和order by中作用在字段上的聚合函数
 
-    Col(std::string tab_name_, std::string col_name_) :
-            tab_name(std::move(tab_name_)), col_name(std::move(col_name_)) {}
+    Col(std::string tab_name_, std::string col_name_, SvAggType agg_type_ = SV_AGG_NONE) :
+            tab_name(std::move(tab_name_)), col_name(std::move(col_name_)), agg_type(agg_type_) {}
 };
 
 struct SetClause : public TreeNode {
@@ -166,6 +181,13 @@ struct OrderBy : public TreeNode
        cols(std::move(cols_)), orderby_dir(std::move(orderby_dir_)) {}
 };
 
+struct Limit : public TreeNode
+{
+    int limit;      // 最多返回的行数
+    int offset;     // 跳过的行数
+    Limit(int limit_, int offset_) : limit(limit_), offset(offset_) {}
+};
+
 struct InsertStmt : public TreeNode {
     std::string tab_name;
     std::vector<std::shared_ptr<Value>> vals;
@@ -209,19 +231,23 @@ struct SelectStmt : public TreeNode {
     std::vector<std::string> tabs;
     std::vector<std::shared_ptr<BinaryExpr>> conds;
     std::vector<std::shared_ptr<JoinExpr>> jointree;
+    std::vector<std::shared_ptr<Col>> groups;       // GROUP BY的分组字段
 
     
     bool has_sort;
-    std::shared_ptr<OrderBy> order;
+    std::vector<std::shared_ptr<OrderBy>> orders;   // 排序字段，依次作为第一、第二...排序键
+    std::shared_ptr<Limit> limit;                   // 没有LIMIT子句时为空
 
 
     SelectStmt(std::vector<std::shared_ptr<Col>> cols_,
                std::vector<std::string> tabs_,
                std::vector<std::shared_ptr<BinaryExpr>> conds_,
-               std::shared_ptr<OrderBy> order_) :
-            cols(std::move(cols_)), tabs(std::move(tabs_)), conds(std::move(conds_)), 
-            order(std::move(order_)) {
-                has_sort = (bool)order;
+               std::vector<std::shared_ptr<Col>> groups_,
+               std::vector<std::shared_ptr<OrderBy>> orders_,
+               std::shared_ptr<Limit> limit_) :
+            cols(std::move(cols_)), tabs(std::move(tabs_)), conds(std::move(conds_)), groups(std::move(groups_)),
+            orders(std::move(orders_)), limit(std::move(limit_)) {
+                has_sort = !orders.empty();
             }
 };
 
@@ -237,6 +263,8 @@ struct SemValue {
 
     SvCompOp sv_comp_op;
 
+    SvAggType sv_agg_type;
+
     std::shared_ptr<TypeLen> sv_type_len;
 
     std::shared_ptr<Field> sv_field;
@@ -257,6 +285,9 @@ struct SemValue {
     std::vector<std::shared_ptr<BinaryExpr>> sv_conds;
 
     std::shared_ptr<OrderBy> sv_orderby;
+    std::vector<std::shared_ptr<OrderBy>> sv_orderbys;
+
+    std::shared_ptr<Limit> sv_limit;
 };
 
 extern std::shared_ptr<ast::TreeNode> parse_tree;
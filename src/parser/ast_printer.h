@@ -90,11 +90,14 @@ private:
             std::cout << "DESC_TABLE\n";
             print_val(x->tab_name, offset);
         } else if (auto x = std::dynamic_pointer_cast<CreateIndex>(node)) {
-            std::cout << "CREATE_INDEX\n";
+            std::cout << (x->unique ? "CREATE_UNIQUE_INDEX\n" : "CREATE_INDEX\n");
             print_val(x->tab_name, offset);
             // print_val(x->col_name, offset);
             for(auto col_name: x->col_names)
                 print_val(col_name, offset);
+            if (x->hash) {
+                print_val(std::string("USING_HASH"), offset);
+            }
         } else if (auto x = std::dynamic_pointer_cast<DropIndex>(node)) {
             std::cout << "DROP_INDEX\n";
             print_val(x->tab_name, offset);
@@ -102,9 +105,13 @@ private:
             for(auto col_name: x->col_names)
                 print_val(col_name, offset);
         } else if (auto x = std::dynamic_pointer_cast<ColDef>(node)) {
-            std::cout << "COL_DEF\n";
+            std::cout << (x->primary_key ? "COL_DEF_PRIMARY_KEY\n" : "COL_DEF\n");
             print_val(x->col_name, offset);
             print_node(x->type_len, offset);
+        } else if (auto x = std::dynamic_pointer_cast<PrimaryKey>(node)) {
+            std::cout << "PRIMARY_KEY\n";
+            for(auto col_name: x->col_names)
+                print_val(col_name, offset);
         } else if (auto x = std::dynamic_pointer_cast<Col>(node)) {
             std::cout << "COL\n";
             print_val(x->tab_name, offset);
@@ -609,6 +609,7 @@ char *yytext;
 #include "ast.h"
 #include "yacc.tab.h"
 #include <iostream>
+#include <strings.h>
 
 // automatically update location
 #define YY_USER_ACTION \
@@ -1136,6 +1137,27 @@ case 42:
 YY_RULE_SETUP
 #line 95 "lex.l"
 {
+    /* keyword rules added to lex.l after this file was last generated by flex */
+    static const struct { const char *word; int token; } keywords[] = {
+        {"UNIQUE", UNIQUE},
+        {"PRIMARY", PRIMARY},
+        {"KEY", KEY},
+        {"USING", USING},
+        {"HASH", HASH},
+        {"LIMIT", LIMIT},
+        {"OFFSET", OFFSET},
+        {"GROUP", GROUP},
+        {"COUNT", COUNT},
+        {"SUM", SUM},
+        {"MIN", MIN},
+        {"MAX", MAX},
+        {"AVG", AVG},
+    };
+    for (auto &kw : keywords) {
+        if (strcasecmp(yytext, kw.word) == 0) {
+            return kw.token;
+        }
+    }
     yylval->sv_str = yytext;
     return IDENTIFIER;
 }
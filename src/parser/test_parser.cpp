@@ -21,6 +21,11 @@ int main() {
         "drop table tb;",
         "create index tb(a);",
         "create index tb(a, b, c);",
+        "create unique index tb(a, b);",
+        "create index tb(a) using hash;",
+        "create unique index tb(a, b) using hash;",
+        "create table tb (a int primary key, b float);",
+        "create table tb (a int, b char(4), primary key (a, b));",
         "drop index tb(a, b, c);",
         "drop index tb(b);",
         "insert into tb values (1, 3.14, 'pi');",
@@ -1,8 +1,8 @@
-/* A Bison parser, made by GNU Bison 3.5.1.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
 /* Bison implementation for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2020 Free Software Foundation,
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
    Inc.
 
    This program is free software: you can redistribute it and/or modify
@@ -16,7 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -34,6 +34,10 @@
 /* C LALR(1) parser skeleton written by Richard Stallman, by
    simplifying the original so-called "semantic" parser.  */
 
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
 /* All symbols defined below should begin with yy or YY, to avoid
    infringing on user name space.  This should be done even for local
    variables, as they might otherwise be expanded by user macros.
@@ -41,14 +45,11 @@
    define necessary library symbols; they are noted "INFRINGES ON
    USER NAME SPACE" below.  */
 
-/* Undocumented macros, especially those whose name start with YY_,
-   are private implementation details.  Do not rely on them.  */
-
-/* Identify Bison output.  */
-#define YYBISON 1
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
 
-/* Bison version.  */
-#define YYBISON_VERSION "3.5.1"
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
 
 /* Skeleton name.  */
 #define YYSKELETON_NAME "yacc.c"
@@ -66,7 +67,7 @@
 
 
 /* First part of user prologue.  */
-#line 1 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+#line 1 "yacc.y"
 
 #include "ast.h"
 #include "yacc.tab.h"
@@ -81,7 +82,7 @@ void yyerror(YYLTYPE *locp, const char* s) {
 
 using namespace ast;
 
-#line 85 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 86 "yacc.tab.cpp"
 
 # ifndef YY_CAST
 #  ifdef __cplusplus
@@ -104,96 +105,116 @@ using namespace ast;
 #  endif
 # endif
 
-/* Enabling verbose error messages.  */
-#ifdef YYERROR_VERBOSE
-# undef YYERROR_VERBOSE
-# define YYERROR_VERBOSE 1
-#else
-# define YYERROR_VERBOSE 1
-#endif
-
-/* Use api.header.include to #include this header
-   instead of duplicating it here.  */
-#ifndef YY_YY_HOME_USER_LVXINDA_LEARNGIT_RUCBASE_LAB_SRC_PARSER_YACC_TAB_H_INCLUDED
-# define YY_YY_HOME_USER_LVXINDA_LEARNGIT_RUCBASE_LAB_SRC_PARSER_YACC_TAB_H_INCLUDED
-/* Debug traces.  */
-#ifndef YYDEBUG
-# define YYDEBUG 0
-#endif
-#if YYDEBUG
-extern int yydebug;
-#endif
-
-/* Token type.  */
-#ifndef YYTOKENTYPE
-# define YYTOKENTYPE
-  enum yytokentype
-  {
-    SHOW = 258,
-    TABLES = 259,
-    CREATE = 260,
-    TABLE = 261,
-    DROP = 262,
-    DESC = 263,
-    INSERT = 264,
-    INTO = 265,
-    VALUES = 266,
-    DELETE = 267,
-    FROM = 268,
-    ASC = 269,
-    ORDER = 270,
-    BY = 271,
-    WHERE = 272,
-    UPDATE = 273,
-    SET = 274,
-    SELECT = 275,
-    INT = 276,
-    CHAR = 277,
-    FLOAT = 278,
-    INDEX = 279,
-    AND = 280,
-    JOIN = 281,
-    EXIT = 282,
-    HELP = 283,
-    TXN_BEGIN = 284,
-    TXN_COMMIT = 285,
-    TXN_ABORT = 286,
-    TXN_ROLLBACK = 287,
-    ORDER_BY = 288,
-    LEQ = 289,
-    NEQ = 290,
-    GEQ = 291,
-    T_EOF = 292,
-    IDENTIFIER = 293,
-    VALUE_STRING = 294,
-    VALUE_INT = 295,
-    VALUE_FLOAT = 296
-  };
-#endif
-
-/* Value type.  */
-
-/* Location type.  */
-#if ! defined YYLTYPE && ! defined YYLTYPE_IS_DECLARED
-typedef struct YYLTYPE YYLTYPE;
-struct YYLTYPE
+#include "yacc.tab.h"
+/* Symbol kind.  */
+enum yysymbol_kind_t
 {
-  int first_line;
-  int first_column;
-  int last_line;
-  int last_column;
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_SHOW = 3,                       /* SHOW  */
+  YYSYMBOL_TABLES = 4,                     /* TABLES  */
+  YYSYMBOL_CREATE = 5,                     /* CREATE  */
+  YYSYMBOL_TABLE = 6,                      /* TABLE  */
+  YYSYMBOL_DROP = 7,                       /* DROP  */
+  YYSYMBOL_DESC = 8,                       /* DESC  */
+  YYSYMBOL_INSERT = 9,                     /* INSERT  */
+  YYSYMBOL_INTO = 10,                      /* INTO  */
+  YYSYMBOL_VALUES = 11,                    /* VALUES  */
+  YYSYMBOL_DELETE = 12,                    /* DELETE  */
+  YYSYMBOL_FROM = 13,                      /* FROM  */
+  YYSYMBOL_ASC = 14,                       /* ASC  */
+  YYSYMBOL_ORDER = 15,                     /* ORDER  */
+  YYSYMBOL_BY = 16,                        /* BY  */
+  YYSYMBOL_WHERE = 17,                     /* WHERE  */
+  YYSYMBOL_UPDATE = 18,                    /* UPDATE  */
+  YYSYMBOL_SET = 19,                       /* SET  */
+  YYSYMBOL_SELECT = 20,                    /* SELECT  */
+  YYSYMBOL_INT = 21,                       /* INT  */
+  YYSYMBOL_CHAR = 22,                      /* CHAR  */
+  YYSYMBOL_FLOAT = 23,                     /* FLOAT  */
+  YYSYMBOL_INDEX = 24,                     /* INDEX  */
+  YYSYMBOL_AND = 25,                       /* AND  */
+  YYSYMBOL_JOIN = 26,                      /* JOIN  */
+  YYSYMBOL_EXIT = 27,                      /* EXIT  */
+  YYSYMBOL_HELP = 28,                      /* HELP  */
+  YYSYMBOL_TXN_BEGIN = 29,                 /* TXN_BEGIN  */
+  YYSYMBOL_TXN_COMMIT = 30,                /* TXN_COMMIT  */
+  YYSYMBOL_TXN_ABORT = 31,                 /* TXN_ABORT  */
+  YYSYMBOL_TXN_ROLLBACK = 32,              /* TXN_ROLLBACK  */
+  YYSYMBOL_ORDER_BY = 33,                  /* ORDER_BY  */
+  YYSYMBOL_UNIQUE = 34,                    /* UNIQUE  */
+  YYSYMBOL_PRIMARY = 35,                   /* PRIMARY  */
+  YYSYMBOL_KEY = 36,                       /* KEY  */
+  YYSYMBOL_USING = 37,                     /* USING  */
+  YYSYMBOL_HASH = 38,                      /* HASH  */
+  YYSYMBOL_LIMIT = 39,                     /* LIMIT  */
+  YYSYMBOL_OFFSET = 40,                    /* OFFSET  */
+  YYSYMBOL_GROUP = 41,                     /* GROUP  */
+  YYSYMBOL_COUNT = 42,                     /* COUNT  */
+  YYSYMBOL_SUM = 43,                       /* SUM  */
+  YYSYMBOL_MIN = 44,                       /* MIN  */
+  YYSYMBOL_MAX = 45,                       /* MAX  */
+  YYSYMBOL_AVG = 46,                       /* AVG  */
+  YYSYMBOL_LEQ = 47,                       /* LEQ  */
+  YYSYMBOL_NEQ = 48,                       /* NEQ  */
+  YYSYMBOL_GEQ = 49,                       /* GEQ  */
+  YYSYMBOL_T_EOF = 50,                     /* T_EOF  */
+  YYSYMBOL_IDENTIFIER = 51,                /* IDENTIFIER  */
+  YYSYMBOL_VALUE_STRING = 52,              /* VALUE_STRING  */
+  YYSYMBOL_VALUE_INT = 53,                 /* VALUE_INT  */
+  YYSYMBOL_VALUE_FLOAT = 54,               /* VALUE_FLOAT  */
+  YYSYMBOL_55_ = 55,                       /* ';'  */
+  YYSYMBOL_56_ = 56,                       /* '('  */
+  YYSYMBOL_57_ = 57,                       /* ')'  */
+  YYSYMBOL_58_ = 58,                       /* ','  */
+  YYSYMBOL_59_ = 59,                       /* '.'  */
+  YYSYMBOL_60_ = 60,                       /* '*'  */
+  YYSYMBOL_61_ = 61,                       /* '='  */
+  YYSYMBOL_62_ = 62,                       /* '<'  */
+  YYSYMBOL_63_ = 63,                       /* '>'  */
+  YYSYMBOL_YYACCEPT = 64,                  /* $accept  */
+  YYSYMBOL_start = 65,                     /* start  */
+  YYSYMBOL_stmt = 66,                      /* stmt  */
+  YYSYMBOL_txnStmt = 67,                   /* txnStmt  */
+  YYSYMBOL_dbStmt = 68,                    /* dbStmt  */
+  YYSYMBOL_ddl = 69,                       /* ddl  */
+  YYSYMBOL_dml = 70,                       /* dml  */
+  YYSYMBOL_fieldList = 71,                 /* fieldList  */
+  YYSYMBOL_colNameList = 72,               /* colNameList  */
+  YYSYMBOL_field = 73,                     /* field  */
+  YYSYMBOL_type = 74,                      /* type  */
+  YYSYMBOL_valueList = 75,                 /* valueList  */
+  YYSYMBOL_value = 76,                     /* value  */
+  YYSYMBOL_condition = 77,                 /* condition  */
+  YYSYMBOL_optWhereClause = 78,            /* optWhereClause  */
+  YYSYMBOL_whereClause = 79,               /* whereClause  */
+  YYSYMBOL_col = 80,                       /* col  */
+  YYSYMBOL_aggCol = 81,                    /* aggCol  */
+  YYSYMBOL_aggFunc = 82,                   /* aggFunc  */
+  YYSYMBOL_selItem = 83,                   /* selItem  */
+  YYSYMBOL_selList = 84,                   /* selList  */
+  YYSYMBOL_colList = 85,                   /* colList  */
+  YYSYMBOL_op = 86,                        /* op  */
+  YYSYMBOL_expr = 87,                      /* expr  */
+  YYSYMBOL_setClauses = 88,                /* setClauses  */
+  YYSYMBOL_setClause = 89,                 /* setClause  */
+  YYSYMBOL_selector = 90,                  /* selector  */
+  YYSYMBOL_tableList = 91,                 /* tableList  */
+  YYSYMBOL_opt_groupby_clause = 92,        /* opt_groupby_clause  */
+  YYSYMBOL_opt_order_clause = 93,          /* opt_order_clause  */
+  YYSYMBOL_order_clause = 94,              /* order_clause  */
+  YYSYMBOL_order_item = 95,                /* order_item  */
+  YYSYMBOL_opt_limit_clause = 96,          /* opt_limit_clause  */
+  YYSYMBOL_opt_asc_desc = 97,              /* opt_asc_desc  */
+  YYSYMBOL_tbName = 98,                    /* tbName  */
+  YYSYMBOL_colName = 99                    /* colName  */
 };
-# define YYLTYPE_IS_DECLARED 1
-# define YYLTYPE_IS_TRIVIAL 1
-#endif
+typedef enum yysymbol_kind_t yysymbol_kind_t;
 
 
 
-int yyparse (void);
-
-#endif /* !YY_YY_HOME_USER_LVXINDA_LEARNGIT_RUCBASE_LAB_SRC_PARSER_YACC_TAB_H_INCLUDED  */
-
-
 
 #ifdef short
 # undef short
@@ -232,6 +253,18 @@ typedef int_least16_t yytype_int16;
 typedef short yytype_int16;
 #endif
 
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
+#endif
+
 #if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
 typedef __UINT_LEAST8_TYPE__ yytype_uint8;
 #elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
@@ -291,8 +324,9 @@ typedef int yytype_uint16;
 
 #define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
 
+
 /* Stored state numbers (used for stacks). */
-typedef yytype_int8 yy_state_t;
+typedef yytype_uint8 yy_state_t;
 
 /* State numbers in computations.  */
 typedef int yy_state_fast_t;
@@ -309,6 +343,7 @@ typedef int yy_state_fast_t;
 # endif
 #endif
 
+
 #ifndef YY_ATTRIBUTE_PURE
 # if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
 #  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
@@ -327,17 +362,23 @@ typedef int yy_state_fast_t;
 
 /* Suppress unused-variable warnings by "using" E.  */
 #if ! defined lint || defined __GNUC__
-# define YYUSE(E) ((void) (E))
+# define YY_USE(E) ((void) (E))
 #else
-# define YYUSE(E) /* empty */
+# define YY_USE(E) /* empty */
 #endif
 
-#if defined __GNUC__ && ! defined __ICC && 407 <= __GNUC__ * 100 + __GNUC_MINOR__
 /* Suppress an incorrect diagnostic about yylval being uninitialized.  */
-# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                            \
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
     _Pragma ("GCC diagnostic push")                                     \
     _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
     _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+# endif
 # define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
     _Pragma ("GCC diagnostic pop")
 #else
@@ -366,7 +407,7 @@ typedef int yy_state_fast_t;
 
 #define YY_ASSERT(E) ((void) (0 && (E)))
 
-#if ! defined yyoverflow || YYERROR_VERBOSE
+#if 1
 
 /* The parser invokes alloca or malloc; define the necessary symbols.  */
 
@@ -431,8 +472,7 @@ void free (void *); /* INFRINGES ON USER NAME SPACE */
 #   endif
 #  endif
 # endif
-#endif /* ! defined yyoverflow || YYERROR_VERBOSE */
-
+#endif /* 1 */
 
 #if (! defined yyoverflow \
      && (! defined __cplusplus \
@@ -498,27 +538,29 @@ union yyalloc
 #endif /* !YYCOPY_NEEDED */
 
 /* YYFINAL -- State number of the termination state.  */
-#define YYFINAL  39
+#define YYFINAL  48
 /* YYLAST -- Last index in YYTABLE.  */
-#define YYLAST   112
+#define YYLAST   168
 
 /* YYNTOKENS -- Number of terminals.  */
-#define YYNTOKENS  51
+#define YYNTOKENS  64
 /* YYNNTS -- Number of nonterminals.  */
-#define YYNNTS  29
+#define YYNNTS  36
 /* YYNRULES -- Number of rules.  */
-#define YYNRULES  69
+#define YYNRULES  92
 /* YYNSTATES -- Number of states.  */
-#define YYNSTATES  127
+#define YYNSTATES  175
 
-#define YYUNDEFTOK  2
-#define YYMAXUTOK   296
+/* YYMAXUTOK -- Last valid token kind.  */
+#define YYMAXUTOK   309
 
 
 /* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
    as returned by yylex, with out-of-bounds checking.  */
-#define YYTRANSLATE(YYX)                                                \
-  (0 <= (YYX) && (YYX) <= YYMAXUTOK ? yytranslate[YYX] : YYUNDEFTOK)
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
 
 /* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
    as returned by yylex.  */
@@ -528,9 +570,9 @@ static const yytype_int8 yytranslate[] =
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-      43,    44,    50,     2,    45,     2,    46,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,    42,
-      48,    47,    49,     2,     2,     2,     2,     2,     2,     2,
+      56,    57,    60,     2,    58,     2,    59,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,    55,
+      62,    61,    63,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
@@ -553,209 +595,249 @@ static const yytype_int8 yytranslate[] =
        5,     6,     7,     8,     9,    10,    11,    12,    13,    14,
       15,    16,    17,    18,    19,    20,    21,    22,    23,    24,
       25,    26,    27,    28,    29,    30,    31,    32,    33,    34,
-      35,    36,    37,    38,    39,    40,    41
+      35,    36,    37,    38,    39,    40,    41,    42,    43,    44,
+      45,    46,    47,    48,    49,    50,    51,    52,    53,    54
 };
 
 #if YYDEBUG
-  /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
 static const yytype_int16 yyrline[] =
 {
-       0,    56,    56,    61,    66,    71,    79,    80,    81,    82,
-      86,    90,    94,    98,   105,   112,   116,   120,   124,   128,
-     135,   139,   143,   147,   154,   158,   165,   169,   176,   183,
-     187,   191,   198,   202,   209,   213,   217,   224,   231,   232,
-     239,   243,   250,   254,   261,   265,   272,   276,   280,   284,
-     288,   292,   299,   303,   310,   314,   321,   328,   332,   336,
-     340,   344,   351,   355,   359,   366,   367,   368,   371,   373
+       0,    60,    60,    65,    70,    75,    83,    84,    85,    86,
+      90,    94,    98,   102,   109,   116,   120,   124,   128,   132,
+     136,   140,   144,   151,   155,   159,   163,   170,   174,   181,
+     185,   192,   196,   200,   207,   211,   215,   222,   226,   233,
+     237,   241,   248,   255,   256,   263,   267,   274,   278,   285,
+     290,   295,   302,   306,   310,   314,   321,   322,   326,   330,
+     337,   341,   348,   352,   356,   360,   364,   368,   375,   379,
+     386,   390,   397,   404,   408,   412,   416,   420,   427,   431,
+     435,   439,   443,   447,   454,   461,   465,   469,   473,   474,
+     475,   478,   480
 };
 #endif
 
-#if YYDEBUG || YYERROR_VERBOSE || 1
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if 1
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
 /* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
    First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
 static const char *const yytname[] =
 {
-  "$end", "error", "$undefined", "SHOW", "TABLES", "CREATE", "TABLE",
-  "DROP", "DESC", "INSERT", "INTO", "VALUES", "DELETE", "FROM", "ASC",
-  "ORDER", "BY", "WHERE", "UPDATE", "SET", "SELECT", "INT", "CHAR",
-  "FLOAT", "INDEX", "AND", "JOIN", "EXIT", "HELP", "TXN_BEGIN",
-  "TXN_COMMIT", "TXN_ABORT", "TXN_ROLLBACK", "ORDER_BY", "LEQ", "NEQ",
-  "GEQ", "T_EOF", "IDENTIFIER", "VALUE_STRING", "VALUE_INT", "VALUE_FLOAT",
-  "';'", "'('", "')'", "','", "'.'", "'='", "'<'", "'>'", "'*'", "$accept",
-  "start", "stmt", "txnStmt", "dbStmt", "ddl", "dml", "fieldList",
-  "colNameList", "field", "type", "valueList", "value", "condition",
-  "optWhereClause", "whereClause", "col", "colList", "op", "expr",
-  "setClauses", "setClause", "selector", "tableList", "opt_order_clause",
-  "order_clause", "opt_asc_desc", "tbName", "colName", YY_NULLPTR
+  "\"end of file\"", "error", "\"invalid token\"", "SHOW", "TABLES",
+  "CREATE", "TABLE", "DROP", "DESC", "INSERT", "INTO", "VALUES", "DELETE",
+  "FROM", "ASC", "ORDER", "BY", "WHERE", "UPDATE", "SET", "SELECT", "INT",
+  "CHAR", "FLOAT", "INDEX", "AND", "JOIN", "EXIT", "HELP", "TXN_BEGIN",
+  "TXN_COMMIT", "TXN_ABORT", "TXN_ROLLBACK", "ORDER_BY", "UNIQUE",
+  "PRIMARY", "KEY", "USING", "HASH", "LIMIT", "OFFSET", "GROUP", "COUNT",
+  "SUM", "MIN", "MAX", "AVG", "LEQ", "NEQ", "GEQ", "T_EOF", "IDENTIFIER",
+  "VALUE_STRING", "VALUE_INT", "VALUE_FLOAT", "';'", "'('", "')'", "','",
+  "'.'", "'*'", "'='", "'<'", "'>'", "$accept", "start", "stmt", "txnStmt",
+  "dbStmt", "ddl", "dml", "fieldList", "colNameList", "field", "type",
+  "valueList", "value", "condition", "optWhereClause", "whereClause",
+  "col", "aggCol", "aggFunc", "selItem", "selList", "colList", "op",
+  "expr", "setClauses", "setClause", "selector", "tableList",
+  "opt_groupby_clause", "opt_order_clause", "order_clause", "order_item",
+  "opt_limit_clause", "opt_asc_desc", "tbName", "colName", YY_NULLPTR
 };
-#endif
 
-# ifdef YYPRINT
-/* YYTOKNUM[NUM] -- (External) token number corresponding to the
-   (internal) symbol number NUM (which must be that of a token).  */
-static const yytype_int16 yytoknum[] =
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
 {
-       0,   256,   257,   258,   259,   260,   261,   262,   263,   264,
-     265,   266,   267,   268,   269,   270,   271,   272,   273,   274,
-     275,   276,   277,   278,   279,   280,   281,   282,   283,   284,
-     285,   286,   287,   288,   289,   290,   291,   292,   293,   294,
-     295,   296,    59,    40,    41,    44,    46,    61,    60,    62,
-      42
-};
-# endif
+  return yytname[yysymbol];
+}
+#endif
 
-#define YYPACT_NINF (-75)
+#define YYPACT_NINF (-93)
 
 #define yypact_value_is_default(Yyn) \
   ((Yyn) == YYPACT_NINF)
 
-#define YYTABLE_NINF (-69)
+#define YYTABLE_NINF (-92)
 
 #define yytable_value_is_error(Yyn) \
   0
 
-  /* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
-     STATE-NUM.  */
-static const yytype_int8 yypact[] =
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
+static const yytype_int16 yypact[] =
 {
-      42,    21,     5,     8,    -2,    32,    31,    -2,   -26,   -75,
-     -75,   -75,   -75,   -75,   -75,   -75,    52,     6,   -75,   -75,
-     -75,   -75,   -75,    -2,    -2,    -2,    -2,   -75,   -75,    -2,
-      -2,    34,    13,   -75,   -75,    16,    55,    39,   -75,   -75,
-     -75,    43,    44,   -75,    45,    78,    73,    53,    54,    -2,
-      53,    53,    53,    53,    50,    54,   -75,   -75,    -4,   -75,
-      51,   -75,    -7,   -75,   -75,   -11,   -75,    -5,    22,   -75,
-      33,    24,   -75,    74,    48,    53,   -75,    24,    -2,    -2,
-      85,   -75,    53,   -75,    58,   -75,   -75,   -75,    53,   -75,
-     -75,   -75,   -75,    36,   -75,    54,   -75,   -75,   -75,   -75,
-     -75,   -75,    17,   -75,   -75,   -75,   -75,    86,   -75,   -75,
-      63,   -75,   -75,    24,   -75,   -75,   -75,   -75,    54,    60,
-     -75,     1,   -75,   -75,   -75,   -75,   -75
+      61,    15,    12,    10,   -42,    39,    34,   -42,    57,   -93,
+     -93,   -93,   -93,   -93,   -93,   -93,    51,    -1,   -93,   -93,
+     -93,   -93,   -93,   -42,   -42,    41,   -42,   -42,   -93,   -93,
+     -42,   -42,    63,    24,   -93,   -93,   -93,   -93,    54,   -93,
+     -93,   -93,    40,   -93,    13,    99,    55,   -93,   -93,   -93,
+      59,    60,   -42,   -93,    62,   116,   111,    78,   -25,    79,
+      80,   -42,    78,   -28,    78,    76,    78,    77,    79,   -93,
+     -93,    -5,   -93,    73,    81,    82,    83,   -93,    -6,   -93,
+     -93,   100,   -26,   -93,    53,     0,   -93,    78,     5,    32,
+     -93,   110,    58,    78,   -93,    32,   -93,   -93,   -93,   -42,
+     -42,    96,    85,   -93,   -28,   -93,    86,   -93,   108,   107,
+      78,    20,   -93,   -93,   -93,   -93,    37,   -93,    79,   -93,
+     -93,   -93,   -93,   -93,   -93,   -11,   -93,   -93,   -93,   -93,
+     129,   131,    78,   -93,    94,   112,   113,   -93,   115,   -93,
+      32,   -93,   -93,   -93,   -93,    79,   133,   114,    52,    93,
+     -93,   -93,   117,   -93,   -93,    98,    80,   101,   -93,   -93,
+     -93,   -93,    79,    31,   102,   -93,   118,   -93,   -93,   -93,
+     -93,    80,   104,   -93,   -93
 };
 
-  /* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
-     Performed when YYTABLE does not specify something else to do.  Zero
-     means the default is an error.  */
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
 static const yytype_int8 yydefact[] =
 {
        0,     0,     0,     0,     0,     0,     0,     0,     0,     4,
        3,    10,    11,    12,    13,     5,     0,     0,     9,     6,
-       7,     8,    14,     0,     0,     0,     0,    68,    17,     0,
-       0,     0,    69,    57,    44,    58,     0,     0,    43,     1,
-       2,     0,     0,    16,     0,     0,    38,     0,     0,     0,
-       0,     0,     0,     0,     0,     0,    21,    69,    38,    54,
-       0,    45,    38,    59,    42,     0,    24,     0,     0,    26,
-       0,     0,    40,    39,     0,     0,    22,     0,     0,     0,
-      63,    15,     0,    29,     0,    31,    28,    18,     0,    19,
-      36,    34,    35,     0,    32,     0,    50,    49,    51,    46,
-      47,    48,     0,    55,    56,    61,    60,     0,    23,    25,
-       0,    27,    20,     0,    41,    52,    53,    37,     0,     0,
-      33,    67,    62,    30,    66,    65,    64
+       7,     8,    14,     0,     0,     0,     0,     0,    91,    17,
+       0,     0,     0,     0,    52,    53,    54,    55,    92,    73,
+      56,    57,     0,    58,    74,     0,     0,    48,     1,     2,
+       0,     0,     0,    16,     0,     0,    43,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,    24,
+      92,    43,    70,     0,     0,     0,     0,    59,    43,    75,
+      47,     0,     0,    27,     0,     0,    29,     0,     0,     0,
+      45,    44,     0,     0,    25,     0,    51,    50,    49,     0,
+       0,    79,     0,    15,     0,    34,     0,    36,    31,    18,
+       0,     0,    22,    41,    39,    40,     0,    37,     0,    66,
+      65,    67,    62,    63,    64,     0,    71,    72,    77,    76,
+       0,    81,     0,    28,     0,     0,     0,    30,    19,    23,
+       0,    46,    68,    69,    42,     0,     0,    87,     0,     0,
+      32,    20,     0,    38,    60,    78,     0,     0,    26,    33,
+      35,    21,     0,    90,    80,    82,    85,    61,    89,    88,
+      84,     0,     0,    83,    86
 };
 
-  /* YYPGOTO[NTERM-NUM].  */
+/* YYPGOTO[NTERM-NUM].  */
 static const yytype_int8 yypgoto[] =
 {
-     -75,   -75,   -75,   -75,   -75,   -75,   -75,   -75,    56,    23,
-     -75,   -75,   -74,    11,   -27,   -75,    -8,   -75,   -75,   -75,
-     -75,    37,   -75,   -75,   -75,   -75,   -75,    -3,   -45
+     -93,   -93,   -93,   -93,   -93,   -93,   -93,   -93,   -60,    64,
+     -93,   -93,   -92,    43,   -41,   -93,   -58,   -93,   -93,    -4,
+     -93,   -93,   -93,   -93,   -93,    66,   -93,   -93,   -93,   -93,
+     -93,    -9,   -93,   -93,    -2,   -49
 };
 
-  /* YYDEFGOTO[NTERM-NUM].  */
-static const yytype_int8 yydefgoto[] =
+/* YYDEFGOTO[NTERM-NUM].  */
+static const yytype_uint8 yydefgoto[] =
 {
-      -1,    16,    17,    18,    19,    20,    21,    65,    68,    66,
-      86,    93,    94,    72,    56,    73,    74,    35,   102,   117,
-      58,    59,    36,    62,   108,   122,   126,    37,    38
+       0,    16,    17,    18,    19,    20,    21,    82,    85,    83,
+     108,   116,   117,    90,    69,    91,    40,    41,    42,   163,
+      44,   155,   125,   144,    71,    72,    45,    78,   131,   147,
+     164,   165,   158,   170,    46,    47
 };
 
-  /* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
-     positive, shift that token.  If negative, reduce the rule whose
-     number is the opposite.  If YYTABLE_NINF, syntax error.  */
-static const yytype_int8 yytable[] =
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
+static const yytype_int16 yytable[] =
 {
-      34,    28,    60,   104,    31,    64,    67,    69,    69,   124,
-      55,    23,    32,    55,    25,   125,    83,    84,    85,    78,
-      41,    42,    43,    44,    33,    22,    45,    46,   115,    24,
-      60,    76,    26,    81,    82,    80,    27,    67,    79,   120,
-      61,    75,    29,   111,    30,     1,    63,     2,    40,     3,
-       4,     5,    39,    47,     6,    32,    90,    91,    92,   -68,
-       7,    48,     8,    90,    91,    92,    87,    88,    49,     9,
-      10,    11,    12,    13,    14,   105,   106,    89,    88,    15,
-     112,   113,    96,    97,    98,    50,    51,    52,    53,    54,
-      55,    57,    32,    71,   116,    99,   100,   101,    77,    95,
-     107,   110,   118,   119,   123,   109,   114,     0,     0,    70,
-     121,     0,   103
+      75,    76,    29,   127,    43,    32,    88,    81,    73,    28,
+      92,    68,    68,    80,    84,    86,    26,    86,    23,    22,
+      99,    50,    51,    70,    53,    54,    38,   111,    55,    56,
+      94,   103,   104,   142,    27,    74,    24,   101,    86,   168,
+      38,   113,   114,   115,    73,   169,    25,    31,   153,    30,
+      65,    48,   100,    93,    49,    84,    77,   109,   110,    79,
+      92,   137,   112,   110,     1,    52,     2,   143,     3,     4,
+       5,    60,   148,     6,   105,   106,   107,   138,   110,     7,
+      58,     8,    57,    86,   113,   114,   115,   154,     9,    10,
+      11,    12,    13,    14,   139,   140,    59,   128,   129,    33,
+      34,    35,    36,    37,   167,   119,   120,   121,    38,   159,
+     110,    15,    61,   -91,    62,    63,    64,    39,    66,   122,
+     123,   124,    33,    34,    35,    36,    37,    67,    68,    70,
+      38,    38,    87,    89,    95,   118,   102,   130,    96,    97,
+      98,   132,   134,   135,   136,   145,   146,   149,   150,   156,
+     160,   151,   152,   157,   166,   161,   162,   174,   172,   126,
+     171,   141,   173,     0,     0,     0,     0,     0,   133
 };
 
-static const yytype_int8 yycheck[] =
+static const yytype_int16 yycheck[] =
 {
-       8,     4,    47,    77,     7,    50,    51,    52,    53,     8,
-      17,     6,    38,    17,     6,    14,    21,    22,    23,    26,
-      23,    24,    25,    26,    50,     4,    29,    30,   102,    24,
-      75,    58,    24,    44,    45,    62,    38,    82,    45,   113,
-      48,    45,    10,    88,    13,     3,    49,     5,    42,     7,
-       8,     9,     0,    19,    12,    38,    39,    40,    41,    46,
-      18,    45,    20,    39,    40,    41,    44,    45,    13,    27,
-      28,    29,    30,    31,    32,    78,    79,    44,    45,    37,
-      44,    45,    34,    35,    36,    46,    43,    43,    43,    11,
-      17,    38,    38,    43,   102,    47,    48,    49,    47,    25,
-      15,    43,    16,    40,    44,    82,    95,    -1,    -1,    53,
-     118,    -1,    75
+      58,    59,     4,    95,     8,     7,    66,    35,    57,    51,
+      68,    17,    17,    62,    63,    64,     6,    66,     6,     4,
+      26,    23,    24,    51,    26,    27,    51,    87,    30,    31,
+      71,    57,    58,   125,    24,    60,    24,    78,    87,     8,
+      51,    52,    53,    54,    93,    14,    34,    13,   140,    10,
+      52,     0,    58,    58,    55,   104,    60,    57,    58,    61,
+     118,   110,    57,    58,     3,    24,     5,   125,     7,     8,
+       9,    58,   132,    12,    21,    22,    23,    57,    58,    18,
+      56,    20,    19,   132,    52,    53,    54,   145,    27,    28,
+      29,    30,    31,    32,    57,    58,    56,    99,   100,    42,
+      43,    44,    45,    46,   162,    47,    48,    49,    51,    57,
+      58,    50,    13,    59,    59,    56,    56,    60,    56,    61,
+      62,    63,    42,    43,    44,    45,    46,    11,    17,    51,
+      51,    51,    56,    56,    61,    25,    36,    41,    57,    57,
+      57,    56,    56,    35,    37,    16,    15,    53,    36,    16,
+      57,    38,    37,    39,    53,    38,    58,    53,    40,    93,
+      58,   118,   171,    -1,    -1,    -1,    -1,    -1,   104
 };
 
-  /* YYSTOS[STATE-NUM] -- The (internal number of the) accessing
-     symbol of state STATE-NUM.  */
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
 static const yytype_int8 yystos[] =
 {
        0,     3,     5,     7,     8,     9,    12,    18,    20,    27,
-      28,    29,    30,    31,    32,    37,    52,    53,    54,    55,
-      56,    57,     4,     6,    24,     6,    24,    38,    78,    10,
-      13,    78,    38,    50,    67,    68,    73,    78,    79,     0,
-      42,    78,    78,    78,    78,    78,    78,    19,    45,    13,
-      46,    43,    43,    43,    11,    17,    65,    38,    71,    72,
-      79,    67,    74,    78,    79,    58,    60,    79,    59,    79,
-      59,    43,    64,    66,    67,    45,    65,    47,    26,    45,
-      65,    44,    45,    21,    22,    23,    61,    44,    45,    44,
-      39,    40,    41,    62,    63,    25,    34,    35,    36,    47,
-      48,    49,    69,    72,    63,    78,    78,    15,    75,    60,
-      43,    79,    44,    45,    64,    63,    67,    70,    16,    40,
-      63,    67,    76,    44,     8,    14,    77
+      28,    29,    30,    31,    32,    50,    65,    66,    67,    68,
+      69,    70,     4,     6,    24,    34,     6,    24,    51,    98,
+      10,    13,    98,    42,    43,    44,    45,    46,    51,    60,
+      80,    81,    82,    83,    84,    90,    98,    99,     0,    55,
+      98,    98,    24,    98,    98,    98,    98,    19,    56,    56,
+      58,    13,    59,    56,    56,    98,    56,    11,    17,    78,
+      51,    88,    89,    99,    60,    80,    80,    83,    91,    98,
+      99,    35,    71,    73,    99,    72,    99,    56,    72,    56,
+      77,    79,    80,    58,    78,    61,    57,    57,    57,    26,
+      58,    78,    36,    57,    58,    21,    22,    23,    74,    57,
+      58,    72,    57,    52,    53,    54,    75,    76,    25,    47,
+      48,    49,    61,    62,    63,    86,    89,    76,    98,    98,
+      41,    92,    56,    73,    56,    35,    37,    99,    57,    57,
+      58,    77,    76,    80,    87,    16,    15,    93,    72,    53,
+      36,    38,    37,    76,    80,    85,    16,    39,    96,    57,
+      57,    38,    58,    83,    94,    95,    53,    80,     8,    14,
+      97,    58,    40,    95,    53
 };
 
-  /* YYR1[YYN] -- Symbol number of symbol that rule YYN derives.  */
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
 static const yytype_int8 yyr1[] =
 {
-       0,    51,    52,    52,    52,    52,    53,    53,    53,    53,
-      54,    54,    54,    54,    55,    56,    56,    56,    56,    56,
-      57,    57,    57,    57,    58,    58,    59,    59,    60,    61,
-      61,    61,    62,    62,    63,    63,    63,    64,    65,    65,
-      66,    66,    67,    67,    68,    68,    69,    69,    69,    69,
-      69,    69,    70,    70,    71,    71,    72,    73,    73,    74,
-      74,    74,    75,    75,    76,    77,    77,    77,    78,    79
+       0,    64,    65,    65,    65,    65,    66,    66,    66,    66,
+      67,    67,    67,    67,    68,    69,    69,    69,    69,    69,
+      69,    69,    69,    70,    70,    70,    70,    71,    71,    72,
+      72,    73,    73,    73,    74,    74,    74,    75,    75,    76,
+      76,    76,    77,    78,    78,    79,    79,    80,    80,    81,
+      81,    81,    82,    82,    82,    82,    83,    83,    84,    84,
+      85,    85,    86,    86,    86,    86,    86,    86,    87,    87,
+      88,    88,    89,    90,    90,    91,    91,    91,    92,    92,
+      93,    93,    94,    94,    95,    96,    96,    96,    97,    97,
+      97,    98,    99
 };
 
-  /* YYR2[YYN] -- Number of symbols on the right hand side of rule YYN.  */
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
 static const yytype_int8 yyr2[] =
 {
        0,     2,     2,     1,     1,     1,     1,     1,     1,     1,
-       1,     1,     1,     1,     2,     6,     3,     2,     6,     6,
-       7,     4,     5,     6,     1,     3,     1,     3,     2,     1,
-       4,     1,     1,     3,     1,     1,     1,     3,     0,     2,
-       1,     3,     3,     1,     1,     3,     1,     1,     1,     1,
-       1,     1,     1,     1,     1,     3,     3,     1,     1,     1,
-       3,     3,     3,     0,     2,     1,     1,     0,     1,     1
+       1,     1,     1,     1,     2,     6,     3,     2,     6,     7,
+       8,     9,     6,     7,     4,     5,     8,     1,     3,     1,
+       3,     2,     4,     5,     1,     4,     1,     1,     3,     1,
+       1,     1,     3,     0,     2,     1,     3,     3,     1,     4,
+       4,     4,     1,     1,     1,     1,     1,     1,     1,     3,
+       1,     3,     1,     1,     1,     1,     1,     1,     1,     1,
+       1,     3,     3,     1,     1,     1,     3,     3,     3,     0,
+       3,     0,     1,     3,     2,     2,     4,     0,     1,     1,
+       0,     1,     1
 };
 
 
+enum { YYENOMEM = -2 };
+
 #define yyerrok         (yyerrstatus = 0)
 #define yyclearin       (yychar = YYEMPTY)
-#define YYEMPTY         (-2)
-#define YYEOF           0
 
 #define YYACCEPT        goto yyacceptlab
 #define YYABORT         goto yyabortlab
 #define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
 
 
 #define YYRECOVERING()  (!!yyerrstatus)
@@ -777,10 +859,9 @@ static const yytype_int8 yyr2[] =
       }                                                           \
   while (0)
 
-/* Error token number */
-#define YYTERROR        1
-#define YYERRCODE       256
-
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
 
 /* YYLLOC_DEFAULT -- Set CURRENT to span from RHS[1] to RHS[N].
    If N is 0, then set CURRENT to the empty location which ends
@@ -824,12 +905,19 @@ do {                                            \
 } while (0)
 
 
-/* YY_LOCATION_PRINT -- Print the location on the stream.
+/* YYLOCATION_PRINT -- Print the location on the stream.
    This macro was not mandated originally: define only if we know
    we won't break user code: when these are the locations we know.  */
 
-#ifndef YY_LOCATION_PRINT
-# if defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL
+# ifndef YYLOCATION_PRINT
+
+#  if defined YY_LOCATION_PRINT
+
+   /* Temporary convenience wrapper in case some people defined the
+      undocumented and private YY_LOCATION_PRINT macros.  */
+#   define YYLOCATION_PRINT(File, Loc)  YY_LOCATION_PRINT(File, *(Loc))
+
+#  elif defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL
 
 /* Print *YYLOCP on YYO.  Private, do not rely on its existence. */
 
@@ -857,24 +945,32 @@ yy_location_print_ (FILE *yyo, YYLTYPE const * const yylocp)
         res += YYFPRINTF (yyo, "-%d", end_col);
     }
   return res;
- }
+}
 
-#  define YY_LOCATION_PRINT(File, Loc)          \
-  yy_location_print_ (File, &(Loc))
+#   define YYLOCATION_PRINT  yy_location_print_
 
-# else
-#  define YY_LOCATION_PRINT(File, Loc) ((void) 0)
-# endif
-#endif
+    /* Temporary convenience wrapper in case some people defined the
+       undocumented and private YY_LOCATION_PRINT macros.  */
+#   define YY_LOCATION_PRINT(File, Loc)  YYLOCATION_PRINT(File, &(Loc))
 
+#  else
 
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)                    \
+#   define YYLOCATION_PRINT(File, Loc) ((void) 0)
+    /* Temporary convenience wrapper in case some people defined the
+       undocumented and private YY_LOCATION_PRINT macros.  */
+#   define YY_LOCATION_PRINT  YYLOCATION_PRINT
+
+#  endif
+# endif /* !defined YYLOCATION_PRINT */
+
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
 do {                                                                      \
   if (yydebug)                                                            \
     {                                                                     \
       YYFPRINTF (stderr, "%s ", Title);                                   \
       yy_symbol_print (stderr,                                            \
-                  Type, Value, Location); \
+                  Kind, Value, Location); \
       YYFPRINTF (stderr, "\n");                                           \
     }                                                                     \
 } while (0)
@@ -885,19 +981,16 @@ do {                                                                      \
 `-----------------------------------*/
 
 static void
-yy_symbol_value_print (FILE *yyo, int yytype, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp)
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp)
 {
   FILE *yyoutput = yyo;
-  YYUSE (yyoutput);
-  YYUSE (yylocationp);
+  YY_USE (yyoutput);
+  YY_USE (yylocationp);
   if (!yyvaluep)
     return;
-# ifdef YYPRINT
-  if (yytype < YYNTOKENS)
-    YYPRINT (yyo, yytoknum[yytype], *yyvaluep);
-# endif
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-  YYUSE (yytype);
+  YY_USE (yykind);
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
@@ -907,14 +1000,15 @@ yy_symbol_value_print (FILE *yyo, int yytype, YYSTYPE const * const yyvaluep, YY
 `---------------------------*/
 
 static void
-yy_symbol_print (FILE *yyo, int yytype, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp)
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp)
 {
   YYFPRINTF (yyo, "%s %s (",
-             yytype < YYNTOKENS ? "token" : "nterm", yytname[yytype]);
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
 
-  YY_LOCATION_PRINT (yyo, *yylocationp);
+  YYLOCATION_PRINT (yyo, yylocationp);
   YYFPRINTF (yyo, ": ");
-  yy_symbol_value_print (yyo, yytype, yyvaluep, yylocationp);
+  yy_symbol_value_print (yyo, yykind, yyvaluep, yylocationp);
   YYFPRINTF (yyo, ")");
 }
 
@@ -947,7 +1041,8 @@ do {                                                            \
 `------------------------------------------------*/
 
 static void
-yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp, YYLTYPE *yylsp, int yyrule)
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp, YYLTYPE *yylsp,
+                 int yyrule)
 {
   int yylno = yyrline[yyrule];
   int yynrhs = yyr2[yyrule];
@@ -959,9 +1054,9 @@ yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp, YYLTYPE *yylsp, int yyrule)
     {
       YYFPRINTF (stderr, "   $%d = ", yyi + 1);
       yy_symbol_print (stderr,
-                       yystos[+yyssp[yyi + 1 - yynrhs]],
-                       &yyvsp[(yyi + 1) - (yynrhs)]
-                       , &(yylsp[(yyi + 1) - (yynrhs)])                       );
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)],
+                       &(yylsp[(yyi + 1) - (yynrhs)]));
       YYFPRINTF (stderr, "\n");
     }
 }
@@ -976,8 +1071,8 @@ do {                                    \
    multiple parsers can coexist.  */
 int yydebug;
 #else /* !YYDEBUG */
-# define YYDPRINTF(Args)
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
 # define YY_STACK_PRINT(Bottom, Top)
 # define YY_REDUCE_PRINT(Rule)
 #endif /* !YYDEBUG */
@@ -1000,12 +1095,61 @@ int yydebug;
 #endif
 
 
-#if YYERROR_VERBOSE
+/* Context of a parse error.  */
+typedef struct
+{
+  yy_state_t *yyssp;
+  yysymbol_kind_t yytoken;
+  YYLTYPE *yylloc;
+} yypcontext_t;
+
+/* Put in YYARG at most YYARGN of the expected tokens given the
+   current YYCTX, and return the number of tokens stored in YYARG.  If
+   YYARG is null, return the number of expected tokens (guaranteed to
+   be less than YYNTOKENS).  Return YYENOMEM on memory exhaustion.
+   Return 0 if there are more than YYARGN expected tokens, yet fill
+   YYARG up to YYARGN. */
+static int
+yypcontext_expected_tokens (const yypcontext_t *yyctx,
+                            yysymbol_kind_t yyarg[], int yyargn)
+{
+  /* Actual size of YYARG. */
+  int yycount = 0;
+  int yyn = yypact[+*yyctx->yyssp];
+  if (!yypact_value_is_default (yyn))
+    {
+      /* Start YYX at -YYN if negative to avoid negative indexes in
+         YYCHECK.  In other words, skip the first -YYN actions for
+         this state because they are default actions.  */
+      int yyxbegin = yyn < 0 ? -yyn : 0;
+      /* Stay within bounds of both yycheck and yytname.  */
+      int yychecklim = YYLAST - yyn + 1;
+      int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
+      int yyx;
+      for (yyx = yyxbegin; yyx < yyxend; ++yyx)
+        if (yycheck[yyx + yyn] == yyx && yyx != YYSYMBOL_YYerror
+            && !yytable_value_is_error (yytable[yyx + yyn]))
+          {
+            if (!yyarg)
+              ++yycount;
+            else if (yycount == yyargn)
+              return 0;
+            else
+              yyarg[yycount++] = YY_CAST (yysymbol_kind_t, yyx);
+          }
+    }
+  if (yyarg && yycount == 0 && 0 < yyargn)
+    yyarg[0] = YYSYMBOL_YYEMPTY;
+  return yycount;
+}
 
-# ifndef yystrlen
-#  if defined __GLIBC__ && defined _STRING_H
-#   define yystrlen(S) (YY_CAST (YYPTRDIFF_T, strlen (S)))
-#  else
+
+
+
+#ifndef yystrlen
+# if defined __GLIBC__ && defined _STRING_H
+#  define yystrlen(S) (YY_CAST (YYPTRDIFF_T, strlen (S)))
+# else
 /* Return the length of YYSTR.  */
 static YYPTRDIFF_T
 yystrlen (const char *yystr)
@@ -1015,13 +1159,13 @@ yystrlen (const char *yystr)
     continue;
   return yylen;
 }
-#  endif
 # endif
+#endif
 
-# ifndef yystpcpy
-#  if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
-#   define yystpcpy stpcpy
-#  else
+#ifndef yystpcpy
+# if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
+#  define yystpcpy stpcpy
+# else
 /* Copy YYSRC to YYDEST, returning the address of the terminating '\0' in
    YYDEST.  */
 static char *
@@ -1035,10 +1179,10 @@ yystpcpy (char *yydest, const char *yysrc)
 
   return yyd - 1;
 }
-#  endif
 # endif
+#endif
 
-# ifndef yytnamerr
+#ifndef yytnamerr
 /* Copy to YYRES the contents of YYSTR after stripping away unnecessary
    quotes and backslashes, so that it's suitable for yyerror.  The
    heuristic is that double-quoting is unnecessary unless the string
@@ -1053,7 +1197,6 @@ yytnamerr (char *yyres, const char *yystr)
     {
       YYPTRDIFF_T yyn = 0;
       char const *yyp = yystr;
-
       for (;;)
         switch (*++yyp)
           {
@@ -1087,31 +1230,15 @@ yytnamerr (char *yyres, const char *yystr)
   else
     return yystrlen (yystr);
 }
-# endif
+#endif
 
-/* Copy into *YYMSG, which is of size *YYMSG_ALLOC, an error message
-   about the unexpected token YYTOKEN for the state stack whose top is
-   YYSSP.
 
-   Return 0 if *YYMSG was successfully written.  Return 1 if *YYMSG is
-   not large enough to hold the message.  In that case, also set
-   *YYMSG_ALLOC to the required number of bytes.  Return 2 if the
-   required number of bytes is too large to store.  */
 static int
-yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
-                yy_state_t *yyssp, int yytoken)
+yy_syntax_error_arguments (const yypcontext_t *yyctx,
+                           yysymbol_kind_t yyarg[], int yyargn)
 {
-  enum { YYERROR_VERBOSE_ARGS_MAXIMUM = 5 };
-  /* Internationalized format string. */
-  const char *yyformat = YY_NULLPTR;
-  /* Arguments of yyformat: reported tokens (one for the "unexpected",
-     one per "expected"). */
-  char const *yyarg[YYERROR_VERBOSE_ARGS_MAXIMUM];
   /* Actual size of YYARG. */
   int yycount = 0;
-  /* Cumulated lengths of YYARG.  */
-  YYPTRDIFF_T yysize = 0;
-
   /* There are many possibilities here to consider:
      - If this state is a consistent state with a default action, then
        the only way this function was invoked is if the default action
@@ -1135,52 +1262,54 @@ yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
        one exception: it will still contain any token that will not be
        accepted due to an error action in a later state.
   */
-  if (yytoken != YYEMPTY)
-    {
-      int yyn = yypact[+*yyssp];
-      YYPTRDIFF_T yysize0 = yytnamerr (YY_NULLPTR, yytname[yytoken]);
-      yysize = yysize0;
-      yyarg[yycount++] = yytname[yytoken];
-      if (!yypact_value_is_default (yyn))
-        {
-          /* Start YYX at -YYN if negative to avoid negative indexes in
-             YYCHECK.  In other words, skip the first -YYN actions for
-             this state because they are default actions.  */
-          int yyxbegin = yyn < 0 ? -yyn : 0;
-          /* Stay within bounds of both yycheck and yytname.  */
-          int yychecklim = YYLAST - yyn + 1;
-          int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
-          int yyx;
-
-          for (yyx = yyxbegin; yyx < yyxend; ++yyx)
-            if (yycheck[yyx + yyn] == yyx && yyx != YYTERROR
-                && !yytable_value_is_error (yytable[yyx + yyn]))
-              {
-                if (yycount == YYERROR_VERBOSE_ARGS_MAXIMUM)
-                  {
-                    yycount = 1;
-                    yysize = yysize0;
-                    break;
-                  }
-                yyarg[yycount++] = yytname[yyx];
-                {
-                  YYPTRDIFF_T yysize1
-                    = yysize + yytnamerr (YY_NULLPTR, yytname[yyx]);
-                  if (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM)
-                    yysize = yysize1;
-                  else
-                    return 2;
-                }
-              }
-        }
+  if (yyctx->yytoken != YYSYMBOL_YYEMPTY)
+    {
+      int yyn;
+      if (yyarg)
+        yyarg[yycount] = yyctx->yytoken;
+      ++yycount;
+      yyn = yypcontext_expected_tokens (yyctx,
+                                        yyarg ? yyarg + 1 : yyarg, yyargn - 1);
+      if (yyn == YYENOMEM)
+        return YYENOMEM;
+      else
+        yycount += yyn;
     }
+  return yycount;
+}
+
+/* Copy into *YYMSG, which is of size *YYMSG_ALLOC, an error message
+   about the unexpected token YYTOKEN for the state stack whose top is
+   YYSSP.
+
+   Return 0 if *YYMSG was successfully written.  Return -1 if *YYMSG is
+   not large enough to hold the message.  In that case, also set
+   *YYMSG_ALLOC to the required number of bytes.  Return YYENOMEM if the
+   required number of bytes is too large to store.  */
+static int
+yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
+                const yypcontext_t *yyctx)
+{
+  enum { YYARGS_MAX = 5 };
+  /* Internationalized format string. */
+  const char *yyformat = YY_NULLPTR;
+  /* Arguments of yyformat: reported tokens (one for the "unexpected",
+     one per "expected"). */
+  yysymbol_kind_t yyarg[YYARGS_MAX];
+  /* Cumulated lengths of YYARG.  */
+  YYPTRDIFF_T yysize = 0;
+
+  /* Actual size of YYARG. */
+  int yycount = yy_syntax_error_arguments (yyctx, yyarg, YYARGS_MAX);
+  if (yycount == YYENOMEM)
+    return YYENOMEM;
 
   switch (yycount)
     {
-# define YYCASE_(N, S)                      \
+#define YYCASE_(N, S)                       \
       case N:                               \
         yyformat = S;                       \
-      break
+        break
     default: /* Avoid compiler warnings. */
       YYCASE_(0, YY_("syntax error"));
       YYCASE_(1, YY_("syntax error, unexpected %s"));
@@ -1188,17 +1317,23 @@ yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
       YYCASE_(3, YY_("syntax error, unexpected %s, expecting %s or %s"));
       YYCASE_(4, YY_("syntax error, unexpected %s, expecting %s or %s or %s"));
       YYCASE_(5, YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s"));
-# undef YYCASE_
+#undef YYCASE_
     }
 
+  /* Compute error message size.  Don't count the "%s"s, but reserve
+     room for the terminator.  */
+  yysize = yystrlen (yyformat) - 2 * yycount + 1;
   {
-    /* Don't count the "%s"s in the final size, but reserve room for
-       the terminator.  */
-    YYPTRDIFF_T yysize1 = yysize + (yystrlen (yyformat) - 2 * yycount) + 1;
-    if (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM)
-      yysize = yysize1;
-    else
-      return 2;
+    int yyi;
+    for (yyi = 0; yyi < yycount; ++yyi)
+      {
+        YYPTRDIFF_T yysize1
+          = yysize + yytnamerr (YY_NULLPTR, yytname[yyarg[yyi]]);
+        if (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM)
+          yysize = yysize1;
+        else
+          return YYENOMEM;
+      }
   }
 
   if (*yymsg_alloc < yysize)
@@ -1207,7 +1342,7 @@ yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
       if (! (yysize <= *yymsg_alloc
              && *yymsg_alloc <= YYSTACK_ALLOC_MAXIMUM))
         *yymsg_alloc = YYSTACK_ALLOC_MAXIMUM;
-      return 1;
+      return -1;
     }
 
   /* Avoid sprintf, as that infringes on the user's name space.
@@ -1219,7 +1354,7 @@ yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
     while ((*yyp = *yyformat) != '\0')
       if (*yyp == '%' && yyformat[1] == 's' && yyi < yycount)
         {
-          yyp += yytnamerr (yyp, yyarg[yyi++]);
+          yyp += yytnamerr (yyp, yytname[yyarg[yyi++]]);
           yyformat += 2;
         }
       else
@@ -1230,29 +1365,32 @@ yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
   }
   return 0;
 }
-#endif /* YYERROR_VERBOSE */
+
 
 /*-----------------------------------------------.
 | Release the memory associated to this symbol.  |
 `-----------------------------------------------*/
 
 static void
-yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep, YYLTYPE *yylocationp)
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep, YYLTYPE *yylocationp)
 {
-  YYUSE (yyvaluep);
-  YYUSE (yylocationp);
+  YY_USE (yyvaluep);
+  YY_USE (yylocationp);
   if (!yymsg)
     yymsg = "Deleting";
-  YY_SYMBOL_PRINT (yymsg, yytype, yyvaluep, yylocationp);
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
 
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-  YYUSE (yytype);
+  YY_USE (yykind);
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
 
 
 
+
+
 /*----------.
 | yyparse.  |
 `----------*/
@@ -1260,7 +1398,7 @@ yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep, YYLTYPE *yylocatio
 int
 yyparse (void)
 {
-/* The lookahead symbol.  */
+/* Lookahead token kind.  */
 int yychar;
 
 
@@ -1279,55 +1417,50 @@ static YYLTYPE yyloc_default
 YYLTYPE yylloc = yyloc_default;
 
     /* Number of syntax errors so far.  */
-    int yynerrs;
+    int yynerrs = 0;
 
-    yy_state_fast_t yystate;
+    yy_state_fast_t yystate = 0;
     /* Number of tokens to shift before error messages enabled.  */
-    int yyerrstatus;
+    int yyerrstatus = 0;
 
-    /* The stacks and their tools:
-       'yyss': related to states.
-       'yyvs': related to semantic values.
-       'yyls': related to locations.
-
-       Refer to the stacks through separate pointers, to allow yyoverflow
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
        to reallocate them elsewhere.  */
 
-    /* The state stack.  */
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
+
+    /* The state stack: array, bottom, top.  */
     yy_state_t yyssa[YYINITDEPTH];
-    yy_state_t *yyss;
-    yy_state_t *yyssp;
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
 
-    /* The semantic value stack.  */
+    /* The semantic value stack: array, bottom, top.  */
     YYSTYPE yyvsa[YYINITDEPTH];
-    YYSTYPE *yyvs;
-    YYSTYPE *yyvsp;
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
 
-    /* The location stack.  */
+    /* The location stack: array, bottom, top.  */
     YYLTYPE yylsa[YYINITDEPTH];
-    YYLTYPE *yyls;
-    YYLTYPE *yylsp;
-
-    /* The locations where the error started and ended.  */
-    YYLTYPE yyerror_range[3];
-
-    YYPTRDIFF_T yystacksize;
+    YYLTYPE *yyls = yylsa;
+    YYLTYPE *yylsp = yyls;
 
   int yyn;
+  /* The return value of yyparse.  */
   int yyresult;
-  /* Lookahead token as an internal (translated) token number.  */
-  int yytoken = 0;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
   /* The variables used to return semantic value and location from the
      action routines.  */
   YYSTYPE yyval;
   YYLTYPE yyloc;
 
-#if YYERROR_VERBOSE
+  /* The locations where the error started and ended.  */
+  YYLTYPE yyerror_range[3];
+
   /* Buffer for error messages, and its allocated size.  */
   char yymsgbuf[128];
   char *yymsg = yymsgbuf;
   YYPTRDIFF_T yymsg_alloc = sizeof yymsgbuf;
-#endif
 
 #define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N), yylsp -= (N))
 
@@ -1335,17 +1468,10 @@ YYLTYPE yylloc = yyloc_default;
      Keep to zero when no symbol should be popped.  */
   int yylen = 0;
 
-  yyssp = yyss = yyssa;
-  yyvsp = yyvs = yyvsa;
-  yylsp = yyls = yylsa;
-  yystacksize = YYINITDEPTH;
-
   YYDPRINTF ((stderr, "Starting parse\n"));
 
-  yystate = 0;
-  yyerrstatus = 0;
-  yynerrs = 0;
   yychar = YYEMPTY; /* Cause a token to be read.  */
+
   yylsp[0] = yylloc;
   goto yysetstate;
 
@@ -1368,10 +1494,11 @@ yysetstate:
   YY_IGNORE_USELESS_CAST_BEGIN
   *yyssp = YY_CAST (yy_state_t, yystate);
   YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
 
   if (yyss + yystacksize - 1 <= yyssp)
 #if !defined yyoverflow && !defined YYSTACK_RELOCATE
-    goto yyexhaustedlab;
+    YYNOMEM;
 #else
     {
       /* Get the current used size of the three stacks, in elements.  */
@@ -1402,7 +1529,7 @@ yysetstate:
 # else /* defined YYSTACK_RELOCATE */
       /* Extend the stack our own way.  */
       if (YYMAXDEPTH <= yystacksize)
-        goto yyexhaustedlab;
+        YYNOMEM;
       yystacksize *= 2;
       if (YYMAXDEPTH < yystacksize)
         yystacksize = YYMAXDEPTH;
@@ -1413,11 +1540,11 @@ yysetstate:
           YY_CAST (union yyalloc *,
                    YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
         if (! yyptr)
-          goto yyexhaustedlab;
+          YYNOMEM;
         YYSTACK_RELOCATE (yyss_alloc, yyss);
         YYSTACK_RELOCATE (yyvs_alloc, yyvs);
         YYSTACK_RELOCATE (yyls_alloc, yyls);
-# undef YYSTACK_RELOCATE
+#  undef YYSTACK_RELOCATE
         if (yyss1 != yyssa)
           YYSTACK_FREE (yyss1);
       }
@@ -1437,6 +1564,7 @@ yysetstate:
     }
 #endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
 
+
   if (yystate == YYFINAL)
     YYACCEPT;
 
@@ -1457,18 +1585,30 @@ yybackup:
 
   /* Not known => get a lookahead token if don't already have one.  */
 
-  /* YYCHAR is either YYEMPTY or YYEOF or a valid lookahead symbol.  */
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
   if (yychar == YYEMPTY)
     {
-      YYDPRINTF ((stderr, "Reading a token: "));
+      YYDPRINTF ((stderr, "Reading a token\n"));
       yychar = yylex (&yylval, &yylloc);
     }
 
   if (yychar <= YYEOF)
     {
-      yychar = yytoken = YYEOF;
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
       YYDPRINTF ((stderr, "Now at end of input.\n"));
     }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      yyerror_range[1] = yylloc;
+      goto yyerrlab1;
+    }
   else
     {
       yytoken = YYTRANSLATE (yychar);
@@ -1540,490 +1680,656 @@ yyreduce:
   YY_REDUCE_PRINT (yyn);
   switch (yyn)
     {
-  case 2:
-#line 57 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 2: /* start: stmt ';'  */
+#line 61 "yacc.y"
     {
         parse_tree = (yyvsp[-1].sv_node);
         YYACCEPT;
     }
-#line 1550 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1690 "yacc.tab.cpp"
     break;
 
-  case 3:
-#line 62 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 3: /* start: HELP  */
+#line 66 "yacc.y"
     {
         parse_tree = std::make_shared<Help>();
         YYACCEPT;
     }
-#line 1559 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1699 "yacc.tab.cpp"
     break;
 
-  case 4:
-#line 67 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 4: /* start: EXIT  */
+#line 71 "yacc.y"
     {
         parse_tree = nullptr;
         YYACCEPT;
     }
-#line 1568 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1708 "yacc.tab.cpp"
     break;
 
-  case 5:
-#line 72 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 5: /* start: T_EOF  */
+#line 76 "yacc.y"
     {
         parse_tree = nullptr;
         YYACCEPT;
     }
-#line 1577 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1717 "yacc.tab.cpp"
     break;
 
-  case 10:
-#line 87 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 10: /* txnStmt: TXN_BEGIN  */
+#line 91 "yacc.y"
     {
         (yyval.sv_node) = std::make_shared<TxnBegin>();
     }
-#line 1585 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1725 "yacc.tab.cpp"
     break;
 
-  case 11:
-#line 91 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 11: /* txnStmt: TXN_COMMIT  */
+#line 95 "yacc.y"
     {
         (yyval.sv_node) = std::make_shared<TxnCommit>();
     }
-#line 1593 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1733 "yacc.tab.cpp"
     break;
 
-  case 12:
-#line 95 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 12: /* txnStmt: TXN_ABORT  */
+#line 99 "yacc.y"
     {
         (yyval.sv_node) = std::make_shared<TxnAbort>();
     }
-#line 1601 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1741 "yacc.tab.cpp"
     break;
 
-  case 13:
-#line 99 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 13: /* txnStmt: TXN_ROLLBACK  */
+#line 103 "yacc.y"
     {
         (yyval.sv_node) = std::make_shared<TxnRollback>();
     }
-#line 1609 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1749 "yacc.tab.cpp"
     break;
 
-  case 14:
-#line 106 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 14: /* dbStmt: SHOW TABLES  */
+#line 110 "yacc.y"
     {
         (yyval.sv_node) = std::make_shared<ShowTables>();
     }
-#line 1617 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1757 "yacc.tab.cpp"
     break;
 
-  case 15:
-#line 113 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 15: /* ddl: CREATE TABLE tbName '(' fieldList ')'  */
+#line 117 "yacc.y"
     {
         (yyval.sv_node) = std::make_shared<CreateTable>((yyvsp[-3].sv_str), (yyvsp[-1].sv_fields));
     }
-#line 1625 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1765 "yacc.tab.cpp"
     break;
 
-  case 16:
-#line 117 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 16: /* ddl: DROP TABLE tbName  */
+#line 121 "yacc.y"
     {
         (yyval.sv_node) = std::make_shared<DropTable>((yyvsp[0].sv_str));
     }
-#line 1633 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1773 "yacc.tab.cpp"
     break;
 
-  case 17:
-#line 121 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 17: /* ddl: DESC tbName  */
+#line 125 "yacc.y"
     {
         (yyval.sv_node) = std::make_shared<DescTable>((yyvsp[0].sv_str));
     }
-#line 1641 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1781 "yacc.tab.cpp"
     break;
 
-  case 18:
-#line 125 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 18: /* ddl: CREATE INDEX tbName '(' colNameList ')'  */
+#line 129 "yacc.y"
     {
         (yyval.sv_node) = std::make_shared<CreateIndex>((yyvsp[-3].sv_str), (yyvsp[-1].sv_strs));
     }
-#line 1649 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1789 "yacc.tab.cpp"
     break;
 
-  case 19:
-#line 129 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 19: /* ddl: CREATE UNIQUE INDEX tbName '(' colNameList ')'  */
+#line 133 "yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<CreateIndex>((yyvsp[-3].sv_str), (yyvsp[-1].sv_strs), true);
+    }
+#line 1797 "yacc.tab.cpp"
+    break;
+
+  case 20: /* ddl: CREATE INDEX tbName '(' colNameList ')' USING HASH  */
+#line 137 "yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<CreateIndex>((yyvsp[-5].sv_str), (yyvsp[-3].sv_strs), false, true);
+    }
+#line 1805 "yacc.tab.cpp"
+    break;
+
+  case 21: /* ddl: CREATE UNIQUE INDEX tbName '(' colNameList ')' USING HASH  */
+#line 141 "yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<CreateIndex>((yyvsp[-5].sv_str), (yyvsp[-3].sv_strs), true, true);
+    }
+#line 1813 "yacc.tab.cpp"
+    break;
+
+  case 22: /* ddl: DROP INDEX tbName '(' colNameList ')'  */
+#line 145 "yacc.y"
     {
         (yyval.sv_node) = std::make_shared<DropIndex>((yyvsp[-3].sv_str), (yyvsp[-1].sv_strs));
     }
-#line 1657 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1821 "yacc.tab.cpp"
     break;
 
-  case 20:
-#line 136 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 23: /* dml: INSERT INTO tbName VALUES '(' valueList ')'  */
+#line 152 "yacc.y"
     {
         (yyval.sv_node) = std::make_shared<InsertStmt>((yyvsp[-4].sv_str), (yyvsp[-1].sv_vals));
     }
-#line 1665 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1829 "yacc.tab.cpp"
     break;
 
-  case 21:
-#line 140 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 24: /* dml: DELETE FROM tbName optWhereClause  */
+#line 156 "yacc.y"
     {
         (yyval.sv_node) = std::make_shared<DeleteStmt>((yyvsp[-1].sv_str), (yyvsp[0].sv_conds));
     }
-#line 1673 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1837 "yacc.tab.cpp"
     break;
 
-  case 22:
-#line 144 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 25: /* dml: UPDATE tbName SET setClauses optWhereClause  */
+#line 160 "yacc.y"
     {
         (yyval.sv_node) = std::make_shared<UpdateStmt>((yyvsp[-3].sv_str), (yyvsp[-1].sv_set_clauses), (yyvsp[0].sv_conds));
     }
-#line 1681 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1845 "yacc.tab.cpp"
     break;
 
-  case 23:
-#line 148 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 26: /* dml: SELECT selector FROM tableList optWhereClause opt_groupby_clause opt_order_clause opt_limit_clause  */
+#line 164 "yacc.y"
     {
-        (yyval.sv_node) = std::make_shared<SelectStmt>((yyvsp[-4].sv_cols), (yyvsp[-2].sv_strs), (yyvsp[-1].sv_conds), (yyvsp[0].sv_orderby));
+        (yyval.sv_node) = std::make_shared<SelectStmt>((yyvsp[-6].sv_cols), (yyvsp[-4].sv_strs), (yyvsp[-3].sv_conds), (yyvsp[-2].sv_cols), (yyvsp[-1].sv_orderbys), (yyvsp[0].sv_limit));
     }
-#line 1689 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1853 "yacc.tab.cpp"
     break;
 
-  case 24:
-#line 155 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 27: /* fieldList: field  */
+#line 171 "yacc.y"
     {
         (yyval.sv_fields) = std::vector<std::shared_ptr<Field>>{(yyvsp[0].sv_field)};
     }
-#line 1697 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1861 "yacc.tab.cpp"
     break;
 
-  case 25:
-#line 159 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 28: /* fieldList: fieldList ',' field  */
+#line 175 "yacc.y"
     {
         (yyval.sv_fields).push_back((yyvsp[0].sv_field));
     }
-#line 1705 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1869 "yacc.tab.cpp"
     break;
 
-  case 26:
-#line 166 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 29: /* colNameList: colName  */
+#line 182 "yacc.y"
     {
         (yyval.sv_strs) = std::vector<std::string>{(yyvsp[0].sv_str)};
     }
-#line 1713 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1877 "yacc.tab.cpp"
     break;
 
-  case 27:
-#line 170 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 30: /* colNameList: colNameList ',' colName  */
+#line 186 "yacc.y"
     {
         (yyval.sv_strs).push_back((yyvsp[0].sv_str));
     }
-#line 1721 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1885 "yacc.tab.cpp"
     break;
 
-  case 28:
-#line 177 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 31: /* field: colName type  */
+#line 193 "yacc.y"
     {
         (yyval.sv_field) = std::make_shared<ColDef>((yyvsp[-1].sv_str), (yyvsp[0].sv_type_len));
     }
-#line 1729 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1893 "yacc.tab.cpp"
+    break;
+
+  case 32: /* field: colName type PRIMARY KEY  */
+#line 197 "yacc.y"
+    {
+        (yyval.sv_field) = std::make_shared<ColDef>((yyvsp[-3].sv_str), (yyvsp[-2].sv_type_len), true);
+    }
+#line 1901 "yacc.tab.cpp"
+    break;
+
+  case 33: /* field: PRIMARY KEY '(' colNameList ')'  */
+#line 201 "yacc.y"
+    {
+        (yyval.sv_field) = std::make_shared<PrimaryKey>((yyvsp[-1].sv_strs));
+    }
+#line 1909 "yacc.tab.cpp"
     break;
 
-  case 29:
-#line 184 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 34: /* type: INT  */
+#line 208 "yacc.y"
     {
         (yyval.sv_type_len) = std::make_shared<TypeLen>(SV_TYPE_INT, sizeof(int));
     }
-#line 1737 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1917 "yacc.tab.cpp"
     break;
 
-  case 30:
-#line 188 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 35: /* type: CHAR '(' VALUE_INT ')'  */
+#line 212 "yacc.y"
     {
         (yyval.sv_type_len) = std::make_shared<TypeLen>(SV_TYPE_STRING, (yyvsp[-1].sv_int));
     }
-#line 1745 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1925 "yacc.tab.cpp"
     break;
 
-  case 31:
-#line 192 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 36: /* type: FLOAT  */
+#line 216 "yacc.y"
     {
         (yyval.sv_type_len) = std::make_shared<TypeLen>(SV_TYPE_FLOAT, sizeof(float));
     }
-#line 1753 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1933 "yacc.tab.cpp"
     break;
 
-  case 32:
-#line 199 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 37: /* valueList: value  */
+#line 223 "yacc.y"
     {
         (yyval.sv_vals) = std::vector<std::shared_ptr<Value>>{(yyvsp[0].sv_val)};
     }
-#line 1761 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1941 "yacc.tab.cpp"
     break;
 
-  case 33:
-#line 203 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 38: /* valueList: valueList ',' value  */
+#line 227 "yacc.y"
     {
         (yyval.sv_vals).push_back((yyvsp[0].sv_val));
     }
-#line 1769 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1949 "yacc.tab.cpp"
     break;
 
-  case 34:
-#line 210 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 39: /* value: VALUE_INT  */
+#line 234 "yacc.y"
     {
         (yyval.sv_val) = std::make_shared<IntLit>((yyvsp[0].sv_int));
     }
-#line 1777 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1957 "yacc.tab.cpp"
     break;
 
-  case 35:
-#line 214 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 40: /* value: VALUE_FLOAT  */
+#line 238 "yacc.y"
     {
         (yyval.sv_val) = std::make_shared<FloatLit>((yyvsp[0].sv_float));
     }
-#line 1785 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1965 "yacc.tab.cpp"
     break;
 
-  case 36:
-#line 218 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 41: /* value: VALUE_STRING  */
+#line 242 "yacc.y"
     {
         (yyval.sv_val) = std::make_shared<StringLit>((yyvsp[0].sv_str));
     }
-#line 1793 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1973 "yacc.tab.cpp"
     break;
 
-  case 37:
-#line 225 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 42: /* condition: col op expr  */
+#line 249 "yacc.y"
     {
         (yyval.sv_cond) = std::make_shared<BinaryExpr>((yyvsp[-2].sv_col), (yyvsp[-1].sv_comp_op), (yyvsp[0].sv_expr));
     }
-#line 1801 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1981 "yacc.tab.cpp"
     break;
 
-  case 38:
-#line 231 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 43: /* optWhereClause: %empty  */
+#line 255 "yacc.y"
                       { /* ignore*/ }
-#line 1807 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1987 "yacc.tab.cpp"
     break;
 
-  case 39:
-#line 233 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 44: /* optWhereClause: WHERE whereClause  */
+#line 257 "yacc.y"
     {
         (yyval.sv_conds) = (yyvsp[0].sv_conds);
     }
-#line 1815 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1995 "yacc.tab.cpp"
     break;
 
-  case 40:
-#line 240 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 45: /* whereClause: condition  */
+#line 264 "yacc.y"
     {
         (yyval.sv_conds) = std::vector<std::shared_ptr<BinaryExpr>>{(yyvsp[0].sv_cond)};
     }
-#line 1823 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2003 "yacc.tab.cpp"
     break;
 
-  case 41:
-#line 244 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 46: /* whereClause: whereClause AND condition  */
+#line 268 "yacc.y"
     {
         (yyval.sv_conds).push_back((yyvsp[0].sv_cond));
     }
-#line 1831 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2011 "yacc.tab.cpp"
     break;
 
-  case 42:
-#line 251 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 47: /* col: tbName '.' colName  */
+#line 275 "yacc.y"
     {
         (yyval.sv_col) = std::make_shared<Col>((yyvsp[-2].sv_str), (yyvsp[0].sv_str));
     }
-#line 1839 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2019 "yacc.tab.cpp"
     break;
 
-  case 43:
-#line 255 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 48: /* col: colName  */
+#line 279 "yacc.y"
     {
         (yyval.sv_col) = std::make_shared<Col>("", (yyvsp[0].sv_str));
     }
-#line 1847 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2027 "yacc.tab.cpp"
+    break;
+
+  case 49: /* aggCol: aggFunc '(' col ')'  */
+#line 286 "yacc.y"
+    {
+        (yyval.sv_col) = (yyvsp[-1].sv_col);
+        (yyval.sv_col)->agg_type = (yyvsp[-3].sv_agg_type);
+    }
+#line 2036 "yacc.tab.cpp"
+    break;
+
+  case 50: /* aggCol: COUNT '(' col ')'  */
+#line 291 "yacc.y"
+    {
+        (yyval.sv_col) = (yyvsp[-1].sv_col);
+        (yyval.sv_col)->agg_type = SV_AGG_COUNT;
+    }
+#line 2045 "yacc.tab.cpp"
+    break;
+
+  case 51: /* aggCol: COUNT '(' '*' ')'  */
+#line 296 "yacc.y"
+    {
+        (yyval.sv_col) = std::make_shared<Col>("", "*", SV_AGG_COUNT);
+    }
+#line 2053 "yacc.tab.cpp"
+    break;
+
+  case 52: /* aggFunc: SUM  */
+#line 303 "yacc.y"
+    {
+        (yyval.sv_agg_type) = SV_AGG_SUM;
+    }
+#line 2061 "yacc.tab.cpp"
+    break;
+
+  case 53: /* aggFunc: MIN  */
+#line 307 "yacc.y"
+    {
+        (yyval.sv_agg_type) = SV_AGG_MIN;
+    }
+#line 2069 "yacc.tab.cpp"
+    break;
+
+  case 54: /* aggFunc: MAX  */
+#line 311 "yacc.y"
+    {
+        (yyval.sv_agg_type) = SV_AGG_MAX;
+    }
+#line 2077 "yacc.tab.cpp"
     break;
 
-  case 44:
-#line 262 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 55: /* aggFunc: AVG  */
+#line 315 "yacc.y"
+    {
+        (yyval.sv_agg_type) = SV_AGG_AVG;
+    }
+#line 2085 "yacc.tab.cpp"
+    break;
+
+  case 58: /* selList: selItem  */
+#line 327 "yacc.y"
     {
         (yyval.sv_cols) = std::vector<std::shared_ptr<Col>>{(yyvsp[0].sv_col)};
     }
-#line 1855 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2093 "yacc.tab.cpp"
     break;
 
-  case 45:
-#line 266 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 59: /* selList: selList ',' selItem  */
+#line 331 "yacc.y"
     {
         (yyval.sv_cols).push_back((yyvsp[0].sv_col));
     }
-#line 1863 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2101 "yacc.tab.cpp"
     break;
 
-  case 46:
-#line 273 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 60: /* colList: col  */
+#line 338 "yacc.y"
+    {
+        (yyval.sv_cols) = std::vector<std::shared_ptr<Col>>{(yyvsp[0].sv_col)};
+    }
+#line 2109 "yacc.tab.cpp"
+    break;
+
+  case 61: /* colList: colList ',' col  */
+#line 342 "yacc.y"
+    {
+        (yyval.sv_cols).push_back((yyvsp[0].sv_col));
+    }
+#line 2117 "yacc.tab.cpp"
+    break;
+
+  case 62: /* op: '='  */
+#line 349 "yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_EQ;
     }
-#line 1871 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2125 "yacc.tab.cpp"
     break;
 
-  case 47:
-#line 277 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 63: /* op: '<'  */
+#line 353 "yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_LT;
     }
-#line 1879 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2133 "yacc.tab.cpp"
     break;
 
-  case 48:
-#line 281 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 64: /* op: '>'  */
+#line 357 "yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_GT;
     }
-#line 1887 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2141 "yacc.tab.cpp"
     break;
 
-  case 49:
-#line 285 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 65: /* op: NEQ  */
+#line 361 "yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_NE;
     }
-#line 1895 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2149 "yacc.tab.cpp"
     break;
 
-  case 50:
-#line 289 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 66: /* op: LEQ  */
+#line 365 "yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_LE;
     }
-#line 1903 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2157 "yacc.tab.cpp"
     break;
 
-  case 51:
-#line 293 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 67: /* op: GEQ  */
+#line 369 "yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_GE;
     }
-#line 1911 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2165 "yacc.tab.cpp"
     break;
 
-  case 52:
-#line 300 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 68: /* expr: value  */
+#line 376 "yacc.y"
     {
         (yyval.sv_expr) = std::static_pointer_cast<Expr>((yyvsp[0].sv_val));
     }
-#line 1919 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2173 "yacc.tab.cpp"
     break;
 
-  case 53:
-#line 304 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 69: /* expr: col  */
+#line 380 "yacc.y"
     {
         (yyval.sv_expr) = std::static_pointer_cast<Expr>((yyvsp[0].sv_col));
     }
-#line 1927 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2181 "yacc.tab.cpp"
     break;
 
-  case 54:
-#line 311 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 70: /* setClauses: setClause  */
+#line 387 "yacc.y"
     {
         (yyval.sv_set_clauses) = std::vector<std::shared_ptr<SetClause>>{(yyvsp[0].sv_set_clause)};
     }
-#line 1935 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2189 "yacc.tab.cpp"
     break;
 
-  case 55:
-#line 315 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 71: /* setClauses: setClauses ',' setClause  */
+#line 391 "yacc.y"
     {
         (yyval.sv_set_clauses).push_back((yyvsp[0].sv_set_clause));
     }
-#line 1943 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2197 "yacc.tab.cpp"
     break;
 
-  case 56:
-#line 322 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 72: /* setClause: colName '=' value  */
+#line 398 "yacc.y"
     {
         (yyval.sv_set_clause) = std::make_shared<SetClause>((yyvsp[-2].sv_str), (yyvsp[0].sv_val));
     }
-#line 1951 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2205 "yacc.tab.cpp"
     break;
 
-  case 57:
-#line 329 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 73: /* selector: '*'  */
+#line 405 "yacc.y"
     {
         (yyval.sv_cols) = {};
     }
-#line 1959 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2213 "yacc.tab.cpp"
     break;
 
-  case 59:
-#line 337 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 75: /* tableList: tbName  */
+#line 413 "yacc.y"
     {
         (yyval.sv_strs) = std::vector<std::string>{(yyvsp[0].sv_str)};
     }
-#line 1967 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2221 "yacc.tab.cpp"
     break;
 
-  case 60:
-#line 341 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 76: /* tableList: tableList ',' tbName  */
+#line 417 "yacc.y"
     {
         (yyval.sv_strs).push_back((yyvsp[0].sv_str));
     }
-#line 1975 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2229 "yacc.tab.cpp"
     break;
 
-  case 61:
-#line 345 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 77: /* tableList: tableList JOIN tbName  */
+#line 421 "yacc.y"
     {
         (yyval.sv_strs).push_back((yyvsp[0].sv_str));
     }
-#line 1983 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2237 "yacc.tab.cpp"
     break;
 
-  case 62:
-#line 352 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 78: /* opt_groupby_clause: GROUP BY colList  */
+#line 428 "yacc.y"
+    {
+        (yyval.sv_cols) = (yyvsp[0].sv_cols);
+    }
+#line 2245 "yacc.tab.cpp"
+    break;
+
+  case 79: /* opt_groupby_clause: %empty  */
+#line 431 "yacc.y"
+                      { /* ignore*/ }
+#line 2251 "yacc.tab.cpp"
+    break;
+
+  case 80: /* opt_order_clause: ORDER BY order_clause  */
+#line 436 "yacc.y"
     { 
-        (yyval.sv_orderby) = (yyvsp[0].sv_orderby); 
+        (yyval.sv_orderbys) = (yyvsp[0].sv_orderbys); 
     }
-#line 1991 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2259 "yacc.tab.cpp"
     break;
 
-  case 63:
-#line 355 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 81: /* opt_order_clause: %empty  */
+#line 439 "yacc.y"
                       { /* ignore*/ }
-#line 1997 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2265 "yacc.tab.cpp"
+    break;
+
+  case 82: /* order_clause: order_item  */
+#line 444 "yacc.y"
+    {
+        (yyval.sv_orderbys) = std::vector<std::shared_ptr<OrderBy>>{(yyvsp[0].sv_orderby)};
+    }
+#line 2273 "yacc.tab.cpp"
+    break;
+
+  case 83: /* order_clause: order_clause ',' order_item  */
+#line 448 "yacc.y"
+    {
+        (yyval.sv_orderbys).push_back((yyvsp[0].sv_orderby));
+    }
+#line 2281 "yacc.tab.cpp"
     break;
 
-  case 64:
-#line 360 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 84: /* order_item: selItem opt_asc_desc  */
+#line 455 "yacc.y"
     { 
         (yyval.sv_orderby) = std::make_shared<OrderBy>((yyvsp[-1].sv_col), (yyvsp[0].sv_orderby_dir));
     }
-#line 2005 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2289 "yacc.tab.cpp"
     break;
 
-  case 65:
-#line 366 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 85: /* opt_limit_clause: LIMIT VALUE_INT  */
+#line 462 "yacc.y"
+    {
+        (yyval.sv_limit) = std::make_shared<Limit>((yyvsp[0].sv_int), 0);
+    }
+#line 2297 "yacc.tab.cpp"
+    break;
+
+  case 86: /* opt_limit_clause: LIMIT VALUE_INT OFFSET VALUE_INT  */
+#line 466 "yacc.y"
+    {
+        (yyval.sv_limit) = std::make_shared<Limit>((yyvsp[-2].sv_int), (yyvsp[0].sv_int));
+    }
+#line 2305 "yacc.tab.cpp"
+    break;
+
+  case 87: /* opt_limit_clause: %empty  */
+#line 469 "yacc.y"
+                      { /* ignore*/ }
+#line 2311 "yacc.tab.cpp"
+    break;
+
+  case 88: /* opt_asc_desc: ASC  */
+#line 473 "yacc.y"
                  { (yyval.sv_orderby_dir) = OrderBy_ASC;     }
-#line 2011 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2317 "yacc.tab.cpp"
     break;
 
-  case 66:
-#line 367 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 89: /* opt_asc_desc: DESC  */
+#line 474 "yacc.y"
                  { (yyval.sv_orderby_dir) = OrderBy_DESC;    }
-#line 2017 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2323 "yacc.tab.cpp"
     break;
 
-  case 67:
-#line 368 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+  case 90: /* opt_asc_desc: %empty  */
+#line 475 "yacc.y"
             { (yyval.sv_orderby_dir) = OrderBy_DEFAULT; }
-#line 2023 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2329 "yacc.tab.cpp"
     break;
 
 
-#line 2027 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2333 "yacc.tab.cpp"
 
       default: break;
     }
@@ -2038,11 +2344,10 @@ yyreduce:
      case of YYERROR or YYBACKUP, subsequent parser actions might lead
      to an incorrect destructor call or verbose syntax error message
      before the lookahead is translated.  */
-  YY_SYMBOL_PRINT ("-> $$ =", yyr1[yyn], &yyval, &yyloc);
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
 
   YYPOPSTACK (yylen);
   yylen = 0;
-  YY_STACK_PRINT (yyss, yyssp);
 
   *++yyvsp = yyval;
   *++yylsp = yyloc;
@@ -2067,50 +2372,45 @@ yyreduce:
 yyerrlab:
   /* Make sure we have latest lookahead translation.  See comments at
      user semantic actions for why this is necessary.  */
-  yytoken = yychar == YYEMPTY ? YYEMPTY : YYTRANSLATE (yychar);
-
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
   /* If not already recovering from an error, report this error.  */
   if (!yyerrstatus)
     {
       ++yynerrs;
-#if ! YYERROR_VERBOSE
-      yyerror (&yylloc, YY_("syntax error"));
-#else
-# define YYSYNTAX_ERROR yysyntax_error (&yymsg_alloc, &yymsg, \
-                                        yyssp, yytoken)
       {
+        yypcontext_t yyctx
+          = {yyssp, yytoken, &yylloc};
         char const *yymsgp = YY_("syntax error");
         int yysyntax_error_status;
-        yysyntax_error_status = YYSYNTAX_ERROR;
+        yysyntax_error_status = yysyntax_error (&yymsg_alloc, &yymsg, &yyctx);
         if (yysyntax_error_status == 0)
           yymsgp = yymsg;
-        else if (yysyntax_error_status == 1)
+        else if (yysyntax_error_status == -1)
           {
             if (yymsg != yymsgbuf)
               YYSTACK_FREE (yymsg);
-            yymsg = YY_CAST (char *, YYSTACK_ALLOC (YY_CAST (YYSIZE_T, yymsg_alloc)));
-            if (!yymsg)
+            yymsg = YY_CAST (char *,
+                             YYSTACK_ALLOC (YY_CAST (YYSIZE_T, yymsg_alloc)));
+            if (yymsg)
               {
-                yymsg = yymsgbuf;
-                yymsg_alloc = sizeof yymsgbuf;
-                yysyntax_error_status = 2;
+                yysyntax_error_status
+                  = yysyntax_error (&yymsg_alloc, &yymsg, &yyctx);
+                yymsgp = yymsg;
               }
             else
               {
-                yysyntax_error_status = YYSYNTAX_ERROR;
-                yymsgp = yymsg;
+                yymsg = yymsgbuf;
+                yymsg_alloc = sizeof yymsgbuf;
+                yysyntax_error_status = YYENOMEM;
               }
           }
         yyerror (&yylloc, yymsgp);
-        if (yysyntax_error_status == 2)
-          goto yyexhaustedlab;
+        if (yysyntax_error_status == YYENOMEM)
+          YYNOMEM;
       }
-# undef YYSYNTAX_ERROR
-#endif
     }
 
   yyerror_range[1] = yylloc;
-
   if (yyerrstatus == 3)
     {
       /* If just tried and failed to reuse lookahead token after an
@@ -2143,6 +2443,7 @@ yyerrorlab:
      label yyerrorlab therefore never appears in user code.  */
   if (0)
     YYERROR;
+  ++yynerrs;
 
   /* Do not reclaim the symbols of the rule whose action triggered
      this YYERROR.  */
@@ -2159,13 +2460,14 @@ yyerrorlab:
 yyerrlab1:
   yyerrstatus = 3;      /* Each real token shifted decrements this.  */
 
+  /* Pop stack until we find a state that shifts the error token.  */
   for (;;)
     {
       yyn = yypact[yystate];
       if (!yypact_value_is_default (yyn))
         {
-          yyn += YYTERROR;
-          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYTERROR)
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
             {
               yyn = yytable[yyn];
               if (0 < yyn)
@@ -2179,7 +2481,7 @@ yyerrlab1:
 
       yyerror_range[1] = *yylsp;
       yydestruct ("Error: popping",
-                  yystos[yystate], yyvsp, yylsp);
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp, yylsp);
       YYPOPSTACK (1);
       yystate = *yyssp;
       YY_STACK_PRINT (yyss, yyssp);
@@ -2190,13 +2492,11 @@ yyerrlab1:
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 
   yyerror_range[2] = yylloc;
-  /* Using YYLLOC is tempting, but would change the location of
-     the lookahead.  YYLOC is available though.  */
-  YYLLOC_DEFAULT (yyloc, yyerror_range, 2);
-  *++yylsp = yyloc;
+  ++yylsp;
+  YYLLOC_DEFAULT (*yylsp, yyerror_range, 2);
 
   /* Shift the error token.  */
-  YY_SYMBOL_PRINT ("Shifting", yystos[yyn], yyvsp, yylsp);
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
 
   yystate = yyn;
   goto yynewstate;
@@ -2207,7 +2507,7 @@ yyerrlab1:
 `-------------------------------------*/
 yyacceptlab:
   yyresult = 0;
-  goto yyreturn;
+  goto yyreturnlab;
 
 
 /*-----------------------------------.
@@ -2215,24 +2515,22 @@ yyacceptlab:
 `-----------------------------------*/
 yyabortlab:
   yyresult = 1;
-  goto yyreturn;
+  goto yyreturnlab;
 
 
-#if !defined yyoverflow || YYERROR_VERBOSE
-/*-------------------------------------------------.
-| yyexhaustedlab -- memory exhaustion comes here.  |
-`-------------------------------------------------*/
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
 yyexhaustedlab:
   yyerror (&yylloc, YY_("memory exhausted"));
   yyresult = 2;
-  /* Fall through.  */
-#endif
+  goto yyreturnlab;
 
 
-/*-----------------------------------------------------.
-| yyreturn -- parsing is finished, return the result.  |
-`-----------------------------------------------------*/
-yyreturn:
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
   if (yychar != YYEMPTY)
     {
       /* Make sure we have latest lookahead translation.  See comments at
@@ -2248,18 +2546,17 @@ yyreturn:
   while (yyssp != yyss)
     {
       yydestruct ("Cleanup: popping",
-                  yystos[+*yyssp], yyvsp, yylsp);
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp, yylsp);
       YYPOPSTACK (1);
     }
 #ifndef yyoverflow
   if (yyss != yyssa)
     YYSTACK_FREE (yyss);
 #endif
-#if YYERROR_VERBOSE
   if (yymsg != yymsgbuf)
     YYSTACK_FREE (yymsg);
-#endif
   return yyresult;
 }
-#line 374 "/home/user/lvxinda/learngit/rucbase-lab/src/parser/yacc.y"
+
+#line 481 "yacc.y"
 
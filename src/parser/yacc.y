@@ -23,6 +23,7 @@ using namespace ast;
 // keywords
 %token SHOW TABLES CREATE TABLE DROP DESC INSERT INTO VALUES DELETE FROM ASC ORDER BY
 WHERE UPDATE SET SELECT INT CHAR FLOAT INDEX AND JOIN EXIT HELP TXN_BEGIN TXN_COMMIT TXN_ABORT TXN_ROLLBACK ORDER_BY
+UNIQUE PRIMARY KEY USING HASH LIMIT OFFSET GROUP COUNT SUM MIN MAX AVG
 // non-keywords
 %token LEQ NEQ GEQ T_EOF
 
@@ -42,13 +43,16 @@ WHERE UPDATE SET SELECT INT CHAR FLOAT INDEX AND JOIN EXIT HELP TXN_BEGIN TXN_CO
 %type <sv_vals> valueList
 %type <sv_str> tbName colName
 %type <sv_strs> tableList colNameList
-%type <sv_col> col
-%type <sv_cols> colList selector
+%type <sv_col> col aggCol selItem
+%type <sv_cols> colList selector selList opt_groupby_clause
+%type <sv_agg_type> aggFunc
 %type <sv_set_clause> setClause
 %type <sv_set_clauses> setClauses
 %type <sv_cond> condition
 %type <sv_conds> whereClause optWhereClause
-%type <sv_orderby>  order_clause opt_order_clause
+%type <sv_orderby>  order_item
+%type <sv_orderbys> order_clause opt_order_clause
+%type <sv_limit> opt_limit_clause
 %type <sv_orderby_dir> opt_asc_desc
 
 %%
@@ -125,6 +129,18 @@ ddl:
     {
         $$ = std::make_shared<CreateIndex>($3, $5);
     }
+    |   CREATE UNIQUE INDEX tbName '(' colNameList ')'
+    {
+        $$ = std::make_shared<CreateIndex>($4, $6, true);
+    }
+    |   CREATE INDEX tbName '(' colNameList ')' USING HASH
+    {
+        $$ = std::make_shared<CreateIndex>($3, $5, false, true);
+    }
+    |   CREATE UNIQUE INDEX tbName '(' colNameList ')' USING HASH
+    {
+        $$ = std::make_shared<CreateIndex>($4, $6, true, true);
+    }
     |   DROP INDEX tbName '(' colNameList ')'
     {
         $$ = std::make_shared<DropIndex>($3, $5);
@@ -144,9 +160,9 @@ dml:
     {
         $$ = std::make_shared<UpdateStmt>($2, $4, $5);
     }
-    |   SELECT selector FROM tableList optWhereClause opt_order_clause
+    |   SELECT selector FROM tableList optWhereClause opt_groupby_clause opt_order_clause opt_limit_clause
     {
-        $$ = std::make_shared<SelectStmt>($2, $4, $5, $6);
+        $$ = std::make_shared<SelectStmt>($2, $4, $5, $6, $7, $8);
     }
     ;
 
@@ -177,6 +193,14 @@ field:
     {
         $$ = std::make_shared<ColDef>($1, $2);
     }
+    |   colName type PRIMARY KEY
+    {
+        $$ = std::make_shared<ColDef>($1, $2, true);
+    }
+    |   PRIMARY KEY '(' colNameList ')'
+    {
+        $$ = std::make_shared<PrimaryKey>($4);
+    }
     ;
 
 type:
@@ -257,6 +281,58 @@ col:
     }
     ;
 
+aggCol:
+        aggFunc '(' col ')'
+    {
+        $$ = $3;
+        $$->agg_type = $1;
+    }
+    |   COUNT '(' col ')'
+    {
+        $$ = $3;
+        $$->agg_type = SV_AGG_COUNT;
+    }
+    |   COUNT '(' '*' ')'
+    {
+        $$ = std::make_shared<Col>("", "*", SV_AGG_COUNT);
+    }
+    ;
+
+aggFunc:
+        SUM
+    {
+        $$ = SV_AGG_SUM;
+    }
+    |   MIN
+    {
+        $$ = SV_AGG_MIN;
+    }
+    |   MAX
+    {
+        $$ = SV_AGG_MAX;
+    }
+    |   AVG
+    {
+        $$ = SV_AGG_AVG;
+    }
+    ;
+
+selItem:
+        col
+    |   aggCol
+    ;
+
+selList:
+        selItem
+    {
+        $$ = std::vector<std::shared_ptr<Col>>{$1};
+    }
+    |   selList ',' selItem
+    {
+        $$.push_back($3);
+    }
+    ;
+
 colList:
         col
     {
@@ -329,7 +405,7 @@ selector:
     {
         $$ = {};
     }
-    |   colList
+    |   selList
     ;
 
 tableList:
@@ -347,6 +423,14 @@ tableList:
     }
     ;
 
+opt_groupby_clause:
+    GROUP BY colList
+    {
+        $$ = $3;
+    }
+    |   /* epsilon */ { /* ignore*/ }
+    ;
+
 opt_order_clause:
     ORDER BY order_clause      
     { 
@@ -356,12 +440,35 @@ opt_order_clause:
     ;
 
 order_clause:
-      col  opt_asc_desc 
+      order_item
+    {
+        $$ = std::vector<std::shared_ptr<OrderBy>>{$1};
+    }
+    |   order_clause ',' order_item
+    {
+        $$.push_back($3);
+    }
+    ;
+
+order_item:
+      selItem  opt_asc_desc 
     { 
         $$ = std::make_shared<OrderBy>($1, $2);
     }
     ;   
 
+opt_limit_clause:
+    LIMIT VALUE_INT
+    {
+        $$ = std::make_shared<Limit>($2, 0);
+    }
+    |   LIMIT VALUE_INT OFFSET VALUE_INT
+    {
+        $$ = std::make_shared<Limit>($2, $4);
+    }
+    |   /* epsilon */ { /* ignore*/ }
+    ;
+
 opt_asc_desc:
     ASC          { $$ = OrderBy_ASC;     }
     |  DESC      { $$ = OrderBy_DESC;    }
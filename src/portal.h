@@ -15,12 +15,18 @@ See the Mulan PSL v2 for more details. */
 #include <string>
 #include "optimizer/plan.h"
 #include "execution/executor_abstract.h"
+#include "execution/executor_aggregate.h"
+#include "execution/executor_bitmap_heap_scan.h"
+#include "execution/executor_hash_join.h"
+#include "execution/executor_index_nestedloop_join.h"
+#include "execution/executor_merge_join.h"
 #include "execution/executor_nestedloop_join.h"
 #include "execution/executor_projection.h"
 #include "execution/executor_seq_scan.h"
 #include "execution/executor_index_scan.h"
 #include "execution/executor_update.h"
 #include "execution/executor_insert.h"
+#include "execution/executor_limit.h"
 #include "execution/executor_delete.h"
 #include "execution/execution_sort.h"
 #include "common/common.h"
@@ -160,19 +166,48 @@ class Portal
             if(x->tag == T_SeqScan) {
                 return std::make_unique<SeqScanExecutor>(sm_manager_, x->tab_name_, x->conds_, context);
             }
+            else if(x->tag == T_BitmapHeapScan) {
+                return std::make_unique<BitmapHeapScanExecutor>(sm_manager_, x->tab_name_, x->conds_,
+                                                                x->bitmap_index_cols_, context);
+            }
             else {
-                return std::make_unique<IndexScanExecutor>(sm_manager_, x->tab_name_, x->conds_, x->index_col_names_, context);
+                return std::make_unique<IndexScanExecutor>(sm_manager_, x->tab_name_, x->conds_, x->index_col_names_, context,
+                                                           x->covering_);
             } 
         } else if(auto x = std::dynamic_pointer_cast<JoinPlan>(plan)) {
+            if (x->tag == T_IndexNestLoop) {
+                auto inner = std::dynamic_pointer_cast<ScanPlan>(x->inner_left_ ? x->left_ : x->right_);
+                return std::make_unique<IndexNestedLoopJoinExecutor>(
+                    convert_plan_executor(x->inner_left_ ? x->right_ : x->left_, context), sm_manager_,
+                    inner->tab_name_, inner->conds_, x->index_col_names_, std::move(x->conds_), x->inner_left_,
+                    context);
+            }
             std::unique_ptr<AbstractExecutor> left = convert_plan_executor(x->left_, context);
             std::unique_ptr<AbstractExecutor> right = convert_plan_executor(x->right_, context);
+            if (x->tag == T_MergeJoin) {
+                return std::make_unique<MergeJoinExecutor>(std::move(left), std::move(right), std::move(x->conds_));
+            }
+            if (x->tag == T_HashJoin) {
+                return std::make_unique<HashJoinExecutor>(std::move(left), std::move(right), std::move(x->conds_),
+                                                          x->build_left_);
+            }
             std::unique_ptr<AbstractExecutor> join = std::make_unique<NestedLoopJoinExecutor>(
                                 std::move(left), 
                                 std::move(right), std::move(x->conds_));
             return join;
+        } else if(auto x = std::dynamic_pointer_cast<AggregatePlan>(plan)) {
+            return std::make_unique<AggregateExecutor>(convert_plan_executor(x->subplan_, context), x->group_cols_,
+                                                       x->agg_cols_);
         } else if(auto x = std::dynamic_pointer_cast<SortPlan>(plan)) {
+            if (x->limit_ >= 0) {
+                return std::make_unique<TopNExecutor>(convert_plan_executor(x->subplan_, context), x->sel_cols_,
+                                                      x->is_descs_, x->limit_);
+            }
             return std::make_unique<SortExecutor>(convert_plan_executor(x->subplan_, context), 
-                                            x->sel_col_, x->is_desc_);
+                                            x->sel_cols_, x->is_descs_);
+        } else if(auto x = std::dynamic_pointer_cast<LimitPlan>(plan)) {
+            return std::make_unique<LimitExecutor>(convert_plan_executor(x->subplan_, context), x->limit_,
+                                                   x->offset_);
         }
         return nullptr;
     }
@@ -41,6 +41,67 @@ std::unique_ptr<RmRecord> RmFileHandle::get_record(const Rid& rid, Context* cont
 
 }
 
+/**
+ * @description: 读取同一个页面上的多条记录，页面只获取一次
+ * @param {int} page_no 页面号
+ * @param {vector<int>&} slot_nos 要读取的记录在页面中的槽号
+ * @param {Context*} context
+ * @return {vector<unique_ptr<RmRecord>>} 与slot_nos一一对应的记录
+ */
+std::vector<std::unique_ptr<RmRecord>> RmFileHandle::get_records(int page_no, const std::vector<int> &slot_nos,
+                                                                 Context *context) const {
+    if (context) {
+        for (int slot_no : slot_nos) {
+            context->lock_mgr_->lock_shared_on_record(context->txn_, Rid{page_no, slot_no}, fd_);
+        }
+    }
+
+    auto page_handle = fetch_page_handle(page_no);
+    std::vector<std::unique_ptr<RmRecord>> recs;
+    recs.reserve(slot_nos.size());
+    for (int slot_no : slot_nos) {
+        if (!Bitmap::is_set(page_handle.bitmap, slot_no)) {
+            buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), false);
+            throw RecordNotFoundError(page_no, slot_no);
+        }
+        recs.push_back(std::make_unique<RmRecord>(file_hdr_.record_size, page_handle.get_slot(slot_no)));
+    }
+    buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), false);
+    return recs;
+}
+
+/**
+ * @description: 从页面上槽号slot_no之后开始，按槽号顺序读取至多max_n条记录，连续写入buf中，页面只获取一次
+ * @param {int} page_no 页面号
+ * @param {int*} slot_no 开始位置的前一个槽号，返回时更新为最后读取的记录的槽号，页面读完时为每页的记录数
+ * @param {int} max_n 最多读取的记录数
+ * @param {char*} buf 存放记录，至少有max_n条记录的空间
+ * @param {Context*} context
+ * @return {int} 读取的记录数
+ */
+int RmFileHandle::get_page_records(int page_no, int *slot_no, int max_n, char *buf, Context *context) const {
+    auto page_handle = fetch_page_handle(page_no);
+    int n = 0;
+    try {
+        while (n < max_n) {
+            *slot_no = Bitmap::next_bit(true, page_handle.bitmap, file_hdr_.num_records_per_page, *slot_no);
+            if (*slot_no == file_hdr_.num_records_per_page) {
+                break;
+            }
+            if (context) {
+                context->lock_mgr_->lock_shared_on_record(context->txn_, Rid{page_no, *slot_no}, fd_);
+            }
+            memcpy(buf + n * file_hdr_.record_size, page_handle.get_slot(*slot_no), file_hdr_.record_size);
+            n++;
+        }
+    } catch (...) {
+        buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), false);
+        throw;
+    }
+    buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), false);
+    return n;
+}
+
 /**
  * @description: 在当前表中插入一条记录，不指定插入位置
  * @param {char*} buf 要插入的记录的数据
@@ -180,6 +241,14 @@ RmPageHandle RmFileHandle::fetch_page_handle(int page_no) const {
     return RmPageHandle(&file_hdr_, page);
 }
 
+/**
+ * @description: 使用完fetch_page_handle()得到的页面后unpin
+ * @param {RmPageHandle&} page_handle 未修改过的页面
+ */
+void RmFileHandle::unpin_page_handle(const RmPageHandle &page_handle) const {
+    buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), false);
+}
+
 /**
  * @description: 创建一个新的page handle
  * @return {RmPageHandle} 新的PageHandle
@@ -197,14 +266,11 @@ RmPageHandle RmFileHandle::create_new_page_handle() {
     {
         //更新page_handle
         page_handle = RmPageHandle(&file_hdr_, new_page);
-        page_handle.page_hdr->next_free_page_no = RM_NO_PAGE;
         page_handle.page_hdr->num_records = 0;
 
-        //更新file_hdr_
-        if(file_hdr_.num_pages == 0)
-        {
-            file_hdr_.first_free_page_no = page_id.page_no;
-        }
+        //更新file_hdr_：新页面是空的，放到空闲页链表的头部，之后的插入先填满它
+        page_handle.page_hdr->next_free_page_no = file_hdr_.first_free_page_no;
+        file_hdr_.first_free_page_no = page_id.page_no;
         file_hdr_.num_pages++;
     }
 
@@ -242,6 +308,6 @@ void RmFileHandle::release_page_handle(RmPageHandle&page_handle) {
     // 2. file_hdr_.first_free_page_no
 
     page_handle.page_hdr->next_free_page_no = file_hdr_.first_free_page_no;
-    file_hdr_.first_free_page_no = page_handle.page_hdr->next_free_page_no;
+    file_hdr_.first_free_page_no = page_handle.page->get_page_id().page_no;
     
 }
\ No newline at end of file
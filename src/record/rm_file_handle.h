@@ -73,6 +73,11 @@ class RmFileHandle {
 
     std::unique_ptr<RmRecord> get_record(const Rid &rid, Context *context) const;
 
+    std::vector<std::unique_ptr<RmRecord>> get_records(int page_no, const std::vector<int> &slot_nos,
+                                                       Context *context) const;
+
+    int get_page_records(int page_no, int *slot_no, int max_n, char *buf, Context *context) const;
+
     Rid insert_record(char *buf, Context *context);
 
     void insert_record(const Rid &rid, char *buf);
@@ -85,6 +90,8 @@ class RmFileHandle {
 
     RmPageHandle fetch_page_handle(int page_no) const;
 
+    void unpin_page_handle(const RmPageHandle &page_handle) const;
+
    private:
     RmPageHandle create_page_handle();
 
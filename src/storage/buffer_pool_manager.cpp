@@ -221,7 +221,10 @@ bool BufferPoolManager::unpin_page(PageId page_id, bool is_dirty) {
         }
 
         // 3 根据参数is_dirty，更改P的is_dirty_
-        pages_[frame_id].is_dirty_ = is_dirty;
+        // 注意只能置位不能清除：页面可能已被其他使用者修改过，清除脏标记会导致淘汰时丢失修改
+        if (is_dirty) {
+            pages_[frame_id].is_dirty_ = true;
+        }
         //std::cout << "框号" << frame_id <<"页号"<<page_id.page_no <<"pin"<<pin_count<< std::endl;
 
         return true;
@@ -381,6 +384,27 @@ void BufferPoolManager::flush_all_pages(int fd) {
  
 }
 
+/**
+ * @description: 丢弃buffer_pool中属于文件fd的所有页，不写回磁盘
+ * @param {int} fd 文件句柄，文件已经关闭或将被删除，之后打开的文件可能复用同一个fd
+ */
+void BufferPoolManager::drop_all_pages(int fd) {
+    std::scoped_lock lock{latch_};
+
+    for (size_t i = 0; i < pool_size_; i++) {
+        Page *page = &pages_[i];
+        if (page->get_page_id().fd == fd && page->get_page_id().page_no != INVALID_PAGE_ID) {
+            page_table_.erase(page->get_page_id());
+            replacer_->pin(static_cast<frame_id_t>(i));
+            page->reset_memory();
+            page->is_dirty_ = false;
+            page->pin_count_ = 0;
+            page->id_ = {.fd = 0, .page_no = INVALID_PAGE_ID};
+            free_list_.push_back(static_cast<frame_id_t>(i));
+        }
+    }
+}
+
 //make buffer_pool_manager_test CXXFLAGS="-g"
 //./bin/buffer_pool_manager_test
 //gdb ./bin/buffer_pool_manager_test
@@ -10,6 +10,9 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <atomic>
+#include <shared_mutex>
+
 #include "common/config.h"
 
 /**
@@ -71,6 +74,39 @@ class Page {
 
     inline void set_page_lsn(lsn_t page_lsn) { memcpy(get_data() + OFFSET_LSN, &page_lsn, sizeof(lsn_t)); }
 
+    /** 页面读写锁，目前用于B+树的latch crabbing
+     *  持有写锁的线程修改页面前调用mark_modified()，版本号为奇数表示页面正被修改；
+     *  释放写锁时页面被修改过才将版本号加回偶数，只加锁不修改（latch crabbing中的祖先结点）不改变版本号，
+     *  用于B+树的乐观读 */
+    inline void wlatch() {
+        rwlatch_.lock();
+        write_latched_ = true;
+    }
+
+    inline void wunlatch() {
+        if (version_.load(std::memory_order_relaxed) & 1) {
+            version_.fetch_add(1, std::memory_order_release);
+        }
+        write_latched_ = false;
+        rwlatch_.unlock();
+    }
+
+    /** 即将修改页面：第一次修改时将版本号加为奇数，写入的数据排在版本号之后，乐观读者之后验证版本号时一定能发现；
+     *  没有持有写锁的页面（还不能被其它线程访问的新结点、创建索引时批量构建的结点）不改变版本号 */
+    inline void mark_modified() {
+        uint64_t version = version_.load(std::memory_order_relaxed);
+        if (write_latched_ && (version & 1) == 0) {
+            version_.store(version + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+    }
+
+    inline void rlatch() { rwlatch_.lock_shared(); }
+
+    inline void runlatch() { rwlatch_.unlock_shared(); }
+
+    inline uint64_t get_version() const { return version_.load(std::memory_order_acquire); }
+
    private:
     void reset_memory() { memset(data_, OFFSET_PAGE_START, PAGE_SIZE); }  // 将data_的PAGE_SIZE个字节填充为0
 
@@ -87,4 +123,13 @@ class Page {
 
     /** The pin count of this page. */
     int pin_count_ = 0;
+
+    /** 页面读写锁 */
+    std::shared_mutex rwlatch_;
+
+    /** 页面是否被加了写锁，只由持有写锁的线程读写 */
+    bool write_latched_ = false;
+
+    /** 页面版本号，只由mark_modified()/wunlatch()修改 */
+    std::atomic<uint64_t> version_{0};
 };
\ No newline at end of file
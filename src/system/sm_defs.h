@@ -11,3 +11,8 @@ See the Mulan PSL v2 for more details. */
 
 #include "defs.h"
 #include <string>
+
+/* 索引的存储结构：B+树支持等值和范围查找，可扩展哈希只支持所有索引字段上的等值查找 */
+enum IndexType {
+    INDEX_BTREE, INDEX_HASH
+};
@@ -105,8 +105,12 @@ void SmManager::open_db(const std::string& db_name) {
             //打开表文件上的索引文件
             for(auto index: tab.indexes)
             {
-                ihs_.emplace(ix_manager_->get_index_name(tab.name, index.cols), 
-                ix_manager_->open_index(tab.name, index.cols));
+                std::string ix_name = ix_manager_->get_index_name(tab.name, index.cols);
+                if (index.type == INDEX_HASH) {
+                    hhs_.emplace(ix_name, ix_manager_->open_hash_index(tab.name, index.cols));
+                } else {
+                    ihs_.emplace(ix_name, ix_manager_->open_index(tab.name, index.cols));
+                }
             }
         }
     }
@@ -150,6 +154,12 @@ void SmManager::close_db() {
     }
     ihs_.clear();
 
+    for(auto& entry: hhs_)
+    {
+        ix_manager_->close_hash_index(entry.second.get());
+    }
+    hhs_.clear();
+
     if (chdir("..") < 0) 
     {
         throw UnixError();
@@ -274,11 +284,16 @@ void SmManager::drop_table(const std::string& tab_name, Context* context) {
  * @param {string&} tab_name 表的名称
  * @param {vector<string>&} col_names 索引包含的字段名称
  * @param {Context*} context
+ * @param {bool} unique 是否为唯一索引，表中已有重复的key时创建失败
+ * @param {IndexType} type 索引的存储结构
  */
-void SmManager::create_index(const std::string& tab_name, const std::vector<std::string>& col_names, Context* context) {
+void SmManager::create_index(const std::string& tab_name, const std::vector<std::string>& col_names, Context* context,
+                             bool unique, IndexType type) {
 
     auto& tab_meta = db_.get_table(tab_name);
     IndexMeta index_meta = {tab_name};
+    index_meta.unique = unique;
+    index_meta.type = type;
     std::vector<ColMeta> &col_meta = index_meta.cols;
     for (auto& col : col_names) {
         auto it = tab_meta.get_col(col);
@@ -288,12 +303,81 @@ void SmManager::create_index(const std::string& tab_name, const std::vector<std:
     }
     if (context && !context->lock_mgr_->lock_exclusive_on_table(context->txn_, disk_manager_->get_fd2path(tab_name)))
         throw TransactionAbortException(context->txn_->get_transaction_id(), AbortReason::LOCK_ON_SHIRINKING);
-    ix_manager_->create_index(tab_name, col_meta);
+    std::string ix_name = ix_manager_->get_index_name(tab_name, col_meta);
+    if (type == INDEX_HASH) {
+        create_hash_index(index_meta, context);
+        tab_meta.indexes.push_back(index_meta);
+        flush_meta();
+        return;
+    }
+    ix_manager_->create_index(tab_name, col_meta, unique);
+    auto ih = ix_manager_->open_index(tab_name, col_meta);
+
+    // 表中已有记录时，扫描全表收集(key, rid)，排序后自底向上批量构建B+树，不再逐条insert_entry
+    IxBulkLoader loader(ih.get(), ix_name);
+    scan_index_keys(index_meta, [&](const char* key, const Rid& rid) { loader.add(key, rid); });
+    loader.finish();
+    if (unique && loader.has_duplicate()) {
+        ix_manager_->close_index(ih.get());
+        ix_manager_->destroy_index(tab_name, col_meta);
+        throw UniqueConstraintError(tab_name, col_names);
+    }
+
     tab_meta.indexes.push_back(index_meta);
-    ihs_[ix_manager_->get_index_name(tab_name, col_meta)] = ix_manager_->open_index(tab_name, col_meta);
+    ihs_[ix_name] = std::move(ih);
     flush_meta();
 }
 
+/**
+ * @description: 创建哈希索引，把表中已有的记录逐条插入；唯一索引遇到重复的key时删除索引文件并报错
+ * @param {IndexMeta&} index 索引元数据
+ * @param {Context*} context
+ */
+void SmManager::create_hash_index(const IndexMeta& index, Context* context) {
+    ix_manager_->create_hash_index(index.tab_name, index.cols, index.unique);
+    auto ih = ix_manager_->open_hash_index(index.tab_name, index.cols);
+    bool duplicate = false;
+    scan_index_keys(index, [&](const char* key, const Rid& rid) {
+        duplicate = duplicate || ih->insert_entry(key, rid, context ? context->txn_ : nullptr) == IX_NO_PAGE;
+    });
+    if (duplicate) {
+        ix_manager_->close_hash_index(ih.get());
+        ix_manager_->destroy_index(index.tab_name, index.cols);
+        std::vector<std::string> col_names;
+        for (auto& col : index.cols) {
+            col_names.push_back(col.name);
+        }
+        throw UniqueConstraintError(index.tab_name, col_names);
+    }
+    hhs_[ix_manager_->get_index_name(index.tab_name, index.cols)] = std::move(ih);
+}
+
+/**
+ * @description: 扫描索引所在的表，对每条记录拼出索引的key，按记录在表中的顺序交给add
+ * @param {IndexMeta&} index 索引元数据
+ * @param {function} add 接收(key, rid)
+ */
+void SmManager::scan_index_keys(const IndexMeta& index, const std::function<void(const char*, const Rid&)>& add) {
+    auto fh = fhs_.at(index.tab_name).get();
+    RmFileHdr file_hdr = fh->get_file_hdr();
+    std::vector<char> key(index.col_tot_len);
+    for (int page_no = RM_FIRST_RECORD_PAGE; page_no < file_hdr.num_pages; page_no++) {
+        RmPageHandle page_handle = fh->fetch_page_handle(page_no);
+        for (int slot_no = Bitmap::first_bit(true, page_handle.bitmap, file_hdr.num_records_per_page);
+             slot_no < file_hdr.num_records_per_page;
+             slot_no = Bitmap::next_bit(true, page_handle.bitmap, file_hdr.num_records_per_page, slot_no)) {
+            char *record = page_handle.get_slot(slot_no);
+            int offset = 0;
+            for (auto& col : index.cols) {
+                memcpy(key.data() + offset, record + col.offset, col.len);
+                offset += col.len;
+            }
+            add(key.data(), Rid{page_no, slot_no});
+        }
+        buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), false);
+    }
+}
+
 /**
  * @description: 删除索引
  * @param {string&} tab_name 表名称
@@ -304,18 +388,24 @@ void SmManager::drop_index(const std::string& tab_name, const std::vector<std::s
     //获得索引文件的名字
     std::string ix_index_name = ix_manager_->get_index_name(tab_name, col_names);
 
+    //获取表元数据
+    TabMeta &tab = db_.get_table(tab_name);
+    auto index_meta = tab.get_index_meta(col_names);
+
     //将索引文件关闭
-    ix_manager_->close_index(ihs_[ix_index_name].get());
+    if (index_meta->type == INDEX_HASH) {
+        ix_manager_->close_hash_index(hhs_.at(ix_index_name).get());
+        hhs_.erase(ix_index_name);
+    } else {
+        ix_manager_->close_index(ihs_.at(ix_index_name).get());
+        ihs_.erase(ix_index_name);
+    }
 
     //将索引文件删除
     ix_manager_->destroy_index(tab_name, col_names);
 
-    //获取表元数据
-    TabMeta &tab = db_.get_table(tab_name);
     //更新tab的indexes
-    tab.indexes.erase(tab.get_index_meta(col_names));
-    //更新ihs_
-    ihs_.erase(ix_index_name);
+    tab.indexes.erase(index_meta);
     flush_meta();
 }
 
@@ -10,6 +10,8 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <functional>
+
 #include "index/ix.h"
 #include "record/rm_file_handle.h"
 #include "sm_defs.h"
@@ -30,6 +32,7 @@ class SmManager {
     DbMeta db_;             // 当前打开的数据库的元数据
     std::unordered_map<std::string, std::unique_ptr<RmFileHandle>> fhs_;    // file name -> record file handle, 当前数据库中每张表的数据文件
     std::unordered_map<std::string, std::unique_ptr<IxIndexHandle>> ihs_;   // file name -> index file handle, 当前数据库中每个索引的文件
+    std::unordered_map<std::string, std::unique_ptr<IxHashIndexHandle>> hhs_;  // file name -> hash index handle, 当前数据库中每个哈希索引的文件
    private:
     DiskManager* disk_manager_;
     BufferPoolManager* buffer_pool_manager_;
@@ -72,9 +75,24 @@ class SmManager {
 
     void drop_table(const std::string& tab_name, Context* context);
 
-    void create_index(const std::string& tab_name, const std::vector<std::string>& col_names, Context* context);
+    void create_index(const std::string& tab_name, const std::vector<std::string>& col_names, Context* context,
+                      bool unique = false, IndexType type = INDEX_BTREE);
 
     void drop_index(const std::string& tab_name, const std::vector<std::string>& col_names, Context* context);
     
     void drop_index(const std::string& tab_name, const std::vector<ColMeta>& col_names, Context* context);
+
+    /** 索引的点操作接口，执行器维护索引时不需要区分B+树和哈希索引 */
+    IxIndex* get_index(const IndexMeta& index) {
+        std::string ix_name = ix_manager_->get_index_name(index.tab_name, index.cols);
+        if (index.type == INDEX_HASH) {
+            return hhs_.at(ix_name).get();
+        }
+        return ihs_.at(ix_name).get();
+    }
+
+   private:
+    void create_hash_index(const IndexMeta& index, Context* context);
+
+    void scan_index_keys(const IndexMeta& index, const std::function<void(const char*, const Rid&)>& add);
 };
\ No newline at end of file
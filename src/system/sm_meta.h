@@ -45,9 +45,19 @@ struct IndexMeta {
     int col_tot_len;                // 索引字段长度总和
     int col_num;                    // 索引字段数量
     std::vector<ColMeta> cols;      // 索引包含的字段
+    bool unique = false;            // 是否为唯一索引（UNIQUE/PRIMARY KEY）
+    IndexType type = INDEX_BTREE;   // 索引的存储结构
+
+    std::vector<std::string> col_names() const {
+        std::vector<std::string> names;
+        for (auto &col : cols) {
+            names.push_back(col.name);
+        }
+        return names;
+    }
 
     friend std::ostream &operator<<(std::ostream &os, const IndexMeta &index) {
-        os << index.tab_name << " " << index.col_tot_len << " " << index.col_num;
+        os << index.tab_name << " " << index.col_tot_len << " " << index.col_num << " " << index.unique << " " << index.type;
         for(auto& col: index.cols) {
             os << "\n" << col;
         }
@@ -55,7 +65,7 @@ struct IndexMeta {
     }
 
     friend std::istream &operator>>(std::istream &is, IndexMeta &index) {
-        is >> index.tab_name >> index.col_tot_len >> index.col_num;
+        is >> index.tab_name >> index.col_tot_len >> index.col_num >> index.unique >> index.type;
         for(int i = 0; i < index.col_num; ++i) {
             ColMeta col;
             is >> col;
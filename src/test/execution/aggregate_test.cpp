@@ -0,0 +1,141 @@
+#include <map>
+#include <random>  // for std::default_random_engine
+
+#include "gtest/gtest.h"
+
+#include "execution/executor_aggregate.h"
+
+static const std::string TAB_NAME = "t";
+
+// 从内存中的元组读取的输入算子，字段为int g, int v, float f, char(8) s
+class VectorExecutor : public AbstractExecutor {
+   private:
+    std::vector<ColMeta> cols_;
+    size_t len_;
+    std::vector<std::vector<char>> tuples_;
+    size_t pos_ = 0;
+
+   public:
+    explicit VectorExecutor(std::vector<std::vector<char>> tuples) : tuples_(std::move(tuples)) {
+        int offset = 0;
+        for (auto &[name, type, len] : std::vector<std::tuple<std::string, ColType, int>>{
+                 {"g", TYPE_INT, 4}, {"v", TYPE_INT, 4}, {"f", TYPE_FLOAT, 4}, {"s", TYPE_STRING, 8}}) {
+            cols_.push_back({.tab_name = TAB_NAME, .name = name, .type = type, .len = len, .offset = offset,
+                             .index = false});
+            offset += len;
+        }
+        len_ = offset;
+    }
+
+    size_t tupleLen() const override { return len_; }
+
+    const std::vector<ColMeta> &cols() const override { return cols_; }
+
+    void beginTuple() override { pos_ = 0; }
+
+    void nextTuple() override { pos_++; }
+
+    bool is_end() const override { return pos_ == tuples_.size(); }
+
+    std::unique_ptr<RmRecord> Next() override {
+        auto record = std::make_unique<RmRecord>(len_);
+        memcpy(record->data, tuples_[pos_].data(), len_);
+        return record;
+    }
+
+    Rid &rid() override { return _abstract_rid; }
+};
+
+static std::vector<std::vector<char>> make_tuples(size_t n, int num_groups) {
+    std::default_random_engine rng(0);
+    std::vector<std::vector<char>> tuples;
+    for (size_t i = 0; i < n; i++) {
+        std::vector<char> tuple(20, 0);
+        *(int *)(tuple.data()) = static_cast<int>(rng() % num_groups);
+        *(int *)(tuple.data() + 4) = static_cast<int>(rng() % 1000) - 500;
+        *(float *)(tuple.data() + 8) = static_cast<float>(rng() % 100) / 4;
+        std::string str = "s" + std::to_string(rng() % 50);
+        memcpy(tuple.data() + 12, str.c_str(), str.size());
+        tuples.push_back(std::move(tuple));
+    }
+    return tuples;
+}
+
+static TabCol agg_col(AggType agg_type, const std::string &col_name) {
+    return {.tab_name = col_name == "*" ? "" : TAB_NAME, .col_name = col_name, .agg_type = agg_type};
+}
+
+/* 每个分组的参照结果 */
+struct Expected {
+    int count = 0;
+    int sum = 0;
+    double sum_f = 0;
+    int min = INT_MAX;
+    std::string max_s;
+};
+
+/**
+ * @brief 按g分组计算COUNT(*)、SUM(v)、MIN(v)、AVG(f)、MAX(s)，与逐个元组计算的参照结果比较；
+ * 内存预算很小时大部分分组写出到分区，多次再分区后结果仍然相同
+ */
+TEST(AggregateTest, MatchesReference) {
+    auto tuples = make_tuples(20000, 3000);
+    std::map<int, Expected> expected;
+    for (auto &tuple : tuples) {
+        auto &exp = expected[*(int *)tuple.data()];
+        int v = *(int *)(tuple.data() + 4);
+        exp.count++;
+        exp.sum += v;
+        exp.sum_f += *(float *)(tuple.data() + 8);
+        exp.min = std::min(exp.min, v);
+        exp.max_s = std::max(exp.max_s, std::string(tuple.data() + 12));
+    }
+    std::vector<TabCol> group_cols = {{.tab_name = TAB_NAME, .col_name = "g"}};
+    std::vector<TabCol> agg_cols = {agg_col(AGG_COUNT, "*"), agg_col(AGG_SUM, "v"), agg_col(AGG_MIN, "v"),
+                                    agg_col(AGG_AVG, "f"), agg_col(AGG_MAX, "s")};
+    for (size_t mem_budget : {AGG_MEM_BUDGET, static_cast<size_t>(1024)}) {
+        AggregateExecutor agg(std::make_unique<VectorExecutor>(tuples), group_cols, agg_cols, mem_budget);
+        auto &cols = agg.cols();
+        ASSERT_EQ(cols.size(), 6);
+        EXPECT_EQ(cols[1].name, "COUNT(*)");
+        EXPECT_EQ(cols[4].type, TYPE_FLOAT);
+        std::map<int, bool> seen;
+        TupleBatch batch;
+        for (agg.beginTuple(); agg.next_batch(&batch);) {
+            for (size_t i = 0; i < batch.size(); i++) {
+                const char *out = batch.get(i);
+                int g = *(int *)(out + cols[0].offset);
+                ASSERT_TRUE(expected.count(g));
+                ASSERT_FALSE(seen[g]);
+                seen[g] = true;
+                auto &exp = expected[g];
+                EXPECT_EQ(*(int *)(out + cols[1].offset), exp.count);
+                EXPECT_EQ(*(int *)(out + cols[2].offset), exp.sum);
+                EXPECT_EQ(*(int *)(out + cols[3].offset), exp.min);
+                EXPECT_FLOAT_EQ(*(float *)(out + cols[4].offset), static_cast<float>(exp.sum_f / exp.count));
+                EXPECT_EQ(std::string(out + cols[5].offset, strnlen(out + cols[5].offset, 8)), exp.max_s);
+            }
+        }
+        EXPECT_EQ(seen.size(), expected.size());
+    }
+}
+
+/**
+ * @brief 没有分组字段时输入为空也输出一个元组，COUNT为0
+ */
+TEST(AggregateTest, EmptyInputWithoutGroupBy) {
+    AggregateExecutor agg(std::make_unique<VectorExecutor>(std::vector<std::vector<char>>()), {},
+                          {agg_col(AGG_COUNT, "*"), agg_col(AGG_SUM, "v")});
+    agg.beginTuple();
+    ASSERT_FALSE(agg.is_end());
+    auto record = agg.Next();
+    EXPECT_EQ(*(int *)record->data, 0);
+    EXPECT_EQ(*(int *)(record->data + 4), 0);
+    agg.nextTuple();
+    EXPECT_TRUE(agg.is_end());
+
+    AggregateExecutor grouped(std::make_unique<VectorExecutor>(std::vector<std::vector<char>>()),
+                              {{.tab_name = TAB_NAME, .col_name = "g"}}, {agg_col(AGG_COUNT, "*")});
+    grouped.beginTuple();
+    EXPECT_TRUE(grouped.is_end());
+}
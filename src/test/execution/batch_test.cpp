@@ -0,0 +1,183 @@
+#include "gtest/gtest.h"
+
+#include "execution/executor_projection.h"
+#include "execution/executor_seq_scan.h"
+#include "vector_executor.h"
+
+const std::string TEST_DB_NAME = "BatchTest_db";  // 以数据库名作为根目录
+const std::string TAB_NAME = "t";
+
+/**
+ * 表t(a int, f float, s char(8))，a是插入的顺序，每3个元组删除一个，页面中留下空槽；
+ * 每个测试点在目录TEST_DB_NAME下重新建库
+ */
+class BatchTest : public ::testing::Test {
+   public:
+    static constexpr int NUM_TUPLES = 5000;
+
+    std::unique_ptr<DiskManager> disk_manager_;
+    std::unique_ptr<BufferPoolManager> buffer_pool_manager_;
+    std::unique_ptr<RmManager> rm_manager_;
+    std::unique_ptr<IxManager> ix_manager_;
+    std::unique_ptr<SmManager> sm_manager_;
+    std::vector<Row> rows_;  // 表中剩下的元组，按插入的顺序
+
+   public:
+    void SetUp() override {
+        ::testing::Test::SetUp();
+        disk_manager_ = std::make_unique<DiskManager>();
+        buffer_pool_manager_ = std::make_unique<BufferPoolManager>(200, disk_manager_.get());
+        rm_manager_ = std::make_unique<RmManager>(disk_manager_.get(), buffer_pool_manager_.get());
+        ix_manager_ = std::make_unique<IxManager>(disk_manager_.get(), buffer_pool_manager_.get());
+        sm_manager_ = std::make_unique<SmManager>(disk_manager_.get(), buffer_pool_manager_.get(), rm_manager_.get(),
+                                                  ix_manager_.get());
+
+        if (sm_manager_->is_dir(TEST_DB_NAME)) {
+            sm_manager_->drop_db(TEST_DB_NAME);
+        }
+        sm_manager_->create_db(TEST_DB_NAME);
+        sm_manager_->open_db(TEST_DB_NAME);
+        sm_manager_->create_table(TAB_NAME, {{"a", TYPE_INT, 4}, {"f", TYPE_FLOAT, 4}, {"s", TYPE_STRING, 8}},
+                                  nullptr);
+
+        auto fh = sm_manager_->fhs_.at(TAB_NAME).get();
+        for (int i = 0; i < NUM_TUPLES; i++) {
+            Row row(4, 0);
+            row[0] = i;
+            float f = static_cast<float>(i % 100) / 2;
+            memcpy(&row[1], &f, sizeof(f));
+            std::string s = "s" + std::to_string(i % 7);
+            memcpy(&row[2], s.c_str(), s.size());
+            Rid rid = fh->insert_record(reinterpret_cast<char *>(row.data()), nullptr);
+            if (i % 3 == 1) {
+                fh->delete_record(rid, nullptr);
+            } else {
+                rows_.push_back(row);
+            }
+        }
+    }
+
+    void TearDown() override {
+        sm_manager_->close_db();
+        sm_manager_->drop_db(TEST_DB_NAME);
+    }
+
+    static Condition val_cond(const std::string &col_name, CompOp op, Value val, int len) {
+        Condition cond;
+        cond.lhs_col = {TAB_NAME, col_name};
+        cond.op = op;
+        cond.is_rhs_val = true;
+        cond.rhs_val = std::move(val);
+        cond.rhs_val.init_raw(len);
+        return cond;
+    }
+
+    static Condition int_cond(const std::string &col_name, CompOp op, int x) {
+        Value val;
+        val.set_int(x);
+        return val_cond(col_name, op, val, 4);
+    }
+
+    std::unique_ptr<SeqScanExecutor> scan(std::vector<Condition> conds) {
+        return std::make_unique<SeqScanExecutor>(sm_manager_.get(), TAB_NAME, std::move(conds), nullptr);
+    }
+
+    /** 表中满足pred的元组，按插入的顺序 */
+    template <typename Pred>
+    std::vector<Row> reference(Pred pred) const {
+        std::vector<Row> result;
+        for (auto &row : rows_) {
+            if (pred(row)) {
+                result.push_back(row);
+            }
+        }
+        return result;
+    }
+};
+
+/**
+ * @brief 选择向量：过滤只压缩选择向量，get(i)返回第i个有效元组；是否已满按存放的元组数判断；reset后重新开始
+ */
+TEST(TupleBatchTest, SelectionVector) {
+    TupleBatch batch;
+    batch.reset(sizeof(int), 8);
+    for (int i = 0; i < 8; i++) {
+        batch.append(reinterpret_cast<const char *>(&i));
+    }
+    EXPECT_TRUE(batch.full());
+    auto &sel = batch.sel();
+    sel.erase(std::remove_if(sel.begin(), sel.end(), [](uint32_t row_no) { return row_no % 3 != 0; }), sel.end());
+    ASSERT_EQ(batch.size(), 3);
+    EXPECT_TRUE(batch.full());
+    EXPECT_EQ(batch.num_rows(), 8);
+    for (size_t i = 0; i < batch.size(); i++) {
+        EXPECT_EQ(*reinterpret_cast<const int *>(batch.get(i)), static_cast<int>(3 * i));
+    }
+
+    batch.reset(2 * sizeof(int), 4);
+    EXPECT_TRUE(batch.empty());
+    EXPECT_EQ(batch.remaining(), 4);
+    int *rows = reinterpret_cast<int *>(batch.row(batch.num_rows()));
+    for (int i = 0; i < 6; i++) {
+        rows[i] = 100 + i;
+    }
+    batch.extend(3);
+    EXPECT_EQ(batch.size(), 3);
+    EXPECT_EQ(batch.remaining(), 1);
+    EXPECT_EQ(reinterpret_cast<const int *>(batch.get(2))[1], 105);
+}
+
+/**
+ * @brief 按批扫描和逐个元组扫描的结果相同：没有条件、页面上判断的数值条件、批中判断的字符串条件，
+ * 以及只有最后几页有满足条件的元组时（前面的页面都被整批过滤掉）
+ */
+TEST_F(BatchTest, SeqScanMatchesTuplePath) {
+    Value half;
+    half.set_float(10.0f);
+    Value s3;
+    s3.set_str("s3");
+    std::vector<std::pair<std::vector<Condition>, std::vector<Row>>> cases = {
+        {{}, rows_},
+        {{int_cond("a", OP_GE, 100), val_cond("f", OP_LT, half, 4)},
+         reference([](const Row &row) {
+             float f;
+             memcpy(&f, &row[1], sizeof(f));
+             return row[0] >= 100 && f < 10.0f;
+         })},
+        {{val_cond("s", OP_NE, s3, 8), int_cond("a", OP_LT, 3000)},
+         reference([](const Row &row) { return strncmp(reinterpret_cast<const char *>(&row[2]), "s3", 8) != 0 &&
+                                                row[0] < 3000; })},
+        {{int_cond("a", OP_GE, NUM_TUPLES - 10)}, reference([](const Row &row) { return row[0] >= NUM_TUPLES - 10; })},
+        {{int_cond("a", OP_GT, NUM_TUPLES)}, {}}};
+    for (auto &[conds, expected] : cases) {
+        auto exec = scan(conds);
+        EXPECT_EQ(collect_batches(exec.get()), expected);
+        EXPECT_EQ(collect_tuples(exec.get()), expected);
+    }
+}
+
+/**
+ * @brief 投影按批读取扫描的结果时只投影选择向量中的元组；BatchReader跨越多批逐个读出的元组与逐个元组的结果相同
+ */
+TEST_F(BatchTest, ProjectionAndBatchReader) {
+    Value s3;
+    s3.set_str("s3");
+    ProjectionExecutor proj(scan({val_cond("s", OP_NE, s3, 8)}), {{TAB_NAME, "s"}, {TAB_NAME, "a"}});
+    std::vector<Row> expected;
+    for (auto &row : reference([](const Row &row) { return strncmp(reinterpret_cast<const char *>(&row[2]), "s3", 8); })) {
+        expected.push_back({row[2], row[3], row[0]});
+    }
+    ASSERT_GT(expected.size(), 2 * EXECUTION_BATCH_SIZE);
+    EXPECT_EQ(collect_batches(&proj), expected);
+    EXPECT_EQ(collect_tuples(&proj), expected);
+
+    // 重新开始读取时从头读起
+    for (int round = 0; round < 2; round++) {
+        std::vector<Row> read;
+        BatchReader reader;
+        for (reader.begin(&proj); !reader.is_end(); reader.next()) {
+            read.push_back(to_row(reader.get(), proj.tupleLen()));
+        }
+        EXPECT_EQ(read, expected);
+    }
+}
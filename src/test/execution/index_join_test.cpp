@@ -0,0 +1,149 @@
+#include <random>  // for std::default_random_engine
+
+#include "gtest/gtest.h"
+
+#include "execution/executor_index_nestedloop_join.h"
+#include "vector_executor.h"
+
+const std::string TEST_DB_NAME = "IndexJoinTest_db";  // 以数据库名作为根目录
+const std::string OUTER_TAB = "l";
+const std::string INNER_TAB = "r";
+
+/**
+ * 外层是内存中的元组l(a, b)，内层是表r(a, c)，a上有B+树索引，(a, c)上有哈希索引；
+ * 每个测试点在目录TEST_DB_NAME下重新建库
+ */
+class IndexJoinTest : public ::testing::Test {
+   public:
+    std::unique_ptr<DiskManager> disk_manager_;
+    std::unique_ptr<BufferPoolManager> buffer_pool_manager_;
+    std::unique_ptr<RmManager> rm_manager_;
+    std::unique_ptr<IxManager> ix_manager_;
+    std::unique_ptr<SmManager> sm_manager_;
+    std::vector<Row> inner_rows_;
+
+   public:
+    void SetUp() override {
+        ::testing::Test::SetUp();
+        disk_manager_ = std::make_unique<DiskManager>();
+        buffer_pool_manager_ = std::make_unique<BufferPoolManager>(200, disk_manager_.get());
+        rm_manager_ = std::make_unique<RmManager>(disk_manager_.get(), buffer_pool_manager_.get());
+        ix_manager_ = std::make_unique<IxManager>(disk_manager_.get(), buffer_pool_manager_.get());
+        sm_manager_ = std::make_unique<SmManager>(disk_manager_.get(), buffer_pool_manager_.get(), rm_manager_.get(),
+                                                  ix_manager_.get());
+
+        if (sm_manager_->is_dir(TEST_DB_NAME)) {
+            sm_manager_->drop_db(TEST_DB_NAME);
+        }
+        sm_manager_->create_db(TEST_DB_NAME);
+        sm_manager_->open_db(TEST_DB_NAME);
+        sm_manager_->create_table(INNER_TAB, {{"a", TYPE_INT, 4}, {"c", TYPE_INT, 4}}, nullptr);
+
+        // a在[0, 200)中随机取值，每个key平均有十几个元组，跨越多个叶子结点
+        std::default_random_engine rng(0);
+        auto fh = sm_manager_->fhs_.at(INNER_TAB).get();
+        for (int i = 0; i < 3000; i++) {
+            Row row = {static_cast<int>(rng() % 200), i % 50};
+            fh->insert_record(reinterpret_cast<char *>(row.data()), nullptr);
+            inner_rows_.push_back(row);
+        }
+        sm_manager_->create_index(INNER_TAB, {"a"}, nullptr);
+        sm_manager_->create_index(INNER_TAB, {"a", "c"}, nullptr, false, INDEX_HASH);
+    }
+
+    void TearDown() override {
+        sm_manager_->close_db();
+        sm_manager_->drop_db(TEST_DB_NAME);
+    }
+
+    /** 外层元组，a在[0, 250)中随机取值，有的key在内层中没有元组，b在[0, 50)中取值 */
+    static std::vector<Row> outer_rows(size_t n, unsigned seed) {
+        std::default_random_engine rng(seed);
+        std::vector<Row> rows;
+        for (size_t i = 0; i < n; i++) {
+            rows.push_back({static_cast<int>(rng() % 250), static_cast<int>(i % 50)});
+        }
+        return rows;
+    }
+
+    static std::unique_ptr<VectorExecutor> outer_input(std::vector<Row> rows) {
+        return std::make_unique<VectorExecutor>(OUTER_TAB, std::vector<std::string>{"a", "b"}, std::move(rows));
+    }
+
+    std::unique_ptr<IndexNestedLoopJoinExecutor> join(std::vector<Row> outer, std::vector<Condition> inner_conds,
+                                                      std::vector<std::string> index_col_names,
+                                                      std::vector<Condition> conds, bool inner_left) {
+        return std::make_unique<IndexNestedLoopJoinExecutor>(outer_input(std::move(outer)), sm_manager_.get(),
+                                                             INNER_TAB, std::move(inner_conds),
+                                                             std::move(index_col_names), std::move(conds),
+                                                             inner_left, nullptr);
+    }
+
+    /** 逐对比较的参照结果，inner_left时内层元组在前 */
+    template <typename Pred>
+    std::vector<Row> reference_join(const std::vector<Row> &outer, Pred pred, bool inner_left) {
+        std::vector<Row> result;
+        for (auto &l : outer) {
+            for (auto &r : inner_rows_) {
+                if (pred(l, r)) {
+                    result.push_back(inner_left ? Row{r[0], r[1], l[0], l[1]} : Row{l[0], l[1], r[0], r[1]});
+                }
+            }
+        }
+        return sorted(result);
+    }
+};
+
+/**
+ * @brief 用外层元组的a在B+树索引中查找内层元组，内层在左侧或右侧时结果都与参照结果相同；
+ * 内层表自身的条件对取出的内层元组判断
+ */
+TEST_F(IndexJoinTest, BTreeIndex) {
+    auto outer = outer_rows(800, 1);
+    for (bool inner_left : {false, true}) {
+        auto equi = join(outer, {}, {"a"}, {join_cond({OUTER_TAB, "a"}, OP_EQ, {INNER_TAB, "a"})}, inner_left);
+        auto expected = reference_join(outer, [](const Row &l, const Row &r) { return l[0] == r[0]; }, inner_left);
+        ASSERT_FALSE(expected.empty());
+        EXPECT_EQ(sorted(collect_batches(equi.get())), expected);
+        EXPECT_EQ(sorted(collect_tuples(equi.get())), expected);
+
+        Condition small_c;
+        small_c.lhs_col = {INNER_TAB, "c"};
+        small_c.op = OP_LT;
+        small_c.is_rhs_val = true;
+        small_c.rhs_val.set_int(10);
+        small_c.rhs_val.init_raw(4);
+        auto filtered = join(outer, {small_c}, {"a"}, {join_cond({INNER_TAB, "a"}, OP_EQ, {OUTER_TAB, "a"})}, inner_left);
+        EXPECT_EQ(sorted(collect_batches(filtered.get())),
+                  reference_join(outer, [](const Row &l, const Row &r) { return l[0] == r[0] && r[1] < 10; },
+                                 inner_left));
+    }
+}
+
+/**
+ * @brief 多个字段的哈希索引：每个索引字段各用一个等值条件拼key，其余的连接条件对连接后的元组判断
+ */
+TEST_F(IndexJoinTest, HashIndexWithResidual) {
+    auto outer = outer_rows(800, 2);
+    auto exec = join(outer, {}, {"a", "c"},
+                     {join_cond({OUTER_TAB, "b"}, OP_EQ, {INNER_TAB, "c"}),
+                      join_cond({OUTER_TAB, "a"}, OP_LE, {INNER_TAB, "c"}),
+                      join_cond({INNER_TAB, "a"}, OP_EQ, {OUTER_TAB, "a"})},
+                     false);
+    auto expected = reference_join(
+        outer, [](const Row &l, const Row &r) { return l[0] == r[0] && l[1] == r[1] && l[0] <= r[1]; }, false);
+    ASSERT_FALSE(expected.empty());
+    EXPECT_EQ(sorted(collect_batches(exec.get())), expected);
+    EXPECT_EQ(sorted(collect_tuples(exec.get())), expected);
+}
+
+/**
+ * @brief 外层为空或者外层的key在内层中都没有元组时没有结果
+ */
+TEST_F(IndexJoinTest, NoMatches) {
+    auto cond = join_cond({OUTER_TAB, "a"}, OP_EQ, {INNER_TAB, "a"});
+    auto empty = join({}, {}, {"a"}, {cond}, false);
+    EXPECT_TRUE(collect_batches(empty.get()).empty());
+    auto missing = join({{-1, 0}, {200, 1}, {1000, 2}}, {}, {"a"}, {cond}, false);
+    EXPECT_TRUE(collect_tuples(missing.get()).empty());
+}
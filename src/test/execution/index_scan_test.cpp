@@ -0,0 +1,277 @@
+#include <climits>
+#include <random>  // for std::default_random_engine
+
+#include "gtest/gtest.h"
+
+#include "execution/executor_bitmap_heap_scan.h"
+#include "execution/executor_index_scan.h"
+#include "vector_executor.h"
+
+const std::string TEST_DB_NAME = "IndexScanTest_db";  // 以数据库名作为根目录
+const std::string TAB_NAME = "t";
+
+/**
+ * 表t(a int, b int, c int)，(a, b)上有B+树索引，c上有唯一B+树索引；
+ * a、b在[-6, 6]中随机取值，少数取INT_MIN或INT_MAX，c是插入的顺序；每个测试点在目录TEST_DB_NAME下重新建库
+ */
+class IndexScanTest : public ::testing::Test {
+   public:
+    static constexpr int NUM_TUPLES = 4000;
+
+    std::unique_ptr<DiskManager> disk_manager_;
+    std::unique_ptr<BufferPoolManager> buffer_pool_manager_;
+    std::unique_ptr<RmManager> rm_manager_;
+    std::unique_ptr<IxManager> ix_manager_;
+    std::unique_ptr<SmManager> sm_manager_;
+    std::vector<Row> rows_;
+    std::default_random_engine rng_;
+
+   public:
+    void SetUp() override {
+        ::testing::Test::SetUp();
+        disk_manager_ = std::make_unique<DiskManager>();
+        buffer_pool_manager_ = std::make_unique<BufferPoolManager>(200, disk_manager_.get());
+        rm_manager_ = std::make_unique<RmManager>(disk_manager_.get(), buffer_pool_manager_.get());
+        ix_manager_ = std::make_unique<IxManager>(disk_manager_.get(), buffer_pool_manager_.get());
+        sm_manager_ = std::make_unique<SmManager>(disk_manager_.get(), buffer_pool_manager_.get(), rm_manager_.get(),
+                                                  ix_manager_.get());
+
+        if (sm_manager_->is_dir(TEST_DB_NAME)) {
+            sm_manager_->drop_db(TEST_DB_NAME);
+        }
+        sm_manager_->create_db(TEST_DB_NAME);
+        sm_manager_->open_db(TEST_DB_NAME);
+        sm_manager_->create_table(TAB_NAME, {{"a", TYPE_INT, 4}, {"b", TYPE_INT, 4}, {"c", TYPE_INT, 4}}, nullptr);
+
+        auto fh = sm_manager_->fhs_.at(TAB_NAME).get();
+        for (int i = 0; i < NUM_TUPLES; i++) {
+            Row row = {random_val(), random_val(), i};
+            fh->insert_record(reinterpret_cast<char *>(row.data()), nullptr);
+            rows_.push_back(row);
+        }
+        sm_manager_->create_index(TAB_NAME, {"a", "b"}, nullptr);
+        sm_manager_->create_index(TAB_NAME, {"c"}, nullptr, true);
+    }
+
+    void TearDown() override {
+        sm_manager_->close_db();
+        sm_manager_->drop_db(TEST_DB_NAME);
+    }
+
+    int random_val() {
+        switch (rng_() % 40) {
+            case 0:
+                return INT_MIN;
+            case 1:
+                return INT_MAX;
+            default:
+                return static_cast<int>(rng_() % 13) - 6;
+        }
+    }
+
+    static Condition int_cond(const std::string &col_name, CompOp op, int x) {
+        Condition cond;
+        cond.lhs_col = {TAB_NAME, col_name};
+        cond.op = op;
+        cond.is_rhs_val = true;
+        cond.rhs_val.set_int(x);
+        cond.rhs_val.init_raw(4);
+        return cond;
+    }
+
+    static int col_no(const std::string &col_name) { return col_name[0] - 'a'; }
+
+    static bool eval(const Row &row, const Condition &cond) {
+        int lhs = row[col_no(cond.lhs_col.col_name)];
+        int rhs = cond.rhs_val.int_val;
+        switch (cond.op) {
+            case OP_EQ:
+                return lhs == rhs;
+            case OP_NE:
+                return lhs != rhs;
+            case OP_LT:
+                return lhs < rhs;
+            case OP_GT:
+                return lhs > rhs;
+            case OP_LE:
+                return lhs <= rhs;
+            case OP_GE:
+                return lhs >= rhs;
+        }
+        return false;
+    }
+
+    /** 表中满足所有条件的元组 */
+    std::vector<Row> reference(const std::vector<Condition> &conds) const {
+        std::vector<Row> result;
+        for (auto &row : rows_) {
+            if (std::all_of(conds.begin(), conds.end(), [&](const Condition &cond) { return eval(row, cond); })) {
+                result.push_back(row);
+            }
+        }
+        return result;
+    }
+
+    /** 1到3个随机条件，取值集中在表中的值附近，包括两个极值 */
+    std::vector<Condition> random_conds() {
+        static const CompOp ops[] = {OP_EQ, OP_NE, OP_LT, OP_GT, OP_LE, OP_GE};
+        std::vector<Condition> conds;
+        int num_conds = static_cast<int>(rng_() % 3) + 1;
+        for (int i = 0; i < num_conds; i++) {
+            std::string col_name(1, static_cast<char>('a' + rng_() % 3));
+            int val = col_name == "c" ? static_cast<int>(rng_() % (NUM_TUPLES + 10)) - 5 : random_val();
+            conds.push_back(int_cond(col_name, ops[rng_() % 6], val));
+        }
+        return conds;
+    }
+
+    IndexMeta index_meta(const std::vector<std::string> &col_names) {
+        return *sm_manager_->db_.get_table(TAB_NAME).get_index_meta(col_names);
+    }
+};
+
+/**
+ * @brief 由条件推出的范围：等值前缀之后最多一个范围字段；矛盾的条件得到空范围；
+ * 不等于、跳过了前缀字段的条件和范围字段之后的条件留作剩余条件
+ */
+TEST_F(IndexScanTest, RangeDerivation) {
+    auto index = index_meta({"a", "b"});
+    struct Case {
+        std::vector<Condition> conds;
+        int num_matched_cols;
+        bool is_point;
+        bool is_empty;
+        size_t num_residual;
+    };
+    std::vector<Case> cases = {
+        {{int_cond("a", OP_EQ, 3), int_cond("b", OP_EQ, 4)}, 2, true, false, 0},
+        {{int_cond("a", OP_EQ, 3), int_cond("b", OP_GE, 2), int_cond("b", OP_LT, 5)}, 2, false, false, 0},
+        {{int_cond("a", OP_GE, 3), int_cond("a", OP_LE, 3), int_cond("b", OP_GT, 1)}, 2, false, false, 0},
+        {{int_cond("a", OP_GT, 1), int_cond("b", OP_EQ, 4)}, 1, false, false, 1},
+        {{int_cond("b", OP_EQ, 4)}, 0, false, false, 1},
+        {{int_cond("a", OP_NE, 3), int_cond("a", OP_LT, 0)}, 1, false, false, 1},
+        {{int_cond("a", OP_GT, 5), int_cond("a", OP_LT, 3)}, 1, false, true, 0},
+        {{int_cond("a", OP_GT, 3), int_cond("a", OP_LE, 3)}, 1, false, true, 0},
+        {{int_cond("a", OP_EQ, 3), int_cond("a", OP_EQ, 4)}, 1, false, true, 0},
+        {{int_cond("a", OP_EQ, 3), int_cond("b", OP_GT, 4), int_cond("b", OP_LT, 4)}, 2, false, true, 0},
+        {{int_cond("a", OP_EQ, 3), int_cond("b", OP_GT, 4), int_cond("b", OP_LT, 5)}, 2, false, false, 0},
+    };
+    for (size_t i = 0; i < cases.size(); i++) {
+        auto &c = cases[i];
+        IndexRange range(index, TAB_NAME, c.conds);
+        EXPECT_EQ(range.num_matched_cols(), c.num_matched_cols) << "case " << i;
+        EXPECT_EQ(range.is_point(), c.is_point) << "case " << i;
+        EXPECT_EQ(range.is_empty(), c.is_empty) << "case " << i;
+        EXPECT_EQ(range.residual_conds().size(), c.num_residual) << "case " << i;
+    }
+}
+
+/**
+ * @brief 随机的条件组合下，在(a, b)索引上的范围扫描和在c唯一索引上的扫描（等值时为点查询）
+ * 都与逐个元组判断的参照结果相同，并且按索引key的顺序输出；条件的值包括字段的最小值和最大值
+ */
+TEST_F(IndexScanTest, RandomConditions) {
+    for (int round = 0; round < 200; round++) {
+        auto conds = random_conds();
+        auto expected = reference(conds);
+        IndexScanExecutor by_ab(sm_manager_.get(), TAB_NAME, conds, {"a", "b"}, nullptr);
+        auto output = collect_batches(&by_ab);
+        EXPECT_TRUE(std::is_sorted(output.begin(), output.end(), [](const Row &x, const Row &y) {
+            return x[0] != y[0] ? x[0] < y[0] : x[1] < y[1];
+        })) << "round " << round;
+        EXPECT_EQ(sorted(output), sorted(expected)) << "round " << round;
+
+        IndexScanExecutor by_c(sm_manager_.get(), TAB_NAME, conds, {"c"}, nullptr);
+        EXPECT_EQ(collect_tuples(&by_c), expected) << "round " << round;
+    }
+}
+
+/**
+ * @brief 只读索引：输出的元组就是索引key，随机的索引字段条件下与参照结果的投影相同并按key的顺序输出；
+ * 唯一索引上的点查询直接输出查找的key
+ */
+TEST_F(IndexScanTest, CoveringScan) {
+    for (int round = 0; round < 100; round++) {
+        std::vector<Condition> conds;
+        for (auto &cond : random_conds()) {
+            if (cond.lhs_col.col_name != "c") {
+                conds.push_back(cond);
+            }
+        }
+        std::vector<Row> expected;
+        for (auto &row : reference(conds)) {
+            expected.push_back({row[0], row[1]});
+        }
+        expected = sorted(expected);
+        IndexScanExecutor scan(sm_manager_.get(), TAB_NAME, conds, {"a", "b"}, nullptr, true);
+        ASSERT_EQ(scan.tupleLen(), 8);
+        EXPECT_EQ(collect_batches(&scan), expected) << "round " << round;
+    }
+
+    IndexScanExecutor point(sm_manager_.get(), TAB_NAME, {int_cond("c", OP_EQ, 17)}, {"c"}, nullptr, true);
+    EXPECT_EQ(collect_tuples(&point), std::vector<Row>{{17}});
+    IndexScanExecutor missing(sm_manager_.get(), TAB_NAME, {int_cond("c", OP_EQ, NUM_TUPLES)}, {"c"}, nullptr, true);
+    EXPECT_TRUE(collect_tuples(&missing).empty());
+    IndexScanExecutor range(sm_manager_.get(), TAB_NAME, {int_cond("c", OP_GE, 10), int_cond("c", OP_LT, 13)}, {"c"},
+                            nullptr, true);
+    EXPECT_EQ(collect_tuples(&range), (std::vector<Row>{{10}, {11}, {12}}));
+}
+
+/**
+ * @brief 只读索引不访问表的数据文件：绕过索引直接改写表中的元组后，只读索引扫描仍输出索引中的key，
+ * 回表的索引扫描输出改写后的元组
+ */
+TEST_F(IndexScanTest, CoveringScanSkipsHeap) {
+    auto fh = sm_manager_->fhs_.at(TAB_NAME).get();
+    for (RmScan scan(fh); !scan.is_end(); scan.next()) {
+        auto rec = fh->get_record(scan.rid(), nullptr);
+        int *cols = reinterpret_cast<int *>(rec->data);
+        cols[0] = cols[1] = 1000;
+        fh->update_record(scan.rid(), rec->data, nullptr);
+    }
+    std::vector<Condition> conds = {int_cond("a", OP_EQ, 2)};
+    std::vector<Row> keys;
+    for (auto &row : reference(conds)) {
+        keys.push_back({row[0], row[1]});
+    }
+    ASSERT_FALSE(keys.empty());
+    IndexScanExecutor covering(sm_manager_.get(), TAB_NAME, conds, {"a", "b"}, nullptr, true);
+    EXPECT_EQ(collect_tuples(&covering), sorted(keys));
+
+    IndexScanExecutor heap(sm_manager_.get(), TAB_NAME, conds, {"a", "b"}, nullptr);
+    auto fetched = collect_tuples(&heap);
+    ASSERT_EQ(fetched.size(), keys.size());
+    for (auto &row : fetched) {
+        EXPECT_EQ(row[0], 1000);
+    }
+}
+
+/**
+ * @brief 位图扫描：对一个或两个索引的范围求交后按(page_no, slot_no)顺序读取，每个元组只输出一次，
+ * 结果与参照结果相同；有索引的范围为空时没有结果
+ */
+TEST_F(IndexScanTest, BitmapHeapScan) {
+    std::vector<std::vector<std::vector<std::string>>> index_sets = {{{"a", "b"}}, {{"c"}}, {{"a", "b"}, {"c"}}};
+    for (int round = 0; round < 100; round++) {
+        auto conds = random_conds();
+        auto expected = sorted(reference(conds));
+        for (auto &index_col_names : index_sets) {
+            BitmapHeapScanExecutor scan(sm_manager_.get(), TAB_NAME, conds, index_col_names, nullptr);
+            std::vector<Row> output;
+            std::vector<Rid> rids;
+            for (scan.beginTuple(); !scan.is_end(); scan.nextTuple()) {
+                output.push_back(to_row(scan.Next()->data, scan.tupleLen()));
+                rids.push_back(scan.rid());
+            }
+            EXPECT_TRUE(std::is_sorted(rids.begin(), rids.end(), [](const Rid &x, const Rid &y) {
+                return x.page_no != y.page_no ? x.page_no < y.page_no : x.slot_no < y.slot_no;
+            })) << "round " << round;
+            EXPECT_TRUE(std::adjacent_find(rids.begin(), rids.end()) == rids.end()) << "round " << round;
+            EXPECT_EQ(sorted(output), expected) << "round " << round;
+        }
+    }
+
+    std::vector<Condition> contradictory = {int_cond("a", OP_GT, 3), int_cond("a", OP_LE, 3), int_cond("c", OP_GE, 0)};
+    BitmapHeapScanExecutor empty(sm_manager_.get(), TAB_NAME, contradictory, {{"a", "b"}, {"c"}}, nullptr);
+    EXPECT_TRUE(collect_tuples(&empty).empty());
+}
@@ -0,0 +1,240 @@
+#include <random>  // for std::default_random_engine
+
+#include "gtest/gtest.h"
+
+#define private public
+#include "execution/executor_hash_join.h"
+#include "execution/executor_merge_join.h"
+#include "execution/executor_nestedloop_join.h"
+#undef private  // 检查哈希连接是否分区写出、块嵌套循环连接每块的大小
+
+#include "vector_executor.h"
+
+static const std::string LEFT_TAB = "l";
+static const std::string RIGHT_TAB = "r";
+
+// 左表l(a, b)、右表r(a, c)，a在[0, num_keys)中随机取值，b、c是元组的编号
+static std::vector<Row> make_rows(size_t n, int num_keys, unsigned seed) {
+    std::default_random_engine rng(seed);
+    std::vector<Row> rows;
+    for (size_t i = 0; i < n; i++) {
+        rows.push_back({static_cast<int>(rng() % num_keys), static_cast<int>(i)});
+    }
+    return rows;
+}
+
+static std::unique_ptr<VectorExecutor> left_input(std::vector<Row> rows) {
+    return std::make_unique<VectorExecutor>(LEFT_TAB, std::vector<std::string>{"a", "b"}, std::move(rows));
+}
+
+static std::unique_ptr<VectorExecutor> right_input(std::vector<Row> rows) {
+    return std::make_unique<VectorExecutor>(RIGHT_TAB, std::vector<std::string>{"a", "c"}, std::move(rows));
+}
+
+/** 逐对比较的参照结果：l.a = r.a，pred为其余条件 */
+template <typename Pred>
+static std::vector<Row> reference_join(const std::vector<Row> &left, const std::vector<Row> &right, Pred pred) {
+    std::vector<Row> result;
+    for (auto &l : left) {
+        for (auto &r : right) {
+            if (pred(l, r)) {
+                result.push_back({l[0], l[1], r[0], r[1]});
+            }
+        }
+    }
+    return sorted(result);
+}
+
+static bool equal_keys(const Row &l, const Row &r) { return l[0] == r[0]; }
+
+/** 按key升序排列，作为归并连接的输入 */
+static std::vector<Row> sorted_by_key(std::vector<Row> rows) {
+    std::stable_sort(rows.begin(), rows.end(), [](const Row &l, const Row &r) { return l[0] < r[0]; });
+    return rows;
+}
+
+/** 哈希连接建表侧每个元组占用的内存：key、元组、哈希值和两个槽 */
+static constexpr size_t HASH_JOIN_ENTRY_MEM = 4 + 8 + sizeof(uint64_t) + 2 * sizeof(uint32_t);
+
+/**
+ * @brief 建表侧放得下时在内存中连接；预算只够四分之一时分区写出一次；预算很小时分区还要再分区。
+ * 两侧分别作为建表侧，按批和逐个元组读取的结果都与参照结果相同
+ */
+TEST(HashJoinTest, SpillAndRepartition) {
+    auto left = make_rows(3000, 1000, 1);
+    auto right = make_rows(4000, 1200, 2);
+    auto expected = reference_join(left, right, equal_keys);
+    ASSERT_FALSE(expected.empty());
+
+    struct Case {
+        size_t max_build_tuples;
+        bool spilled;
+        bool repartitioned;
+    };
+    for (bool build_left : {false, true}) {
+        size_t build_size = build_left ? left.size() : right.size();
+        for (auto c : {Case{build_size, false, false}, Case{build_size / 4, true, false}, Case{20, true, true}}) {
+            std::vector<Condition> conds = {join_cond({LEFT_TAB, "a"}, OP_EQ, {RIGHT_TAB, "a"})};
+            HashJoinExecutor join(left_input(left), right_input(right), conds, build_left,
+                                  c.max_build_tuples * HASH_JOIN_ENTRY_MEM);
+            ASSERT_EQ(join.max_build_tuples_, c.max_build_tuples);
+            EXPECT_EQ(sorted(collect_batches(&join)), expected);
+
+            join.beginTuple();
+            EXPECT_EQ(join.spilled_, c.spilled);
+            bool repartitioned = std::any_of(join.partitions_.begin(), join.partitions_.end(),
+                                             [](const auto &part) { return part.depth > 1; });
+            EXPECT_EQ(repartitioned, c.repartitioned);
+            EXPECT_EQ(sorted(collect_tuples(&join)), expected);
+        }
+    }
+}
+
+/**
+ * @brief 不能作为key的连接条件在连接后的元组上判断；条件中左右两侧的字段顺序不影响结果
+ */
+TEST(HashJoinTest, ResidualConditions) {
+    auto left = make_rows(2000, 300, 3);
+    auto right = make_rows(2000, 300, 4);
+    auto expected = reference_join(left, right, [](const Row &l, const Row &r) { return l[0] == r[0] && l[1] < r[1]; });
+    std::vector<Condition> conds = {join_cond({RIGHT_TAB, "a"}, OP_EQ, {LEFT_TAB, "a"}),
+                                    join_cond({LEFT_TAB, "b"}, OP_LT, {RIGHT_TAB, "c"})};
+    for (size_t max_build_tuples : {static_cast<size_t>(2000), static_cast<size_t>(100)}) {
+        HashJoinExecutor join(left_input(left), right_input(right), conds, false,
+                              max_build_tuples * HASH_JOIN_ENTRY_MEM);
+        EXPECT_EQ(sorted(collect_batches(&join)), expected);
+    }
+}
+
+/**
+ * @brief 建表侧大部分元组是同一个key，再分区也分不开：达到最大分区次数后直接建表，结果仍然正确
+ */
+TEST(HashJoinTest, SkewedKey) {
+    auto left = make_rows(500, 50, 5);
+    auto right = make_rows(3000, 50, 6);
+    for (size_t i = 0; i < right.size(); i += 2) {
+        right[i][0] = 7;
+    }
+    auto expected = reference_join(left, right, equal_keys);
+    HashJoinExecutor join(left_input(left), right_input(right),
+                          {join_cond({LEFT_TAB, "a"}, OP_EQ, {RIGHT_TAB, "a"})}, false, 100 * HASH_JOIN_ENTRY_MEM);
+    EXPECT_EQ(sorted(collect_batches(&join)), expected);
+}
+
+/**
+ * @brief 任意一侧为空时没有结果；建表侧为空时不读取探测侧
+ */
+TEST(HashJoinTest, EmptyInput) {
+    auto rows = make_rows(100, 10, 7);
+    HashJoinExecutor empty_probe(left_input({}), right_input(rows), {join_cond({LEFT_TAB, "a"}, OP_EQ, {RIGHT_TAB, "a"})});
+    EXPECT_TRUE(collect_batches(&empty_probe).empty());
+
+    auto left = left_input(rows);
+    auto *left_ptr = left.get();
+    HashJoinExecutor empty_build(std::move(left), right_input({}), {join_cond({LEFT_TAB, "a"}, OP_EQ, {RIGHT_TAB, "a"})});
+    EXPECT_TRUE(collect_batches(&empty_build).empty());
+    EXPECT_EQ(left_ptr->num_scans, 0);
+}
+
+/**
+ * @brief 每块最多容纳的外层元组数不同时，内层扫描次数等于外层的块数；非等值条件和笛卡尔积的结果与参照结果相同
+ */
+TEST(NestedLoopJoinTest, BlockScans) {
+    auto left = make_rows(400, 100, 8);
+    auto right = make_rows(150, 100, 9);
+    auto less = [](const Row &l, const Row &r) { return l[0] < r[0]; };
+    std::vector<std::pair<std::vector<Condition>, std::vector<Row>>> cases = {
+        {{join_cond({LEFT_TAB, "a"}, OP_LT, {RIGHT_TAB, "a"})}, reference_join(left, right, less)},
+        {{}, reference_join(left, right, [](const Row &, const Row &) { return true; })}};
+    for (auto &[conds, expected] : cases) {
+        for (size_t block_tuples : {static_cast<size_t>(1), static_cast<size_t>(64), static_cast<size_t>(400)}) {
+            auto inner = right_input(right);
+            auto *inner_ptr = inner.get();
+            NestedLoopJoinExecutor join(left_input(left), std::move(inner), conds, block_tuples * 8);
+            ASSERT_EQ(join.max_block_tuples_, block_tuples);
+            EXPECT_EQ(sorted(collect_batches(&join)), expected);
+            int num_blocks = static_cast<int>((left.size() + block_tuples - 1) / block_tuples);
+            EXPECT_EQ(inner_ptr->num_scans, num_blocks);
+            EXPECT_EQ(sorted(collect_tuples(&join)), expected);
+            EXPECT_EQ(inner_ptr->num_scans, 2 * num_blocks);
+        }
+    }
+}
+
+/**
+ * @brief 预算不够一个外层元组时每块仍有一个元组；任意一侧为空时没有结果，外层为空时不扫描内层
+ */
+TEST(NestedLoopJoinTest, TinyBudgetAndEmptyInput) {
+    auto rows = make_rows(50, 10, 10);
+    NestedLoopJoinExecutor tiny(left_input(rows), right_input(rows),
+                                {join_cond({LEFT_TAB, "a"}, OP_EQ, {RIGHT_TAB, "a"})}, 1);
+    EXPECT_EQ(tiny.max_block_tuples_, 1);
+    EXPECT_EQ(sorted(collect_batches(&tiny)), reference_join(rows, rows, equal_keys));
+
+    auto inner = right_input(rows);
+    auto *inner_ptr = inner.get();
+    NestedLoopJoinExecutor empty_outer(left_input({}), std::move(inner), {});
+    EXPECT_TRUE(collect_batches(&empty_outer).empty());
+    EXPECT_EQ(inner_ptr->num_scans, 0);
+
+    NestedLoopJoinExecutor empty_inner(left_input(rows), right_input({}), {});
+    EXPECT_TRUE(collect_tuples(&empty_inner).empty());
+}
+
+/**
+ * @brief 两侧都有key相同的一段元组，有的段比一批元组还长，有的key只在一侧出现，还有负数key；
+ * 结果与参照结果相同，并且按key升序输出
+ */
+TEST(MergeJoinTest, DuplicateRuns) {
+    auto left = make_rows(3000, 40, 11);
+    auto right = make_rows(5000, 60, 12);
+    for (size_t i = 0; i < right.size(); i += 2) {
+        right[i][0] = 30;  // 右侧key为30的一段超过EXECUTION_BATCH_SIZE
+    }
+    for (size_t i = 0; i < left.size(); i += 5) {
+        left[i][0] = -left[i][0];
+    }
+    left.push_back({1000, -1});  // 两侧最大的key相同，右侧读完后左侧仍与最后一段连接
+    left.push_back({1000, -2});
+    right.push_back({1000, -1});
+    left = sorted_by_key(left);
+    right = sorted_by_key(right);
+    auto expected = reference_join(left, right, equal_keys);
+
+    MergeJoinExecutor join(left_input(left), right_input(right), {join_cond({LEFT_TAB, "a"}, OP_EQ, {RIGHT_TAB, "a"})});
+    auto batches = collect_batches(&join);
+    EXPECT_TRUE(std::is_sorted(batches.begin(), batches.end(), [](const Row &l, const Row &r) { return l[0] < r[0]; }));
+    EXPECT_EQ(sorted(batches), expected);
+    EXPECT_EQ(sorted(collect_tuples(&join)), expected);
+}
+
+/**
+ * @brief 其余的连接条件在段中逐个判断；条件中左右两侧的字段顺序不影响结果
+ */
+TEST(MergeJoinTest, ResidualConditions) {
+    auto left = sorted_by_key(make_rows(2000, 100, 13));
+    auto right = sorted_by_key(make_rows(2000, 100, 14));
+    auto expected = reference_join(left, right, [](const Row &l, const Row &r) { return l[0] == r[0] && l[1] > r[1]; });
+    MergeJoinExecutor join(left_input(left), right_input(right),
+                           {join_cond({RIGHT_TAB, "a"}, OP_EQ, {LEFT_TAB, "a"}),
+                            join_cond({RIGHT_TAB, "c"}, OP_LT, {LEFT_TAB, "b"})});
+    EXPECT_EQ(sorted(collect_batches(&join)), expected);
+}
+
+/**
+ * @brief 两侧key没有交集或者任意一侧为空时没有结果
+ */
+TEST(MergeJoinTest, NoMatches) {
+    std::vector<Row> evens, odds;
+    for (int i = 0; i < 200; i++) {
+        evens.push_back({2 * i, i});
+        odds.push_back({2 * i + 1, i});
+    }
+    auto cond = join_cond({LEFT_TAB, "a"}, OP_EQ, {RIGHT_TAB, "a"});
+    MergeJoinExecutor disjoint(left_input(evens), right_input(odds), {cond});
+    EXPECT_TRUE(collect_batches(&disjoint).empty());
+    MergeJoinExecutor empty_left(left_input({}), right_input(odds), {cond});
+    EXPECT_TRUE(collect_tuples(&empty_left).empty());
+    MergeJoinExecutor empty_right(left_input(evens), right_input({}), {cond});
+    EXPECT_TRUE(collect_batches(&empty_right).empty());
+}
@@ -0,0 +1,279 @@
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <random>  // for std::default_random_engine
+
+#include "gtest/gtest.h"
+
+#include "execution/execution_conds.h"
+#include "execution/execution_page_filter.h"
+#include "index/ix_compare.h"
+#include "record/rm.h"
+
+static const std::string TAB_NAME = "t";
+
+// 测试表的字段：int a, float b, char(12) c, int d
+static std::vector<ColMeta> make_cols() {
+    std::vector<ColMeta> cols;
+    int offset = 0;
+    for (auto &[name, type, len] : std::vector<std::tuple<std::string, ColType, int>>{
+             {"a", TYPE_INT, 4}, {"b", TYPE_FLOAT, 4}, {"c", TYPE_STRING, 12}, {"d", TYPE_INT, 4}}) {
+        ColMeta col;
+        col.tab_name = TAB_NAME;
+        col.name = name;
+        col.type = type;
+        col.len = len;
+        col.offset = offset;
+        col.index = false;
+        cols.push_back(col);
+        offset += len;
+    }
+    return cols;
+}
+
+static void fill_tuple(const std::vector<ColMeta> &cols, std::default_random_engine &rng, char *tuple) {
+    *(int *)(tuple + cols[0].offset) = static_cast<int>(rng() % 100);
+    *(float *)(tuple + cols[1].offset) = static_cast<float>(rng() % 100) / 4;
+    memset(tuple + cols[2].offset, 0, cols[2].len);
+    std::string str = std::string(1, static_cast<char>('a' + rng() % 4)) + std::to_string(rng() % 10);
+    memcpy(tuple + cols[2].offset, str.c_str(), str.size());
+    *(int *)(tuple + cols[3].offset) = static_cast<int>(rng() % 100);
+}
+
+static Condition make_val_cond(const std::string &col_name, CompOp op, Value val, int len) {
+    Condition cond;
+    cond.lhs_col = {TAB_NAME, col_name};
+    cond.op = op;
+    cond.is_rhs_val = true;
+    cond.rhs_val = std::move(val);
+    cond.rhs_val.init_raw(len);
+    return cond;
+}
+
+static Condition make_col_cond(const std::string &lhs, CompOp op, const std::string &rhs) {
+    Condition cond;
+    cond.lhs_col = {TAB_NAME, lhs};
+    cond.op = op;
+    cond.is_rhs_val = false;
+    cond.rhs_col = {TAB_NAME, rhs};
+    return cond;
+}
+
+// 原来扫描算子中的条件判断：每个元组每个条件都按名字查找字段、按类型比较、再按运算符分支，作为正确性和性能的对照
+static bool interpreted_eval(const std::vector<ColMeta> &cols, const std::vector<Condition> &conds, const char *tuple) {
+    for (auto &cond : conds) {
+        auto lhs_col = ResolvedCond::find_col(cols, cond.lhs_col);
+        const char *rhs = cond.is_rhs_val ? cond.rhs_val.raw->data : tuple + ResolvedCond::find_col(cols, cond.rhs_col)->offset;
+        int result = ix_compare(tuple + lhs_col->offset, rhs, lhs_col->type, lhs_col->len);
+        bool ok;
+        if (cond.op == OP_EQ) {
+            ok = result == 0;
+        } else if (cond.op == OP_NE) {
+            ok = result != 0;
+        } else if (cond.op == OP_LT) {
+            ok = result < 0;
+        } else if (cond.op == OP_GT) {
+            ok = result > 0;
+        } else if (cond.op == OP_LE) {
+            ok = result <= 0;
+        } else {
+            ok = result >= 0;
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static Value int_val(int x) {
+    Value val;
+    val.set_int(x);
+    return val;
+}
+
+static Value float_val(float x) {
+    Value val;
+    val.set_float(x);
+    return val;
+}
+
+static Value str_val(const std::string &x) {
+    Value val;
+    val.set_str(x);
+    return val;
+}
+
+/**
+ * @brief 每种类型和运算符的条件，包括右边是本表字段的条件，编译后的判断结果与逐个解释的结果一致
+ */
+TEST(ScanPredicateTest, MatchesInterpretedEval) {
+    auto cols = make_cols();
+    int tuple_len = cols.back().offset + cols.back().len;
+    std::default_random_engine rng(0);
+    for (CompOp op : {OP_EQ, OP_NE, OP_LT, OP_GT, OP_LE, OP_GE}) {
+        std::vector<std::vector<Condition>> cond_lists = {
+            {make_val_cond("a", op, int_val(50), 4)},
+            {make_val_cond("b", op, float_val(12.5f), 4)},
+            {make_val_cond("c", op, str_val("b5"), 12)},
+            {make_col_cond("a", op, "d")},
+            {make_val_cond("a", op, int_val(30), 4), make_col_cond("d", op, "a"), make_val_cond("c", OP_NE, str_val("a1"), 12)},
+        };
+        for (auto &conds : cond_lists) {
+            auto resolved = ResolvedCond::resolve(cols, conds);
+            TupleBatch batch;
+            batch.reset(tuple_len, 500);
+            std::vector<uint32_t> expected;
+            for (uint32_t i = 0; i < 500; i++) {
+                char *tuple = batch.append();
+                fill_tuple(cols, rng, tuple);
+                bool ok = interpreted_eval(cols, conds, tuple);
+                ASSERT_EQ(ResolvedCond::eval_all(resolved, tuple), ok);
+                if (ok) {
+                    expected.push_back(i);
+                }
+            }
+            ResolvedCond::filter(resolved, &batch);
+            ASSERT_EQ(batch.sel(), expected);
+        }
+    }
+}
+
+/**
+ * @brief 在模拟的页面上用标量和AVX2两种方式批量判断数值条件，再判断其余条件，与逐个元组判断的结果一致；
+ * 槽数不是8的倍数，bitmap中有空槽
+ */
+TEST(ScanPredicateTest, PageFilterMatchesResolvedCond) {
+    auto cols = make_cols();
+    int tuple_len = cols.back().offset + cols.back().len;
+    const int num_slots = 203;
+    std::default_random_engine rng(0);
+    std::vector<char> slots(num_slots * tuple_len);
+    std::vector<char> bitmap((num_slots + 7) / 8, 0);
+    for (int i = 0; i < num_slots; i++) {
+        fill_tuple(cols, rng, slots.data() + i * tuple_len);
+        if (rng() % 4 != 0) {
+            bitmap[i / 8] |= static_cast<char>(0x80u >> (i % 8));
+        }
+    }
+    for (bool use_avx2 : {false, page_filter_use_avx2()}) {
+        for (CompOp op : {OP_EQ, OP_NE, OP_LT, OP_GT, OP_LE, OP_GE}) {
+            std::vector<Condition> conds = {make_val_cond("a", op, int_val(50), 4),
+                                            make_val_cond("b", op == OP_EQ ? OP_NE : op, float_val(12.5f), 4),
+                                            make_col_cond("d", OP_NE, "a")};
+            auto resolved = ResolvedCond::resolve(cols, conds);
+            PageFilter page_filter(resolved, use_avx2);
+            ASSERT_EQ(page_filter.residual_conds().size(), 1);
+            std::vector<uint8_t> mask;
+            page_filter.eval(bitmap.data(), slots.data(), tuple_len, num_slots, &mask);
+            ASSERT_EQ(mask.size(), (num_slots + 7) / 8);
+            for (int i = 0; i < num_slots; i++) {
+                const char *tuple = slots.data() + i * tuple_len;
+                bool in_page = (bitmap[i / 8] & (0x80u >> (i % 8))) != 0;
+                bool expected = in_page && ResolvedCond::eval_all(resolved, tuple);
+                bool selected = (mask[i / 8] >> (i % 8) & 1) && ResolvedCond::eval_all(page_filter.residual_conds(), tuple);
+                ASSERT_EQ(selected, expected) << "slot " << i << " op " << op << " avx2 " << use_avx2;
+            }
+        }
+    }
+}
+
+/**
+ * @brief 对比原来逐个解释条件与编译后的条件在整表扫描中每秒处理的元组数
+ */
+TEST(ScanPredicateTest, ScanBenchmark) {
+    const int num_tuples = 200000;
+    const int rounds = 10;
+    auto cols = make_cols();
+    int tuple_len = cols.back().offset + cols.back().len;
+
+    auto disk_manager = std::make_unique<DiskManager>();
+    auto buffer_pool_manager = std::make_unique<BufferPoolManager>(BUFFER_POOL_SIZE, disk_manager.get());
+    auto rm_manager = std::make_unique<RmManager>(disk_manager.get(), buffer_pool_manager.get());
+    std::string filename = "scan_predicate_test.tbl";
+    if (disk_manager->is_file(filename)) {
+        disk_manager->destroy_file(filename);
+    }
+    rm_manager->create_file(filename, tuple_len);
+    auto file_handle = rm_manager->open_file(filename);
+    std::default_random_engine rng(0);
+    std::vector<char> tuple(tuple_len);
+    for (int i = 0; i < num_tuples; i++) {
+        fill_tuple(cols, rng, tuple.data());
+        file_handle->insert_record(tuple.data(), nullptr);
+    }
+
+    std::vector<Condition> conds = {make_val_cond("a", OP_GE, int_val(20), 4), make_val_cond("b", OP_LT, float_val(20), 4),
+                                    make_col_cond("d", OP_NE, "a"), make_val_cond("c", OP_GT, str_val("a5"), 12)};
+    auto resolved = ResolvedCond::resolve(cols, conds);
+    RmFileHdr file_hdr = file_handle->get_file_hdr();
+
+    // 按页把元组读入一批，再用filter去掉不满足条件的元组，返回满足条件的元组数
+    auto bench = [&](const char *name, auto filter) {
+        long long checksum = 0;
+        TupleBatch batch;
+        auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < rounds; round++) {
+            for (int page_no = RM_FIRST_RECORD_PAGE; page_no < file_hdr.num_pages; page_no++) {
+                int slot_no = -1;
+                batch.reset(tuple_len, file_hdr.num_records_per_page);
+                int n = file_handle->get_page_records(page_no, &slot_no, file_hdr.num_records_per_page,
+                                                      batch.row(0), nullptr);
+                batch.extend(n);
+                filter(&batch);
+                checksum += batch.size();
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+        double secs = std::chrono::duration<double>(end - start).count();
+        printf("%-12s %8.2f M rows/s (selected %lld)\n", name, 1e-6 * num_tuples * rounds / secs, checksum);
+        return checksum;
+    };
+
+    long long interpreted = bench("interpreted", [&](TupleBatch *batch) {
+        auto &sel = batch->sel();
+        size_t num_sel = 0;
+        for (uint32_t row_no : sel) {
+            if (interpreted_eval(cols, conds, batch->row(row_no))) {
+                sel[num_sel++] = row_no;
+            }
+        }
+        sel.resize(num_sel);
+    });
+    long long compiled = bench("compiled", [&](TupleBatch *batch) { ResolvedCond::filter(resolved, batch); });
+    EXPECT_EQ(interpreted, compiled);
+
+    // 先在页面上批量判断数值条件，只复制选中的元组，再判断其余条件
+    auto bench_page = [&](const char *name, bool use_avx2) {
+        PageFilter page_filter(resolved, use_avx2);
+        std::vector<uint8_t> mask;
+        long long checksum = 0;
+        TupleBatch batch;
+        auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < rounds; round++) {
+            for (int page_no = RM_FIRST_RECORD_PAGE; page_no < file_hdr.num_pages; page_no++) {
+                batch.reset(tuple_len, file_hdr.num_records_per_page);
+                RmPageHandle page_handle = file_handle->fetch_page_handle(page_no);
+                page_filter.eval(page_handle.bitmap, page_handle.slots, tuple_len, file_hdr.num_records_per_page, &mask);
+                for (int slot_no = 0; slot_no < file_hdr.num_records_per_page; slot_no++) {
+                    if (mask[slot_no >> 3] >> (slot_no & 7) & 1) {
+                        batch.append(page_handle.get_slot(slot_no));
+                    }
+                }
+                file_handle->unpin_page_handle(page_handle);
+                ResolvedCond::filter(page_filter.residual_conds(), &batch);
+                checksum += batch.size();
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+        double secs = std::chrono::duration<double>(end - start).count();
+        printf("%-12s %8.2f M rows/s (selected %lld)\n", name, 1e-6 * num_tuples * rounds / secs, checksum);
+        return checksum;
+    };
+    EXPECT_EQ(interpreted, bench_page("page scalar", false));
+    if (page_filter_use_avx2()) {
+        EXPECT_EQ(interpreted, bench_page("page avx2", true));
+    }
+
+    rm_manager->close_file(file_handle.get());
+    rm_manager->destroy_file(filename);
+}
@@ -0,0 +1,194 @@
+#include <random>  // for std::default_random_engine
+
+#include "gtest/gtest.h"
+
+#define private public
+#include "execution/execution_sort.h"
+#undef private  // 检查写出的有序段数量
+
+#include "execution/executor_limit.h"
+#include "vector_executor.h"
+
+static const std::string TAB_NAME = "t";
+
+// 表t(a, b)，a在[-num_keys, num_keys)中随机取值，b是元组的编号
+static std::vector<Row> make_rows(size_t n, int num_keys, unsigned seed) {
+    std::default_random_engine rng(seed);
+    std::vector<Row> rows;
+    for (size_t i = 0; i < n; i++) {
+        rows.push_back({static_cast<int>(rng() % (2 * num_keys)) - num_keys, static_cast<int>(i)});
+    }
+    return rows;
+}
+
+static std::unique_ptr<VectorExecutor> input(std::vector<Row> rows) {
+    return std::make_unique<VectorExecutor>(TAB_NAME, std::vector<std::string>{"a", "b"}, std::move(rows));
+}
+
+static const std::vector<TabCol> SORT_COLS = {{TAB_NAME, "a"}, {TAB_NAME, "b"}};
+
+/** 参照结果：先按a再按b排序，is_descs给出每个字段是否降序 */
+static std::vector<Row> reference_sort(std::vector<Row> rows, const std::vector<bool> &is_descs) {
+    std::sort(rows.begin(), rows.end(), [&](const Row &x, const Row &y) {
+        for (size_t i = 0; i < is_descs.size(); i++) {
+            if (x[i] != y[i]) {
+                return is_descs[i] ? x[i] > y[i] : x[i] < y[i];
+            }
+        }
+        return false;
+    });
+    return rows;
+}
+
+/** 排序时每个元组占用的内存：元组和排序对象 */
+static constexpr size_t SORT_ENTRY_MEM = 8 + 16;
+
+/**
+ * @brief 输入放得下时在内存中排序；放不下时写出多个有序段后归并；
+ * 有序段超过SORT_MERGE_FANIN个时先多次归并到不超过SORT_MERGE_FANIN个，结果都与参照结果相同
+ */
+TEST(SortTest, ExternalMerge) {
+    auto rows = make_rows(20000, 500, 1);
+    struct Case {
+        size_t max_tuples;
+        size_t num_runs;  // 开始归并时的有序段数量，0表示在内存中排序
+    };
+    for (auto &is_descs : {std::vector<bool>{false, false}, std::vector<bool>{true, false}, std::vector<bool>{false, true}}) {
+        auto expected = reference_sort(rows, is_descs);
+        // 20000个元组每段100个共200段，归并64段成一段三次后剩下11段
+        for (auto c : {Case{rows.size(), 0}, Case{1000, 20}, Case{100, 11}}) {
+            SortExecutor sort(input(rows), SORT_COLS, is_descs, c.max_tuples * SORT_ENTRY_MEM);
+            ASSERT_EQ(sort.max_tuples_, c.max_tuples);
+            EXPECT_EQ(collect_tuples(&sort), expected);
+            EXPECT_EQ(sort.runs_.size(), c.num_runs);
+            EXPECT_EQ(collect_batches(&sort), expected);
+        }
+    }
+}
+
+/**
+ * @brief 只按第一个字段排序时key相同的元组都连续输出；正好攒满内存时不多写出空的有序段；空输入没有结果
+ */
+TEST(SortTest, SingleKeyAndBoundaries) {
+    auto rows = make_rows(5000, 20, 2);
+    SortExecutor by_a(input(rows), {{TAB_NAME, "a"}}, {true}, 100 * SORT_ENTRY_MEM);
+    auto output = collect_batches(&by_a);
+    ASSERT_EQ(output.size(), rows.size());
+    EXPECT_TRUE(std::is_sorted(output.begin(), output.end(), [](const Row &x, const Row &y) { return x[0] > y[0]; }));
+    EXPECT_EQ(sorted(output), sorted(rows));
+
+    SortExecutor exact(input(make_rows(1000, 20, 3)), SORT_COLS, {false, false}, 100 * SORT_ENTRY_MEM);
+    exact.beginTuple();
+    EXPECT_EQ(exact.runs_.size(), 10);
+
+    SortExecutor empty(input({}), SORT_COLS, {false, false}, 100 * SORT_ENTRY_MEM);
+    EXPECT_TRUE(collect_tuples(&empty).empty());
+}
+
+/**
+ * @brief 第一个排序字段编码成的前缀按无符号整数比较，与按字段比较的顺序一致（前缀相同时只要求字段也不能反序）
+ */
+TEST(SortTest, PrefixOrder) {
+    std::vector<ColMeta> cols = {{.tab_name = TAB_NAME, .name = "f", .type = TYPE_FLOAT, .len = 4, .offset = 0},
+                                 {.tab_name = TAB_NAME, .name = "s", .type = TYPE_STRING, .len = 12, .offset = 4}};
+    std::vector<std::vector<char>> tuples;
+    std::default_random_engine rng(4);
+    for (float f : {-1e30f, -2.5f, -1.0f, -0.0f, 0.0f, 1e-30f, 0.5f, 3.0f, 1e30f}) {
+        std::vector<char> tuple(16, 0);
+        memcpy(tuple.data(), &f, sizeof(f));
+        std::string s(rng() % 12, 'a');
+        for (auto &ch : s) {
+            ch = static_cast<char>('a' + rng() % 3);
+        }
+        memcpy(tuple.data() + 4, s.data(), s.size());
+        tuples.push_back(std::move(tuple));
+    }
+    for (auto &col : cols) {
+        for (bool is_desc : {false, true}) {
+            SortKeys keys(cols, {{TAB_NAME, col.name}}, {is_desc});
+            for (auto &x : tuples) {
+                for (auto &y : tuples) {
+                    uint64_t px = keys.make_prefix(x.data());
+                    uint64_t py = keys.make_prefix(y.data());
+                    int result = keys.compare(x.data(), y.data());
+                    if (px < py) {
+                        EXPECT_LT(result, 0);
+                    } else if (px > py) {
+                        EXPECT_GT(result, 0);
+                    }
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief top-N排序输出的是完整排序的前n个元组，n为0、小于、等于和大于输入大小时都是如此
+ */
+TEST(TopNTest, MatchesSortPrefix) {
+    auto rows = make_rows(3000, 100, 5);
+    for (auto &is_descs : {std::vector<bool>{false, false}, std::vector<bool>{true, true}}) {
+        auto expected = reference_sort(rows, is_descs);
+        for (size_t limit : {0, 1, 10, 1024, 2999, 3000, 5000}) {
+            TopNExecutor top_n(input(rows), SORT_COLS, is_descs, limit);
+            auto prefix = std::vector<Row>(expected.begin(), expected.begin() + std::min(limit, expected.size()));
+            EXPECT_EQ(collect_tuples(&top_n), prefix);
+            EXPECT_EQ(collect_batches(&top_n), prefix);
+        }
+    }
+}
+
+/**
+ * @brief 只按有重复值的字段排序时，输出的排序字段与完整排序的前n个相同，输出的元组都来自输入
+ */
+TEST(TopNTest, Ties) {
+    auto rows = make_rows(2000, 5, 6);
+    auto expected = reference_sort(rows, {false});
+    TopNExecutor top_n(input(rows), {{TAB_NAME, "a"}}, {false}, 300);
+    auto output = collect_batches(&top_n);
+    ASSERT_EQ(output.size(), 300);
+    for (size_t i = 0; i < output.size(); i++) {
+        EXPECT_EQ(output[i][0], expected[i][0]);
+        EXPECT_EQ(rows.at(output[i][1]), output[i]);
+    }
+}
+
+/**
+ * @brief LIMIT/OFFSET跳过前offset个元组后最多输出limit个；输出够limit个后不再让输入前进
+ */
+TEST(LimitTest, LimitOffset) {
+    auto rows = make_rows(100, 10, 7);
+    for (size_t offset : {0, 1, 50, 99, 100, 150}) {
+        for (size_t limit : {0, 1, 10, 100}) {
+            auto in = input(rows);
+            auto *in_ptr = in.get();
+            LimitExecutor limit_exec(std::move(in), limit, offset);
+            size_t begin = std::min(offset, rows.size());
+            size_t end = std::min(offset + limit, rows.size());
+            std::vector<Row> expected(rows.begin() + begin, rows.begin() + end);
+            EXPECT_EQ(collect_tuples(&limit_exec), expected);
+            // limit为0时不读输入；输入足够时输出的最后一个元组之后不再前进；输入不够时读到输入结束
+            size_t nexts = 0;
+            if (limit > 0) {
+                nexts = offset + limit <= rows.size() ? offset + limit - 1 : rows.size();
+            }
+            EXPECT_EQ(in_ptr->num_nexts, static_cast<int>(nexts));
+            EXPECT_EQ(collect_batches(&limit_exec), expected);
+        }
+    }
+}
+
+/**
+ * @brief 计划中ORDER BY ... LIMIT n OFFSET m是top-N(n+m)上面的LIMIT/OFFSET，结果与完整排序中的对应一段相同
+ */
+TEST(LimitTest, OverTopN) {
+    auto rows = make_rows(5000, 300, 8);
+    auto expected = reference_sort(rows, {true, false});
+    for (auto [limit, offset] : std::vector<std::pair<size_t, size_t>>{{10, 0}, {10, 20}, {100, 4950}, {2000, 1024}}) {
+        LimitExecutor limit_exec(std::make_unique<TopNExecutor>(input(rows), SORT_COLS, std::vector<bool>{true, false},
+                                                                limit + offset),
+                                 limit, offset);
+        size_t end = std::min(limit + offset, rows.size());
+        EXPECT_EQ(collect_batches(&limit_exec), std::vector<Row>(expected.begin() + offset, expected.begin() + end));
+    }
+}
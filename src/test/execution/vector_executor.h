@@ -0,0 +1,103 @@
+#pragma once
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "execution/executor_abstract.h"
+
+using Row = std::vector<int>;
+
+/**
+ * 执行算子测试使用的输入算子：从内存中的元组读取，字段都是int，字段名由测试给出；
+ * 记录被从头扫描的次数和前进的次数，用于检查上层算子读取输入的次数
+ */
+class VectorExecutor : public AbstractExecutor {
+   private:
+    std::vector<ColMeta> cols_;
+    size_t len_;
+    std::vector<Row> rows_;
+    size_t pos_ = 0;
+
+   public:
+    int num_scans = 0;  // beginTuple()被调用的次数
+    int num_nexts = 0;  // nextTuple()被调用的次数
+
+    VectorExecutor(const std::string &tab_name, const std::vector<std::string> &col_names, std::vector<Row> rows)
+        : rows_(std::move(rows)) {
+        int offset = 0;
+        for (auto &name : col_names) {
+            cols_.push_back({.tab_name = tab_name, .name = name, .type = TYPE_INT, .len = 4, .offset = offset,
+                             .index = false});
+            offset += 4;
+        }
+        len_ = offset;
+    }
+
+    size_t tupleLen() const override { return len_; }
+
+    const std::vector<ColMeta> &cols() const override { return cols_; }
+
+    void beginTuple() override {
+        pos_ = 0;
+        num_scans++;
+    }
+
+    void nextTuple() override {
+        pos_++;
+        num_nexts++;
+    }
+
+    bool is_end() const override { return pos_ == rows_.size(); }
+
+    std::unique_ptr<RmRecord> Next() override {
+        auto record = std::make_unique<RmRecord>(len_);
+        memcpy(record->data, rows_[pos_].data(), len_);
+        return record;
+    }
+
+    Rid &rid() override { return _abstract_rid; }
+};
+
+/** 把一个元组按int字段拆开 */
+inline Row to_row(const char *tuple, size_t len) {
+    Row row(len / sizeof(int));
+    memcpy(row.data(), tuple, len);
+    return row;
+}
+
+/** 按批读出算子的全部输出 */
+inline std::vector<Row> collect_batches(AbstractExecutor *exec) {
+    std::vector<Row> rows;
+    TupleBatch batch;
+    for (exec->beginTuple(); exec->next_batch(&batch);) {
+        for (size_t i = 0; i < batch.size(); i++) {
+            rows.push_back(to_row(batch.get(i), exec->tupleLen()));
+        }
+    }
+    return rows;
+}
+
+/** 逐个元组读出算子的全部输出 */
+inline std::vector<Row> collect_tuples(AbstractExecutor *exec) {
+    std::vector<Row> rows;
+    for (exec->beginTuple(); !exec->is_end(); exec->nextTuple()) {
+        rows.push_back(to_row(exec->Next()->data, exec->tupleLen()));
+    }
+    return rows;
+}
+
+inline std::vector<Row> sorted(std::vector<Row> rows) {
+    std::sort(rows.begin(), rows.end());
+    return rows;
+}
+
+/** 两个表的字段之间的连接条件 */
+inline Condition join_cond(const TabCol &lhs, CompOp op, const TabCol &rhs) {
+    Condition cond;
+    cond.lhs_col = lhs;
+    cond.op = op;
+    cond.is_rhs_val = false;
+    cond.rhs_col = rhs;
+    return cond;
+}
@@ -0,0 +1,418 @@
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <random>  // for std::default_random_engine
+#include <thread>  // NOLINT
+
+#include "gtest/gtest.h"
+
+#define private public
+#include "index/ix.h"
+#undef private  // for use private variables in "ix.h"
+
+#include "storage/buffer_pool_manager.h"
+#include "system/sm.h"
+#include "record/rm.h"
+
+const std::string TEST_DB_NAME = "BPlusTreeCompressTest_db";  // 以数据库名作为根目录
+const std::string TEST_FILE_NAME = "table1";                  // 压缩索引所在的表
+const std::string BASELINE_FILE_NAME = "table2";              // 不压缩的对照索引所在的表
+const std::vector<std::string> TEST_COL = {"col1"};
+const int KEY_LEN = 64;
+
+/** 注意：每个测试点都在目录TEST_DB_NAME下重新创建两张表，
+ * table1的索引按前缀压缩的格式存放，table2的索引关闭压缩作为对照 */
+class BPlusTreeCompressTest : public ::testing::Test {
+   public:
+    std::unique_ptr<DiskManager> disk_manager_;
+    std::unique_ptr<BufferPoolManager> buffer_pool_manager_;
+    std::unique_ptr<IxManager> ix_manager_;
+    std::unique_ptr<IxIndexHandle> ih_;
+    std::unique_ptr<IxIndexHandle> baseline_;
+    std::unique_ptr<Transaction> txn_;
+    std::unique_ptr<RmManager> rm_;
+    std::unique_ptr<SmManager> sm_;
+
+   public:
+    void SetUp() override {
+        ::testing::Test::SetUp();
+        disk_manager_ = std::make_unique<DiskManager>();
+        buffer_pool_manager_ = std::make_unique<BufferPoolManager>(200, disk_manager_.get());
+        ix_manager_ = std::make_unique<IxManager>(disk_manager_.get(), buffer_pool_manager_.get());
+        txn_ = std::make_unique<Transaction>(0);
+        rm_ = std::make_unique<RmManager>(disk_manager_.get(), buffer_pool_manager_.get());
+        sm_ = std::make_unique<SmManager>(disk_manager_.get(), buffer_pool_manager_.get(), rm_.get(), ix_manager_.get());
+
+        if (disk_manager_->is_dir(TEST_DB_NAME)) {
+            std::string cmd = "rm -rf " + TEST_DB_NAME;
+            if (system(cmd.c_str()) < 0) {
+                throw UnixError();
+            }
+        }
+        sm_->create_db(TEST_DB_NAME);
+        assert(disk_manager_->is_dir(TEST_DB_NAME));
+        if (chdir(TEST_DB_NAME.c_str()) < 0) {
+            throw UnixError();
+        }
+        for (auto &name : {TEST_FILE_NAME, BASELINE_FILE_NAME}) {
+            std::vector<ColDef> coldef;
+            coldef.push_back({"col1", TYPE_STRING, KEY_LEN});
+            coldef.push_back({"col2", TYPE_INT, 4});
+            sm_->create_table(name, coldef, nullptr);
+        }
+        sm_->create_index(TEST_FILE_NAME, TEST_COL, nullptr);
+        // 对照索引创建时关闭压缩
+        ix_manager_->create_index(BASELINE_FILE_NAME, {*sm_->db_.get_table(BASELINE_FILE_NAME).get_col("col1")}, false,
+                                  false);
+        ih_ = ix_manager_->open_index(TEST_FILE_NAME, TEST_COL);
+        baseline_ = ix_manager_->open_index(BASELINE_FILE_NAME, TEST_COL);
+        assert(ih_->file_hdr_->compress_);
+        assert(!baseline_->file_hdr_->compress_);
+    }
+
+    void TearDown() override {
+        ix_manager_->close_index(ih_.get());
+        ix_manager_->close_index(baseline_.get());
+        if (chdir("..") < 0) {
+            throw UnixError();
+        }
+        assert(disk_manager_->is_dir(TEST_DB_NAME));
+    }
+
+    /** 类似URL的key：较长的公共前缀，后面是补0的编号 */
+    static std::string make_key(int id) {
+        char buf[KEY_LEN + 1];
+        snprintf(buf, sizeof(buf), "https://www.example.com/catalog/category-%02d/item-%08d", id % 17, id);
+        std::string key(buf);
+        key.resize(KEY_LEN, '\0');
+        return key;
+    }
+
+    static Rid make_rid(int id) { return Rid{.page_no = id / 100, .slot_no = id % 100}; }
+
+    int height(IxIndexHandle *ih) {
+        int h = 1;
+        IxNodeHandle *node = ih->fetch_node(ih->file_hdr_->root_page_);
+        while (!node->is_leaf_page()) {
+            IxNodeHandle *child = ih->fetch_node(node->value_at(0));
+            buffer_pool_manager_->unpin_page(node->get_page_id(), false);
+            delete node;
+            node = child;
+            h++;
+        }
+        buffer_pool_manager_->unpin_page(node->get_page_id(), false);
+        delete node;
+        return h;
+    }
+
+    /** 沿叶子链表统计叶子结点数量，以及其中键值对数量不到一半容量（get_min_size()）的结点数量 */
+    std::pair<int, int> leaf_stats(IxIndexHandle *ih) {
+        int leaves = 0, underfull = 0;
+        page_id_t page_no = ih->file_hdr_->first_leaf_;
+        while (true) {
+            IxNodeHandle *leaf = ih->fetch_node(page_no);
+            leaves++;
+            underfull += leaf->get_size() < leaf->get_min_size();
+            bool last = page_no == ih->file_hdr_->last_leaf_;
+            page_no = leaf->get_next_leaf();
+            buffer_pool_manager_->unpin_page(leaf->get_page_id(), false);
+            delete leaf;
+            if (last) {
+                break;
+            }
+        }
+        return {leaves, underfull};
+    }
+
+    /** 检查点查询和从头到尾的扫描结果与mock一致 */
+    void check_all(IxIndexHandle *ih, const std::map<std::string, Rid> &mock) {
+        for (auto &[key, rid] : mock) {
+            std::vector<Rid> result;
+            ASSERT_TRUE(ih->get_value(key.data(), &result, txn_.get()));
+            ASSERT_EQ(result.size(), 1);
+            EXPECT_EQ(result[0], rid);
+        }
+        IxScan scan(ih, ih->leaf_begin(), ih->leaf_end(), buffer_pool_manager_.get());
+        auto it = mock.begin();
+        while (!scan.is_end()) {
+            ASSERT_NE(it, mock.end());
+            ASSERT_EQ(scan.rid(), it->second);
+            ++it;
+            scan.next();
+        }
+        EXPECT_EQ(it, mock.end());
+    }
+};
+
+/**
+ * @brief 乱序插入，压缩索引与对照索引的查询结果一致，并且页面数量明显更少
+ */
+TEST_F(BPlusTreeCompressTest, InsertTest) {
+    const int scale = 20000;
+    std::vector<int> ids;
+    for (int id = 0; id < scale; id++) {
+        ids.push_back(id);
+    }
+    std::shuffle(ids.begin(), ids.end(), std::default_random_engine{});
+
+    std::map<std::string, Rid> mock;
+    for (int id : ids) {
+        std::string key = make_key(id);
+        ih_->insert_entry(key.data(), make_rid(id), txn_.get());
+        baseline_->insert_entry(key.data(), make_rid(id), txn_.get());
+        mock[key] = make_rid(id);
+    }
+    check_all(ih_.get(), mock);
+    check_all(baseline_.get(), mock);
+
+    // 范围查询：同一个category中[lower, upper)内的key数量
+    std::string lower = make_key(1000), upper = make_key(1000 + 17 * 500);
+    IxScan scan(ih_.get(), ih_->lower_bound(lower.data()), ih_->lower_bound(upper.data()), buffer_pool_manager_.get());
+    int cnt = 0;
+    for (; !scan.is_end(); scan.next()) {
+        cnt++;
+    }
+    EXPECT_EQ(cnt, std::distance(mock.lower_bound(lower), mock.lower_bound(upper)));
+
+    printf("compressed: height %d, %d pages; uncompressed: height %d, %d pages\n", height(ih_.get()),
+           ih_->file_hdr_->num_pages_, height(baseline_.get()), baseline_->file_hdr_->num_pages_);
+    EXPECT_LE(height(ih_.get()), height(baseline_.get()));
+    EXPECT_LT(ih_->file_hdr_->num_pages_ * 2, baseline_->file_hdr_->num_pages_);
+}
+
+/**
+ * @brief 乱序删除一半后检查，再全部删除后重新插入
+ */
+TEST_F(BPlusTreeCompressTest, DeleteTest) {
+    const int scale = 10000;
+    std::vector<int> ids;
+    for (int id = 0; id < scale; id++) {
+        ids.push_back(id);
+    }
+    auto rng = std::default_random_engine{};
+    std::shuffle(ids.begin(), ids.end(), rng);
+
+    std::map<std::string, Rid> mock;
+    for (int id : ids) {
+        ih_->insert_entry(make_key(id).data(), make_rid(id), txn_.get());
+        mock[make_key(id)] = make_rid(id);
+    }
+    std::shuffle(ids.begin(), ids.end(), rng);
+    for (int i = 0; i < scale / 2; i++) {
+        ASSERT_TRUE(ih_->delete_entry(make_key(ids[i]).data(), txn_.get()));
+        mock.erase(make_key(ids[i]));
+    }
+    EXPECT_FALSE(ih_->delete_entry(make_key(ids[0]).data(), txn_.get()));
+    check_all(ih_.get(), mock);
+    for (int i = 0; i < scale / 2; i++) {
+        std::vector<Rid> result;
+        EXPECT_FALSE(ih_->get_value(make_key(ids[i]).data(), &result, txn_.get()));
+    }
+
+    for (int i = scale / 2; i < scale; i++) {
+        ASSERT_TRUE(ih_->delete_entry(make_key(ids[i]).data(), txn_.get()));
+    }
+    mock.clear();
+    check_all(ih_.get(), mock);
+
+    for (int i = 0; i < scale / 4; i++) {
+        ih_->insert_entry(make_key(ids[i]).data(), make_rid(ids[i]), txn_.get());
+        mock[make_key(ids[i])] = make_rid(ids[i]);
+    }
+    check_all(ih_.get(), mock);
+}
+
+/**
+ * @brief 批量构建压缩索引后继续插入和删除
+ */
+TEST_F(BPlusTreeCompressTest, BulkLoadTest) {
+    const int scale = 20000;
+    std::vector<int> ids;
+    for (int id = 0; id < scale; id++) {
+        ids.push_back(id);
+    }
+    auto rng = std::default_random_engine{};
+    std::shuffle(ids.begin(), ids.end(), rng);
+
+    std::map<std::string, Rid> mock;
+    {
+        IxBulkLoader loader(ih_.get(), "bulk_load_test", 1000 * (KEY_LEN + sizeof(Rid)));
+        for (int id : ids) {
+            loader.add(make_key(id).data(), make_rid(id));
+            mock[make_key(id)] = make_rid(id);
+        }
+        loader.finish(0.7);
+    }
+    check_all(ih_.get(), mock);
+
+    for (int id = scale; id < scale + 2000; id++) {
+        ih_->insert_entry(make_key(id).data(), make_rid(id), txn_.get());
+        mock[make_key(id)] = make_rid(id);
+    }
+    for (int i = 0; i < 2000; i++) {
+        ASSERT_TRUE(ih_->delete_entry(make_key(ids[i]).data(), txn_.get()));
+        mock.erase(make_key(ids[i]));
+    }
+    check_all(ih_.get(), mock);
+}
+
+/**
+ * @brief 多个线程并发插入和删除各自的key
+ */
+TEST_F(BPlusTreeCompressTest, ConcurrentTest) {
+    const int num_threads = 4;
+    const int per_thread = 5000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([this, t] {
+            Transaction txn(t + 1);
+            std::vector<int> ids;
+            for (int i = 0; i < per_thread; i++) {
+                ids.push_back(i * num_threads + t);
+            }
+            std::shuffle(ids.begin(), ids.end(), std::default_random_engine(t));
+            for (int id : ids) {
+                ih_->insert_entry(make_key(id).data(), make_rid(id), &txn);
+            }
+            for (int i = 0; i < per_thread / 2; i++) {
+                ih_->delete_entry(make_key(ids[i]).data(), &txn);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    std::map<std::string, Rid> mock;
+    for (int t = 0; t < num_threads; t++) {
+        std::vector<int> ids;
+        for (int i = 0; i < per_thread; i++) {
+            ids.push_back(i * num_threads + t);
+        }
+        std::shuffle(ids.begin(), ids.end(), std::default_random_engine(t));
+        for (int i = per_thread / 2; i < per_thread; i++) {
+            mock[make_key(ids[i])] = make_rid(ids[i]);
+        }
+    }
+    check_all(ih_.get(), mock);
+}
+
+/**
+ * @brief 压缩索引的批量删除与对照索引的结果一致
+ */
+TEST_F(BPlusTreeCompressTest, BatchDeleteTest) {
+    const int scale = 5000;
+    std::map<std::string, Rid> mock;
+    for (int id = 0; id < scale; id++) {
+        ih_->insert_entry(make_key(id).data(), make_rid(id), txn_.get());
+        baseline_->insert_entry(make_key(id).data(), make_rid(id), txn_.get());
+        mock[make_key(id)] = make_rid(id);
+    }
+
+    std::vector<int> ids;
+    for (int id = 0; id < scale; id++) {
+        if (id % 3 != 0 || (id > 1000 && id < 3000)) {
+            ids.push_back(id);
+        }
+    }
+    std::shuffle(ids.begin(), ids.end(), std::default_random_engine{});
+    std::string keys;
+    std::vector<Rid> rids;
+    for (int id : ids) {
+        keys += make_key(id);
+        rids.push_back(make_rid(id));
+        mock.erase(make_key(id));
+    }
+    EXPECT_EQ(ih_->delete_entries(keys.data(), KEY_LEN, rids.data(), ids.size(), txn_.get()), ids.size());
+    EXPECT_EQ(baseline_->delete_entries(keys.data(), KEY_LEN, rids.data(), ids.size(), txn_.get()), ids.size());
+    check_all(ih_.get(), mock);
+    check_all(baseline_.get(), mock);
+}
+
+/**
+ * @brief 批量构建出全满的叶子结点后，每隔一个叶子结点删除到只剩一个key：这些结点与全满的兄弟结点合并后放不下，
+ * 从兄弟结点移过来一部分键值对，删除之后除了最后一个叶子结点外都不少于一半容量
+ */
+TEST_F(BPlusTreeCompressTest, HeavyDeleteTest) {
+    const int scale = 20000;
+    std::map<std::string, Rid> mock;
+    {
+        IxBulkLoader loader(ih_.get(), "heavy_delete_test", 1000 * (KEY_LEN + sizeof(Rid)));
+        for (int id = 0; id < scale; id++) {
+            loader.add(make_key(id).data(), make_rid(id));
+            mock[make_key(id)] = make_rid(id);
+        }
+        loader.finish(1.0);
+    }
+    int leaves = leaf_stats(ih_.get()).first;
+
+    std::vector<std::string> victims;
+    {
+        IxScan scan(ih_.get(), ih_->leaf_begin(), ih_->leaf_end(), buffer_pool_manager_.get());
+        int leaf_idx = -1;
+        for (page_id_t page_no = IX_NO_PAGE; !scan.is_end(); scan.next()) {
+            if (scan.iid().page_no != page_no) {
+                page_no = scan.iid().page_no;
+                leaf_idx++;
+            }
+            if (leaf_idx % 2 == 1 && scan.iid().slot_no > 0) {
+                std::string key(KEY_LEN, '\0');
+                scan.key(key.data());
+                victims.push_back(key);
+            }
+        }
+    }
+    std::shuffle(victims.begin(), victims.end(), std::default_random_engine{});
+    for (auto &key : victims) {
+        ASSERT_TRUE(ih_->delete_entry(key.data(), txn_.get()));
+        mock.erase(key);
+    }
+    check_all(ih_.get(), mock);
+
+    auto [remaining, underfull] = leaf_stats(ih_.get());
+    EXPECT_LE(remaining, leaves);
+    EXPECT_LE(underfull, 1);
+
+    // 剩下的key按顺序分批删除，整个叶子结点一次删空后与兄弟结点合并，最后再全部插入
+    std::vector<std::pair<std::string, Rid>> entries(mock.begin(), mock.end());
+    const size_t batch = 200;
+    for (size_t i = 0; i < entries.size(); i += batch) {
+        std::string keys;
+        std::vector<Rid> rids;
+        for (size_t j = i; j < std::min(i + batch, entries.size()); j++) {
+            keys += entries[j].first;
+            rids.push_back(entries[j].second);
+        }
+        ASSERT_EQ(ih_->delete_entries(keys.data(), KEY_LEN, rids.data(), rids.size(), txn_.get()), rids.size());
+        check_all(ih_.get(), std::map<std::string, Rid>(entries.begin() + std::min(i + batch, entries.size()),
+                                                        entries.end()));
+    }
+    EXPECT_EQ(leaf_stats(ih_.get()).first, 1);
+    check_all(ih_.get(), std::map<std::string, Rid>());
+    for (auto &[key, rid] : mock) {
+        ih_->insert_entry(key.data(), rid, txn_.get());
+    }
+    check_all(ih_.get(), mock);
+}
+
+/**
+ * @brief 是否压缩在创建索引时写入文件头：重新打开后压缩索引和关闭了压缩的对照索引都保持原来的格式，查询结果不变
+ */
+TEST_F(BPlusTreeCompressTest, ReopenTest) {
+    const int scale = 5000;
+    std::map<std::string, Rid> mock;
+    for (int id = 0; id < scale; id++) {
+        ih_->insert_entry(make_key(id).data(), make_rid(id), txn_.get());
+        baseline_->insert_entry(make_key(id).data(), make_rid(id), txn_.get());
+        mock[make_key(id)] = make_rid(id);
+    }
+    ix_manager_->close_index(ih_.get());
+    ix_manager_->close_index(baseline_.get());
+
+    ih_ = ix_manager_->open_index(TEST_FILE_NAME, TEST_COL);
+    baseline_ = ix_manager_->open_index(BASELINE_FILE_NAME, TEST_COL);
+    EXPECT_TRUE(ih_->file_hdr_->compress_);
+    EXPECT_FALSE(baseline_->file_hdr_->compress_);
+    check_all(ih_.get(), mock);
+    check_all(baseline_.get(), mock);
+}
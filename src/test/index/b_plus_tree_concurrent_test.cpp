@@ -1,3 +1,4 @@
+#include <atomic>
 #include <chrono>  // NOLINT
 #include <cstdio>
 #include <functional>
@@ -18,6 +19,7 @@ const std::string TEST_DB_NAME = "BPlusTreeConcurrentTest_db";  // 以数据库
 const std::string TEST_FILE_NAME = "table1";                    // 测试文件名的前缀
 const int index_no = 0;                 
 const std::vector<std::string> TEST_COL = {"col1"};             
+const std::vector<std::string> UNIQUE_COL = {"col2"};  // 唯一索引测试点的索引字段
 // 创建的索引文件名为"table1.0.idx"（TEST_FILE_NAME + index_no + .idx）
 
 /** 注意：每个测试点只测试了单个文件！
@@ -384,7 +386,7 @@ void DeleteHelper(IxIndexHandle *tree, const std::vector<int64_t> &keys,
 TEST_F(BPlusTreeConcurrentTest, InsertScaleTest) {
     const int64_t scale = 10000;
     const int thread_num = 50;
-    const int order = 255;
+    const int order = 200;  // 非唯一索引的key附加了8字节的rid，单列INT索引的结点最多放下202个键值对
 
     assert(order > 2 && order <= ih_->file_hdr_->btree_order_);
     ih_->file_hdr_->btree_order_ = order;
@@ -426,7 +428,7 @@ TEST_F(BPlusTreeConcurrentTest, MixScaleTest) {
     const int64_t scale = 10000;
     const int64_t delete_scale = 9900;
     const int thread_num = 50;
-    const int order = 255;
+    const int order = 200;  // 非唯一索引的key附加了8字节的rid，单列INT索引的结点最多放下202个键值对
 
     assert(order > 2 && order <= ih_->file_hdr_->btree_order_);
     ih_->file_hdr_->btree_order_ = order;
@@ -462,4 +464,263 @@ TEST_F(BPlusTreeConcurrentTest, MixScaleTest) {
         scan.next();
     }
     EXPECT_EQ(size, keys.size() - delete_keys.size());
-}
\ No newline at end of file
+}
+// helper function to insert and then look up a disjoint range of keys
+void RangeHelper(IxIndexHandle *tree, int64_t base, int64_t per_thread, uint64_t thread_itr = 0) {
+    Transaction *transaction = new Transaction(0);
+
+    int64_t begin = base + static_cast<int64_t>(thread_itr) * per_thread;
+    for (int64_t key = begin; key < begin + per_thread; key++) {
+        Rid rid = {.page_no = 0, .slot_no = static_cast<int32_t>(key)};
+        tree->insert_entry((const char *)&key, rid, transaction);
+    }
+    std::vector<Rid> rids;
+    for (int64_t key = begin; key < begin + per_thread; key++) {
+        rids.clear();
+        tree->get_value((const char *)&key, &rids, transaction);
+        EXPECT_EQ(rids.size(), 1);
+    }
+
+    delete transaction;
+}
+
+/**
+ * @brief 不同线程数下并发插入+查找的吞吐量，每个线程操作互不相交的key区间
+ * 只打印吞吐量用于对比，不作为通过条件（缓冲池本身仍是一把全局锁）
+ */
+TEST_F(BPlusTreeConcurrentTest, ThroughputTest) {
+    const int64_t per_thread_ops = 20000;
+    const int order = 200;  // 非唯一索引的key附加了8字节的rid，单列INT索引的结点最多放下202个键值对
+
+    assert(order > 2 && order <= ih_->file_hdr_->btree_order_);
+    ih_->file_hdr_->btree_order_ = order;
+
+    int64_t base = 1;
+    for (uint64_t thread_num : {1, 2, 4, 8}) {
+        int64_t per_thread = per_thread_ops / thread_num;
+        auto start = std::chrono::steady_clock::now();
+        LaunchParallelTest(thread_num, RangeHelper, ih_.get(), base, per_thread);
+        auto end = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(end - start).count();
+        printf("threads=%lu: %.0f ops/sec\n", thread_num, 2.0 * per_thread * thread_num / seconds);
+        base += per_thread * thread_num;
+    }
+
+    int64_t current_key = 1;
+    IxScan scan(ih_.get(), ih_->leaf_begin(), ih_->leaf_end(), buffer_pool_manager_.get());
+    while (!scan.is_end()) {
+        EXPECT_EQ(scan.rid().slot_no, current_key);
+        current_key++;
+        scan.next();
+    }
+    EXPECT_EQ(current_key, base);
+}
+
+/**
+ * @brief 写者不断插入、删除奇数key的同时，读者查找始终存在的偶数key，乐观读必须总能找到正确结果
+ */
+TEST_F(BPlusTreeConcurrentTest, OptimisticReadTest) {
+    const int64_t scale = 20000;
+    const int writer_num = 4;
+    const int reader_num = 4;
+    const int order = 16;  // 较小的order使分裂与合并更频繁
+
+    assert(order > 2 && order <= ih_->file_hdr_->btree_order_);
+    ih_->file_hdr_->btree_order_ = order;
+
+    std::vector<int64_t> stable_keys;
+    for (int64_t key = 2; key <= scale; key += 2) {
+        stable_keys.push_back(key);
+    }
+    InsertHelper(ih_.get(), stable_keys);
+
+    auto writer = [&](uint64_t thread_itr) {
+        Transaction transaction(0);
+        for (int round = 0; round < 3; round++) {
+            for (int64_t key = 1 + 2 * thread_itr; key <= scale; key += 2 * writer_num) {
+                Rid rid = {.page_no = 0, .slot_no = static_cast<int32_t>(key)};
+                ih_->insert_entry((const char *)&key, rid, &transaction);
+            }
+            for (int64_t key = 1 + 2 * thread_itr; key <= scale; key += 2 * writer_num) {
+                ih_->delete_entry((const char *)&key, &transaction);
+            }
+        }
+    };
+    auto reader = [&](uint64_t thread_itr) {
+        std::vector<Rid> rids;
+        std::default_random_engine rng(thread_itr);
+        for (int i = 0; i < 50000; i++) {
+            int64_t key = stable_keys[rng() % stable_keys.size()];
+            rids.clear();
+            ih_->get_value((const char *)&key, &rids, nullptr);
+            ASSERT_EQ(rids.size(), 1);
+            ASSERT_EQ(rids[0].slot_no, key);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < writer_num; i++) {
+        threads.emplace_back(writer, i);
+    }
+    for (int i = 0; i < reader_num; i++) {
+        threads.emplace_back(reader, i);
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    int64_t current_key = 2;
+    IxScan scan(ih_.get(), ih_->leaf_begin(), ih_->leaf_end(), buffer_pool_manager_.get());
+    while (!scan.is_end()) {
+        EXPECT_EQ(scan.rid().slot_no, current_key);
+        current_key += 2;
+        scan.next();
+    }
+    EXPECT_EQ(current_key, scale + 2);
+}
+
+/**
+ * @brief 写者在右半部分的叶子结点中反复插入、删除key（不分裂也不合并，祖先结点只加锁不修改），
+ * 读者在左半部分乐观查找时每次都应成功，不需要退回逐层加读锁；根结点的版本号不变
+ */
+TEST_F(BPlusTreeConcurrentTest, OptimisticReadDuringUnrelatedWrites) {
+    const int64_t scale = 4000;
+    const int writer_num = 4;
+    const int reader_num = 4;
+    const int order = 16;
+
+    assert(order > 2 && order <= ih_->file_hdr_->btree_order_);
+    ih_->file_hdr_->btree_order_ = order;
+
+    std::vector<int64_t> stable_keys;
+    for (int64_t key = 2; key <= scale; key += 2) {
+        stable_keys.push_back(key);
+    }
+    InsertHelper(ih_.get(), stable_keys);
+
+    // 顺序插入后叶子结点都是半满的，插入一个奇数key不会分裂，删除它也不会合并或修改父结点
+    std::vector<int64_t> writer_keys;
+    for (int i = 0; i < writer_num; i++) {
+        int64_t key = scale * 3 / 4 + 1 + 100 * i;
+        char node_key[IX_MAX_KEY_LEN];
+        ih_->make_key((const char *)&key, IX_MIN_RID, node_key);
+        IxNodeHandle *leaf = ih_->find_leaf_page_optimistic(node_key);
+        ASSERT_NE(leaf, nullptr);
+        ASSERT_LT(leaf->get_size() + 1, leaf->get_max_size());
+        ASSERT_GE(leaf->get_size(), leaf->get_min_size());
+        leaf->page->runlatch();
+        buffer_pool_manager_->unpin_page(leaf->get_page_id(), false);
+        delete leaf;
+        writer_keys.push_back(key);
+    }
+
+    Page *root = buffer_pool_manager_->fetch_page(PageId{ih_->fd_, ih_->file_hdr_->root_page_});
+    uint64_t root_version = root->get_version();
+    int num_pages = ih_->file_hdr_->num_pages_;
+
+    std::atomic<bool> done = false;
+    std::atomic<int> failures = 0;
+    auto writer = [&](uint64_t thread_itr) {
+        Transaction transaction(0);
+        int64_t key = writer_keys[thread_itr];
+        Rid rid = {.page_no = 0, .slot_no = static_cast<int32_t>(key)};
+        for (int round = 0; round < 5000; round++) {
+            ih_->insert_entry((const char *)&key, rid, &transaction);
+            ih_->delete_entry((const char *)&key, rid, &transaction);
+        }
+    };
+    auto reader = [&](uint64_t thread_itr) {
+        std::default_random_engine rng(thread_itr);
+        char node_key[IX_MAX_KEY_LEN];
+        while (!done) {
+            int64_t key = stable_keys[rng() % (stable_keys.size() / 2)];
+            ih_->make_key((const char *)&key, IX_MIN_RID, node_key);
+            IxNodeHandle *leaf = ih_->find_leaf_page_optimistic(node_key);
+            if (leaf == nullptr) {
+                failures++;
+                continue;
+            }
+            leaf->page->runlatch();
+            buffer_pool_manager_->unpin_page(leaf->get_page_id(), false);
+            delete leaf;
+        }
+    };
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < reader_num; i++) {
+        readers.emplace_back(reader, i);
+    }
+    LaunchParallelTest(writer_num, writer);
+    done = true;
+    for (auto &thread : readers) {
+        thread.join();
+    }
+
+    EXPECT_EQ(failures, 0);
+    EXPECT_EQ(root->get_version(), root_version);
+    EXPECT_EQ(ih_->file_hdr_->num_pages_, num_pages);
+    buffer_pool_manager_->unpin_page(root->get_page_id(), false);
+}
+
+/** 在同一张表的col2上建立唯一索引，结点中只保存key */
+class BPlusTreeConcurrentUniqueTest : public BPlusTreeConcurrentTest {
+   public:
+    void SetUp() override {
+        BPlusTreeConcurrentTest::SetUp();
+        ix_manager_->close_index(ih_.get());
+        sm_->create_index(TEST_FILE_NAME, UNIQUE_COL, nullptr, true);
+        ih_ = ix_manager_->open_index(TEST_FILE_NAME, UNIQUE_COL);
+        assert(ih_->file_hdr_->unique_);
+    }
+};
+
+// helper function to insert every key with a rid whose page_no is the thread number, counting successful inserts
+void UniqueInsertHelper(IxIndexHandle *tree, const std::vector<int> &keys, std::atomic<int> *inserted,
+                        uint64_t thread_itr = 0) {
+    Transaction *transaction = new Transaction(0);
+    for (auto key : keys) {
+        Rid rid = {.page_no = static_cast<int32_t>(thread_itr), .slot_no = key};
+        if (tree->insert_entry((const char *)&key, rid, transaction) != IX_NO_PAGE) {
+            (*inserted)++;
+        }
+    }
+    delete transaction;
+}
+
+/**
+ * @brief 唯一索引：多个线程并发插入同一批key，每个key只有一个线程插入成功，之后每个key恰好对应一个rid
+ */
+TEST_F(BPlusTreeConcurrentUniqueTest, InsertScaleTest) {
+    const int scale = 10000;
+    const int thread_num = 8;
+    const int order = 255;
+
+    assert(order > 2 && order <= ih_->file_hdr_->btree_order_);
+    ih_->file_hdr_->btree_order_ = order;
+
+    std::vector<int> keys;
+    for (int key = 1; key <= scale; key++) {
+        keys.push_back(key);
+    }
+    auto rng = std::default_random_engine{};
+    std::shuffle(keys.begin(), keys.end(), rng);
+
+    std::atomic<int> inserted{0};
+    LaunchParallelTest(thread_num, UniqueInsertHelper, ih_.get(), keys, &inserted);
+    EXPECT_EQ(inserted.load(), scale);
+
+    int current_key = 1;
+    IxScan scan(ih_.get(), ih_->leaf_begin(), ih_->leaf_end(), buffer_pool_manager_.get());
+    while (!scan.is_end()) {
+        auto rid = scan.rid();
+        EXPECT_GE(rid.page_no, 0);
+        EXPECT_LT(rid.page_no, thread_num);
+        EXPECT_EQ(rid.slot_no, current_key);
+        std::vector<Rid> rids;
+        EXPECT_TRUE(ih_->get_value((const char *)&current_key, &rids, nullptr));
+        EXPECT_EQ(rids, std::vector<Rid>{rid});
+        current_key++;
+        scan.next();
+    }
+    EXPECT_EQ(current_key, scale + 1);
+}
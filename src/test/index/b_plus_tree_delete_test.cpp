@@ -491,4 +491,68 @@ TEST_F(BPlusTreeTests, LargeScaleTest) {
     }
     std::cout << "Insert keys count: " << add_cnt << '\n' << "Delete keys count: " << del_cnt << '\n';
     check_all(ih_.get(), mock);
-}
\ No newline at end of file
+}
+/**
+ * @brief 批量删除：连续的一段key使多个叶子结点变空，随机的一部分key使叶子结点缺少多个键值对；
+ * 不存在的key、rid不相等的键值对不会被删除
+ */
+TEST_F(BPlusTreeTests, BatchDeleteTest) {
+    const int scale = 5000;
+    const int order = 8;
+
+    assert(order > 2 && order <= ih_->file_hdr_->btree_order_);
+    ih_->file_hdr_->btree_order_ = order;
+
+    std::vector<int> keys;
+    for (int key = 0; key < scale; key++) {
+        keys.push_back(key);
+    }
+    auto rng = std::default_random_engine{};
+    std::shuffle(keys.begin(), keys.end(), rng);
+    std::multimap<int, Rid> mock;
+    for (int key : keys) {
+        Rid rid = {.page_no = key / 100, .slot_no = key % 100};
+        ASSERT_NE(ih_->insert_entry((const char *)&key, rid, txn_.get()), IX_NO_PAGE);
+        mock.insert({key, rid});
+    }
+
+    auto batch_delete = [&](const std::vector<int> &batch) {
+        std::vector<Rid> rids;
+        int expected = 0;
+        for (int key : batch) {
+            rids.push_back(Rid{.page_no = key / 100, .slot_no = key % 100});
+            expected += mock.erase(key);
+        }
+        EXPECT_EQ(ih_->delete_entries((const char *)batch.data(), sizeof(int), rids.data(), batch.size(), txn_.get()),
+                  expected);
+        check_all(ih_.get(), mock);
+    };
+
+    // 连续的一段
+    std::vector<int> batch;
+    for (int key = 1000; key < 2000; key++) {
+        batch.push_back(key);
+    }
+    batch_delete(batch);
+
+    // 乱序的随机一部分，包括已经删除和从未插入的key
+    batch.clear();
+    for (int i = 0; i < scale / 2; i++) {
+        batch.push_back(keys[i]);
+    }
+    batch.push_back(scale + 1);
+    batch.push_back(-1);
+    batch_delete(batch);
+
+    // rid不相等
+    int key = mock.begin()->first;
+    Rid wrong = {.page_no = -1, .slot_no = -1};
+    EXPECT_EQ(ih_->delete_entries((const char *)&key, sizeof(int), &wrong, 1, txn_.get()), 0);
+
+    // 删除剩下的全部
+    batch.clear();
+    for (auto &entry : mock) {
+        batch.push_back(entry.first);
+    }
+    batch_delete(batch);
+}
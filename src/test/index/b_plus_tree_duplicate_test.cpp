@@ -0,0 +1,383 @@
+#include <algorithm>
+#include <cstdio>
+#include <random>  // for std::default_random_engine
+#include <set>
+#include <thread>  // NOLINT
+#include <tuple>
+
+#include "gtest/gtest.h"
+
+#define private public
+#include "index/ix.h"
+#undef private  // for use private variables in "ix.h"
+
+#include "storage/buffer_pool_manager.h"
+#include "system/sm.h"
+#include "record/rm.h"
+
+const std::string TEST_DB_NAME = "BPlusTreeDuplicateTest_db";  // 以数据库名作为根目录
+const std::string TEST_FILE_NAME = "table1";                   // 非唯一索引所在的表
+const std::vector<std::string> TEST_COL = {"col1"};
+
+using Entry = std::tuple<int, int, int>;  // (key, page_no, slot_no)，与索引中键值对的顺序一致
+
+/** 注意：每个测试点都在目录TEST_DB_NAME下重新创建表和非唯一索引，索引中同一个key对应多个rid */
+class BPlusTreeDuplicateTest : public ::testing::Test {
+   public:
+    std::unique_ptr<DiskManager> disk_manager_;
+    std::unique_ptr<BufferPoolManager> buffer_pool_manager_;
+    std::unique_ptr<IxManager> ix_manager_;
+    std::unique_ptr<IxIndexHandle> ih_;
+    std::unique_ptr<Transaction> txn_;
+    std::unique_ptr<RmManager> rm_;
+    std::unique_ptr<SmManager> sm_;
+
+   public:
+    void SetUp() override {
+        ::testing::Test::SetUp();
+        disk_manager_ = std::make_unique<DiskManager>();
+        buffer_pool_manager_ = std::make_unique<BufferPoolManager>(200, disk_manager_.get());
+        ix_manager_ = std::make_unique<IxManager>(disk_manager_.get(), buffer_pool_manager_.get());
+        txn_ = std::make_unique<Transaction>(0);
+        rm_ = std::make_unique<RmManager>(disk_manager_.get(), buffer_pool_manager_.get());
+        sm_ = std::make_unique<SmManager>(disk_manager_.get(), buffer_pool_manager_.get(), rm_.get(), ix_manager_.get());
+
+        if (disk_manager_->is_dir(TEST_DB_NAME)) {
+            std::string cmd = "rm -rf " + TEST_DB_NAME;
+            if (system(cmd.c_str()) < 0) {
+                throw UnixError();
+            }
+        }
+        sm_->create_db(TEST_DB_NAME);
+        assert(disk_manager_->is_dir(TEST_DB_NAME));
+        if (chdir(TEST_DB_NAME.c_str()) < 0) {
+            throw UnixError();
+        }
+        std::vector<ColDef> coldef;
+        coldef.push_back({"col1", TYPE_INT, 4});
+        coldef.push_back({"col2", TYPE_INT, 4});
+        sm_->create_table(TEST_FILE_NAME, coldef, nullptr);
+        sm_->create_index(TEST_FILE_NAME, TEST_COL, nullptr);
+        ih_ = ix_manager_->open_index(TEST_FILE_NAME, TEST_COL);
+        assert(!ih_->file_hdr_->unique_);
+        assert(ih_->file_hdr_->key_len() == sizeof(int));
+    }
+
+    void TearDown() override {
+        ix_manager_->close_index(ih_.get());
+        if (chdir("..") < 0) {
+            throw UnixError();
+        }
+        assert(disk_manager_->is_dir(TEST_DB_NAME));
+    }
+
+    static Rid make_rid(const Entry &entry) { return Rid{.page_no = std::get<1>(entry), .slot_no = std::get<2>(entry)}; }
+
+    /** 每个key的get_value按rid顺序返回全部rid，[lower_bound, upper_bound)恰好是这些键值对，整体扫描与mock一致 */
+    void check_all(IxIndexHandle *ih, const std::set<Entry> &mock) {
+        std::set<int> keys;
+        for (auto &entry : mock) {
+            keys.insert(std::get<0>(entry));
+        }
+        for (int key : keys) {
+            auto lower = mock.lower_bound(Entry{key, INT_MIN, INT_MIN});
+            auto upper = mock.upper_bound(Entry{key, INT_MAX, INT_MAX});
+            std::vector<Rid> result;
+            ASSERT_TRUE(ih->get_value((const char *)&key, &result, txn_.get()));
+            ASSERT_EQ(result.size(), std::distance(lower, upper));
+            auto it = lower;
+            for (auto &rid : result) {
+                ASSERT_EQ(rid, make_rid(*it++));
+            }
+
+            IxScan scan(ih, ih->lower_bound((const char *)&key), ih->upper_bound((const char *)&key),
+                        buffer_pool_manager_.get());
+            for (it = lower; it != upper; ++it, scan.next()) {
+                ASSERT_FALSE(scan.is_end());
+                ASSERT_EQ(scan.rid(), make_rid(*it));
+            }
+            EXPECT_TRUE(scan.is_end());
+        }
+
+        IxScan scan(ih, ih->leaf_begin(), ih->leaf_end(), buffer_pool_manager_.get());
+        auto it = mock.begin();
+        for (; !scan.is_end(); scan.next()) {
+            ASSERT_NE(it, mock.end());
+            int key;
+            scan.key((char *)&key);
+            ASSERT_EQ(key, std::get<0>(*it));
+            ASSERT_EQ(scan.rid(), make_rid(*it));
+            ++it;
+        }
+        EXPECT_EQ(it, mock.end());
+    }
+};
+
+/**
+ * @brief 每个key对应很多rid，相同key的键值对跨越多个叶子结点；按(key, rid)删除其中一半后检查
+ */
+TEST_F(BPlusTreeDuplicateTest, InsertDeleteTest) {
+    const int num_keys = 50;
+    const int dup = 40;
+    ih_->file_hdr_->btree_order_ = 8;  // 较小的order使相同的key分布在多个结点中
+
+    std::vector<Entry> entries;
+    for (int key = 0; key < num_keys; key++) {
+        for (int i = 0; i < dup; i++) {
+            entries.emplace_back(key, i % 7, key * dup + i);
+        }
+    }
+    auto rng = std::default_random_engine{};
+    std::shuffle(entries.begin(), entries.end(), rng);
+
+    std::set<Entry> mock;
+    for (auto &entry : entries) {
+        int key = std::get<0>(entry);
+        ASSERT_NE(ih_->insert_entry((const char *)&key, make_rid(entry), txn_.get()), IX_NO_PAGE);
+        mock.insert(entry);
+    }
+    // 同一个(key, rid)不能重复插入
+    int key = std::get<0>(entries[0]);
+    EXPECT_EQ(ih_->insert_entry((const char *)&key, make_rid(entries[0]), txn_.get()), IX_NO_PAGE);
+    check_all(ih_.get(), mock);
+
+    std::shuffle(entries.begin(), entries.end(), rng);
+    for (size_t i = 0; i < entries.size() / 2; i++) {
+        key = std::get<0>(entries[i]);
+        ASSERT_TRUE(ih_->delete_entry((const char *)&key, make_rid(entries[i]), txn_.get()));
+        mock.erase(entries[i]);
+    }
+    // 已经删除的键值对、key存在但rid不同的键值对都不会被删除
+    key = std::get<0>(entries[0]);
+    EXPECT_FALSE(ih_->delete_entry((const char *)&key, make_rid(entries[0]), txn_.get()));
+    EXPECT_FALSE(ih_->delete_entry((const char *)&key, Rid{.page_no = 100, .slot_no = 0}, txn_.get()));
+    check_all(ih_.get(), mock);
+
+    // 只给出key时删除rid最小的一个
+    key = std::get<0>(*mock.begin());
+    ASSERT_TRUE(ih_->delete_entry((const char *)&key, txn_.get()));
+    mock.erase(mock.begin());
+    check_all(ih_.get(), mock);
+
+    for (size_t i = entries.size() / 2; i < entries.size(); i++) {
+        key = std::get<0>(entries[i]);
+        if (mock.count(entries[i])) {
+            ASSERT_TRUE(ih_->delete_entry((const char *)&key, make_rid(entries[i]), txn_.get()));
+            mock.erase(entries[i]);
+        }
+    }
+    EXPECT_TRUE(mock.empty());
+    std::vector<Rid> result;
+    EXPECT_FALSE(ih_->get_value((const char *)&key, &result, txn_.get()));
+    check_all(ih_.get(), mock);
+}
+
+/**
+ * @brief 批量构建时相同的key全部保留
+ */
+TEST_F(BPlusTreeDuplicateTest, BulkLoadTest) {
+    const int scale = 20000;
+    std::vector<Entry> entries;
+    for (int id = 0; id < scale; id++) {
+        entries.emplace_back(id % 100, id / 100, id % 100);
+    }
+    std::shuffle(entries.begin(), entries.end(), std::default_random_engine{});
+
+    std::set<Entry> mock;
+    {
+        IxBulkLoader loader(ih_.get(), "bulk_load_test", 1000 * (ih_->file_hdr_->col_tot_len_ + sizeof(Rid)));
+        for (auto &entry : entries) {
+            int key = std::get<0>(entry);
+            loader.add((const char *)&key, make_rid(entry));
+            mock.insert(entry);
+        }
+        loader.finish(0.7);
+        EXPECT_FALSE(loader.has_duplicate());
+    }
+    check_all(ih_.get(), mock);
+
+    for (int i = 0; i < 2000; i++) {
+        int key = std::get<0>(entries[i]);
+        ASSERT_TRUE(ih_->delete_entry((const char *)&key, make_rid(entries[i]), txn_.get()));
+        mock.erase(entries[i]);
+    }
+    check_all(ih_.get(), mock);
+}
+
+/**
+ * @brief 写者插入和删除一部分键值对时，读者读到的其余键值对始终完整
+ */
+TEST_F(BPlusTreeDuplicateTest, ConcurrentTest) {
+    const int num_keys = 20;
+    const int dup = 200;
+    const int writer_num = 4;
+    const int reader_num = 4;
+    ih_->file_hdr_->btree_order_ = 16;  // 较小的order使分裂与合并更频繁
+
+    // 每个key的偶数slot_no的键值对一直存在，奇数的由写者反复插入和删除
+    for (int key = 0; key < num_keys; key++) {
+        for (int i = 0; i < dup; i += 2) {
+            ih_->insert_entry((const char *)&key, Rid{.page_no = key, .slot_no = i}, txn_.get());
+        }
+    }
+    auto writer = [&](int thread_itr) {
+        Transaction transaction(thread_itr + 1);
+        for (int round = 0; round < 3; round++) {
+            for (int key = 0; key < num_keys; key++) {
+                for (int i = 1 + 2 * thread_itr; i < dup; i += 2 * writer_num) {
+                    ih_->insert_entry((const char *)&key, Rid{.page_no = key, .slot_no = i}, &transaction);
+                }
+            }
+            for (int key = 0; key < num_keys; key++) {
+                for (int i = 1 + 2 * thread_itr; i < dup; i += 2 * writer_num) {
+                    ih_->delete_entry((const char *)&key, Rid{.page_no = key, .slot_no = i}, &transaction);
+                }
+            }
+        }
+    };
+    auto reader = [&](int thread_itr) {
+        std::default_random_engine rng(thread_itr);
+        for (int i = 0; i < 2000; i++) {
+            int key = rng() % num_keys;
+            std::vector<Rid> rids;
+            ih_->get_value((const char *)&key, &rids, nullptr);
+            int stable = 0;
+            for (size_t j = 0; j < rids.size(); j++) {
+                ASSERT_EQ(rids[j].page_no, key);
+                ASSERT_TRUE(j == 0 || rids[j - 1].slot_no < rids[j].slot_no);
+                stable += rids[j].slot_no % 2 == 0;
+            }
+            ASSERT_EQ(stable, dup / 2);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < writer_num; i++) {
+        threads.emplace_back(writer, i);
+    }
+    for (int i = 0; i < reader_num; i++) {
+        threads.emplace_back(reader, i);
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    std::set<Entry> mock;
+    for (int key = 0; key < num_keys; key++) {
+        for (int i = 0; i < dup; i += 2) {
+            mock.emplace(key, key, i);
+        }
+    }
+    check_all(ih_.get(), mock);
+}
+
+/**
+ * @brief 非唯一索引的自适应哈希记录key的第一个键值对所在的叶子结点，相同key跨越多个叶子结点时仍返回全部rid
+ */
+TEST_F(BPlusTreeDuplicateTest, AdaptiveHashTest) {
+    const int num_keys = 30;
+    const int dup = 25;
+    ih_->file_hdr_->btree_order_ = 8;
+
+    std::set<Entry> mock;
+    for (int i = 0; i < dup; i++) {
+        for (int key = 0; key < num_keys; key++) {
+            Entry entry{key, i, key};
+            ih_->insert_entry((const char *)&key, make_rid(entry), txn_.get());
+            mock.insert(entry);
+        }
+    }
+    for (int round = 0; round < IX_AHI_SAMPLE_RATE * (IX_AHI_BUILD_THRESHOLD + 2); round++) {
+        check_all(ih_.get(), mock);
+    }
+    uint64_t hits = ih_->ahi_hits_;
+    EXPECT_GT(hits, 0);
+
+    // 删除每个key的一部分键值对，包括原来第一个键值对，叶子结点合并后记录失效
+    for (int key = 0; key < num_keys; key++) {
+        for (int i = 0; i < dup; i += 2) {
+            Entry entry{key, i, key};
+            ASSERT_TRUE(ih_->delete_entry((const char *)&key, make_rid(entry), txn_.get()));
+            mock.erase(entry);
+        }
+    }
+    for (int round = 0; round < IX_AHI_SAMPLE_RATE * (IX_AHI_BUILD_THRESHOLD + 2); round++) {
+        check_all(ih_.get(), mock);
+    }
+    EXPECT_GT(ih_->ahi_hits_, hits);
+}
+
+/**
+ * @brief 非唯一索引的自适应哈希建立之后，逐个插入热点key的新rid使记录的叶子结点分裂，
+ * 再逐个删除使结点合并和重分配，每次修改之后立即检查热点key返回的全部rid
+ */
+TEST_F(BPlusTreeDuplicateTest, AdaptiveHashSplitTest) {
+    const int num_keys = 20;
+    const int hot = 5;
+    const int dup = 4;
+    const int extra = 12;
+    ih_->file_hdr_->btree_order_ = 4;
+
+    std::set<Entry> mock;
+    auto check_key = [&](int key) {
+        auto lower = mock.lower_bound(Entry{key, INT_MIN, INT_MIN});
+        auto upper = mock.upper_bound(Entry{key, INT_MAX, INT_MAX});
+        std::vector<Rid> result;
+        ASSERT_EQ(ih_->get_value((const char *)&key, &result, txn_.get()), lower != upper) << key;
+        ASSERT_EQ(result.size(), std::distance(lower, upper)) << key;
+        for (auto &rid : result) {
+            ASSERT_EQ(rid, make_rid(*lower++));
+        }
+    };
+    auto check_hot = [&]() {
+        for (int key = 0; key < hot; key++) {
+            check_key(key);
+        }
+    };
+
+    for (int key = 0; key < num_keys; key++) {
+        for (int i = 0; i < dup; i++) {
+            Entry entry{key, i, key};
+            ih_->insert_entry((const char *)&key, make_rid(entry), txn_.get());
+            mock.insert(entry);
+        }
+    }
+    for (int round = 0; round < IX_AHI_SAMPLE_RATE * (IX_AHI_BUILD_THRESHOLD + 2); round++) {
+        check_hot();
+    }
+    uint64_t hits = ih_->ahi_hits_;
+    EXPECT_GT(hits, 0);
+
+    // 新rid有的排在原来的第一个键值对之前，有的排在最后，相同key的键值对不断分裂到更多叶子结点
+    for (int i = 0; i < extra; i++) {
+        for (int key = 0; key < hot; key++) {
+            Entry entry{key, i % 2 ? -i : dup + i, key};
+            ih_->insert_entry((const char *)&key, make_rid(entry), txn_.get());
+            mock.insert(entry);
+            check_hot();
+        }
+    }
+    EXPECT_GT(ih_->ahi_hits_, hits);
+
+    hits = ih_->ahi_hits_;
+    for (int i = 0; i < extra; i++) {
+        for (int key = 0; key < hot; key++) {
+            Entry entry{key, i % 2 ? -i : dup + i, key};
+            ASSERT_TRUE(ih_->delete_entry((const char *)&key, make_rid(entry), txn_.get()));
+            mock.erase(entry);
+            check_hot();
+        }
+    }
+    EXPECT_GT(ih_->ahi_hits_, hits);
+
+    // 最后删除热点key的全部键值对：合并后释放的叶子结点中仍留有被删除的键值对，不能再从那里找到
+    for (int i = 0; i < dup; i++) {
+        for (int key = 0; key < hot; key++) {
+            Entry entry{key, i, key};
+            ASSERT_TRUE(ih_->delete_entry((const char *)&key, make_rid(entry), txn_.get()));
+            mock.erase(entry);
+            check_hot();
+        }
+    }
+    check_all(ih_.get(), mock);
+}
@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <cstdio>
+#include <map>
 #include <random>  // for std::default_random_engine
 
 #include "gtest/gtest.h"
@@ -15,6 +16,7 @@ const std::string TEST_DB_NAME = "BPlusTreeInsertTest_db";  // 以数据库名
 const std::string TEST_FILE_NAME = "table1";                // 测试文件名的前缀
 // const int index_no = 0;                                     // 索引编号
 const std::vector<std::string> TEST_COL = {"col1"};
+const std::vector<std::string> UNIQUE_COL = {"col2"};  // 唯一索引测试点的索引字段
 // 创建的索引文件名为"table1.0.idx"（TEST_FILE_NAME + index_no + .idx）
 
 /** 注意：每个测试点只测试了单个文件！
@@ -305,6 +307,18 @@ class BPlusTreeTests : public ::testing::Test {
 
 };
 
+/** 在同一张表的col2上建立唯一索引，结点中只保存key */
+class BPlusTreeUniqueTests : public BPlusTreeTests {
+   public:
+    void SetUp() override {
+        BPlusTreeTests::SetUp();
+        ix_manager_->close_index(ih_.get());
+        sm_->create_index(TEST_FILE_NAME, UNIQUE_COL, nullptr, true);
+        ih_ = ix_manager_->open_index(TEST_FILE_NAME, UNIQUE_COL);
+        assert(ih_->file_hdr_->unique_);
+    }
+};
+
 /**
  * @brief 插入10个key，范围为1~10，插入的value取key的低32位，使用GetValue()函数测试插入的value(即Rid)是否正确
  * 每次插入后都会调用Draw()函数生成一个B+树的图
@@ -362,7 +376,7 @@ TEST_F(BPlusTreeTests, InsertTest) {
  */
 TEST_F(BPlusTreeTests, LargeScaleTest) {
     const int64_t scale = 10000;
-    const int order = 256;
+    const int order = 200;  // 非唯一索引的key附加了8字节的rid，单列INT索引的结点最多放下202个键值对
 
     assert(order > 2 && order <= ih_->file_hdr_->btree_order_);
     ih_->file_hdr_->btree_order_ = order;
@@ -414,4 +428,262 @@ TEST_F(BPlusTreeTests, LargeScaleTest) {
         scan.next();
     }
     EXPECT_EQ(current_key, keys.size() + 1);
-}
\ No newline at end of file
+}
+/**
+ * @brief 乱序给出1~10000，通过IxBulkLoader批量构建B+树
+ * 限制排序可用的内存，使其写出多个有序段后再归并；构建完成后继续调用insert_entry插入
+ */
+TEST_F(BPlusTreeTests, BulkLoadTest) {
+    const int scale = 10000;
+    const int order = 64;
+
+    assert(order > 2 && order <= ih_->file_hdr_->btree_order_);
+    ih_->file_hdr_->btree_order_ = order;
+
+    std::vector<int> keys;
+    for (int key = 1; key <= scale; key++) {
+        keys.push_back(key);
+    }
+    auto rng = std::default_random_engine{};
+    std::shuffle(keys.begin(), keys.end(), rng);
+
+    std::multimap<int, Rid> mock;
+    {
+        IxBulkLoader loader(ih_.get(), "bulk_load_test", 1000 * (sizeof(int) + sizeof(Rid)));
+        for (auto key : keys) {
+            Rid rid = {.page_no = key / 100, .slot_no = key % 100};
+            loader.add((const char *)&key, rid);
+            mock.insert({key, rid});
+        }
+        loader.finish(0.7);
+    }
+    check_all(ih_.get(), mock);
+
+    for (int key = scale + 1; key <= scale + 1000; key++) {
+        Rid rid = {.page_no = key / 100, .slot_no = key % 100};
+        ih_->insert_entry((const char *)&key, rid, txn_.get());
+        mock.insert({key, rid});
+    }
+    check_all(ih_.get(), mock);
+}
+
+/**
+ * @brief 分裂后文件头的页号字段已经写入缓冲池中的文件头页面，刷盘后从磁盘读出的文件头与内存中一致；
+ * 关闭后重新打开索引，查询结果不变
+ */
+TEST_F(BPlusTreeTests, FileHdrTest) {
+    const int scale = 5000;
+    const int order = 16;
+
+    assert(order > 2 && order <= ih_->file_hdr_->btree_order_);
+    ih_->file_hdr_->btree_order_ = order;
+
+    Transaction txn(1);
+    txn.set_prev_lsn(42);
+    for (int key = 1; key <= scale; key++) {
+        ih_->insert_entry((const char *)&key, Rid{.page_no = key, .slot_no = key}, &txn);
+    }
+    EXPECT_NE(ih_->file_hdr_->root_page_, IX_INIT_ROOT_PAGE);
+    EXPECT_EQ(ih_->file_hdr_page_->get_page_lsn(), 42);
+
+    buffer_pool_manager_->flush_page(ih_->file_hdr_page_->get_page_id());
+    char buf[PAGE_SIZE];
+    disk_manager_->read_page(ih_->fd_, IX_FILE_HDR_PAGE, buf, PAGE_SIZE);
+    IxFileHdr on_disk;
+    on_disk.deserialize(buf + IX_FILE_HDR_OFFSET);
+    EXPECT_EQ(on_disk.root_page_, ih_->file_hdr_->root_page_);
+    EXPECT_EQ(on_disk.num_pages_, ih_->file_hdr_->num_pages_);
+    EXPECT_EQ(on_disk.first_leaf_, ih_->file_hdr_->first_leaf_);
+    EXPECT_EQ(on_disk.last_leaf_, ih_->file_hdr_->last_leaf_);
+
+    ix_manager_->close_index(ih_.get());
+    ih_ = ix_manager_->open_index(TEST_FILE_NAME, TEST_COL);
+    EXPECT_EQ(ih_->file_hdr_->root_page_, on_disk.root_page_);
+    EXPECT_EQ(ih_->file_hdr_->last_leaf_, on_disk.last_leaf_);
+    for (int key = 1; key <= scale; key++) {
+        std::vector<Rid> rids;
+        ASSERT_TRUE(ih_->get_value((const char *)&key, &rids, nullptr));
+        ASSERT_EQ(rids[0].slot_no, key);
+    }
+}
+
+/**
+ * @brief 反复查找的key建立自适应哈希后直接定位到叶子结点；之后的分裂与合并使记录失效，查询结果始终正确
+ */
+TEST_F(BPlusTreeUniqueTests, AdaptiveHashTest) {
+    const int scale = 2000;
+    const int hot = 50;
+    const int order = 8;
+
+    assert(order > 2 && order <= ih_->file_hdr_->btree_order_);
+    ih_->file_hdr_->btree_order_ = order;
+
+    std::multimap<int, Rid> mock;
+    for (int key = 1; key <= scale; key += 2) {
+        Rid rid = {.page_no = key / 100, .slot_no = key % 100};
+        ih_->insert_entry((const char *)&key, rid, txn_.get());
+        mock.insert({key, rid});
+    }
+    auto check_hot = [&]() {
+        for (int round = 0; round < IX_AHI_SAMPLE_RATE * (IX_AHI_BUILD_THRESHOLD + 2); round++) {
+            for (int key = 1; key <= 2 * hot; key++) {
+                std::vector<Rid> rids;
+                auto it = mock.find(key);
+                ASSERT_EQ(ih_->get_value((const char *)&key, &rids, txn_.get()), it != mock.end());
+                if (it != mock.end()) {
+                    ASSERT_EQ(rids.size(), 1);
+                    ASSERT_EQ(rids[0], it->second);
+                } else {
+                    ASSERT_TRUE(rids.empty());
+                }
+            }
+        }
+    };
+
+    check_hot();
+    uint64_t hits = ih_->ahi_hits_;
+    EXPECT_GT(hits, 0);
+    // 找不到的key不会建立记录
+    size_t recorded = 0;
+    for (size_t i = 0; i < IX_AHI_SLOTS; i++) {
+        if (ih_->ahi_slots_[i].leaf_page_no != IX_NO_PAGE) {
+            int key = *(int *)(ih_->ahi_keys_.get() + i * sizeof(int));
+            EXPECT_TRUE(mock.count(key)) << key;
+            recorded++;
+        }
+    }
+    EXPECT_GT(recorded, 0);
+    EXPECT_LE(recorded, hot);
+
+    // 插入偶数key使叶子结点分裂，之前的记录全部失效
+    for (int key = 2; key <= scale; key += 2) {
+        Rid rid = {.page_no = key / 100, .slot_no = key % 100};
+        ih_->insert_entry((const char *)&key, rid, txn_.get());
+        mock.insert({key, rid});
+    }
+    check_hot();
+    EXPECT_GT(ih_->ahi_hits_, hits);
+
+    // 删除使叶子结点合并和重分配
+    hits = ih_->ahi_hits_;
+    for (int key = 1; key <= scale; key += 3) {
+        ASSERT_TRUE(ih_->delete_entry((const char *)&key, txn_.get()));
+        mock.erase(key);
+    }
+    check_hot();
+    EXPECT_GT(ih_->ahi_hits_, hits);
+    check_all(ih_.get(), mock);
+}
+
+/**
+ * @brief 自适应哈希建立之后，每次插入或删除一个key都可能使记录的叶子结点分裂、合并或重分配，
+ * 每次修改之后立即查找全部热点key，结果与mock一致
+ */
+TEST_F(BPlusTreeUniqueTests, AdaptiveHashSplitTest) {
+    const int hot = 20;
+    const int step = 10;
+    ih_->file_hdr_->btree_order_ = 4;
+
+    std::map<int, Rid> mock;
+    auto insert = [&](int key) {
+        Rid rid = {.page_no = key / 100, .slot_no = key % 100};
+        ih_->insert_entry((const char *)&key, rid, txn_.get());
+        mock[key] = rid;
+    };
+    auto check_key = [&](int key) {
+        std::vector<Rid> rids;
+        auto it = mock.find(key);
+        ASSERT_EQ(ih_->get_value((const char *)&key, &rids, txn_.get()), it != mock.end()) << key;
+        if (it != mock.end()) {
+            ASSERT_EQ(rids.size(), 1);
+            ASSERT_EQ(rids[0], it->second);
+        } else {
+            ASSERT_TRUE(rids.empty());
+        }
+    };
+    auto check_hot = [&]() {
+        for (int key = step; key <= hot * step; key += step) {
+            check_key(key);
+        }
+    };
+
+    for (int key = step; key <= 2 * hot * step; key += step) {
+        insert(key);
+    }
+    for (int round = 0; round < IX_AHI_SAMPLE_RATE * (IX_AHI_BUILD_THRESHOLD + 2); round++) {
+        check_hot();
+    }
+    uint64_t hits = ih_->ahi_hits_;
+    EXPECT_GT(hits, 0);
+
+    // 在热点key之间插入，记录的叶子结点不断分裂，热点key被移到新结点
+    for (int offset = 1; offset < step; offset++) {
+        for (int key = step; key <= hot * step; key += step) {
+            insert(key + offset);
+            check_key(key + offset);
+            check_hot();
+        }
+    }
+    EXPECT_GT(ih_->ahi_hits_, hits);
+
+    // 再逐个删除，叶子结点合并和重分配
+    hits = ih_->ahi_hits_;
+    for (int offset = 1; offset < step; offset++) {
+        for (int key = step + offset; key <= hot * step + offset; key += step) {
+            ASSERT_TRUE(ih_->delete_entry((const char *)&key, txn_.get()));
+            mock.erase(key);
+            check_key(key);
+            check_hot();
+        }
+    }
+    EXPECT_GT(ih_->ahi_hits_, hits);
+
+    // 最后删除热点key本身：合并后释放的叶子结点中仍留有被删除的key，不能再从那里找到
+    for (int key = step; key <= hot * step; key += step) {
+        ASSERT_TRUE(ih_->delete_entry((const char *)&key, txn_.get()));
+        mock.erase(key);
+        check_hot();
+    }
+}
+
+/**
+ * @brief 唯一索引：随机插入1~10000，已存在的key不能再插入；查询和扫描结果只有第一次插入的rid
+ */
+TEST_F(BPlusTreeUniqueTests, LargeScaleTest) {
+    const int scale = 10000;
+    const int order = 256;
+
+    assert(order > 2 && order <= ih_->file_hdr_->btree_order_);
+    ih_->file_hdr_->btree_order_ = order;
+
+    std::vector<int> keys;
+    for (int key = 1; key <= scale; key++) {
+        keys.push_back(key);
+    }
+    auto rng = std::default_random_engine{};
+    std::shuffle(keys.begin(), keys.end(), rng);
+
+    for (auto key : keys) {
+        ASSERT_NE(ih_->insert_entry((const char *)&key, Rid{.page_no = 0, .slot_no = key}, txn_.get()), IX_NO_PAGE);
+    }
+    for (auto key : keys) {
+        ASSERT_EQ(ih_->insert_entry((const char *)&key, Rid{.page_no = 1, .slot_no = key}, txn_.get()), IX_NO_PAGE);
+    }
+
+    std::vector<Rid> rids;
+    for (auto key : keys) {
+        rids.clear();
+        ASSERT_TRUE(ih_->get_value((const char *)&key, &rids, txn_.get()));
+        ASSERT_EQ(rids.size(), 1);
+        EXPECT_EQ(rids[0], (Rid{.page_no = 0, .slot_no = key}));
+    }
+
+    int current_key = 1;
+    IxScan scan(ih_.get(), ih_->leaf_begin(), ih_->leaf_end(), buffer_pool_manager_.get());
+    while (!scan.is_end()) {
+        EXPECT_EQ(scan.rid(), (Rid{.page_no = 0, .slot_no = current_key}));
+        current_key++;
+        scan.next();
+    }
+    EXPECT_EQ(current_key, scale + 1);
+}
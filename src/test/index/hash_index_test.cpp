@@ -0,0 +1,284 @@
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <random>  // for std::default_random_engine
+#include <thread>  // NOLINT
+
+#include "gtest/gtest.h"
+
+#define private public
+#include "index/ix.h"
+#undef private  // for use private variables in "ix.h"
+
+#include "storage/buffer_pool_manager.h"
+#include "system/sm.h"
+#include "record/rm.h"
+
+const std::string TEST_DB_NAME = "HashIndexTest_db";  // 以数据库名作为根目录
+const std::string TEST_FILE_NAME = "table1";          // 索引文件名的前缀
+
+/** 注意：每个测试点都在目录TEST_DB_NAME下重新创建哈希索引，索引字段由测试点给出 */
+class HashIndexTest : public ::testing::Test {
+   public:
+    std::unique_ptr<DiskManager> disk_manager_;
+    std::unique_ptr<BufferPoolManager> buffer_pool_manager_;
+    std::unique_ptr<IxManager> ix_manager_;
+    std::unique_ptr<IxHashIndexHandle> ih_;
+    std::unique_ptr<Transaction> txn_;
+    std::unique_ptr<RmManager> rm_;
+    std::unique_ptr<SmManager> sm_;
+    std::vector<ColMeta> cols_;
+
+   public:
+    void SetUp() override {
+        ::testing::Test::SetUp();
+        disk_manager_ = std::make_unique<DiskManager>();
+        buffer_pool_manager_ = std::make_unique<BufferPoolManager>(200, disk_manager_.get());
+        ix_manager_ = std::make_unique<IxManager>(disk_manager_.get(), buffer_pool_manager_.get());
+        txn_ = std::make_unique<Transaction>(0);
+        rm_ = std::make_unique<RmManager>(disk_manager_.get(), buffer_pool_manager_.get());
+        sm_ = std::make_unique<SmManager>(disk_manager_.get(), buffer_pool_manager_.get(), rm_.get(), ix_manager_.get());
+
+        if (disk_manager_->is_dir(TEST_DB_NAME)) {
+            std::string cmd = "rm -rf " + TEST_DB_NAME;
+            if (system(cmd.c_str()) < 0) {
+                throw UnixError();
+            }
+        }
+        sm_->create_db(TEST_DB_NAME);
+        assert(disk_manager_->is_dir(TEST_DB_NAME));
+        if (chdir(TEST_DB_NAME.c_str()) < 0) {
+            throw UnixError();
+        }
+    }
+
+    void TearDown() override {
+        if (ih_ != nullptr) {
+            ix_manager_->close_hash_index(ih_.get());
+        }
+        if (chdir("..") < 0) {
+            throw UnixError();
+        }
+        assert(disk_manager_->is_dir(TEST_DB_NAME));
+    }
+
+    void create_index(ColType type, int len, bool unique) {
+        cols_ = {ColMeta{.tab_name = TEST_FILE_NAME, .name = "col1", .type = type, .len = len, .offset = 0, .index = true}};
+        ix_manager_->create_hash_index(TEST_FILE_NAME, cols_, unique);
+        ih_ = ix_manager_->open_hash_index(TEST_FILE_NAME, cols_);
+    }
+
+    void reopen_index() {
+        ix_manager_->close_hash_index(ih_.get());
+        ih_ = ix_manager_->open_hash_index(TEST_FILE_NAME, cols_);
+    }
+
+    /** 每个key的get_value按rid顺序返回全部rid */
+    void check_all(const std::multimap<int, Rid> &mock, int max_key) {
+        for (int key = 0; key < max_key; key++) {
+            auto [begin, end] = mock.equal_range(key);
+            std::vector<Rid> expected;
+            for (auto it = begin; it != end; ++it) {
+                expected.push_back(it->second);
+            }
+            std::sort(expected.begin(), expected.end(), [](const Rid &a, const Rid &b) {
+                return std::make_pair(a.page_no, a.slot_no) < std::make_pair(b.page_no, b.slot_no);
+            });
+            std::vector<Rid> result;
+            ASSERT_EQ(ih_->get_value((const char *)&key, &result, txn_.get()), !expected.empty());
+            ASSERT_EQ(result, expected);
+        }
+    }
+};
+
+/**
+ * @brief 唯一索引：插入足够多的key使桶多次分裂、目录多次翻倍，再删除一半后检查
+ */
+TEST_F(HashIndexTest, InsertDeleteTest) {
+    create_index(TYPE_INT, sizeof(int), true);
+    const int scale = 10000;
+    std::vector<int> keys(scale);
+    for (int i = 0; i < scale; i++) {
+        keys[i] = i;
+    }
+    auto rng = std::default_random_engine{};
+    std::shuffle(keys.begin(), keys.end(), rng);
+
+    std::multimap<int, Rid> mock;
+    for (int key : keys) {
+        Rid rid = {.page_no = key / 100, .slot_no = key % 100};
+        ASSERT_NE(ih_->insert_entry((const char *)&key, rid, txn_.get()), IX_NO_PAGE);
+        mock.emplace(key, rid);
+    }
+    // 目录翻倍后能放下全部key，不需要溢出页
+    EXPECT_GE(1 << ih_->get_global_depth(), scale / BUCKET_SIZE);
+    EXPECT_LE(ih_->get_global_depth(), IX_HASH_MAX_DEPTH);
+    // 唯一索引中已有的key不能再插入
+    EXPECT_EQ(ih_->insert_entry((const char *)&keys[0], Rid{.page_no = 1000, .slot_no = 0}, txn_.get()), IX_NO_PAGE);
+    check_all(mock, scale + 10);
+
+    std::shuffle(keys.begin(), keys.end(), rng);
+    for (int i = 0; i < scale / 2; i++) {
+        int key = keys[i];
+        Rid rid = {.page_no = key / 100, .slot_no = key % 100};
+        // rid不同时不删除
+        EXPECT_FALSE(ih_->delete_entry((const char *)&key, Rid{.page_no = 1000, .slot_no = 0}, txn_.get()));
+        ASSERT_TRUE(ih_->delete_entry((const char *)&key, rid, txn_.get()));
+        mock.erase(key);
+    }
+    EXPECT_FALSE(ih_->delete_entry((const char *)&keys[0], Rid{.page_no = keys[0] / 100, .slot_no = keys[0] % 100},
+                                   txn_.get()));
+    check_all(mock, scale + 10);
+
+    // 删除后的key可以重新插入
+    for (int i = 0; i < scale / 2; i++) {
+        int key = keys[i];
+        Rid rid = {.page_no = key / 100, .slot_no = key % 100};
+        ASSERT_NE(ih_->insert_entry((const char *)&key, rid, txn_.get()), IX_NO_PAGE);
+        mock.emplace(key, rid);
+    }
+    check_all(mock, scale + 10);
+}
+
+/**
+ * @brief 非唯一索引：同一个key的键值对放不下一个桶时挂溢出页，其余key仍按分裂处理
+ */
+TEST_F(HashIndexTest, DuplicateTest) {
+    create_index(TYPE_INT, sizeof(int), false);
+    const int num_keys = 200;
+    const int hot_dup = 5 * BUCKET_SIZE;  // 热点key需要多个溢出页
+    std::vector<std::pair<int, Rid>> entries;
+    for (int key = 0; key < num_keys; key++) {
+        int dup = key % 50 == 0 ? hot_dup : 3;
+        for (int i = 0; i < dup; i++) {
+            entries.emplace_back(key, Rid{.page_no = i % 7, .slot_no = key * 1000 + i});
+        }
+    }
+    auto rng = std::default_random_engine{};
+    std::shuffle(entries.begin(), entries.end(), rng);
+
+    std::multimap<int, Rid> mock;
+    for (auto &[key, rid] : entries) {
+        ASSERT_NE(ih_->insert_entry((const char *)&key, rid, txn_.get()), IX_NO_PAGE);
+        mock.emplace(key, rid);
+    }
+    // 同一个(key, rid)不能重复插入，key相同rid不同可以
+    EXPECT_EQ(ih_->insert_entry((const char *)&entries[0].first, entries[0].second, txn_.get()), IX_NO_PAGE);
+    // 重复的key不会使目录无限翻倍
+    EXPECT_LT(ih_->get_global_depth(), IX_HASH_MAX_DEPTH);
+    check_all(mock, num_keys);
+
+    std::shuffle(entries.begin(), entries.end(), rng);
+    for (size_t i = 0; i < entries.size() / 2; i++) {
+        auto &[key, rid] = entries[i];
+        ASSERT_TRUE(ih_->delete_entry((const char *)&key, rid, txn_.get()));
+        auto range = mock.equal_range(key);
+        mock.erase(std::find_if(range.first, range.second, [&](const auto &entry) { return entry.second == rid; }));
+    }
+    check_all(mock, num_keys);
+}
+
+/**
+ * @brief 关闭后重新打开，目录和桶都从文件中读出
+ */
+TEST_F(HashIndexTest, ReopenTest) {
+    create_index(TYPE_INT, sizeof(int), true);
+    const int scale = 3000;
+    std::multimap<int, Rid> mock;
+    for (int key = 0; key < scale; key++) {
+        Rid rid = {.page_no = key, .slot_no = key};
+        ASSERT_NE(ih_->insert_entry((const char *)&key, rid, txn_.get()), IX_NO_PAGE);
+        mock.emplace(key, rid);
+    }
+    int global_depth = ih_->get_global_depth();
+    int num_pages = ih_->file_hdr_->num_pages_;
+    reopen_index();
+    EXPECT_EQ(ih_->get_global_depth(), global_depth);
+    EXPECT_EQ(ih_->file_hdr_->num_pages_, num_pages);
+    check_all(mock, scale);
+
+    // 重新打开后继续插入，新页面不会覆盖已有的页面
+    for (int key = scale; key < 2 * scale; key++) {
+        Rid rid = {.page_no = key, .slot_no = key};
+        ASSERT_NE(ih_->insert_entry((const char *)&key, rid, txn_.get()), IX_NO_PAGE);
+        mock.emplace(key, rid);
+    }
+    reopen_index();
+    check_all(mock, 2 * scale);
+}
+
+/**
+ * @brief float的0和-0比较结果相等，哈希值也必须相同
+ */
+TEST_F(HashIndexTest, FloatKeyTest) {
+    create_index(TYPE_FLOAT, sizeof(float), true);
+    float zero = 0.0f;
+    float neg_zero = -0.0f;
+    ASSERT_NE(ih_->insert_entry((const char *)&neg_zero, Rid{.page_no = 1, .slot_no = 1}, txn_.get()), IX_NO_PAGE);
+    EXPECT_EQ(ih_->insert_entry((const char *)&zero, Rid{.page_no = 1, .slot_no = 2}, txn_.get()), IX_NO_PAGE);
+    std::vector<Rid> result;
+    ASSERT_TRUE(ih_->get_value((const char *)&zero, &result, txn_.get()));
+    EXPECT_EQ(result, std::vector<Rid>{(Rid{.page_no = 1, .slot_no = 1})});
+    EXPECT_TRUE(ih_->delete_entry((const char *)&zero, Rid{.page_no = 1, .slot_no = 1}, txn_.get()));
+}
+
+/**
+ * @brief 写者插入和删除各自的key时，读者始终能找到一直存在的key
+ */
+TEST_F(HashIndexTest, ConcurrentTest) {
+    create_index(TYPE_INT, sizeof(int), true);
+    const int stable_keys = 2000;
+    const int writer_num = 4;
+    const int reader_num = 4;
+    const int keys_per_writer = 2000;
+    for (int key = 0; key < stable_keys; key++) {
+        ih_->insert_entry((const char *)&key, Rid{.page_no = key, .slot_no = 0}, txn_.get());
+    }
+
+    auto writer = [&](int thread_itr) {
+        Transaction transaction(thread_itr + 1);
+        int base = stable_keys + thread_itr * keys_per_writer;
+        for (int round = 0; round < 2; round++) {
+            for (int key = base; key < base + keys_per_writer; key++) {
+                ASSERT_NE(ih_->insert_entry((const char *)&key, Rid{.page_no = key, .slot_no = 1}, &transaction),
+                          IX_NO_PAGE);
+            }
+            for (int key = base; key < base + keys_per_writer; key += 2) {
+                ASSERT_TRUE(ih_->delete_entry((const char *)&key, Rid{.page_no = key, .slot_no = 1}, &transaction));
+            }
+            for (int key = base; key < base + keys_per_writer; key += 2) {
+                ASSERT_NE(ih_->insert_entry((const char *)&key, Rid{.page_no = key, .slot_no = 1}, &transaction),
+                          IX_NO_PAGE);
+            }
+            for (int key = base; key < base + keys_per_writer; key++) {
+                ASSERT_TRUE(ih_->delete_entry((const char *)&key, Rid{.page_no = key, .slot_no = 1}, &transaction));
+            }
+        }
+    };
+    auto reader = [&](int thread_itr) {
+        std::default_random_engine rng(thread_itr);
+        for (int i = 0; i < 5000; i++) {
+            int key = rng() % stable_keys;
+            std::vector<Rid> rids;
+            ASSERT_TRUE(ih_->get_value((const char *)&key, &rids, nullptr));
+            ASSERT_EQ(rids, std::vector<Rid>{(Rid{.page_no = key, .slot_no = 0})});
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < writer_num; i++) {
+        threads.emplace_back(writer, i);
+    }
+    for (int i = 0; i < reader_num; i++) {
+        threads.emplace_back(reader, i);
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    std::multimap<int, Rid> mock;
+    for (int key = 0; key < stable_keys; key++) {
+        mock.emplace(key, Rid{.page_no = key, .slot_no = 0});
+    }
+    check_all(mock, stable_keys + writer_num * keys_per_writer);
+}
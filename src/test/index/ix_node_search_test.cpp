@@ -0,0 +1,182 @@
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <random>  // for std::default_random_engine
+
+#include "gtest/gtest.h"
+
+#include "index/ix_index_handle.h"
+#include "index/ix_node_search.h"
+
+// 与一个B+树结点中key的数量相当
+const int NODE_KEYS = 300;
+// 数组末尾预留的空间，对应结点中keys后面的rids，AVX2查找会读到num_key之后的位置
+const int PADDING = 8;
+
+// 原来基于ix_compare的二分查找，作为正确性和性能的对照
+static int generic_lower_bound(const char *keys, int n, const char *target, const std::vector<ColType> &col_types,
+                               const std::vector<int> &col_lens, int col_len) {
+    int low = 0, high = n - 1;
+    while (low <= high) {
+        int mid = (low + high) / 2;
+        int res = ix_compare(keys + mid * col_len, target, col_types, col_lens);
+        if (res == 0) {
+            return mid;
+        } else if (res > 0) {
+            high = mid - 1;
+        } else {
+            low = mid + 1;
+        }
+    }
+    return low;
+}
+
+template <typename T>
+static void check_search(const std::vector<T> &keys, int n, T target, bool use_avx2) {
+    int lo = static_cast<int>(std::lower_bound(keys.begin(), keys.begin() + n, target) - keys.begin());
+    int up = static_cast<int>(std::upper_bound(keys.begin() + std::min(n, 1), keys.begin() + n, target) - keys.begin());
+    ASSERT_EQ((ix_node_search<T, false>(keys.data(), 0, n, target, use_avx2)), lo);
+    ASSERT_EQ((ix_node_search<T, true>(keys.data(), 1, n, target, use_avx2)), std::max(up, 1));
+}
+
+/**
+ * @brief 随机生成含重复key的有序数组，与std::lower_bound/upper_bound的结果对比
+ */
+TEST(IxNodeSearchTest, MatchesStdSearch) {
+    std::default_random_engine rng(0);
+    for (bool use_avx2 : {false, ix_search_use_avx2()}) {
+        for (int n = 0; n <= 100; n++) {
+            std::vector<int> int_keys(n + PADDING, 0);
+            std::vector<float> float_keys(n + PADDING, 0);
+            for (int i = 0; i < n; i++) {
+                int_keys[i] = static_cast<int>(rng() % (2 * n + 1)) - n;
+                float_keys[i] = static_cast<float>(int_keys[i]) / 2;
+            }
+            std::sort(int_keys.begin(), int_keys.begin() + n);
+            std::sort(float_keys.begin(), float_keys.begin() + n);
+            for (int target = -n - 1; target <= n + 1; target++) {
+                check_search<int>(int_keys, n, target, use_avx2);
+                check_search<float>(float_keys, n, static_cast<float>(target) / 2, use_avx2);
+                check_search<float>(float_keys, n, static_cast<float>(target) / 2 + 0.25f, use_avx2);
+            }
+        }
+    }
+}
+
+/**
+ * @brief 非唯一索引的key后面附加了rid，第一个字段每隔stride个int存放一个；rid部分填入随机值，不影响查找结果
+ */
+TEST(IxNodeSearchTest, StridedMatchesStdSearch) {
+    const int stride = 3;
+    std::default_random_engine rng(0);
+    for (bool use_avx2 : {false, ix_search_use_avx2()}) {
+        for (int n = 0; n <= 100; n++) {
+            std::vector<int> sorted(n);
+            for (int i = 0; i < n; i++) {
+                sorted[i] = static_cast<int>(rng() % (2 * n + 1)) - n;
+            }
+            std::sort(sorted.begin(), sorted.end());
+            std::vector<int> keys((n + PADDING) * stride);
+            for (int i = 0; i < n + PADDING; i++) {
+                keys[i * stride] = i < n ? sorted[i] : 0;
+                keys[i * stride + 1] = static_cast<int>(rng());
+                keys[i * stride + 2] = static_cast<int>(rng());
+            }
+            for (int target = -n - 1; target <= n + 1; target++) {
+                int lo = static_cast<int>(std::lower_bound(sorted.begin(), sorted.end(), target) - sorted.begin());
+                int up = static_cast<int>(std::upper_bound(sorted.begin(), sorted.end(), target) - sorted.begin());
+                ASSERT_EQ((ix_node_search<int, false>(keys.data(), 0, n, target, use_avx2, stride)), lo);
+                ASSERT_EQ((ix_node_search<int, true>(keys.data(), lo, n, target, use_avx2, stride)), up);
+            }
+        }
+    }
+}
+
+/**
+ * @brief 对比原来的二分查找与专门的INT查找在一个结点大小的数组上的耗时
+ */
+TEST(IxNodeSearchTest, Benchmark) {
+    const int rounds = 2000000;
+    std::vector<int> keys(NODE_KEYS + PADDING, 0);
+    for (int i = 0; i < NODE_KEYS; i++) {
+        keys[i] = 2 * i;
+    }
+    std::vector<int> targets(1024);
+    std::default_random_engine rng(0);
+    for (auto &target : targets) {
+        target = static_cast<int>(rng() % (2 * NODE_KEYS));
+    }
+    std::vector<ColType> col_types = {TYPE_INT};
+    std::vector<int> col_lens = {sizeof(int)};
+
+    auto bench = [&](const char *name, auto search) {
+        long long checksum = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < rounds; i++) {
+            checksum += search(targets[i & 1023]);
+        }
+        auto end = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(end - start).count() / rounds;
+        printf("%-10s %6.1f ns/search (checksum %lld)\n", name, ns, checksum);
+        return checksum;
+    };
+
+    long long generic = bench("generic", [&](int target) {
+        return generic_lower_bound(reinterpret_cast<const char *>(keys.data()), NODE_KEYS,
+                                   reinterpret_cast<const char *>(&target), col_types, col_lens, sizeof(int));
+    });
+    long long scalar = bench("branchless", [&](int target) {
+        return ix_node_search<int, false>(keys.data(), 0, NODE_KEYS, target, false);
+    });
+    EXPECT_EQ(generic, scalar);
+    if (ix_search_use_avx2()) {
+        long long simd = bench("avx2", [&](int target) {
+            return ix_node_search<int, false>(keys.data(), 0, NODE_KEYS, target, true);
+        });
+        EXPECT_EQ(generic, simd);
+    }
+}
+
+static int sign(int x) { return (x > 0) - (x < 0); }
+
+/**
+ * @brief 各种字段组合下，IxKeyComparator与逐字段的ix_compare结果一致
+ */
+TEST(IxKeyComparatorTest, MatchesIxCompare) {
+    std::vector<std::pair<std::vector<ColType>, std::vector<int>>> shapes = {
+        {{TYPE_INT}, {4}},
+        {{TYPE_FLOAT}, {4}},
+        {{TYPE_INT, TYPE_INT}, {4, 4}},
+        {{TYPE_STRING}, {6}},
+        {{TYPE_STRING, TYPE_INT, TYPE_FLOAT}, {3, 4, 4}},
+    };
+    std::default_random_engine rng(0);
+    for (auto &[col_types, col_lens] : shapes) {
+        IxKeyComparator cmp(col_types, col_lens);
+        int tot_len = 0;
+        for (int len : col_lens) {
+            tot_len += len;
+        }
+        std::vector<char> a(tot_len), b(tot_len);
+        for (int round = 0; round < 1000; round++) {
+            int offset = 0;
+            for (size_t i = 0; i < col_types.size(); i++) {
+                for (auto *key : {&a, &b}) {
+                    if (col_types[i] == TYPE_INT) {
+                        int v = static_cast<int>(rng() % 7) - 3;
+                        memcpy(key->data() + offset, &v, sizeof(int));
+                    } else if (col_types[i] == TYPE_FLOAT) {
+                        float v = static_cast<float>(static_cast<int>(rng() % 7) - 3) / 2;
+                        memcpy(key->data() + offset, &v, sizeof(float));
+                    } else {
+                        for (int j = 0; j < col_lens[i]; j++) {
+                            (*key)[offset + j] = static_cast<char>('a' + rng() % 3);
+                        }
+                    }
+                }
+                offset += col_lens[i];
+            }
+            ASSERT_EQ(sign(cmp(a.data(), b.data())), sign(ix_compare(a.data(), b.data(), col_types, col_lens)));
+        }
+    }
+}
@@ -223,4 +223,41 @@ TEST(RecordManagerTest, MultipleFilesTest) {
         std::string filename = filenames[i];
         rm_manager->destroy_file(filename);
     }
-}
\ No newline at end of file
+}
+
+/**
+ * @brief 新建的数据页和删除记录后变为未满的数据页都进入空闲页链表，插入时先填满已有的页面
+ */
+TEST(RecordManagerTest, FreePageListTest) {
+    auto disk_manager = std::make_unique<DiskManager>();
+    auto buffer_pool_manager = std::make_unique<BufferPoolManager>(BUFFER_POOL_SIZE, disk_manager.get());
+    auto rm_manager = std::make_unique<RmManager>(disk_manager.get(), buffer_pool_manager.get());
+
+    std::string filename = "free_list.txt";
+    if (disk_manager->is_file(filename)) {
+        disk_manager->destroy_file(filename);
+    }
+    rm_manager->create_file(filename, 64);
+    auto file_handle = rm_manager->open_file(filename);
+    int num_per_page = file_handle->file_hdr_.num_records_per_page;
+
+    char buf[64] = {0};
+    std::vector<Rid> rids;
+    for (int i = 0; i < 3 * num_per_page; i++) {
+        rids.push_back(file_handle->insert_record(buf, nullptr));
+    }
+    // 文件头页之外正好3个数据页，都已经写满
+    EXPECT_EQ(file_handle->file_hdr_.num_pages, 4);
+    EXPECT_EQ(file_handle->file_hdr_.first_free_page_no, RM_NO_PAGE);
+
+    // 删除第一页的一条记录，这一页重新成为第一个空闲页，下一次插入使用它空出的槽
+    file_handle->delete_record(rids[0], nullptr);
+    EXPECT_EQ(file_handle->file_hdr_.first_free_page_no, rids[0].page_no);
+    Rid rid = file_handle->insert_record(buf, nullptr);
+    EXPECT_EQ(rid.page_no, rids[0].page_no);
+    EXPECT_EQ(rid.slot_no, rids[0].slot_no);
+    EXPECT_EQ(file_handle->file_hdr_.num_pages, 4);
+
+    rm_manager->close_file(file_handle.get());
+    rm_manager->destroy_file(filename);
+}
@@ -0,0 +1,204 @@
+#include <optional>
+
+#include "gtest/gtest.h"
+
+#include "execution/executor_delete.h"
+#include "execution/executor_insert.h"
+#include "execution/executor_update.h"
+#include "recovery/log_manager.h"
+#include "transaction/transaction_manager.h"
+
+const std::string TEST_DB_NAME = "TransactionAbortTest_db";  // 以数据库名作为根目录
+const std::string TAB_NAME = "p";
+
+/** 表p(id int, v int)，id上有唯一索引；每个测试点在目录TEST_DB_NAME下重新建库 */
+class TransactionAbortTest : public ::testing::Test {
+   public:
+    std::unique_ptr<DiskManager> disk_manager_;
+    std::unique_ptr<BufferPoolManager> buffer_pool_manager_;
+    std::unique_ptr<RmManager> rm_manager_;
+    std::unique_ptr<IxManager> ix_manager_;
+    std::unique_ptr<SmManager> sm_manager_;
+    std::unique_ptr<LockManager> lock_manager_;
+    std::unique_ptr<LogManager> log_manager_;
+    std::unique_ptr<TransactionManager> txn_manager_;
+
+   public:
+    void SetUp() override {
+        ::testing::Test::SetUp();
+        disk_manager_ = std::make_unique<DiskManager>();
+        buffer_pool_manager_ = std::make_unique<BufferPoolManager>(200, disk_manager_.get());
+        rm_manager_ = std::make_unique<RmManager>(disk_manager_.get(), buffer_pool_manager_.get());
+        ix_manager_ = std::make_unique<IxManager>(disk_manager_.get(), buffer_pool_manager_.get());
+        sm_manager_ = std::make_unique<SmManager>(disk_manager_.get(), buffer_pool_manager_.get(), rm_manager_.get(),
+                                                  ix_manager_.get());
+        lock_manager_ = std::make_unique<LockManager>();
+        log_manager_ = std::make_unique<LogManager>(disk_manager_.get());
+        txn_manager_ = std::make_unique<TransactionManager>(lock_manager_.get(), sm_manager_.get());
+
+        if (sm_manager_->is_dir(TEST_DB_NAME)) {
+            sm_manager_->drop_db(TEST_DB_NAME);
+        }
+        sm_manager_->create_db(TEST_DB_NAME);
+        sm_manager_->open_db(TEST_DB_NAME);
+        sm_manager_->create_table(TAB_NAME, {{"id", TYPE_INT, 4}, {"v", TYPE_INT, 4}}, nullptr);
+        sm_manager_->create_index(TAB_NAME, {"id"}, nullptr, true);
+    }
+
+    void TearDown() override {
+        sm_manager_->close_db();
+        sm_manager_->drop_db(TEST_DB_NAME);
+    }
+
+    static Value int_val(int x) {
+        Value val;
+        val.set_int(x);
+        return val;
+    }
+
+    /** 开始一个新事务 */
+    std::unique_ptr<Context> begin() {
+        auto txn = txn_manager_->begin(nullptr, log_manager_.get());
+        return std::make_unique<Context>(lock_manager_.get(), log_manager_.get(), txn);
+    }
+
+    void insert(Context *context, int id, int v) {
+        InsertExecutor(sm_manager_.get(), TAB_NAME, {int_val(id), int_val(v)}, context).Next();
+    }
+
+    /** 通过唯一索引查找id，返回找到的记录中的v，没有找到返回std::nullopt */
+    std::optional<int> lookup(int id) {
+        auto &index = sm_manager_->db_.get_table(TAB_NAME).indexes[0];
+        std::vector<Rid> rids;
+        if (!sm_manager_->get_index(index)->get_value((const char *)&id, &rids, nullptr)) {
+            return std::nullopt;
+        }
+        EXPECT_EQ(rids.size(), 1);
+        auto rec = sm_manager_->fhs_.at(TAB_NAME)->get_record(rids[0], nullptr);
+        EXPECT_EQ(*(int *)rec->data, id);
+        return *(int *)(rec->data + 4);
+    }
+
+    /** 通过唯一索引找到id所在的rid */
+    Rid rid_of(int id) {
+        auto &index = sm_manager_->db_.get_table(TAB_NAME).indexes[0];
+        std::vector<Rid> rids;
+        EXPECT_TRUE(sm_manager_->get_index(index)->get_value((const char *)&id, &rids, nullptr));
+        return rids.at(0);
+    }
+};
+
+/**
+ * @brief 插入后回滚，索引项也被删除：同一个key可以再次插入，点查询找到新插入的记录
+ */
+TEST_F(TransactionAbortTest, AbortInsertThenReinsert) {
+    auto context = begin();
+    insert(context.get(), 2, 2);
+    EXPECT_EQ(lookup(2), 2);
+    txn_manager_->abort(context->txn_, log_manager_.get());
+    EXPECT_EQ(lookup(2), std::nullopt);
+
+    context = begin();
+    EXPECT_NO_THROW(insert(context.get(), 2, 22));
+    txn_manager_->commit(context->txn_, log_manager_.get());
+    EXPECT_EQ(lookup(2), 22);
+}
+
+/**
+ * @brief 删除后回滚，索引项恢复，点查询仍能找到记录
+ */
+TEST_F(TransactionAbortTest, AbortDelete) {
+    auto context = begin();
+    insert(context.get(), 1, 10);
+    insert(context.get(), 3, 30);
+    txn_manager_->commit(context->txn_, log_manager_.get());
+
+    context = begin();
+    DeleteExecutor(sm_manager_.get(), TAB_NAME, {}, {rid_of(1), rid_of(3)}, context.get()).Next();
+    EXPECT_EQ(lookup(1), std::nullopt);
+    txn_manager_->abort(context->txn_, log_manager_.get());
+    EXPECT_EQ(lookup(1), 10);
+    EXPECT_EQ(lookup(3), 30);
+
+    // 恢复的索引项仍然保证唯一
+    context = begin();
+    EXPECT_THROW(insert(context.get(), 1, 11), UniqueConstraintError);
+    txn_manager_->commit(context->txn_, log_manager_.get());
+}
+
+/**
+ * @brief 修改索引字段后回滚：新key的索引项删除，旧key的索引项恢复
+ */
+TEST_F(TransactionAbortTest, AbortUpdate) {
+    auto context = begin();
+    insert(context.get(), 1, 10);
+    insert(context.get(), 2, 20);
+    txn_manager_->commit(context->txn_, log_manager_.get());
+
+    // 依次把2改成3、1改成2，更新后2的索引项属于原来id为1的记录
+    context = begin();
+    std::vector<Rid> rids = {rid_of(2), rid_of(1)};
+    std::vector<std::vector<SetClause>> set_clauses = {{{{TAB_NAME, "id"}, int_val(3)}},
+                                                       {{{TAB_NAME, "id"}, int_val(2)}}};
+    for (size_t i = 0; i < rids.size(); i++) {
+        set_clauses[i][0].rhs.init_raw(4);
+        UpdateExecutor(sm_manager_.get(), TAB_NAME, set_clauses[i], {}, {rids[i]}, context.get()).Next();
+    }
+    EXPECT_EQ(lookup(1), std::nullopt);
+    EXPECT_EQ(lookup(2), 10);
+    EXPECT_EQ(lookup(3), 20);
+    txn_manager_->abort(context->txn_, log_manager_.get());
+    EXPECT_EQ(lookup(1), 10);
+    EXPECT_EQ(lookup(2), 20);
+    EXPECT_EQ(lookup(3), std::nullopt);
+}
+
+/**
+ * @brief 只改写key发生变化的索引项：没有更新索引字段、或者更新后的值与原来相同时不记录索引项的写操作；
+ * 回滚后改写过的索引恢复原来的key
+ */
+TEST_F(TransactionAbortTest, UpdateOnlyChangedIndexes) {
+    sm_manager_->create_index(TAB_NAME, {"v"}, nullptr);
+    auto context = begin();
+    insert(context.get(), 1, 10);
+    insert(context.get(), 2, 20);
+    txn_manager_->commit(context->txn_, log_manager_.get());
+
+    // 收集事务中索引项写操作所属的索引
+    auto entry_indexes = [](Transaction *txn) {
+        std::vector<std::vector<std::string>> result;
+        for (auto wr : *txn->get_write_set()) {
+            if (wr->GetWriteType() == WType::INSERT_ENTRY || wr->GetWriteType() == WType::DELETE_ENTRY) {
+                result.push_back(wr->GetIndexCols());
+            }
+        }
+        return result;
+    };
+    auto v_rids = [&](int v) {
+        auto &index = sm_manager_->db_.get_table(TAB_NAME).indexes[1];
+        std::vector<Rid> rids;
+        sm_manager_->get_index(index)->get_value((const char *)&v, &rids, nullptr);
+        return rids;
+    };
+
+    context = begin();
+    Rid rid = rid_of(1);
+    std::vector<SetClause> same = {{{TAB_NAME, "id"}, int_val(1)}, {{TAB_NAME, "v"}, int_val(10)}};
+    std::vector<SetClause> new_v = {{{TAB_NAME, "v"}, int_val(11)}};
+    for (auto set_clauses : {same, new_v}) {
+        for (auto &set_clause : set_clauses) {
+            set_clause.rhs.init_raw(4);
+        }
+        UpdateExecutor(sm_manager_.get(), TAB_NAME, set_clauses, {}, {rid}, context.get()).Next();
+    }
+    auto indexes = entry_indexes(context->txn_);
+    EXPECT_EQ(indexes, std::vector<std::vector<std::string>>(2, {"v"}));
+    EXPECT_EQ(lookup(1), 11);
+    EXPECT_EQ(v_rids(11), std::vector<Rid>{rid});
+    EXPECT_TRUE(v_rids(10).empty());
+
+    txn_manager_->abort(context->txn_, log_manager_.get());
+    EXPECT_EQ(lookup(1), 10);
+    EXPECT_EQ(v_rids(10), std::vector<Rid>{rid});
+    EXPECT_TRUE(v_rids(11).empty());
+}
@@ -140,6 +140,17 @@ void TransactionManager::abort(Transaction * txn, LogManager *log_manager) {
             auto &rid = wr->GetRid();
             fh_->update_record(rid, rec.data, context);
         }
+        else if(wtype == WType::INSERT_ENTRY || wtype == WType::DELETE_ENTRY)
+        {
+            auto &key = wr->GetRecord();
+            auto &tab = sm_manager_->db_.get_table(wr->GetTableName());
+            auto ih = sm_manager_->get_index(*tab.get_index_meta(wr->GetIndexCols()));
+            if(wtype == WType::INSERT_ENTRY) {
+                ih->delete_entry(key.data, wr->GetRid(), txn);
+            } else {
+                ih->insert_entry(key.data, wr->GetRid(), txn);
+            }
+        }
     }
 
     //释放所有锁
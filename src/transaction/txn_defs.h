@@ -11,6 +11,7 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 
 #include <atomic>
+#include <vector>
 
 #include "common/config.h"
 #include "defs.h"
@@ -22,8 +23,8 @@ enum class TransactionState { DEFAULT, GROWING, SHRINKING, COMMITTED, ABORTED };
 /* 系统的隔离级别，当前赛题中为可串行化隔离级别 */
 enum class IsolationLevel { READ_UNCOMMITTED, REPEATABLE_READ, READ_COMMITTED, SERIALIZABLE };
 
-/* 事务写操作类型，包括插入、删除、更新三种操作 */
-enum class WType { INSERT_TUPLE = 0, DELETE_TUPLE, UPDATE_TUPLE};
+/* 事务写操作类型，包括插入、删除、更新三种操作，以及索引项的插入、删除 */
+enum class WType { INSERT_TUPLE = 0, DELETE_TUPLE, UPDATE_TUPLE, INSERT_ENTRY, DELETE_ENTRY };
 
 /**
  * @brief 事务的写操作记录，用于事务的回滚
@@ -35,6 +36,10 @@ enum class WType { INSERT_TUPLE = 0, DELETE_TUPLE, UPDATE_TUPLE};
  * ----------------------------------------------
  * | wtype | tab_name | tuple_rid | tuple_value |
  * ----------------------------------------------
+ * INSERT_ENTRY / DELETE_ENTRY
+ * ---------------------------------------------------
+ * | wtype | tab_name | tuple_rid | key | index_cols |
+ * ---------------------------------------------------
  */
 class WriteRecord {
    public:
@@ -48,6 +53,11 @@ class WriteRecord {
     WriteRecord(WType wtype, const std::string &tab_name, const Rid &rid, const RmRecord &record)
         : wtype_(wtype), tab_name_(tab_name), rid_(rid), record_(record) {}
 
+    // constructor for index entry operation, record_ holds the key
+    WriteRecord(WType wtype, const std::string &tab_name, const Rid &rid, const RmRecord &key,
+                const std::vector<std::string> &index_cols)
+        : wtype_(wtype), tab_name_(tab_name), rid_(rid), record_(key), index_cols_(index_cols) {}
+
     ~WriteRecord() = default;
 
     inline RmRecord &GetRecord() { return record_; }
@@ -58,11 +68,14 @@ class WriteRecord {
 
     inline std::string &GetTableName() { return tab_name_; }
 
+    inline std::vector<std::string> &GetIndexCols() { return index_cols_; }
+
    private:
     WType wtype_;
     std::string tab_name_;
     Rid rid_;
     RmRecord record_;
+    std::vector<std::string> index_cols_;   // 索引项所属索引的字段名
 };
 
 /* 多粒度锁，加锁对象的类型，包括记录和表 */